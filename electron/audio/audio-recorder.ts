@@ -1,14 +1,22 @@
-import fs from 'node:fs'
 import fsPromises from 'node:fs/promises'
 import path from 'node:path'
-import { BrowserWindow } from 'electron'
+import { BrowserWindow, MessageChannelMain, type MessagePortMain } from 'electron'
 import type { RecorderConfig } from '../config'
+import type { PcmAudio } from '../transcriber'
+import { DEFAULT_RECORDER_FRAME_MS, FRAME_FLAG_END, parseRecorderFrame } from '../../shared/recorder-frame'
+
+/** 按样本偏移补齐丢帧时最多补入的静音，超过视为异常帧 */
+const MAX_GAP_FILL_MS = 10000
 
 export interface RecordingResult {
   sessionId: string
   audioPath: string
   durationMs: number
   startedAt: number
+  /** 录音原始 PCM，可直接交给转写器 */
+  pcm: PcmAudio
+  /** audio.wav 归档写入完成（在后台进行，不阻塞转写） */
+  archived: Promise<void>
 }
 
 
@@ -17,8 +25,18 @@ export interface RecordingResult {
  */
 export class NativeRecordingHandle {
   private stopped = false
+  private completed = false
   private finished: Promise<RecordingResult> | null = null
   private audioChunks: Buffer[] = []
+  private port: MessagePortMain | null = null
+  /** 下一帧期望的序号 */
+  private nextSeq = 0
+  /** 已收到的每声道样本数 */
+  private receivedFrames = 0
+  private droppedFrames = 0
+  private lateFrames = 0
+  private malformedFrames = 0
+  private chunkListener: ((chunk: Buffer) => void) | null = null
   private resolvePromise?: (result: RecordingResult) => void
   private rejectPromise?: (error: Error) => void
 
@@ -32,11 +50,63 @@ export class NativeRecordingHandle {
   ) {}
 
   /**
-   * 接收音频数据块
+   * 绑定渲染进程的录音数据端口，结束帧或端口关闭时完成录音
    */
-  receiveChunk(data: Buffer): void {
-    if (this.stopped) return
+  attachPort(port: MessagePortMain): void {
+    this.port = port
+    port.on('message', (event) => this.receiveFrame(event.data as ArrayBuffer | Uint8Array))
+    port.on('close', () => this.finishRecording())
+    port.start()
+  }
+
+  /**
+   * 接收一帧音频（格式见 shared/recorder-frame.ts）
+   * 停止后仍接收在途的帧，直到结束帧到达
+   */
+  receiveFrame(data: ArrayBuffer | Uint8Array): void {
+    if (this.completed) return
+    const frame = parseRecorderFrame(data)
+    if (!frame) {
+      this.malformedFrames++
+      return
+    }
+    if (frame.seq < this.nextSeq) {
+      // 乱序或重复的帧：对应时间段已补齐，丢弃
+      this.lateFrames++
+      return
+    }
+    this.droppedFrames += frame.seq - this.nextSeq
+    this.nextSeq = frame.seq + 1
+
+    const frameBytes = 2 * this.channels
+    let pcm = Buffer.from(frame.pcm.buffer, frame.pcm.byteOffset, frame.pcm.byteLength)
+    const gap = frame.sampleOffset - this.receivedFrames
+    if (gap > 0 && gap <= (this.sampleRate * MAX_GAP_FILL_MS) / 1000) {
+      // 丢失的部分补静音，保持录音时长与时间戳一致
+      this.appendPcm(Buffer.alloc(gap * frameBytes))
+    } else if (gap < 0) {
+      pcm = pcm.subarray(Math.min(pcm.length, -gap * frameBytes))
+    }
+    if (pcm.length > 0) {
+      this.appendPcm(pcm)
+    }
+
+    if (frame.flags & FRAME_FLAG_END) {
+      this.finishRecording()
+    }
+  }
+
+  private appendPcm(data: Buffer): void {
     this.audioChunks.push(data)
+    this.receivedFrames += data.length / (2 * this.channels)
+    this.chunkListener?.(data)
+  }
+
+  /**
+   * 订阅实时音频块（用于录音期间的流式转写）
+   */
+  setChunkListener(listener: ((chunk: Buffer) => void) | null): void {
+    this.chunkListener = listener
   }
 
   /**
@@ -64,23 +134,44 @@ export class NativeRecordingHandle {
   }
 
   /**
-   * 完成录音（渲染进程调用）
+   * 完成录音（收到结束帧、端口关闭或窗口已销毁时调用）
    */
-  finishRecording(finalData?: Buffer): void {
-    if (finalData) {
-      this.audioChunks.push(finalData)
+  finishRecording(): void {
+    if (this.completed) return
+    this.completed = true
+    this.chunkListener = null
+    this.port?.close()
+    this.port = null
+
+    if (this.droppedFrames > 0 || this.lateFrames > 0 || this.malformedFrames > 0) {
+      console.warn('[AudioRecorder] 录音数据帧异常:', {
+        dropped: this.droppedFrames,
+        late: this.lateFrames,
+        malformed: this.malformedFrames,
+      })
+    }
+
+    // 端口在 stop() 之前关闭（例如渲染进程重载）时保留结果，stop() 直接返回
+    if (!this.finished) {
+      this.finished = new Promise((resolve, reject) => {
+        this.resolvePromise = resolve
+        this.rejectPromise = reject
+      })
+      this.finished.catch(() => {
+        // 由 stop() 的调用方处理
+      })
     }
 
     try {
       // 合并所有音频块
       const audioData = Buffer.concat(this.audioChunks)
-      
-      // 创建 WAV 文件
-      const header = this.createWavHeader(audioData.length)
-      const wavBuffer = Buffer.concat([header, audioData])
-      
-      // 写入文件
-      fs.writeFileSync(this.audioPath, wavBuffer)
+      this.audioChunks = []
+
+      // 归档 WAV 在后台写入，转写直接使用内存中的 PCM
+      const archived = this.writeArchive(audioData)
+      archived.catch((error) => {
+        console.error('[AudioRecorder] 录音归档写入失败:', error)
+      })
 
       const durationMs = Date.now() - this.startedAt
       this.resolvePromise?.({
@@ -88,12 +179,37 @@ export class NativeRecordingHandle {
         audioPath: this.audioPath,
         durationMs,
         startedAt: this.startedAt,
+        pcm: {
+          sampleRate: this.sampleRate,
+          channels: this.channels,
+          bitsPerSample: 16,
+          data: audioData,
+        },
+        archived,
       })
     } catch (error) {
       this.rejectPromise?.(error instanceof Error ? error : new Error(String(error)))
     }
   }
 
+  /** 录音数据已全部接收 */
+  isCompleted(): boolean {
+    return this.completed
+  }
+
+  /**
+   * 写入 WAV 归档（头部与数据分开写，避免再拼接一份完整副本）
+   */
+  private async writeArchive(audioData: Buffer): Promise<void> {
+    const header = this.createWavHeader(audioData.length)
+    const file = await fsPromises.open(this.audioPath, 'w')
+    try {
+      await file.writev([header, audioData])
+    } finally {
+      await file.close()
+    }
+  }
+
   /**
    * 创建 WAV 文件头
    */
@@ -172,34 +288,27 @@ export class AudioRecorder {
 
     this.activeNativeHandle = handle
 
+    // 每次录音新建一对端口，音频帧走专用通道并转移缓冲区，不经过 ipcMain
+    const { port1, port2 } = new MessageChannelMain()
+    handle.attachPort(port1)
+
     // 通知渲染进程开始录音
-    window.webContents.send('native-recorder:start', {
+    window.webContents.postMessage('native-recorder:start', {
       sampleRate: this.config.sampleRate,
       channels: this.config.channels,
-    })
+      frameMs: this.config.frameMs ?? DEFAULT_RECORDER_FRAME_MS,
+    }, [port2])
 
     return handle
   }
 
-  /**
-   * 接收原生录音数据块
-   */
-  receiveNativeChunk(data: Buffer): void {
-    this.activeNativeHandle?.receiveChunk(data)
-  }
-
-  /**
-   * 完成原生录音
-   */
-  finishNativeRecording(finalData?: Buffer): void {
-    this.activeNativeHandle?.finishRecording(finalData)
-    this.activeNativeHandle = null
-  }
-
   /**
    * 获取当前活跃的原生录音句柄
    */
   getActiveNativeHandle(): NativeRecordingHandle | null {
+    if (this.activeNativeHandle?.isCompleted()) {
+      this.activeNativeHandle = null
+    }
     return this.activeNativeHandle
   }
 }
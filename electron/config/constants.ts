@@ -58,6 +58,16 @@ export const APP_CONSTANTS = {
   ERROR_IDLE_DELAY_MS: 4000,
   /** 快捷键防抖延迟（毫秒） */
   SHORTCUT_DEBOUNCE_MS: 500,
+  /** 批量文件转录同时运行的批次数（每批占用一个识别器进程） */
+  BATCH_TRANSCRIPTION_CONCURRENCY: 2,
+  /** 启动后延迟多久在空闲时自动调优识别器（毫秒） */
+  AUTOTUNE_DELAY_MS: 60 * 1000,
+  /** 启动后延迟多久按保留策略清理历史记录（毫秒） */
+  RETENTION_DELAY_MS: 5 * 60 * 1000,
+  /** 历史记录清理的运行间隔（毫秒） */
+  RETENTION_INTERVAL_MS: 6 * 60 * 60 * 1000,
+  /** 转写结果缓存的容量上限（字节） */
+  RESULT_CACHE_MAX_BYTES: 8 * 1024 * 1024,
 } as const
 
 /**
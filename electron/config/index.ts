@@ -1,8 +1,9 @@
 import fs from 'node:fs'
 import path from 'node:path'
 import os from 'node:os'
-import type { ShortcutConfig, PolishConfig, TranscriptionSettings, OnlineTranscriptionConfig, AppleDictationConfig } from '../../shared/app-state'
+import type { ShortcutConfig, PolishConfig, TranscriptionSettings, OnlineTranscriptionConfig, AppleDictationConfig, RetentionSettings } from '../../shared/app-state'
 import { DEFAULT_TAP_POLISH_ENABLED, DEFAULT_HOLD_POLISH_ENABLED } from '../../shared/app-state'
+import { DEFAULT_RECORDER_FRAME_MS } from '../../shared/recorder-frame'
 import {
   getAppRoot,
   getUserDataPath,
@@ -26,6 +27,8 @@ export interface RecorderConfig {
   silence: string
   recorder: 'sox'
   maxDurationMs: number
+  /** 渲染进程每帧发送的音频时长（毫秒），越大唤醒主进程越少、流式转写延迟越高 */
+  frameMs?: number
 }
 
 export interface SenseVoiceTranscriberConfig {
@@ -36,6 +39,8 @@ export interface SenseVoiceTranscriberConfig {
   language?: string
   useInverseTextNormalization?: boolean
   modelId?: string
+  /** 推理线程数，未设置时使用 worker 默认值 */
+  numThreads?: number
 }
 
 export type TranscriberConfig = SenseVoiceTranscriberConfig
@@ -81,6 +86,7 @@ export function loadRecorderConfig(): RecorderConfig {
     silence: '10.0',
     recorder: 'sox',
     maxDurationMs: 0,
+    frameMs: DEFAULT_RECORDER_FRAME_MS,
   }
   return loadJsonFile<RecorderConfig>('audio.json', defaults)
 }
@@ -126,6 +132,7 @@ type RawTranscriberConfig = Partial<{
   language: string
   useInverseTextNormalization: boolean
   modelId: string
+  numThreads: number
 }>
 
 function normalizePath(p: string | undefined) {
@@ -160,6 +167,7 @@ function buildSenseVoiceConfig(raw: RawTranscriberConfig): SenseVoiceTranscriber
     language,
     useInverseTextNormalization: raw.useInverseTextNormalization ?? true,
     modelId: raw.modelId ?? (language === 'zh' ? 'SenseVoice-Small (中文)' : 'SenseVoice-Small'),
+    numThreads: Number.isInteger(raw.numThreads) && (raw.numThreads as number) > 0 ? raw.numThreads : undefined,
   }
 }
 
@@ -175,14 +183,18 @@ export interface AppSettings {
   clipboardMode: boolean
   notificationEnabled: boolean
   autoShowOnStart: boolean
-  /** 模型缓存 TTL（分钟），0 表示永不过期 */
+  /** 内存偏紧时模型的最短闲置时间（分钟），0 表示常驻，仅严重内存压力时卸载 */
   cacheTTLMinutes: number
+  /** 离线识别 worker 常驻内存上限（MB），超出后闲置时卸载，0 表示不限制 */
+  modelMemoryCapMB: number
   /** 是否接收测试版更新（beta 版本） */
   allowBetaUpdates: boolean
   /** AI 润色配置 */
   polish: PolishConfig
   /** 转录配置 */
   transcription: TranscriptionSettings
+  /** 历史记录保留策略 */
+  retention: RetentionSettings
 }
 
 const DEFAULT_POLISH_CONFIG: PolishConfig = {
@@ -200,6 +212,9 @@ const DEFAULT_ONLINE_TRANSCRIPTION_CONFIG: OnlineTranscriptionConfig = {
   responseFormat: 'json',
   temperature: 0,
   timeoutMs: 120000,
+  uploadFormat: 'flac',
+  trimSilence: true,
+  streamingUpload: true,
 }
 
 const DEFAULT_APPLE_DICTATION_CONFIG: AppleDictationConfig = {
@@ -210,6 +225,15 @@ const DEFAULT_TRANSCRIPTION_SETTINGS: TranscriptionSettings = {
   mode: 'offline',
   online: DEFAULT_ONLINE_TRANSCRIPTION_CONFIG,
   apple: DEFAULT_APPLE_DICTATION_CONFIG,
+  streamingDecode: true,
+  streamingRedecodeBoundary: false,
+  longFileWindowSec: 60,
+}
+
+const DEFAULT_RETENTION_SETTINGS: RetentionSettings = {
+  audioDays: 0,
+  transcriptDays: 0,
+  maxAudioMB: 0,
 }
 
 export function loadAppSettings(): AppSettings {
@@ -220,9 +244,11 @@ export function loadAppSettings(): AppSettings {
     notificationEnabled: true,
     autoShowOnStart: false,
     cacheTTLMinutes: 30, // 默认 30 分钟
+    modelMemoryCapMB: 0, // 默认不限制
     allowBetaUpdates: false, // 默认不接收测试版
     polish: DEFAULT_POLISH_CONFIG,
     transcription: DEFAULT_TRANSCRIPTION_SETTINGS,
+    retention: DEFAULT_RETENTION_SETTINGS, // 默认永久保留
   }
   const raw = loadJsonFile<AppSettings>('settings.json', defaults)
   return {
@@ -244,6 +270,10 @@ export function loadAppSettings(): AppSettings {
         ...raw.transcription?.apple,
       },
     },
+    retention: {
+      ...DEFAULT_RETENTION_SETTINGS,
+      ...raw.retention,
+    },
   }
 }
 
@@ -28,6 +28,7 @@ const DEFAULT_SETTINGS = {
   notificationEnabled: true,
   autoShowOnStart: true,
   cacheTTLMinutes: 30,
+  modelMemoryCapMB: 0,
   transcription: {
     mode: 'offline',
     online: {
@@ -9,7 +9,7 @@ import path from 'node:path'
 import fsPromises from 'node:fs/promises'
 import crypto from 'node:crypto'
 import fs from 'node:fs'
-import type { SpeechTideState, TranscriptionMeta, TriggerType } from '../../shared/app-state'
+import type { AutotuneStatus, SpeechTideState, TranscriptionMeta, TriggerType } from '../../shared/app-state'
 import { DEFAULT_TAP_POLISH_ENABLED, DEFAULT_HOLD_POLISH_ENABLED } from '../../shared/app-state'
 import type { ConversationRecord } from '../../shared/conversation'
 import { StateMachine } from './state-machine'
@@ -19,8 +19,8 @@ import { KeyboardHookService } from '../services/keyboard-hook-service'
 import { IPCListeners } from '../listeners/ipc-listeners'
 import { ipcMain } from 'electron'
 import { AudioRecorder, RecordingHandle, RecordingResult, NativeRecordingHandle } from '../audio/audio-recorder'
-import { createTranscriber, Transcriber, type OpenAITranscriberConfig } from '../transcriber'
-import { getDefaultSupportDirectory, loadRecorderConfig, loadTranscriberConfig, loadAppSettings, saveAppSettings } from '../config'
+import { createTranscriber, StreamFallbackError, Transcriber, type OpenAITranscriberConfig, type TranscriptionStream } from '../transcriber'
+import { getConfigDir, getDefaultSupportDirectory, loadRecorderConfig, loadTranscriberConfig, loadAppSettings, saveAppSettings } from '../config'
 import { ConversationStore } from '../storage/conversation-store'
 import { AppleScriptTextInserter } from '../utils/apple-script'
 import { STATUS_LABEL, STATUS_HINT, DEFAULT_TEST_AUDIO_URL, APP_CONSTANTS } from '../config/constants'
@@ -29,8 +29,13 @@ import { metrics } from '../utils/metrics'
 import { onboardingService } from '../services/onboarding-service'
 import { updateService } from '../services/update-service'
 import { PolishEngine } from '../services/polish-engine'
-import { FileTranscriptionService } from '../services/file-transcription-service'
+import { FileTranscriptionService, type ExportOptions } from '../services/file-transcription-service'
+import { BatchTranscriptionQueue } from '../services/batch-transcription-queue'
 import { AppleDictationService, type AppleDictationHandle } from '../services/apple-dictation-service'
+import { TranscriberResidencyManager, type ResidencyPolicy } from '../services/transcriber-residency'
+import { RecognizerAutotuner } from '../services/recognizer-autotuner'
+import { HistoryRetention } from '../services/history-retention'
+import { TranscriptionResultCache, withResultCache } from '../services/transcription-result-cache'
 import { dialog } from 'electron'
 
 const logger = createModuleLogger('app-controller')
@@ -54,17 +59,53 @@ export class AppController {
   private readonly testAudioPath = path.join(this.supportDir, 'assets', 'test-audio.wav')
   private readonly audioRecorder = new AudioRecorder(this.conversationsDir, this.recorderConfig)
   private readonly appleDictationService = new AppleDictationService()
-  private transcriber: Transcriber | null = null  // 懒加载，支持动态卸载
+  // 识别器自动调优：在本机测量并选择模型文件（fp32/int8）与推理线程数
+  private readonly autotuner = new RecognizerAutotuner({
+    configDir: getConfigDir(),
+    supportDir: this.supportDir,
+    getBaseConfig: () => this.senseVoiceConfig,
+    prepareAudio: async () => {
+      if (!fs.existsSync(this.testAudioPath)) {
+        await this.downloadTestAudio(this.testAudioPath)
+      }
+      return this.testAudioPath
+    },
+    onUpdate: (status) => this.windowService?.send('speech:autotune-updated', status),
+  })
+  // 转写结果缓存：相同音频 + 相同配置直接返回上次结果
+  private readonly resultCache = new TranscriptionResultCache({
+    cacheDir: path.join(this.supportDir, 'cache', 'transcripts'),
+    maxBytes: APP_CONSTANTS.RESULT_CACHE_MAX_BYTES,
+  })
+  // 离线模型懒加载，内存紧张时卸载，快捷键/窗口焦点触发预热
+  private readonly transcriberResidency = new TranscriberResidencyManager({
+    create: () => {
+      logger.info('创建转写器实例...')
+      const config = this.resolveTranscriberConfig()
+      return withResultCache(createTranscriber(config, { supportDir: this.supportDir }), this.resultCache, config)
+    },
+    getPolicy: () => this.resolveResidencyPolicy(),
+  })
   private readonly conversationStore = new ConversationStore(this.conversationsDir)
+  // 历史记录保留策略：应用空闲时按批清理过期的会话与录音
+  private readonly historyRetention = new HistoryRetention({
+    store: this.conversationStore,
+    getPolicy: () => this.settings.retention,
+    isBusy: () => {
+      const { status } = this.stateMachine.getState()
+      return this.activeRecording !== null || this.testInProgress || status === 'recording' || status === 'transcribing' || status === 'polishing'
+    },
+    onUpdate: (status) => this.windowService?.send('speech:retention-updated', status),
+  })
   private readonly appleScriptInserter = new AppleScriptTextInserter()
   private polishEngine: PolishEngine | null = null  // 润色引擎
   private fileTranscriptionService: FileTranscriptionService | null = null  // 文件转录服务
+  private batchQueue: BatchTranscriptionQueue | null = null  // 批量文件转录队列
 
   // 状态
   private initialized = false
-  private activeRecording: { sessionId: string; kind: 'native' | 'apple'; handle: RecordingHandle | NativeRecordingHandle | AppleDictationHandle; timeout?: NodeJS.Timeout; recordingTimer?: string; appleRequireOnDevice?: boolean; appleLocale?: string; appleAudioPath?: string } | null = null
+  private activeRecording: { sessionId: string; kind: 'native' | 'apple'; handle: RecordingHandle | NativeRecordingHandle | AppleDictationHandle; timeout?: NodeJS.Timeout; recordingTimer?: string; appleRequireOnDevice?: boolean; appleLocale?: string; appleAudioPath?: string; stream?: TranscriptionStream | null } | null = null
   private idleTimer: NodeJS.Timeout | null = null
-  private cacheTimer: NodeJS.Timeout | null = null  // 模型缓存卸载计时器
   private testInProgress = false
   private settings = loadAppSettings()
 
@@ -106,19 +147,37 @@ export class AppController {
     await app.whenReady()
     logger.info('Electron 已就绪')
 
+    // 用户切回应用通常意味着即将口述，提前加载模型
+    app.on('browser-window-focus', () => this.transcriberResidency.prewarm('window-focus'))
+
     if (isMac) {
       app.dock.hide()
     }
 
+    // 重放上次退出前未写完的会话记录
+    this.conversationStore.recover().catch((error) => {
+      logger.error(error instanceof Error ? error : new Error(String(error)), { context: 'recoverConversations' })
+    })
+
     this.initServices()
     this.registerIPC()
-    this.registerNativeRecordingIPC()
     this.registerFileTranscriptionIPC()
     this.setupStateListeners()
 
+    // 恢复重启前未完成的批量转录
+    if (fs.existsSync(path.join(this.supportDir, 'cache', 'batch-queue.json'))) {
+      this.ensureBatchQueue().resume()
+    }
+
     // 应用 beta 更新设置
     updateService.setAllowBetaUpdates(this.settings.allowBetaUpdates)
 
+    // 尚未调优（或机器/模型已变化）时，稍后在空闲时自动调优
+    this.scheduleAutotune()
+
+    // 按保留策略定期清理历史记录
+    this.historyRetention.schedule(APP_CONSTANTS.RETENTION_DELAY_MS, APP_CONSTANTS.RETENTION_INTERVAL_MS)
+
     this.initialized = true
     metrics.endTimer(initTimer, 'model_load', { stage: 'app_init' })
     logger.info('初始化完成')
@@ -246,6 +305,13 @@ export class AppController {
             }
           }
 
+          if (settings.retention) {
+            settings.retention = {
+              ...this.settings.retention,
+              ...settings.retention,
+            }
+          }
+
           const transcriptionChanged = settings.transcription !== undefined
 
           saveAppSettings(settings)
@@ -253,12 +319,9 @@ export class AppController {
           Object.assign(this.settings, settings)
           logger.debug('设置已更新', { settings })
 
-          // 如果缓存时间变更，重新调度卸载计时器
+          // 驻留策略在每次内存检查时读取，新的缓存时间会自动生效
           if (settings.cacheTTLMinutes !== undefined && settings.cacheTTLMinutes !== oldTTL) {
             logger.info(`缓存时间变更：${oldTTL} -> ${settings.cacheTTLMinutes} 分钟`)
-            if (this.transcriber) {
-              this.scheduleTranscriberUnload()
-            }
           }
 
           // 如果 beta 更新设置变更，更新 UpdateService
@@ -266,9 +329,14 @@ export class AppController {
             updateService.setAllowBetaUpdates(settings.allowBetaUpdates)
           }
 
+          // 保留策略变更后尽快按新策略清理一次
+          if (settings.retention !== undefined) {
+            this.historyRetention.schedule(APP_CONSTANTS.IDLE_DELAY_MS, APP_CONSTANTS.RETENTION_INTERVAL_MS)
+            logger.info('历史记录保留策略已更新', { ...settings.retention })
+          }
+
           if (transcriptionChanged) {
-            this.unloadTranscriber()
-            this.cancelTranscriberUnload()
+            this.transcriberResidency.unload('config-changed')
             logger.info('转写配置已更新', { mode: this.settings.transcription?.mode })
           }
 
@@ -341,6 +409,38 @@ export class AppController {
           return { records: [], error: '加载历史记录失败' }
         }
       },
+      searchHistory: async (options) => {
+        try {
+          return await this.conversationStore.search(options?.query ?? '', {
+            limit: options?.limit ?? 50,
+            offset: options?.offset ?? 0,
+          })
+        } catch (error) {
+          logger.error(error instanceof Error ? error : new Error(String(error)), { context: 'searchHistory' })
+          return { records: [], total: 0, error: '搜索历史记录失败' }
+        }
+      },
+      getUsageAnalytics: async (options) => {
+        try {
+          return await this.conversationStore.getUsageAnalytics(options)
+        } catch (error) {
+          logger.error(error instanceof Error ? error : new Error(String(error)), { context: 'getUsageAnalytics' })
+          return {
+            count: 0,
+            errorCount: 0,
+            errorRate: 0,
+            spokenMs: 0,
+            words: 0,
+            wordsPerMinute: null,
+            avgLatencyMs: null,
+            daily: [],
+            models: [],
+            rows: 0,
+            elapsedMs: 0,
+            error: '统计历史记录失败',
+          }
+        }
+      },
       deleteHistoryItem: async (sessionId) => {
         try {
           // 不允许删除当前正在进行的会话
@@ -360,16 +460,57 @@ export class AppController {
           if (!record) {
             return { success: false, error: '记录不存在' }
           }
-          if (!record.audioPath || !fs.existsSync(record.audioPath)) {
+          // 已打包的音频会先导出为临时 WAV
+          const audioPath = await this.conversationStore.resolveAudioPath(sessionId)
+          if (!audioPath) {
             return { success: false, error: '音频文件不存在' }
           }
-          this.windowService?.send('speech:play-audio', record.audioPath)
+          this.windowService?.send('speech:play-audio', audioPath)
           return { success: true }
         } catch (error) {
           logger.error(error instanceof Error ? error : new Error(String(error)), { context: 'playHistoryAudio', sessionId })
           return { success: false, error: String(error) }
         }
       },
+      exportHistoryAudio: async (sessionId) => {
+        try {
+          const record = await this.conversationStore.get(sessionId)
+          if (!record) {
+            return { success: false, error: '记录不存在' }
+          }
+          const mainWindow = this.windowService?.getWindow()
+          const result = await dialog.showSaveDialog(mainWindow!, {
+            title: '导出录音',
+            defaultPath: `SpeechTide-${new Date(record.finishedAt || record.startedAt).toISOString().slice(0, 19).replace(/[T:]/g, '-')}.wav`,
+            filters: [{ name: 'WAV 音频', extensions: ['wav'] }],
+          })
+          if (result.canceled || !result.filePath) {
+            return { success: false, canceled: true }
+          }
+          const exported = await this.conversationStore.exportAudio(sessionId, result.filePath)
+          if (!exported) {
+            return { success: false, error: '音频文件不存在' }
+          }
+          logger.info('录音已导出', { sessionId, filePath: result.filePath })
+          return { success: true, filePath: result.filePath }
+        } catch (error) {
+          logger.error(error instanceof Error ? error : new Error(String(error)), { context: 'exportHistoryAudio', sessionId })
+          return { success: false, error: String(error) }
+        }
+      },
+      getPerformanceStats: async () => ({
+        residency: this.transcriberResidency.getStats(),
+        operations: metrics.getAllStats(),
+        workerQueues: {
+          dictation: (await this.transcriberResidency.current?.getQueueStats?.()) ?? null,
+          files: (await this.fileTranscriptionService?.getQueueStats()) ?? [],
+        },
+        resultCache: this.resultCache.getStats(),
+      }),
+      getAutotuneStatus: () => this.autotuner.getStatus(),
+      runAutotune: () => this.runAutotune(),
+      getRetentionStatus: () => this.historyRetention.getStatus(),
+      runRetention: () => this.historyRetention.run(),
     })
   }
 
@@ -383,21 +524,6 @@ export class AppController {
     })
   }
 
-  /**
-   * 注册原生录音 IPC 处理器
-   */
-  private registerNativeRecordingIPC(): void {
-    // 接收音频数据块
-    ipcMain.on('native-recorder:chunk', (_event, data: ArrayBuffer) => {
-      this.audioRecorder.receiveNativeChunk(Buffer.from(data))
-    })
-
-    // 录音完成
-    ipcMain.on('native-recorder:complete', (_event, data: ArrayBuffer | null) => {
-      this.audioRecorder.finishNativeRecording(data ? Buffer.from(data) : undefined)
-    })
-  }
-
   /**
    * 注册文件转录 IPC 处理器
    */
@@ -406,14 +532,35 @@ export class AppController {
     ipcMain.handle('speech:transcribe-file', async (_event, filePath: string) => {
       logger.info('收到文件转录请求', { filePath })
       const service = this.ensureFileTranscriptionService()
-      const result = await service.transcribeFile(filePath, (progress) => {
-        this.windowService?.send('speech:transcribe-file-progress', progress)
-      })
+      const result = await service.transcribeFile(
+        filePath,
+        (progress) => this.windowService?.send('speech:transcribe-file-progress', progress),
+        (segments) => this.windowService?.send('speech:transcribe-file-segments', segments)
+      )
       return result
     })
 
+    // 批量转录：加入队列后立即返回，进度通过 speech:batch-queue-updated 推送
+    ipcMain.handle('speech:transcribe-batch', async (_event, filePaths: string[]) => {
+      if (!Array.isArray(filePaths) || filePaths.length === 0) {
+        return { success: false, error: '未选择文件' }
+      }
+      logger.info('收到批量转录请求', { count: filePaths.length })
+      const queue = this.ensureBatchQueue()
+      queue.enqueue(filePaths)
+      return { success: true, snapshot: queue.getSnapshot() }
+    })
+
+    ipcMain.handle('speech:get-batch-queue', async () => {
+      return this.ensureBatchQueue().getSnapshot()
+    })
+
+    ipcMain.handle('speech:clear-batch-queue', async () => {
+      return this.ensureBatchQueue().clearFinished()
+    })
+
     // 导出转录结果
-    ipcMain.handle('speech:export-transcription', async (_event, options: { text: string; outputPath: string; fileName: string }) => {
+    ipcMain.handle('speech:export-transcription', async (_event, options: ExportOptions) => {
       logger.info('收到导出转录请求', { outputPath: options.outputPath, fileName: options.fileName })
       const service = this.ensureFileTranscriptionService()
       return service.exportTranscription(options)
@@ -441,11 +588,30 @@ export class AppController {
       this.fileTranscriptionService = new FileTranscriptionService({
         supportDir: this.supportDir,
         transcriberConfig: () => this.resolveTranscriberConfig(),
+        maxPoolSize: APP_CONSTANTS.BATCH_TRANSCRIPTION_CONCURRENCY,
+        resultCache: this.resultCache,
+        longWindowMs: () => (this.settings.transcription?.longFileWindowSec ?? 60) * 1000,
       })
     }
     return this.fileTranscriptionService
   }
 
+  /**
+   * 确保批量转录队列可用
+   */
+  private ensureBatchQueue(): BatchTranscriptionQueue {
+    if (!this.batchQueue) {
+      this.batchQueue = new BatchTranscriptionQueue({
+        cacheDir: path.join(this.supportDir, 'cache'),
+        service: () => this.ensureFileTranscriptionService(),
+        concurrency: APP_CONSTANTS.BATCH_TRANSCRIPTION_CONCURRENCY,
+        onUpdate: (snapshot) => this.windowService?.send('speech:batch-queue-updated', snapshot),
+      })
+      this.batchQueue.setLiveActive(this.activeRecording !== null)
+    }
+    return this.batchQueue
+  }
+
   /**
    * 广播状态到渲染进程
    */
@@ -516,6 +682,8 @@ export class AppController {
         throw new Error('窗口未初始化或已销毁，无法录音')
       }
       const mode = this.settings.transcription?.mode ?? 'offline'
+      // 实时听写优先：录音期间暂停派发批量转写
+      this.batchQueue?.setLiveActive(true)
       if (mode === 'apple') {
         this.activeRecording = {
           sessionId,
@@ -528,20 +696,28 @@ export class AppController {
           await this.startAppleDictation(sessionId)
         } catch {
           this.activeRecording = null
+          this.batchQueue?.setLiveActive(false)
         }
         return
       }
 
       const handle = await this.audioRecorder.start(sessionId, mainWindow)
       const timeout = undefined
+      // 录音期间即持有转写器，停止录音并转写完成后释放，期间不会被卸载
+      this.transcriberResidency.acquire()
+      const stream = this.openTranscriptionStream()
+      if (stream) {
+        handle.setChunkListener((chunk) => stream.push(chunk))
+      }
 
       this.cancelIdleTimer()
-      this.activeRecording = { sessionId, handle, timeout, recordingTimer, kind: 'native' }
+      this.activeRecording = { sessionId, handle, timeout, recordingTimer, kind: 'native', stream }
 
       const meta: TranscriptionMeta = { sessionId }
       this.stateMachine.setRecording(meta)
       logger.info('开始录音', { sessionId })
     } catch (error) {
+      this.batchQueue?.setLiveActive(false)
       this.handleError('启动录音失败', error)
     }
   }
@@ -666,7 +842,7 @@ export class AppController {
         modelId: polished ? `${modelId} + AI` : modelId,
         language: locale,
       }
-      await this.conversationStore.save(record)
+      this.persistRecord(record)
 
       const nextMeta: TranscriptionMeta = {
         sessionId,
@@ -680,7 +856,7 @@ export class AppController {
       this.scheduleIdle()
     } catch (error) {
       if (audioPath) {
-        await this.conversationStore.save({
+        this.persistRecord({
           id: sessionId,
           startedAt: Date.now(),
           finishedAt: Date.now(),
@@ -691,10 +867,22 @@ export class AppController {
       }
       this.handleError('Apple 听写失败', error, sessionId)
     } finally {
-      this.scheduleTranscriberUnload()
+      this.batchQueue?.setLiveActive(false)
     }
   }
 
+  /**
+   * 保存会话记录：写入预写日志后立即返回，不阻塞文本插入
+   */
+  private persistRecord(record: ConversationRecord): void {
+    this.conversationStore.enqueue(record).catch((error) => {
+      logger.error(error instanceof Error ? error : new Error(String(error)), {
+        context: 'persistRecord',
+        sessionId: record.id,
+      })
+    })
+  }
+
   private async ensureConversationFolder(sessionId: string): Promise<{ audioPath: string }> {
     const dir = path.join(this.conversationsDir, sessionId)
     await fsPromises.mkdir(dir, { recursive: true })
@@ -709,7 +897,7 @@ export class AppController {
   private async stopRecording(message?: string, triggerType: TriggerType = 'hold'): Promise<void> {
     if (!this.activeRecording) return
 
-    const { handle, sessionId, timeout, recordingTimer, kind, appleRequireOnDevice, appleLocale, appleAudioPath } = this.activeRecording
+    const { handle, sessionId, timeout, recordingTimer, kind, appleRequireOnDevice, appleLocale, appleAudioPath, stream } = this.activeRecording
     if (timeout) clearTimeout(timeout)
     if (recordingTimer) {
       metrics.endTimer(recordingTimer, 'recording', { sessionId })
@@ -731,8 +919,9 @@ export class AppController {
 
     try {
       recordingResult = await nativeHandle.stop()
-      const transcriber = this.ensureTranscriber()
-      const transcription = await transcriber.transcribe(recordingResult.audioPath)
+      const transcription = stream
+        ? await this.finishTranscriptionStream(stream, recordingResult)
+        : await this.transcribeRecording(recordingResult)
       metrics.endTimer(transcriptionTimer, 'transcription', {
         sessionId,
         durationMs: transcription.durationMs,
@@ -782,7 +971,7 @@ export class AppController {
         modelId: transcription.modelId,
         language: transcription.language,
       }
-      await this.conversationStore.save(record)
+      this.persistRecord(record)
 
       const nextMeta: TranscriptionMeta = {
         sessionId,
@@ -795,8 +984,9 @@ export class AppController {
       this.stateMachine.setReady(finalText, nextMeta)
       this.scheduleIdle()
     } catch (error) {
+      stream?.cancel()
       if (recordingResult) {
-        await this.conversationStore.save({
+        this.persistRecord({
           id: sessionId,
           startedAt: recordingResult.startedAt,
           finishedAt: Date.now(),
@@ -807,8 +997,70 @@ export class AppController {
       }
       this.handleError('转写失败', error, sessionId)
     } finally {
-      // 无论成功失败都刷新缓存计时器
-      this.scheduleTranscriberUnload()
+      // 无论成功失败都结束本次使用，之后模型可在内存紧张时卸载
+      this.transcriberResidency.release()
+      this.batchQueue?.setLiveActive(false)
+    }
+  }
+
+  /**
+   * 转写录音结果
+   * 支持 PCM 直传的转写器直接使用内存数据；否则等待归档 WAV 写完后按文件转写
+   */
+  private async transcribeRecording(recording: RecordingResult) {
+    const transcriber = this.ensureTranscriber()
+    if (transcriber.transcribePcm) {
+      return transcriber.transcribePcm(recording.pcm)
+    }
+    await recording.archived
+    return transcriber.transcribe(recording.audioPath)
+  }
+
+  /**
+   * 为本次录音开启流式转写会话
+   * 离线模式需开启边说边识别，同时会提前拉起 worker，录音期间即可完成模型加载；
+   * 在线模式需开启边录边传，录音期间即开始上传
+   */
+  private openTranscriptionStream(): TranscriptionStream | null {
+    const transcription = this.settings.transcription
+    const mode = transcription?.mode ?? 'offline'
+    const enabled = mode === 'offline'
+      ? transcription?.streamingDecode !== false
+      : mode === 'online' && transcription?.online.streamingUpload !== false
+    if (!enabled) {
+      return null
+    }
+    try {
+      const transcriber = this.ensureTranscriber()
+      return transcriber.startStream?.({
+        sampleRate: this.recorderConfig.sampleRate,
+        channels: this.recorderConfig.channels,
+        redecodeBoundary: this.settings.transcription?.streamingRedecodeBoundary === true,
+      }) ?? null
+    } catch (error) {
+      logger.warn('开启流式转写失败，将在录音结束后整体转写', {
+        error: error instanceof Error ? error.message : String(error),
+      })
+      return null
+    }
+  }
+
+  /**
+   * 结束流式转写；只有转写器标明可以整段重试的失败（服务端不接受分块上传、请求未得到响应、
+   * 离线会话中断）才回退到整段转写，超时、鉴权、限流等错误直接抛出，避免重复等待与重复上传
+   */
+  private async finishTranscriptionStream(stream: TranscriptionStream, recording: RecordingResult) {
+    try {
+      return await stream.finish()
+    } catch (error) {
+      if (!(error instanceof StreamFallbackError)) {
+        throw error
+      }
+      logger.warn('流式转写失败，回退到整段转写', {
+        sessionId: recording.sessionId,
+        error: error.message,
+      })
+      return this.transcribeRecording(recording)
     }
   }
 
@@ -880,6 +1132,7 @@ export class AppController {
     }
 
     this.testInProgress = true
+    this.transcriberResidency.acquire()
     const sessionId = crypto.randomUUID()
     const startTime = Date.now()
 
@@ -935,8 +1188,8 @@ export class AppController {
       return { success: false, error: detail }
     } finally {
       this.testInProgress = false
-      // 无论成功失败都刷新缓存计时器
-      this.scheduleTranscriberUnload()
+      // 无论成功失败都结束本次使用，之后模型可在内存紧张时卸载
+      this.transcriberResidency.release()
     }
   }
 
@@ -1092,78 +1345,67 @@ export class AppController {
         responseFormat: online?.responseFormat,
         temperature: online?.temperature,
         timeoutMs: online?.timeoutMs,
+        uploadFormat: online?.uploadFormat,
+        trimSilence: online?.trimSilence,
+        streamingUpload: online?.streamingUpload,
       }
       return config
     }
-    return this.senseVoiceConfig
+    return this.autotuner.apply(this.senseVoiceConfig)
   }
 
   /**
-   * 确保转写器可用（懒加载）
-   * 如果已销毁或未初始化，则重新创建
-   * 同时取消任何待执行的卸载计时器，防止转写过程中被卸载
+   * 延迟触发自动调优，录音或测试进行中时顺延
    */
-  private ensureTranscriber(): Transcriber {
-    // 关键：取消待执行的卸载计时器，防止转写过程中被卸载
-    this.cancelTranscriberUnload()
-
-    if (!this.transcriber) {
-      logger.info('创建转写器实例...')
-      this.transcriber = createTranscriber(this.resolveTranscriberConfig(), { supportDir: this.supportDir })
-    }
-    return this.transcriber
+  private scheduleAutotune(delayMs: number = APP_CONSTANTS.AUTOTUNE_DELAY_MS): void {
+    const timer = setTimeout(() => {
+      if ((this.settings.transcription?.mode ?? 'offline') !== 'offline' || !this.autotuner.needsTuning()) return
+      if (this.activeRecording || this.testInProgress) {
+        this.scheduleAutotune()
+        return
+      }
+      void this.runAutotune()
+    }, delayMs)
+    timer.unref()
   }
 
   /**
-   * 调度转写器卸载
-   * 根据 cacheTTLMinutes 设置延迟销毁计时器
+   * 运行自动调优；结果改变配置时卸载当前模型，下次使用按新配置加载
    */
-  private scheduleTranscriberUnload(): void {
-    this.cancelTranscriberUnload()
-
-    if (this.settings.transcription?.mode === 'online') {
-      return
+  private async runAutotune(): Promise<AutotuneStatus> {
+    const before = JSON.stringify(this.resolveTranscriberConfig())
+    const status = await this.autotuner.run()
+    const changed = JSON.stringify(this.resolveTranscriberConfig()) !== before
+    if (changed && !this.activeRecording && !this.testInProgress) {
+      this.transcriberResidency.unload('config-changed')
     }
-
-    // 验证从配置加载的 TTL 值，防止损坏的 settings.json 导致 NaN
-    const validValues = [0, 5, 15, 30, 60]
-    const rawTTL = this.settings.cacheTTLMinutes
-    const ttlMinutes = Number.isFinite(rawTTL) && validValues.includes(rawTTL) ? rawTTL : 30
-
-    if (ttlMinutes <= 0) {
-      // 0 或负数表示永不卸载
-      logger.debug('模型缓存设置为永不卸载')
-      return
-    }
-
-    const ttlMs = ttlMinutes * 60 * 1000
-    logger.info(`模型将在 ${ttlMinutes} 分钟后卸载`)
-
-    this.cacheTimer = setTimeout(() => {
-      this.unloadTranscriber()
-    }, ttlMs)
+    return status
   }
 
   /**
-   * 取消转写器卸载计时器
+   * 确保转写器可用（懒加载）
+   * 只在已 acquire() 的录音或测试转写期间调用；如果已卸载则重新创建
    */
-  private cancelTranscriberUnload(): void {
-    if (this.cacheTimer) {
-      clearTimeout(this.cacheTimer)
-      this.cacheTimer = null
-    }
+  private ensureTranscriber(): Transcriber {
+    return this.transcriberResidency.get()
   }
 
   /**
-   * 卸载转写器（终止 Worker 进程）
+   * 计算模型驻留策略
+   * cacheTTLMinutes 为内存偏紧时的最短闲置时间，0 表示常驻（仅严重内存压力或超出上限时卸载）
    */
-  private unloadTranscriber(): void {
-    if (!this.transcriber) return
+  private resolveResidencyPolicy(): ResidencyPolicy {
+    // 验证从配置加载的 TTL 值，防止损坏的 settings.json 导致 NaN
+    const validValues = [0, 5, 15, 30, 60]
+    const rawTTL = this.settings.cacheTTLMinutes
+    const ttlMinutes = Number.isFinite(rawTTL) && validValues.includes(rawTTL) ? rawTTL : 30
+    const capMB = this.settings.modelMemoryCapMB
 
-    logger.info('卸载模型缓存，终止 Worker 进程')
-    this.transcriber.destroy?.()
-    this.transcriber = null
-    this.cacheTimer = null
+    return {
+      managed: (this.settings.transcription?.mode ?? 'offline') === 'offline',
+      idleUnloadMs: ttlMinutes > 0 ? ttlMinutes * 60 * 1000 : null,
+      rssCapBytes: Number.isFinite(capMB) && capMB > 0 ? capMB * 1024 * 1024 : null,
+    }
   }
 
   /**
@@ -1185,6 +1427,7 @@ export class AppController {
     const started = this.keyboardHookService.start({
       onRecordingStart: () => this.startRecording(),
       onRecordingStop: (triggerType) => this.stopRecording('松开按键，停止录音', triggerType),
+      onShortcutPrepare: () => this.transcriberResidency.prewarm('shortcut-modifier'),
     })
 
     if (started) {
@@ -1226,10 +1469,12 @@ export class AppController {
    */
   destroy(): void {
     this.cancelIdleTimer()
-    this.cancelTranscriberUnload()  // 清理缓存计时器
+    this.historyRetention.stop()
     if (this.activeRecording) {
       if (this.activeRecording.kind === 'native') {
-        (this.activeRecording.handle as NativeRecordingHandle).forceStop()
+        const nativeHandle = this.activeRecording.handle as NativeRecordingHandle
+        this.activeRecording.stream?.cancel()
+        nativeHandle.forceStop()
       } else {
         void (this.activeRecording.handle as AppleDictationHandle).stop().catch(() => {})
       }
@@ -1242,11 +1487,13 @@ export class AppController {
     updateService.destroy()
     this.appleDictationService.destroy()
     // 终止 transcriber worker 进程
-    this.transcriber?.destroy?.()
-    this.transcriber = null
+    this.transcriberResidency.destroy()
     // 终止文件转录服务
+    this.batchQueue = null
     this.fileTranscriptionService?.destroy()
     this.fileTranscriptionService = null
+    this.resultCache.flushSync()
+    this.conversationStore.flushSync()
     this.initialized = false
   }
 }
@@ -5,10 +5,11 @@
  */
 
 import { ipcMain } from 'electron'
-import type { ShortcutConfig, SpeechTideState, AppleDictationStatus } from '../../shared/app-state'
-import type { ConversationRecord } from '../../shared/conversation'
+import type { ShortcutConfig, SpeechTideState, AppleDictationStatus, ModelResidencyStats, WorkerQueueStats, AutotuneStatus, ResultCacheStats, RetentionStatus } from '../../shared/app-state'
+import type { ConversationRecord, HistorySearchResult, UsageAnalytics, UsageAnalyticsOptions } from '../../shared/conversation'
 import { loadAppSettings } from '../config'
 import type { AppSettings } from '../config'
+import type { AggregatedStats } from '../utils/metrics'
 
 export interface IPCHandlers {
   getState: () => SpeechTideState
@@ -42,8 +43,24 @@ export interface IPCHandlers {
   clearHistory: (options: { maxAgeDays?: number }) => Promise<{ success: boolean; deletedCount?: number; error?: string }>
   // 历史记录列表相关
   getHistoryList: (options?: { limit?: number; offset?: number }) => Promise<{ records: ConversationRecord[]; error?: string }>
+  searchHistory: (options: { query: string; limit?: number; offset?: number }) => Promise<HistorySearchResult>
+  getUsageAnalytics: (options?: UsageAnalyticsOptions) => Promise<UsageAnalytics>
   deleteHistoryItem: (sessionId: string) => Promise<{ success: boolean; error?: string }>
   playHistoryAudio: (sessionId: string) => Promise<{ success: boolean; error?: string }>
+  exportHistoryAudio: (sessionId: string) => Promise<{ success: boolean; canceled?: boolean; filePath?: string; error?: string }>
+  // 性能统计
+  getPerformanceStats: () => Promise<{
+    residency: ModelResidencyStats
+    operations: Record<string, AggregatedStats>
+    workerQueues: { dictation: WorkerQueueStats | null; files: WorkerQueueStats[] }
+    resultCache: ResultCacheStats
+  }>
+  // 识别器自动调优
+  getAutotuneStatus: () => AutotuneStatus
+  runAutotune: () => Promise<AutotuneStatus>
+  // 历史记录保留策略
+  getRetentionStatus: () => RetentionStatus
+  runRetention: () => Promise<RetentionStatus>
 }
 
 /**
@@ -141,6 +158,16 @@ export class IPCListeners {
       return this.handlers?.getHistoryList(options)
     })
 
+    // 全文检索历史记录
+    ipcMain.handle('speech:search-history', async (_event, options: { query: string; limit?: number; offset?: number }) => {
+      return this.handlers?.searchHistory(options)
+    })
+
+    // 历史记录使用统计
+    ipcMain.handle('speech:get-usage-analytics', async (_event, options?: UsageAnalyticsOptions) => {
+      return this.handlers?.getUsageAnalytics(options)
+    })
+
     // 删除单条历史记录
     ipcMain.handle('speech:delete-history-item', async (_event, sessionId: string) => {
       return this.handlers?.deleteHistoryItem(sessionId)
@@ -151,6 +178,36 @@ export class IPCListeners {
       return this.handlers?.playHistoryAudio(sessionId)
     })
 
+    // 导出历史录音为 WAV
+    ipcMain.handle('speech:export-history-audio', async (_event, sessionId: string) => {
+      return this.handlers?.exportHistoryAudio(sessionId)
+    })
+
+    // 获取性能统计（模型驻留、冷启动等）
+    ipcMain.handle('speech:get-performance-stats', () => {
+      return this.handlers?.getPerformanceStats()
+    })
+
+    // 获取自动调优结果
+    ipcMain.handle('speech:get-autotune-status', () => {
+      return this.handlers?.getAutotuneStatus()
+    })
+
+    // 重新运行自动调优
+    ipcMain.handle('speech:run-autotune', () => {
+      return this.handlers?.runAutotune()
+    })
+
+    // 获取历史记录清理状态
+    ipcMain.handle('speech:get-retention-status', () => {
+      return this.handlers?.getRetentionStatus()
+    })
+
+    // 立即按保留策略清理历史记录
+    ipcMain.handle('speech:run-retention', () => {
+      return this.handlers?.runRetention()
+    })
+
     this.registered = true
     console.log('[IPCListeners] ✓ IPC 处理器注册完成')
   }
@@ -176,8 +233,16 @@ export class IPCListeners {
     ipcMain.removeHandler('speech:get-history-stats')
     ipcMain.removeHandler('speech:clear-history')
     ipcMain.removeHandler('speech:get-history-list')
+    ipcMain.removeHandler('speech:search-history')
+    ipcMain.removeHandler('speech:get-usage-analytics')
     ipcMain.removeHandler('speech:delete-history-item')
     ipcMain.removeHandler('speech:play-history-audio')
+    ipcMain.removeHandler('speech:export-history-audio')
+    ipcMain.removeHandler('speech:get-performance-stats')
+    ipcMain.removeHandler('speech:get-autotune-status')
+    ipcMain.removeHandler('speech:run-autotune')
+    ipcMain.removeHandler('speech:get-retention-status')
+    ipcMain.removeHandler('speech:run-retention')
 
     this.handlers = null
     this.registered = false
@@ -1,6 +1,9 @@
 import { contextBridge, ipcRenderer, IpcRendererEvent } from 'electron'
 import type { SpeechTideState } from '../shared/app-state'
 import type { ShortcutConfig } from '../shared/app-state'
+import type { AutotuneStatus, BatchQueueSnapshot, RetentionStatus, TranscriptSegment } from '../shared/app-state'
+import type { UsageAnalyticsOptions } from '../shared/conversation'
+import { RECORDER_PORT_MESSAGE } from '../shared/recorder-frame'
 
 console.log('[Preload] 脚本开始执行')
 
@@ -32,8 +35,40 @@ const speechAPI = {
       ipcRenderer.off('speech:transcribe-file-progress', listener)
     }
   },
+  /** 监听长音频转录的增量分段 */
+  onTranscribeSegments(callback: (segments: TranscriptSegment[]) => void) {
+    const listener = (_event: IpcRendererEvent, segments: TranscriptSegment[]) => {
+      callback(segments)
+    }
+    ipcRenderer.on('speech:transcribe-file-segments', listener)
+    return () => {
+      ipcRenderer.off('speech:transcribe-file-segments', listener)
+    }
+  },
+  /** 批量转录多个音频文件（加入后台队列） */
+  transcribeBatch(filePaths: string[]) {
+    return ipcRenderer.invoke('speech:transcribe-batch', filePaths)
+  },
+  /** 获取批量转录队列 */
+  getBatchQueue() {
+    return ipcRenderer.invoke('speech:get-batch-queue')
+  },
+  /** 清除已完成的批量转录条目 */
+  clearBatchQueue() {
+    return ipcRenderer.invoke('speech:clear-batch-queue')
+  },
+  /** 监听批量转录队列变化 */
+  onBatchQueueUpdate(callback: (snapshot: BatchQueueSnapshot) => void) {
+    const listener = (_event: IpcRendererEvent, snapshot: BatchQueueSnapshot) => {
+      callback(snapshot)
+    }
+    ipcRenderer.on('speech:batch-queue-updated', listener)
+    return () => {
+      ipcRenderer.off('speech:batch-queue-updated', listener)
+    }
+  },
   /** 导出转录结果到文件 */
-  exportTranscription(options: { text: string; outputPath: string; fileName: string }) {
+  exportTranscription(options: { text: string; outputPath: string; fileName: string; segments?: TranscriptSegment[] }) {
     return ipcRenderer.invoke('speech:export-transcription', options)
   },
   /** 选择目录 */
@@ -100,6 +135,14 @@ const speechAPI = {
   getHistoryList(options?: { limit?: number; offset?: number }) {
     return ipcRenderer.invoke('speech:get-history-list', options || {})
   },
+  /** 全文检索历史记录 */
+  searchHistory(options: { query: string; limit?: number; offset?: number }) {
+    return ipcRenderer.invoke('speech:search-history', options)
+  },
+  /** 历史记录使用统计（每日次数、各模型耗时与语速、失败率） */
+  getUsageAnalytics(options?: UsageAnalyticsOptions) {
+    return ipcRenderer.invoke('speech:get-usage-analytics', options || {})
+  },
   /** 删除单条历史记录 */
   deleteHistoryItem(sessionId: string) {
     return ipcRenderer.invoke('speech:delete-history-item', sessionId)
@@ -108,6 +151,50 @@ const speechAPI = {
   playHistoryAudio(sessionId: string) {
     return ipcRenderer.invoke('speech:play-history-audio', sessionId)
   },
+  /** 导出历史录音为 WAV */
+  exportHistoryAudio(sessionId: string) {
+    return ipcRenderer.invoke('speech:export-history-audio', sessionId)
+  },
+  /** 获取性能统计（模型驻留、冷启动耗时等） */
+  getPerformanceStats() {
+    return ipcRenderer.invoke('speech:get-performance-stats')
+  },
+  /** 获取识别器自动调优结果 */
+  getAutotuneStatus() {
+    return ipcRenderer.invoke('speech:get-autotune-status')
+  },
+  /** 重新运行识别器自动调优 */
+  runAutotune() {
+    return ipcRenderer.invoke('speech:run-autotune')
+  },
+  /** 监听自动调优进度 */
+  onAutotuneUpdate(callback: (status: AutotuneStatus) => void) {
+    const listener = (_event: IpcRendererEvent, status: AutotuneStatus) => {
+      callback(status)
+    }
+    ipcRenderer.on('speech:autotune-updated', listener)
+    return () => {
+      ipcRenderer.off('speech:autotune-updated', listener)
+    }
+  },
+  /** 获取历史记录清理状态 */
+  getRetentionStatus() {
+    return ipcRenderer.invoke('speech:get-retention-status')
+  },
+  /** 立即按保留策略清理历史记录 */
+  runRetention() {
+    return ipcRenderer.invoke('speech:run-retention')
+  },
+  /** 监听历史记录清理进度 */
+  onRetentionUpdate(callback: (status: RetentionStatus) => void) {
+    const listener = (_event: IpcRendererEvent, status: RetentionStatus) => {
+      callback(status)
+    }
+    ipcRenderer.on('speech:retention-updated', listener)
+    return () => {
+      ipcRenderer.off('speech:retention-updated', listener)
+    }
+  },
   /** 监听音频播放事件 */
   onPlayAudio(callback: (audioPath: string) => void) {
     const listener = (_event: IpcRendererEvent, audioPath: string) => {
@@ -122,6 +209,12 @@ const speechAPI = {
 
 // Onboarding API
 // Native Recorder API - 用于渲染进程录音
+// 每次录音主进程随开始信号送来一个 MessagePort；MessagePort 无法经过 contextBridge，
+// 转发到页面的 window 上，由录音 Hook 直接在端口上发送音频帧
+ipcRenderer.on('native-recorder:start', (event) => {
+  window.postMessage({ type: RECORDER_PORT_MESSAGE }, '*', event.ports)
+})
+
 const nativeRecorderAPI = {
   onStart(callback: (config: unknown) => void) {
     const listener = (_event: IpcRendererEvent, config: unknown) => callback(config)
@@ -133,12 +226,6 @@ const nativeRecorderAPI = {
     ipcRenderer.on('native-recorder:stop', listener)
     return () => ipcRenderer.off('native-recorder:stop', listener)
   },
-  sendChunk(data: ArrayBuffer) {
-    ipcRenderer.send('native-recorder:chunk', data)
-  },
-  sendComplete(data: ArrayBuffer | null = null) {
-    ipcRenderer.send('native-recorder:complete', data)
-  },
 }
 
 // Update API - 自动更新
@@ -0,0 +1,204 @@
+/**
+ * 批量文件转写队列
+ *
+ * 多个文件按批次提交给 FileTranscriptionService，批次内一次解码；
+ * 同时运行的批次数受并发上限约束，实时听写期间暂停派发新批次。
+ * 队列状态持久化到缓存目录，应用重启后未完成的文件会继续转写。
+ */
+
+import fs from 'node:fs'
+import fsPromises from 'node:fs/promises'
+import path from 'node:path'
+import { randomUUID } from 'node:crypto'
+import type { BatchQueueItem, BatchQueueSnapshot } from '../../shared/app-state'
+import type { FileTranscriptionService } from './file-transcription-service'
+import { createModuleLogger } from '../utils/logger'
+
+const logger = createModuleLogger('batch-queue')
+
+/** 每批最多包含的文件数 */
+const DEFAULT_BATCH_SIZE = 4
+const QUEUE_FILE = 'batch-queue.json'
+
+export interface BatchTranscriptionQueueOptions {
+  /** 持久化目录 */
+  cacheDir: string
+  service: () => FileTranscriptionService
+  /** 同时运行的批次数 */
+  concurrency?: number
+  batchSize?: number
+  /** 队列变化时回调（用于推送进度） */
+  onUpdate?: (snapshot: BatchQueueSnapshot) => void
+}
+
+export class BatchTranscriptionQueue {
+  private items: BatchQueueItem[] = []
+  private readonly queuePath: string
+  private readonly concurrency: number
+  private readonly batchSize: number
+  private running = 0
+  private liveActive = false
+  private persistChain: Promise<void> = Promise.resolve()
+
+  constructor(private readonly options: BatchTranscriptionQueueOptions) {
+    this.queuePath = path.join(options.cacheDir, QUEUE_FILE)
+    this.concurrency = Math.max(1, options.concurrency ?? 1)
+    this.batchSize = Math.max(1, options.batchSize ?? DEFAULT_BATCH_SIZE)
+    this.restore()
+  }
+
+  /**
+   * 加入待转写文件，返回新加入的条目
+   */
+  enqueue(filePaths: string[]): BatchQueueItem[] {
+    const now = Date.now()
+    const added = filePaths.map<BatchQueueItem>((filePath) => ({
+      id: randomUUID(),
+      filePath,
+      fileName: path.basename(filePath),
+      status: 'pending',
+      addedAt: now,
+    }))
+    this.items.push(...added)
+    logger.info('加入批量转写队列', { count: added.length, pending: this.countByStatus('pending') })
+    this.changed()
+    this.pump()
+    return added
+  }
+
+  /**
+   * 实时听写开始/结束：听写期间不派发新批次，已在解码的批次继续完成
+   */
+  setLiveActive(active: boolean): void {
+    if (this.liveActive === active) return
+    this.liveActive = active
+    if (!active) {
+      this.pump()
+    }
+  }
+
+  /**
+   * 继续处理重启前遗留的文件
+   */
+  resume(): void {
+    if (this.countByStatus('pending') > 0) {
+      logger.info('恢复未完成的批量转写', { pending: this.countByStatus('pending') })
+      this.pump()
+    }
+  }
+
+  /**
+   * 移除已完成和失败的条目
+   */
+  clearFinished(): BatchQueueSnapshot {
+    this.items = this.items.filter((item) => item.status === 'pending' || item.status === 'running')
+    this.changed()
+    return this.getSnapshot()
+  }
+
+  getSnapshot(): BatchQueueSnapshot {
+    return {
+      items: this.items.map((item) => ({ ...item })),
+      completed: this.items.filter((item) => item.status === 'done' || item.status === 'error').length,
+      total: this.items.length,
+      paused: this.liveActive,
+    }
+  }
+
+  /**
+   * 等待挂起的持久化写入完成
+   */
+  flush(): Promise<void> {
+    return this.persistChain
+  }
+
+  /**
+   * 在并发上限内派发批次
+   */
+  private pump(): void {
+    while (!this.liveActive && this.running < this.concurrency) {
+      const batch = this.items.filter((item) => item.status === 'pending').slice(0, this.batchSize)
+      if (batch.length === 0) return
+      for (const item of batch) {
+        item.status = 'running'
+      }
+      this.running++
+      this.changed()
+      void this.runBatch(batch).finally(() => {
+        this.running--
+        this.pump()
+      })
+    }
+  }
+
+  private async runBatch(batch: BatchQueueItem[]): Promise<void> {
+    try {
+      const results = await this.options.service().transcribeBatch(batch.map((item) => item.filePath))
+      const finishedAt = Date.now()
+      batch.forEach((item, index) => {
+        const outcome = results[index]
+        if (outcome?.result) {
+          item.status = 'done'
+          item.text = outcome.result.text
+          item.durationMs = outcome.result.durationMs
+        } else {
+          item.status = 'error'
+          item.error = outcome?.error ?? '转写失败'
+        }
+        item.finishedAt = finishedAt
+      })
+    } catch (error) {
+      const message = error instanceof Error ? error.message : String(error)
+      logger.error(error instanceof Error ? error : new Error(message), { context: 'runBatch', files: batch.length })
+      for (const item of batch) {
+        item.status = 'error'
+        item.error = `转写失败: ${message}`
+        item.finishedAt = Date.now()
+      }
+    }
+    this.changed()
+  }
+
+  private countByStatus(status: BatchQueueItem['status']): number {
+    return this.items.filter((item) => item.status === status).length
+  }
+
+  private changed(): void {
+    this.persist()
+    this.options.onUpdate?.(this.getSnapshot())
+  }
+
+  /**
+   * 串行写入队列文件（先写临时文件再重命名，避免中途退出留下半截 JSON）
+   */
+  private persist(): void {
+    const data = JSON.stringify({ items: this.items })
+    this.persistChain = this.persistChain
+      .then(async () => {
+        await fsPromises.mkdir(path.dirname(this.queuePath), { recursive: true })
+        const tempPath = `${this.queuePath}.tmp`
+        await fsPromises.writeFile(tempPath, data, 'utf-8')
+        await fsPromises.rename(tempPath, this.queuePath)
+      })
+      .catch((error) => {
+        logger.warn('保存批量转写队列失败', { error: String(error) })
+      })
+  }
+
+  private restore(): void {
+    try {
+      if (!fs.existsSync(this.queuePath)) return
+      const raw = JSON.parse(fs.readFileSync(this.queuePath, 'utf-8')) as { items?: BatchQueueItem[] }
+      this.items = Array.isArray(raw.items) ? raw.items : []
+      // 上次退出时正在解码的文件重新排队
+      for (const item of this.items) {
+        if (item.status === 'running') {
+          item.status = 'pending'
+        }
+      }
+    } catch (error) {
+      logger.warn('读取批量转写队列失败，忽略旧队列', { error: String(error) })
+      this.items = []
+    }
+  }
+}
@@ -7,15 +7,27 @@
 import fs from 'node:fs'
 import path from 'node:path'
 import os from 'node:os'
-import { createTranscriber, type Transcriber, type TranscriberConfig } from '../transcriber'
+import { createTranscriber, type BatchTranscriptionItem, type Transcriber, type TranscriberConfig, type TranscriptionResult } from '../transcriber'
+import type { TranscriptSegment, WorkerQueueStats } from '../../shared/app-state'
 import { createModuleLogger } from '../utils/logger'
+import { readWavHeader } from '../utils/wav-parser'
+import { fingerprintTranscriberConfig, withResultCache, type TranscriptionResultCache } from './transcription-result-cache'
 
 const logger = createModuleLogger('file-transcription-service')
 
+/** 最后一个文件转写完成后，闲置多久释放识别器 */
+const POOL_IDLE_RELEASE_MS = 2 * 60 * 1000
+/** 超过该时长的音频按窗口分段转写，边解码边输出 */
+const LONG_AUDIO_MIN_MS = 5 * 60 * 1000
+/** 未配置时的长音频读取窗口 */
+const DEFAULT_LONG_WINDOW_MS = 60 * 1000
+
 export interface FileTranscriptionResult {
   success: boolean
   text?: string
   durationMs?: number
+  /** 长音频分段结果 */
+  segments?: TranscriptSegment[]
   error?: string
 }
 
@@ -23,6 +35,8 @@ export interface ExportOptions {
   text: string
   outputPath: string
   fileName: string
+  /** 提供时按分段逐行导出，每行带起始时间 */
+  segments?: TranscriptSegment[]
 }
 
 export interface ExportResult {
@@ -34,16 +48,43 @@ export interface ExportResult {
 export interface FileTranscriptionServiceOptions {
   supportDir: string
   transcriberConfig: () => TranscriberConfig
+  /** 同一配置下最多并行的识别器数量，默认 1 */
+  maxPoolSize?: number
+  /** 转写结果缓存，重复文件不再解码 */
+  resultCache?: TranscriptionResultCache
+  /** 长音频每次读取的窗口（毫秒） */
+  longWindowMs?: () => number
+}
+
+/** 识别器池中的一个实例 */
+interface PooledTranscriber {
+  transcriber: Transcriber
+  inFlight: number
+}
+
+/** 按配置指纹缓存的识别器池 */
+interface TranscriberPool {
+  fingerprint: string
+  members: PooledTranscriber[]
+  /** 配置已变更，等待进行中的转写完成后销毁 */
+  retired: boolean
 }
 
 export class FileTranscriptionService {
   private readonly supportDir: string
   private readonly getTranscriberConfig: () => TranscriberConfig
-  private transcriber: Transcriber | null = null
+  private readonly maxPoolSize: number
+  private readonly resultCache: TranscriptionResultCache | null
+  private readonly getLongWindowMs: () => number
+  private pool: TranscriberPool | null = null
+  private idleTimer: NodeJS.Timeout | null = null
 
   constructor(options: FileTranscriptionServiceOptions) {
     this.supportDir = options.supportDir
     this.getTranscriberConfig = options.transcriberConfig
+    this.maxPoolSize = Math.max(1, options.maxPoolSize ?? 1)
+    this.resultCache = options.resultCache ?? null
+    this.getLongWindowMs = options.longWindowMs ?? (() => DEFAULT_LONG_WINDOW_MS)
   }
 
   /**
@@ -51,38 +92,39 @@ export class FileTranscriptionService {
    */
   async transcribeFile(
     filePath: string,
-    onProgress?: (progress: number) => void
+    onProgress?: (progress: number) => void,
+    onSegments?: (segments: TranscriptSegment[]) => void
   ): Promise<FileTranscriptionResult> {
     logger.info('开始转写文件', { filePath })
 
-    // 验证文件存在
-    if (!fs.existsSync(filePath)) {
-      logger.warn('文件不存在', { filePath })
-      return { success: false, error: '文件不存在' }
-    }
-
-    // 验证文件格式
-    const ext = path.extname(filePath).toLowerCase()
-    if (ext !== '.wav') {
-      logger.warn('不支持的文件格式', { filePath, ext })
-      return { success: false, error: `不支持的文件格式: ${ext}，仅支持 .wav 文件` }
+    const invalid = validateAudioFile(filePath)
+    if (invalid) {
+      return { success: false, error: invalid }
     }
 
     // 报告开始进度
     onProgress?.(0)
 
+    // 每次转录都按最新配置的指纹取识别器：配置未变时复用已加载的模型，
+    // 切换离线/在线模式或更换模型时才重建
+    const { pool, member } = this.acquireTranscriber()
     try {
-      // 每次转录时重新获取配置并创建转写器，确保使用最新设置
-      // 这样可以正确响应用户在设置中切换离线/在线模式
-      this.destroyTranscriber()
-      const transcriber = this.ensureTranscriber()
-
-      // 报告转写中进度
-      onProgress?.(50)
-
-      // 执行转写
       const startTime = Date.now()
-      const result = await transcriber.transcribe(filePath)
+      let result: TranscriptionResult
+      if (await this.shouldTranscribeLong(member.transcriber, filePath)) {
+        // 长音频：按实际处理到的位置报告进度，分段解码后立即推送
+        result = await member.transcriber.transcribeLong!(filePath, {
+          windowMs: this.getLongWindowMs(),
+          onProgress: ({ segments, processedMs, totalMs }) => {
+            if (segments.length > 0) onSegments?.(segments)
+            if (totalMs > 0) onProgress?.(Math.min(99, Math.round((processedMs / totalMs) * 100)))
+          },
+        })
+      } else {
+        // 报告转写中进度
+        onProgress?.(50)
+        result = await member.transcriber.transcribe(filePath, { priority: 'background' })
+      }
       const durationMs = Date.now() - startTime
 
       // 报告完成进度
@@ -91,6 +133,7 @@ export class FileTranscriptionService {
       logger.info('转写完成', {
         filePath,
         textLength: result.text.length,
+        segments: result.segments?.length,
         durationMs,
         modelId: result.modelId,
       })
@@ -99,6 +142,7 @@ export class FileTranscriptionService {
         success: true,
         text: result.text,
         durationMs,
+        segments: result.segments,
       }
     } catch (error) {
       const errorMessage = error instanceof Error ? error.message : String(error)
@@ -107,7 +151,82 @@ export class FileTranscriptionService {
         filePath,
       })
       return { success: false, error: `转写失败: ${errorMessage}` }
+    } finally {
+      this.releaseTranscriber(pool, member)
+    }
+  }
+
+  /**
+   * 批量转写多个 WAV 文件
+   * 同一批文件共享一个识别器，支持批量解码的转写器一次提交全部文件
+   */
+  async transcribeBatch(filePaths: string[]): Promise<BatchTranscriptionItem[]> {
+    const results = new Map<string, BatchTranscriptionItem>()
+    const valid: string[] = []
+    for (const filePath of filePaths) {
+      const invalid = validateAudioFile(filePath)
+      if (invalid) {
+        results.set(filePath, { filePath, error: invalid })
+      } else {
+        valid.push(filePath)
+      }
+    }
+
+    if (valid.length > 0) {
+      const { pool, member } = this.acquireTranscriber()
+      const startTime = Date.now()
+      try {
+        const transcriber = member.transcriber
+        // 长音频不进入批量解码，逐个分窗转写，避免整段载入内存
+        const short: string[] = []
+        for (const filePath of valid) {
+          if (await this.shouldTranscribeLong(transcriber, filePath)) {
+            try {
+              results.set(filePath, { filePath, result: await transcriber.transcribeLong!(filePath, { windowMs: this.getLongWindowMs() }) })
+            } catch (error) {
+              results.set(filePath, { filePath, error: error instanceof Error ? error.message : String(error) })
+            }
+          } else {
+            short.push(filePath)
+          }
+        }
+        if (short.length > 0 && transcriber.transcribeBatch) {
+          for (const item of await transcriber.transcribeBatch(short, { priority: 'background' })) {
+            results.set(item.filePath, item)
+          }
+        } else {
+          for (const filePath of short) {
+            try {
+              results.set(filePath, { filePath, result: await transcriber.transcribe(filePath, { priority: 'background' }) })
+            } catch (error) {
+              results.set(filePath, { filePath, error: error instanceof Error ? error.message : String(error) })
+            }
+          }
+        }
+        logger.info('批量转写完成', { files: valid.length, elapsedMs: Date.now() - startTime })
+      } catch (error) {
+        const errorMessage = error instanceof Error ? error.message : String(error)
+        logger.error(error instanceof Error ? error : new Error(errorMessage), { context: 'transcribeBatch', files: valid.length })
+        for (const filePath of valid) {
+          if (!results.has(filePath)) {
+            results.set(filePath, { filePath, error: `转写失败: ${errorMessage}` })
+          }
+        }
+      } finally {
+        this.releaseTranscriber(pool, member)
+      }
     }
+
+    return filePaths.map((filePath) => results.get(filePath) as BatchTranscriptionItem)
+  }
+
+  /**
+   * 各识别器的调度队列统计
+   */
+  async getQueueStats(): Promise<WorkerQueueStats[]> {
+    const members = this.pool?.members ?? []
+    const stats = await Promise.all(members.map((member) => member.transcriber.getQueueStats?.() ?? Promise.resolve(null)))
+    return stats.filter((entry): entry is WorkerQueueStats => entry !== null)
   }
 
   /**
@@ -145,7 +264,8 @@ export class FileTranscriptionService {
       const fullPath = path.join(expandedPath, finalFileName)
 
       // 写入文件
-      fs.writeFileSync(fullPath, text, 'utf-8')
+      const content = options.segments && options.segments.length > 0 ? formatSegments(options.segments) : text
+      fs.writeFileSync(fullPath, content, 'utf-8')
 
       logger.info('导出完成', { fullPath })
 
@@ -175,30 +295,147 @@ export class FileTranscriptionService {
    * 销毁服务，释放资源
    */
   destroy(): void {
-    this.destroyTranscriber()
+    this.cancelIdleRelease()
+    if (this.pool) {
+      this.destroyPool(this.pool)
+      this.pool = null
+    }
   }
 
   /**
-   * 销毁转写器
+   * 转写器支持分窗且音频足够长时使用长音频模式；只读取文件头判断时长
    */
-  private destroyTranscriber(): void {
-    if (this.transcriber) {
-      logger.info('销毁转写器')
-      this.transcriber.destroy?.()
-      this.transcriber = null
+  private async shouldTranscribeLong(transcriber: Transcriber, filePath: string): Promise<boolean> {
+    if (!transcriber.transcribeLong) return false
+    try {
+      return (await readWavHeader(filePath)).duration * 1000 >= LONG_AUDIO_MIN_MS
+    } catch {
+      return false
     }
   }
 
   /**
-   * 确保转写器可用（懒加载）
+   * 从池中取一个识别器
+   * 优先复用空闲实例；全部忙碌且未达上限时扩容，否则分配给排队最少的实例
    */
-  private ensureTranscriber(): Transcriber {
-    if (!this.transcriber) {
-      logger.info('创建转写器实例')
-      const config = this.getTranscriberConfig()
-      logger.info('转写器配置', { engine: (config as { engine?: string }).engine ?? 'sensevoice' })
-      this.transcriber = createTranscriber(config, { supportDir: this.supportDir })
-    }
-    return this.transcriber
+  private acquireTranscriber(): { pool: TranscriberPool; member: PooledTranscriber } {
+    this.cancelIdleRelease()
+    const config = this.getTranscriberConfig()
+    const fingerprint = fingerprintTranscriberConfig(config)
+
+    if (this.pool && this.pool.fingerprint !== fingerprint) {
+      logger.info('转写配置已变更，重建识别器')
+      this.retirePool(this.pool)
+      this.pool = null
+    }
+    if (!this.pool) {
+      this.pool = { fingerprint, members: [], retired: false }
+    }
+
+    const pool = this.pool
+    let member = pool.members.find((candidate) => candidate.inFlight === 0)
+    if (!member && pool.members.length < this.maxPoolSize) {
+      logger.info('创建转写器实例', {
+        engine: (config as { engine?: string }).engine ?? 'sensevoice',
+        poolSize: pool.members.length + 1,
+      })
+      const transcriber = createTranscriber(config, { supportDir: this.supportDir, background: true })
+      member = { transcriber: this.resultCache ? withResultCache(transcriber, this.resultCache, config) : transcriber, inFlight: 0 }
+      pool.members.push(member)
+    }
+    if (!member) {
+      member = pool.members.reduce((least, candidate) => (candidate.inFlight < least.inFlight ? candidate : least))
+    }
+    member.inFlight++
+    return { pool, member }
   }
+
+  private releaseTranscriber(pool: TranscriberPool, member: PooledTranscriber): void {
+    member.inFlight--
+    if (pool.retired) {
+      if (pool.members.every((candidate) => candidate.inFlight === 0)) {
+        this.destroyPool(pool)
+      }
+      return
+    }
+    if (pool === this.pool && pool.members.every((candidate) => candidate.inFlight === 0)) {
+      this.scheduleIdleRelease()
+    }
+  }
+
+  /**
+   * 旧配置的识别器池：无进行中的转写则立即销毁，否则等待完成
+   */
+  private retirePool(pool: TranscriberPool): void {
+    pool.retired = true
+    if (pool.members.every((member) => member.inFlight === 0)) {
+      this.destroyPool(pool)
+    }
+  }
+
+  private destroyPool(pool: TranscriberPool): void {
+    if (pool.members.length > 0) {
+      logger.info('销毁转写器', { count: pool.members.length })
+    }
+    for (const member of pool.members) {
+      member.transcriber.destroy?.()
+    }
+    pool.members = []
+  }
+
+  /**
+   * 批量文件共享同一组已加载的识别器，全部空闲一段时间后再释放内存
+   */
+  private scheduleIdleRelease(): void {
+    this.cancelIdleRelease()
+    this.idleTimer = setTimeout(() => {
+      this.idleTimer = null
+      if (this.pool && this.pool.members.every((member) => member.inFlight === 0)) {
+        this.destroyPool(this.pool)
+        this.pool = null
+      }
+    }, POOL_IDLE_RELEASE_MS)
+    this.idleTimer.unref()
+  }
+
+  private cancelIdleRelease(): void {
+    if (this.idleTimer) {
+      clearTimeout(this.idleTimer)
+      this.idleTimer = null
+    }
+  }
+}
+
+/**
+ * 校验待转写文件，返回错误信息；合法时返回 null
+ */
+function validateAudioFile(filePath: string): string | null {
+  // 验证文件存在
+  if (!fs.existsSync(filePath)) {
+    logger.warn('文件不存在', { filePath })
+    return '文件不存在'
+  }
+
+  // 验证文件格式
+  const ext = path.extname(filePath).toLowerCase()
+  if (ext !== '.wav') {
+    logger.warn('不支持的文件格式', { filePath, ext })
+    return `不支持的文件格式: ${ext}，仅支持 .wav 文件`
+  }
+  return null
+}
+
+/**
+ * 分段文本逐行输出，行首为 [时:分:秒] 起始时间
+ */
+function formatSegments(segments: TranscriptSegment[]): string {
+  return segments.map((segment) => `[${formatTimestamp(segment.start)}] ${segment.text}`).join('\n') + '\n'
+}
+
+function formatTimestamp(ms: number): string {
+  const totalSeconds = Math.floor(ms / 1000)
+  const hours = Math.floor(totalSeconds / 3600)
+  const minutes = Math.floor((totalSeconds % 3600) / 60)
+  const seconds = totalSeconds % 60
+  return [hours, minutes, seconds].map((value) => String(value).padStart(2, '0')).join(':')
 }
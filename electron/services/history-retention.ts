@@ -0,0 +1,228 @@
+/**
+ * SpeechTide 历史记录保留策略
+ *
+ * 按设置在后台清理历史记录：超过保留天数的会话整条删除，超过录音保留天数或
+ * 超出录音总量上限（从最早的开始）的会话只删除音频、保留转写，最后压缩打包段回收空间。
+ * 删除按批进行，每批之前等待应用空闲（无录音、转写、润色），批与批之间让出事件循环，
+ * 不与录音争抢主进程与磁盘。
+ */
+
+import type { RetentionRunResult, RetentionSettings, RetentionStatus } from '../../shared/app-state'
+import type { ConversationStore, SessionUsage } from '../storage/conversation-store'
+import { createModuleLogger } from '../utils/logger'
+
+const logger = createModuleLogger('retention')
+
+const DAY_MS = 24 * 60 * 60 * 1000
+/** 每批处理的会话数 */
+const BATCH_SIZE = 50
+/** 应用忙碌时重新检查的间隔 */
+const BUSY_POLL_MS = 5000
+/** 批与批之间的间隔，降低对磁盘的连续占用 */
+const BATCH_PAUSE_MS = 50
+
+export interface HistoryRetentionOptions {
+  store: ConversationStore
+  getPolicy: () => RetentionSettings
+  /** 正在录音、转写或润色时返回 true，清理会等待 */
+  isBusy: () => boolean
+  onUpdate?: (status: RetentionStatus) => void
+}
+
+type RetentionProgress = Pick<RetentionStatus, 'phase' | 'completed' | 'total' | 'reclaimedBytes'>
+
+export interface RetentionPlan {
+  /** 整条删除的会话 */
+  deleteIds: string[]
+  /** 只删除音频的会话 */
+  audioIds: string[]
+}
+
+function sanitizeLimit(value: number | undefined): number {
+  return Number.isFinite(value) && (value as number) > 0 ? (value as number) : 0
+}
+
+/**
+ * 按策略选择要清理的会话
+ */
+export function planRetention(usage: SessionUsage[], policy: RetentionSettings, now = Date.now()): RetentionPlan {
+  const transcriptDays = sanitizeLimit(policy.transcriptDays)
+  const audioDays = sanitizeLimit(policy.audioDays)
+  const maxAudioBytes = sanitizeLimit(policy.maxAudioMB) * 1024 * 1024
+
+  const deleteIds: string[] = []
+  const kept: SessionUsage[] = []
+  for (const session of usage) {
+    if (transcriptDays > 0 && now - session.sortKey > transcriptDays * DAY_MS) {
+      deleteIds.push(session.id)
+    } else {
+      kept.push(session)
+    }
+  }
+
+  const audioIds: string[] = []
+  // 从最新的会话开始累计音频，超过上限之后的（更早的）全部删除音频
+  kept.sort((a, b) => b.sortKey - a.sortKey)
+  let audioBytes = 0
+  for (const session of kept) {
+    if (session.audioBytes === 0) continue
+    const expired = audioDays > 0 && now - session.sortKey > audioDays * DAY_MS
+    const overCap = maxAudioBytes > 0 && audioBytes + session.audioBytes > maxAudioBytes
+    if (expired || overCap) {
+      audioIds.push(session.id)
+    } else {
+      audioBytes += session.audioBytes
+    }
+  }
+  return { deleteIds, audioIds }
+}
+
+function delay(ms: number): Promise<void> {
+  return new Promise((resolve) => setTimeout(resolve, ms))
+}
+
+export class HistoryRetention {
+  private running: Promise<RetentionStatus> | null = null
+  private progress: RetentionProgress = {}
+  private lastRun: RetentionRunResult | null = null
+  private lastError: string | undefined
+  private timer: NodeJS.Timeout | null = null
+  private stopped = false
+
+  constructor(private readonly options: HistoryRetentionOptions) {}
+
+  getStatus(): RetentionStatus {
+    return {
+      running: this.running !== null,
+      ...(this.running ? this.progress : {}),
+      lastRun: this.lastRun,
+      error: this.lastError,
+    }
+  }
+
+  /**
+   * 安排一次清理（已安排的会被替换），之后按 intervalMs 周期运行
+   */
+  schedule(delayMs: number, intervalMs?: number): void {
+    if (this.stopped) return
+    if (this.timer) clearTimeout(this.timer)
+    this.timer = setTimeout(() => {
+      this.timer = null
+      void this.run().finally(() => {
+        if (intervalMs) this.schedule(intervalMs, intervalMs)
+      })
+    }, delayMs)
+    this.timer.unref()
+  }
+
+  /**
+   * 立即运行一次清理；运行中重复调用返回同一结果
+   */
+  run(): Promise<RetentionStatus> {
+    if (!this.running) {
+      // 推迟一拍执行，保证首次进度通知时 running 已置位
+      this.running = Promise.resolve()
+        .then(() => this.execute())
+        .finally(() => {
+          this.running = null
+          this.progress = {}
+        })
+        .then(() => {
+          this.emit()
+          return this.getStatus()
+        })
+    }
+    return this.running
+  }
+
+  stop(): void {
+    this.stopped = true
+    if (this.timer) clearTimeout(this.timer)
+    this.timer = null
+  }
+
+  private async execute(): Promise<void> {
+    const { store } = this.options
+    const policy = this.options.getPolicy()
+    if (!sanitizeLimit(policy.transcriptDays) && !sanitizeLimit(policy.audioDays) && !sanitizeLimit(policy.maxAudioMB)) {
+      return
+    }
+
+    const startedAt = Date.now()
+    let deletedRecords = 0
+    let removedAudio = 0
+    let reclaimedBytes = 0
+    this.lastError = undefined
+
+    try {
+      this.setProgress({ phase: 'scanning', reclaimedBytes: 0 })
+      await this.waitForIdle()
+      const plan = planRetention(await store.listUsage(), policy)
+      const total = plan.deleteIds.length + plan.audioIds.length
+      let completed = 0
+      this.setProgress({ phase: 'deleting', completed, total, reclaimedBytes })
+
+      for (let i = 0; i < plan.deleteIds.length && !this.stopped; i += BATCH_SIZE) {
+        const batch = plan.deleteIds.slice(i, i + BATCH_SIZE)
+        await this.waitForIdle()
+        const result = await store.deleteMany(batch)
+        deletedRecords += result.deleted
+        reclaimedBytes += result.reclaimedBytes
+        completed += batch.length
+        this.setProgress({ phase: 'deleting', completed, total, reclaimedBytes })
+        await delay(BATCH_PAUSE_MS)
+      }
+      for (let i = 0; i < plan.audioIds.length && !this.stopped; i += BATCH_SIZE) {
+        const batch = plan.audioIds.slice(i, i + BATCH_SIZE)
+        await this.waitForIdle()
+        const result = await store.removeAudio(batch)
+        removedAudio += result.removed
+        reclaimedBytes += result.reclaimedBytes
+        completed += batch.length
+        this.setProgress({ phase: 'deleting', completed, total, reclaimedBytes })
+        await delay(BATCH_PAUSE_MS)
+      }
+
+      if (!this.stopped && total > 0) {
+        await this.waitForIdle()
+        this.setProgress({ phase: 'compacting', completed: 0, total: 0, reclaimedBytes })
+        const compacted = await store.compactPacks((segmentsDone, segmentsTotal) => {
+          this.setProgress({ phase: 'compacting', completed: segmentsDone, total: segmentsTotal, reclaimedBytes })
+        })
+        reclaimedBytes += compacted.reclaimedBytes
+      }
+    } catch (error) {
+      this.lastError = error instanceof Error ? error.message : String(error)
+      logger.error(error instanceof Error ? error : new Error(String(error)), { context: 'retention' })
+    }
+
+    this.lastRun = {
+      finishedAt: Date.now(),
+      durationMs: Date.now() - startedAt,
+      deletedRecords,
+      removedAudio,
+      reclaimedBytes,
+    }
+    if (deletedRecords > 0 || removedAudio > 0) {
+      logger.info('历史记录清理完成', { ...this.lastRun })
+    }
+  }
+
+  /**
+   * 应用忙碌时等待，直到空闲或服务停止
+   */
+  private async waitForIdle(): Promise<void> {
+    while (!this.stopped && this.options.isBusy()) {
+      await delay(BUSY_POLL_MS)
+    }
+  }
+
+  private setProgress(progress: RetentionProgress): void {
+    this.progress = progress
+    this.emit()
+  }
+
+  private emit(): void {
+    this.options.onUpdate?.(this.getStatus())
+  }
+}
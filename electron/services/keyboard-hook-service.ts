@@ -13,6 +13,8 @@ const DEFAULT_HOLD_THRESHOLD_MS = 300
 export interface KeyboardHookCallbacks {
   onRecordingStart: () => void
   onRecordingStop: (triggerType: TriggerType) => void
+  /** 快捷键的修饰键被按下，用户可能即将开始录音（用于预热模型） */
+  onShortcutPrepare?: () => void
 }
 
 /**
@@ -372,12 +374,28 @@ export class KeyboardHookService {
     return true
   }
 
+  /**
+   * 按键是否为快捷键组合中的修饰键
+   */
+  private isShortcutModifier(keycode: number): boolean {
+    const { meta, ctrl, alt, shift } = this.parsedShortcut
+    if (meta && (keycode === UiohookKey.Meta || keycode === UiohookKey.MetaRight)) return true
+    if (ctrl && (keycode === UiohookKey.Ctrl || keycode === UiohookKey.CtrlRight)) return true
+    if (alt && (keycode === UiohookKey.Alt || keycode === UiohookKey.AltRight)) return true
+    if (shift && (keycode === UiohookKey.Shift || keycode === UiohookKey.ShiftRight)) return true
+    return false
+  }
+
   /**
    * 处理按键按下
    * - 未录音时按下：开始录音，标记 startedThisPress = true
    * - 录音中按下：标记 startedThisPress = false（准备停止录音）
    */
   private handleKeyDown = (e: { altKey: boolean; ctrlKey: boolean; metaKey: boolean; shiftKey: boolean; keycode: number }): void => {
+    if (!this.isRecording && !this.isShortcutDown && this.isShortcutModifier(e.keycode)) {
+      this.callbacks?.onShortcutPrepare?.()
+    }
+
     if (!this.isShortcutMatch(e)) return
 
     // 防止重复触发（按住不放会持续触发 keydown）
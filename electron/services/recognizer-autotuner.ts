@@ -0,0 +1,266 @@
+/**
+ * SpeechTide 识别器自动调优
+ *
+ * 在用户机器上用测试音频测量不同模型文件（fp32 / int8）与推理线程数组合的
+ * 加载耗时和实时率，选出最快且精度无明显下降的配置并持久化；
+ * 之后创建转写器时自动套用。机器或模型文件变化后结果失效，需要重新调优。
+ */
+
+import fs from 'node:fs'
+import fsPromises from 'node:fs/promises'
+import os from 'node:os'
+import path from 'node:path'
+import crypto from 'node:crypto'
+import type { AutotuneCandidateResult, AutotuneProfile, AutotuneStatus } from '../../shared/app-state'
+import type { SenseVoiceTranscriberConfig } from '../config'
+import { createTranscriber, type BenchmarkCandidate } from '../transcriber'
+import { MODEL_VARIANTS } from '../transcriber/sensevoice-transcriber'
+import { createModuleLogger } from '../utils/logger'
+
+const logger = createModuleLogger('autotune')
+
+const PROFILE_FILE = 'autotune.json'
+/** 候选线程数，超过 CPU 核数的会被过滤 */
+const THREAD_CANDIDATES = [1, 2, 4, 6, 8]
+/** 每个候选计时解码次数 */
+const BENCHMARK_RUNS = 3
+/** 与最快配置相差在该比例内视为同样快，优先更少线程和更短加载 */
+const RTF_TOLERANCE = 1.05
+/** 量化模型与 fp32 输出的最低字符相似度 */
+const MIN_AGREEMENT = 0.9
+/** 作为精度参照的模型文件 */
+const REFERENCE_VARIANT = 'model.onnx'
+
+export interface RecognizerAutotunerOptions {
+  /** 调优结果保存目录 */
+  configDir: string
+  supportDir: string
+  /** 未套用调优结果的基础配置 */
+  getBaseConfig: () => SenseVoiceTranscriberConfig
+  /** 准备测试音频，返回路径 */
+  prepareAudio: () => Promise<string>
+  onUpdate?: (status: AutotuneStatus) => void
+}
+
+export class RecognizerAutotuner {
+  private readonly profilePath: string
+  private profile: AutotuneProfile | null = null
+  private running: Promise<AutotuneStatus> | null = null
+  private progress: { completed: number; total: number } | null = null
+  private lastError: string | undefined
+
+  constructor(private readonly options: RecognizerAutotunerOptions) {
+    this.profilePath = path.join(options.configDir, PROFILE_FILE)
+    this.profile = this.readProfile()
+  }
+
+  /**
+   * 当前有效的调优结果；机器或模型文件变化后返回 null
+   */
+  getProfile(): AutotuneProfile | null {
+    if (this.profile && this.profile.signature !== this.computeSignature(this.options.getBaseConfig())) {
+      return null
+    }
+    return this.profile
+  }
+
+  /**
+   * 是否需要（重新）调优：模型存在但没有有效结果
+   */
+  needsTuning(): boolean {
+    return this.listVariants(this.options.getBaseConfig()).length > 0 && this.getProfile() === null
+  }
+
+  /**
+   * 套用调优结果；用户在 transcriber.json 中显式指定的模型文件与线程数优先
+   */
+  apply(config: SenseVoiceTranscriberConfig): SenseVoiceTranscriberConfig {
+    const profile = this.getProfile()
+    if (!profile) return config
+    return {
+      ...config,
+      modelFile: config.modelFile ?? profile.best.variant,
+      numThreads: config.numThreads ?? profile.best.numThreads,
+    }
+  }
+
+  getStatus(): AutotuneStatus {
+    return {
+      running: this.running !== null,
+      completed: this.progress?.completed,
+      total: this.progress?.total,
+      profile: this.getProfile(),
+      error: this.lastError,
+    }
+  }
+
+  /**
+   * 运行调优；已在运行时返回同一次结果
+   */
+  run(): Promise<AutotuneStatus> {
+    if (!this.running) {
+      this.running = this.execute()
+        .finally(() => {
+          this.running = null
+          this.progress = null
+          this.notify()
+        })
+        .then(() => this.getStatus())
+      this.notify()
+    }
+    return this.running
+  }
+
+  private async execute(): Promise<void> {
+    const baseConfig = this.options.getBaseConfig()
+    const variants = this.listVariants(baseConfig)
+    if (variants.length === 0) {
+      this.lastError = '未找到模型文件'
+      return
+    }
+    const candidates = variants.flatMap((variant) =>
+      this.threadCandidates().map<BenchmarkCandidate>((numThreads) => ({ variant, numThreads }))
+    )
+    logger.info('开始自动调优', { variants, candidates: candidates.length })
+    this.lastError = undefined
+    this.progress = { completed: 0, total: candidates.length }
+
+    const transcriber = createTranscriber(baseConfig, {
+      supportDir: this.options.supportDir,
+      background: true,
+      benchmarkOnly: true,
+    })
+    try {
+      const audioPath = await this.options.prepareAudio()
+      const report = await transcriber.benchmark!({
+        audioPath,
+        candidates,
+        runs: BENCHMARK_RUNS,
+        onProgress: (completed, total) => {
+          this.progress = { completed, total }
+          this.notify()
+        },
+      })
+      const results = scoreAgreement(report.results)
+      const best = pickBest(results)
+      if (!best) {
+        throw new Error('所有候选配置均测量失败')
+      }
+      const profile: AutotuneProfile = {
+        createdAt: Date.now(),
+        signature: this.computeSignature(baseConfig),
+        audioMs: report.audioMs,
+        best: { variant: best.variant, numThreads: best.numThreads, rtf: best.rtf!, loadMs: best.loadMs! },
+        results,
+      }
+      await this.writeProfile(profile)
+      this.profile = profile
+      logger.info('自动调优完成', { best: profile.best, audioMs: report.audioMs })
+    } catch (error) {
+      this.lastError = error instanceof Error ? error.message : String(error)
+      logger.warn('自动调优失败', { error: this.lastError })
+    } finally {
+      transcriber.destroy?.()
+    }
+  }
+
+  private threadCandidates(): number[] {
+    const threads = THREAD_CANDIDATES.filter((count) => count <= os.availableParallelism())
+    return threads.length > 0 ? threads : [1]
+  }
+
+  /**
+   * 可调优的模型文件：显式指定时只有该文件，否则为模型目录下存在的 fp32/int8 版本
+   */
+  private listVariants(config: SenseVoiceTranscriberConfig): string[] {
+    const variants = config.modelFile ? [config.modelFile] : MODEL_VARIANTS
+    return variants.filter((variant) => fs.existsSync(path.resolve(config.modelDir, variant)))
+  }
+
+  /**
+   * CPU 型号/核数与各模型文件大小、修改时间的指纹
+   */
+  private computeSignature(config: SenseVoiceTranscriberConfig): string {
+    const cpus = os.cpus()
+    const models = this.listVariants(config).map((variant) => {
+      const stat = fs.statSync(path.resolve(config.modelDir, variant))
+      return [variant, stat.size, stat.mtimeMs]
+    })
+    const raw = JSON.stringify({
+      platform: process.platform,
+      arch: process.arch,
+      cpu: cpus[0]?.model ?? 'unknown',
+      cores: cpus.length,
+      modelDir: config.modelDir,
+      models,
+    })
+    return crypto.createHash('sha256').update(raw).digest('hex').slice(0, 16)
+  }
+
+  private readProfile(): AutotuneProfile | null {
+    try {
+      if (!fs.existsSync(this.profilePath)) return null
+      return JSON.parse(fs.readFileSync(this.profilePath, 'utf-8')) as AutotuneProfile
+    } catch (error) {
+      logger.warn('读取调优结果失败，忽略', { error: String(error) })
+      return null
+    }
+  }
+
+  private async writeProfile(profile: AutotuneProfile): Promise<void> {
+    await fsPromises.mkdir(path.dirname(this.profilePath), { recursive: true })
+    const tempPath = `${this.profilePath}.tmp`
+    await fsPromises.writeFile(tempPath, JSON.stringify(profile, null, 2), 'utf-8')
+    await fsPromises.rename(tempPath, this.profilePath)
+  }
+
+  private notify(): void {
+    this.options.onUpdate?.(this.getStatus())
+  }
+}
+
+/**
+ * 计算各候选输出与 fp32 参照输出的字符相似度
+ */
+function scoreAgreement(results: AutotuneCandidateResult[]): AutotuneCandidateResult[] {
+  const reference = results.find((result) => result.variant === REFERENCE_VARIANT && result.text !== undefined)
+  if (!reference?.text) return results
+  return results.map((result) =>
+    result.text === undefined ? result : { ...result, agreement: similarity(reference.text!, result.text) }
+  )
+}
+
+/**
+ * 在精度达标的候选中取实时率最低者；相差不大时优先更少线程，其次更短加载时间
+ */
+function pickBest(results: AutotuneCandidateResult[]): AutotuneCandidateResult | null {
+  const eligible = results.filter(
+    (result) => result.rtf !== undefined && result.loadMs !== undefined && (result.agreement ?? 1) >= MIN_AGREEMENT
+  )
+  if (eligible.length === 0) return null
+  const fastest = Math.min(...eligible.map((result) => result.rtf!))
+  const comparable = eligible.filter((result) => result.rtf! <= fastest * RTF_TOLERANCE)
+  comparable.sort((a, b) => a.numThreads - b.numThreads || a.loadMs! - b.loadMs!)
+  return comparable[0]
+}
+
+/**
+ * 基于编辑距离的字符相似度（忽略空白）
+ */
+function similarity(a: string, b: string): number {
+  const left = Array.from(a.replace(/\s+/g, ''))
+  const right = Array.from(b.replace(/\s+/g, ''))
+  const longest = Math.max(left.length, right.length)
+  if (longest === 0) return 1
+
+  let previous = Array.from({ length: right.length + 1 }, (_, index) => index)
+  for (let i = 1; i <= left.length; i++) {
+    const current = [i]
+    for (let j = 1; j <= right.length; j++) {
+      const cost = left[i - 1] === right[j - 1] ? 0 : 1
+      current[j] = Math.min(previous[j] + 1, current[j - 1] + 1, previous[j - 1] + cost)
+    }
+    previous = current
+  }
+  return Math.round((1 - previous[right.length] / longest) * 1000) / 1000
+}
@@ -0,0 +1,334 @@
+/**
+ * SpeechTide 识别器驻留管理
+ *
+ * 内存充足时保持离线模型常驻，避免每次卸载后重新加载带来的冷启动延迟；
+ * 仅在系统内存紧张或 worker 内存超过上限时卸载。
+ * 快捷键修饰键按下、窗口获得焦点等信号会触发预热，让模型在录音结束前就绪。
+ */
+
+import { execFile } from 'node:child_process'
+import fs from 'node:fs/promises'
+import os from 'node:os'
+import { promisify } from 'node:util'
+import type { ModelResidencyStats, ModelUnloadReason } from '../../shared/app-state'
+import type { Transcriber } from '../transcriber'
+import { createModuleLogger } from '../utils/logger'
+import { metrics } from '../utils/metrics'
+
+const logger = createModuleLogger('residency')
+
+const execFileAsync = promisify(execFile)
+
+/** 内存检查间隔 */
+const PRESSURE_CHECK_INTERVAL_MS = 30 * 1000
+/** 严重内存压力或超出 RSS 上限时，至少闲置这么久才卸载，避免连续口述时反复加载 */
+const PRESSURE_MIN_IDLE_MS = 60 * 1000
+/** 系统可用内存（含可回收的缓存页）比例低于该值视为严重压力，闲置 PRESSURE_MIN_IDLE_MS 即卸载 */
+const CRITICAL_FREE_RATIO = 0.03
+/** 低于该值视为内存偏紧，闲置超过用户设置的缓存时间后卸载 */
+const LOW_FREE_RATIO = 0.1
+/** 两次预热之间的最小间隔，修饰键可能被频繁按下 */
+const PREWARM_DEBOUNCE_MS = 5 * 1000
+
+export interface ResidencyPolicy {
+  /** 是否需要驻留管理（在线转写没有本地模型） */
+  managed: boolean
+  /** 内存偏紧（或无法读取可用内存）时的闲置卸载时间，null 表示常驻（仅严重压力或超限时卸载） */
+  idleUnloadMs: number | null
+  /** worker 常驻内存上限，null 表示不限制 */
+  rssCapBytes: number | null
+}
+
+export interface TranscriberResidencyOptions {
+  /** 创建新的转写器实例 */
+  create: () => Transcriber
+  /** 读取当前驻留策略，每次检查时调用以反映最新设置 */
+  getPolicy: () => ResidencyPolicy
+}
+
+export class TranscriberResidencyManager {
+  private transcriber: Transcriber | null = null
+  private loadedAt = 0
+  private readySettled = false
+  /** 进行中的使用次数（录音、测试转写各持有一次），大于 0 时不卸载 */
+  private inFlight = 0
+  private lastUsedAt = 0
+  private lastPrewarmAt = 0
+  private checkTimer: NodeJS.Timeout | null = null
+  private checking = false
+
+  private loadCount = 0
+  private prewarmCount = 0
+  private warmHits = 0
+  private coldStartTotalMs = 0
+  private coldStarts = 0
+  private lastColdStartMs: number | null = null
+  private maxColdStartMs: number | null = null
+  private lastLoadMs: number | null = null
+  private workerRssBytes: number | null = null
+  private readonly unloads: Record<ModelUnloadReason, number> = {
+    'memory-pressure': 0,
+    'rss-cap': 0,
+    'config-changed': 0,
+  }
+
+  constructor(private readonly options: TranscriberResidencyOptions) {}
+
+  /**
+   * 开始一次使用（一次口述或测试转写），未加载时立即创建
+   * 每次 acquire() 必须对应一次 release()，计数归零之前不会因内存压力被卸载
+   */
+  acquire(): Transcriber {
+    this.inFlight++
+    this.lastUsedAt = Date.now()
+
+    const transcriber = this.get()
+    if (this.readySettled) {
+      this.warmHits++
+    } else if (transcriber.whenReady) {
+      // 模型仍在加载（冷启动或预热尚未完成），记录本次等待时长
+      const waitStartedAt = Date.now()
+      transcriber.whenReady().then(
+        () => this.recordColdStart(Date.now() - waitStartedAt),
+        () => {}
+      )
+    }
+    return transcriber
+  }
+
+  /**
+   * 在 acquire() 与 release() 之间获取转写器，不改变使用计数；
+   * 使用期间被卸载（例如配置变更）时重新创建
+   */
+  get(): Transcriber {
+    if (!this.transcriber) {
+      this.load('demand')
+    }
+    return this.transcriber as Transcriber
+  }
+
+  /**
+   * 本次使用结束，所有使用都结束后可在内存压力下卸载
+   */
+  release(): void {
+    if (this.inFlight === 0) {
+      logger.warn('release() 没有对应的 acquire()')
+      return
+    }
+    this.inFlight--
+    this.lastUsedAt = Date.now()
+  }
+
+  /**
+   * 预测即将使用，提前加载模型
+   * @param reason 触发来源，仅用于日志
+   */
+  prewarm(reason: string): void {
+    if (this.transcriber || !this.options.getPolicy().managed) return
+
+    const now = Date.now()
+    if (now - this.lastPrewarmAt < PREWARM_DEBOUNCE_MS) return
+    this.lastPrewarmAt = now
+
+    void readAvailableMemoryRatio().then((ratio) => {
+      // 读取期间可能已被使用而加载
+      if (this.transcriber) return
+      // 严重内存压力下预热只会在下一次检查时被卸载
+      if (ratio !== null && ratio < CRITICAL_FREE_RATIO) {
+        logger.debug('内存紧张，跳过预热', { reason })
+        return
+      }
+
+      logger.info('预热模型', { reason })
+      this.prewarmCount++
+      this.load('prewarm')
+    })
+  }
+
+  /**
+   * 立即卸载转写器（终止 worker 进程）
+   */
+  unload(reason: ModelUnloadReason): void {
+    if (!this.transcriber) return
+
+    logger.info('卸载模型，终止 Worker 进程', {
+      reason,
+      residentSeconds: Math.round((Date.now() - this.loadedAt) / 1000),
+      workerRssMB: this.workerRssBytes !== null ? Math.round(this.workerRssBytes / 1024 / 1024) : null,
+    })
+    this.unloads[reason]++
+    this.transcriber.destroy?.()
+    this.transcriber = null
+    this.readySettled = false
+    this.workerRssBytes = null
+    this.stopMonitor()
+  }
+
+  /**
+   * 当前已加载的转写器（不触发加载）
+   */
+  get current(): Transcriber | null {
+    return this.transcriber
+  }
+
+  getStats(): ModelResidencyStats {
+    return {
+      loaded: this.transcriber !== null,
+      loadCount: this.loadCount,
+      prewarmCount: this.prewarmCount,
+      warmHits: this.warmHits,
+      coldStarts: this.coldStarts,
+      lastColdStartMs: this.lastColdStartMs,
+      avgColdStartMs: this.coldStarts > 0 ? Math.round(this.coldStartTotalMs / this.coldStarts) : null,
+      maxColdStartMs: this.maxColdStartMs,
+      lastLoadMs: this.lastLoadMs,
+      workerRssBytes: this.workerRssBytes,
+      unloads: { ...this.unloads },
+    }
+  }
+
+  destroy(): void {
+    this.stopMonitor()
+    this.transcriber?.destroy?.()
+    this.transcriber = null
+  }
+
+  private load(trigger: 'demand' | 'prewarm'): void {
+    const transcriber = this.options.create()
+    this.transcriber = transcriber
+    this.loadedAt = Date.now()
+    // 预热加载的模型也从加载时刻开始计算闲置时间
+    this.lastUsedAt = Math.max(this.lastUsedAt, this.loadedAt)
+    this.readySettled = false
+    this.loadCount++
+
+    if (transcriber.whenReady) {
+      const startedAt = Date.now()
+      transcriber.whenReady().then(
+        (workerLoadMs) => {
+          if (this.transcriber !== transcriber) return
+          this.readySettled = true
+          this.lastLoadMs = workerLoadMs
+          metrics.recordMetric({
+            operation: 'model_load',
+            startTime: startedAt,
+            duration: Date.now() - startedAt,
+            memoryUsage: process.memoryUsage().heapUsed,
+            metadata: { stage: 'recognizer', trigger, workerLoadMs },
+          })
+          logger.info('模型已就绪', { trigger, totalMs: Date.now() - startedAt, workerLoadMs })
+        },
+        () => {
+          // 加载失败由转写调用方处理；下次使用时重新创建
+          if (this.transcriber === transcriber) {
+            transcriber.destroy?.()
+            this.transcriber = null
+            this.stopMonitor()
+          }
+        }
+      )
+    } else {
+      this.readySettled = true
+    }
+
+    if (this.options.getPolicy().managed) {
+      this.startMonitor()
+    }
+  }
+
+  private recordColdStart(waitMs: number): void {
+    this.coldStarts++
+    this.coldStartTotalMs += waitMs
+    this.lastColdStartMs = waitMs
+    this.maxColdStartMs = Math.max(this.maxColdStartMs ?? 0, waitMs)
+    logger.info('冷启动等待模型加载', { waitMs, coldStarts: this.coldStarts })
+  }
+
+  private startMonitor(): void {
+    if (this.checkTimer) return
+    this.checkTimer = setInterval(() => {
+      void this.checkPressure()
+    }, PRESSURE_CHECK_INTERVAL_MS)
+    this.checkTimer.unref()
+  }
+
+  private stopMonitor(): void {
+    if (this.checkTimer) {
+      clearInterval(this.checkTimer)
+      this.checkTimer = null
+    }
+  }
+
+  /**
+   * 根据系统可用内存与 worker RSS 判断是否卸载
+   */
+  private async checkPressure(): Promise<void> {
+    const transcriber = this.transcriber
+    if (!transcriber || this.checking) return
+    this.checking = true
+    try {
+      const policy = this.options.getPolicy()
+      if (!policy.managed) return
+
+      if (transcriber.getMemoryUsage) {
+        this.workerRssBytes = await transcriber.getMemoryUsage()
+      }
+      const freeRatio = await readAvailableMemoryRatio()
+      // 等待期间可能已被卸载或重新使用
+      if (this.transcriber !== transcriber || this.inFlight > 0) return
+
+      const idleMs = Date.now() - this.lastUsedAt
+
+      if (policy.rssCapBytes !== null && this.workerRssBytes !== null && this.workerRssBytes > policy.rssCapBytes) {
+        if (idleMs >= PRESSURE_MIN_IDLE_MS) {
+          this.unload('rss-cap')
+        }
+        return
+      }
+      if (freeRatio !== null && freeRatio < CRITICAL_FREE_RATIO && idleMs >= PRESSURE_MIN_IDLE_MS) {
+        this.unload('memory-pressure')
+        return
+      }
+      // 无法读取可用内存时按用户设置的缓存时间卸载
+      const low = freeRatio === null || freeRatio < LOW_FREE_RATIO
+      if (low && policy.idleUnloadMs !== null && idleMs >= policy.idleUnloadMs) {
+        this.unload('memory-pressure')
+      }
+    } finally {
+      this.checking = false
+    }
+  }
+}
+
+/**
+ * 读取系统可用内存占总内存的比例，无法读取时返回 null
+ * os.freemem() 不含可回收的缓存页（macOS 上通常只有百分之几），不能作为内存压力信号：
+ * macOS 使用 vm_stat 的空闲、非活跃、预读与可清除页，Linux 使用 /proc/meminfo 的 MemAvailable
+ */
+async function readAvailableMemoryRatio(): Promise<number | null> {
+  try {
+    if (process.platform === 'darwin') {
+      const { stdout } = await execFileAsync('/usr/bin/vm_stat', [], { timeout: 2000 })
+      const pageSize = Number(/page size of (\d+) bytes/.exec(stdout)?.[1])
+      const pages = (label: string) => Number(new RegExp(`^${label}:\\s+(\\d+)`, 'm').exec(stdout)?.[1] ?? NaN)
+      const available = ['Pages free', 'Pages inactive', 'Pages speculative', 'Pages purgeable']
+        .map(pages)
+        .reduce((sum, count) => sum + (Number.isFinite(count) ? count : 0), 0)
+      if (!pageSize || available === 0) return null
+      return (available * pageSize) / os.totalmem()
+    }
+    if (process.platform === 'linux') {
+      const meminfo = await fs.readFile('/proc/meminfo', 'utf-8')
+      const availableKb = Number(/^MemAvailable:\s+(\d+) kB/m.exec(meminfo)?.[1])
+      const totalKb = Number(/^MemTotal:\s+(\d+) kB/m.exec(meminfo)?.[1])
+      return availableKb > 0 && totalKb > 0 ? availableKb / totalKb : null
+    }
+    if (process.platform === 'win32') {
+      // Windows 的 freemem 即可用物理内存（含备用列表）
+      return os.freemem() / os.totalmem()
+    }
+  } catch (error) {
+    logger.debug('读取系统可用内存失败', { error: error instanceof Error ? error.message : String(error) })
+  }
+  return null
+}
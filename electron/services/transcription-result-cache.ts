@@ -0,0 +1,403 @@
+/**
+ * 转写结果缓存
+ *
+ * 以「解码后的 PCM 内容哈希 + 转写配置指纹」为键持久化转写结果：
+ * 重复转写测试音频、重新转写历史录音或再次拖入同一文件时直接返回，不再解码。
+ * WAV 只对 data 块与采样格式求哈希，元数据块不同但音频相同的文件也能命中。
+ * 缓存按最近使用淘汰，总大小不超过上限。
+ */
+
+import fs from 'node:fs'
+import fsPromises, { type FileHandle } from 'node:fs/promises'
+import path from 'node:path'
+import crypto from 'node:crypto'
+import type { ResultCacheStats } from '../../shared/app-state'
+import type { BatchTranscriptionItem, LongTranscribeOptions, TranscribeOptions, Transcriber, TranscriberConfig, TranscriptionResult } from '../transcriber'
+import { createModuleLogger } from '../utils/logger'
+
+const logger = createModuleLogger('result-cache')
+
+const INDEX_FILE = 'index.json'
+/** 缓存格式版本，结果结构变化时递增使旧缓存失效 */
+const CACHE_VERSION = 1
+/** 合并短时间内的多次写入 */
+const PERSIST_DELAY_MS = 1000
+/** 流式哈希的读取块大小 */
+const HASH_CHUNK_BYTES = 1024 * 1024
+/** 文件摘要的内存缓存条数（按路径 + 大小 + 修改时间命中，免去重复读文件） */
+const MAX_DIGEST_MEMO = 512
+
+interface CacheEntry {
+  result: TranscriptionResult
+  /** 条目序列化后的字节数，计入容量 */
+  bytes: number
+  lastUsedAt: number
+}
+
+export interface TranscriptionResultCacheOptions {
+  cacheDir: string
+  /** 缓存总大小上限（字节） */
+  maxBytes: number
+}
+
+export class TranscriptionResultCache {
+  private readonly indexPath: string
+  private readonly maxBytes: number
+  // Map 按插入顺序迭代：命中时删除再插入，首个元素即最久未使用
+  private entries: Map<string, CacheEntry> | null = null
+  private totalBytes = 0
+  private hits = 0
+  private misses = 0
+  private evictions = 0
+  private readonly inflight = new Map<string, Promise<TranscriptionResult>>()
+  private readonly digestMemo = new Map<string, { size: number; mtimeMs: number; digest: string }>()
+  private persistTimer: NodeJS.Timeout | null = null
+  private persistChain: Promise<void> = Promise.resolve()
+
+  constructor(options: TranscriptionResultCacheOptions) {
+    this.indexPath = path.join(options.cacheDir, INDEX_FILE)
+    this.maxBytes = Math.max(0, options.maxBytes)
+  }
+
+  /**
+   * 计算音频文件在指定配置下的缓存键
+   */
+  async keyForFile(filePath: string, fingerprint: string): Promise<string> {
+    const digest = await this.digestFile(filePath)
+    return crypto.createHash('sha256').update(`${CACHE_VERSION}|${fingerprint}|${digest}`).digest('hex')
+  }
+
+  /**
+   * 查找缓存结果，未命中时执行 compute 并写入缓存；同一键的并发请求只解码一次
+   */
+  async getOrCompute(key: string, compute: () => Promise<TranscriptionResult>): Promise<TranscriptionResult> {
+    const cached = this.get(key)
+    if (cached) return cached
+    const pending = this.inflight.get(key)
+    if (pending) return { ...(await pending) }
+
+    const task = compute()
+      .then((result) => {
+        this.set(key, result)
+        return result
+      })
+      .finally(() => this.inflight.delete(key))
+    this.inflight.set(key, task)
+    return task
+  }
+
+  get(key: string): TranscriptionResult | null {
+    const entries = this.load()
+    const entry = entries.get(key)
+    if (!entry) {
+      this.misses++
+      return null
+    }
+    this.hits++
+    entries.delete(key)
+    entry.lastUsedAt = Date.now()
+    entries.set(key, entry)
+    this.schedulePersist()
+    return { ...entry.result }
+  }
+
+  set(key: string, result: TranscriptionResult): void {
+    const entries = this.load()
+    const bytes = Buffer.byteLength(key) + Buffer.byteLength(JSON.stringify(result))
+    if (bytes > this.maxBytes) return
+
+    const previous = entries.get(key)
+    if (previous) {
+      this.totalBytes -= previous.bytes
+      entries.delete(key)
+    }
+    entries.set(key, { result: { ...result }, bytes, lastUsedAt: Date.now() })
+    this.totalBytes += bytes
+    this.evict()
+    this.schedulePersist()
+  }
+
+  getStats(): ResultCacheStats {
+    const entries = this.load()
+    const lookups = this.hits + this.misses
+    return {
+      entries: entries.size,
+      bytes: this.totalBytes,
+      maxBytes: this.maxBytes,
+      hits: this.hits,
+      misses: this.misses,
+      hitRate: lookups > 0 ? Math.round((this.hits / lookups) * 1000) / 1000 : null,
+      evictions: this.evictions,
+    }
+  }
+
+  /**
+   * 立即写盘（应用退出时调用）
+   */
+  flushSync(): void {
+    if (!this.entries) return
+    if (this.persistTimer) {
+      clearTimeout(this.persistTimer)
+      this.persistTimer = null
+    }
+    try {
+      fs.mkdirSync(path.dirname(this.indexPath), { recursive: true })
+      const tempPath = `${this.indexPath}.tmp`
+      fs.writeFileSync(tempPath, this.serialize(), 'utf-8')
+      fs.renameSync(tempPath, this.indexPath)
+    } catch (error) {
+      logger.warn('保存转写结果缓存失败', { error: String(error) })
+    }
+  }
+
+  /**
+   * WAV 文件：对采样格式与 data 块求哈希；其他格式对整个文件求哈希
+   */
+  private async digestFile(filePath: string): Promise<string> {
+    const stat = await fsPromises.stat(filePath)
+    const memo = this.digestMemo.get(filePath)
+    if (memo && memo.size === stat.size && memo.mtimeMs === stat.mtimeMs) {
+      return memo.digest
+    }
+
+    const handle = await fsPromises.open(filePath, 'r')
+    try {
+      const region = await locateWaveData(handle, stat.size)
+      const hash = crypto.createHash('sha256')
+      hash.update(region ? `pcm|${region.format}|` : 'file|')
+      const start = region?.offset ?? 0
+      const end = region ? region.offset + region.length : stat.size
+      const buffer = Buffer.allocUnsafe(HASH_CHUNK_BYTES)
+      for (let position = start; position < end; ) {
+        const { bytesRead } = await handle.read(buffer, 0, Math.min(buffer.length, end - position), position)
+        if (bytesRead === 0) break
+        hash.update(buffer.subarray(0, bytesRead))
+        position += bytesRead
+      }
+      const digest = hash.digest('hex')
+
+      if (this.digestMemo.size >= MAX_DIGEST_MEMO) {
+        this.digestMemo.delete(this.digestMemo.keys().next().value!)
+      }
+      this.digestMemo.set(filePath, { size: stat.size, mtimeMs: stat.mtimeMs, digest })
+      return digest
+    } finally {
+      await handle.close()
+    }
+  }
+
+  private evict(): void {
+    const entries = this.load()
+    for (const [key, entry] of entries) {
+      if (this.totalBytes <= this.maxBytes) break
+      entries.delete(key)
+      this.totalBytes -= entry.bytes
+      this.evictions++
+    }
+  }
+
+  private load(): Map<string, CacheEntry> {
+    if (this.entries) return this.entries
+    this.entries = new Map()
+    this.totalBytes = 0
+    try {
+      if (fs.existsSync(this.indexPath)) {
+        const raw = JSON.parse(fs.readFileSync(this.indexPath, 'utf-8')) as {
+          version?: number
+          entries?: Array<[string, CacheEntry]>
+        }
+        if (raw.version === CACHE_VERSION && Array.isArray(raw.entries)) {
+          // 按最近使用时间恢复 LRU 顺序
+          const restored = raw.entries.filter(([, entry]) => entry?.result && Number.isFinite(entry.bytes))
+          restored.sort(([, a], [, b]) => a.lastUsedAt - b.lastUsedAt)
+          for (const [key, entry] of restored) {
+            this.entries.set(key, entry)
+            this.totalBytes += entry.bytes
+          }
+          // 上限调小后启动时按新上限淘汰
+          this.evict()
+        }
+      }
+    } catch (error) {
+      logger.warn('读取转写结果缓存失败，忽略旧缓存', { error: String(error) })
+    }
+    return this.entries
+  }
+
+  private serialize(): string {
+    return JSON.stringify({ version: CACHE_VERSION, entries: Array.from(this.load()) })
+  }
+
+  private schedulePersist(): void {
+    if (this.persistTimer) return
+    this.persistTimer = setTimeout(() => {
+      this.persistTimer = null
+      const data = this.serialize()
+      this.persistChain = this.persistChain
+        .then(async () => {
+          await fsPromises.mkdir(path.dirname(this.indexPath), { recursive: true })
+          const tempPath = `${this.indexPath}.tmp`
+          await fsPromises.writeFile(tempPath, data, 'utf-8')
+          await fsPromises.rename(tempPath, this.indexPath)
+        })
+        .catch((error) => {
+          logger.warn('保存转写结果缓存失败', { error: String(error) })
+        })
+    }, PERSIST_DELAY_MS)
+    this.persistTimer.unref()
+  }
+}
+
+/**
+ * 为转写器加上结果缓存：文件转写与批量转写先查缓存，
+ * 实时听写（PCM 直传、流式会话）每次内容都不同，直接透传
+ */
+export function withResultCache(transcriber: Transcriber, cache: TranscriptionResultCache, config: TranscriberConfig): Transcriber {
+  return new CachingTranscriber(transcriber, cache, fingerprintTranscriberConfig(config))
+}
+
+class CachingTranscriber implements Transcriber {
+  transcribePcm?: Transcriber['transcribePcm']
+  startStream?: Transcriber['startStream']
+  transcribeLong?: Transcriber['transcribeLong']
+  transcribeBatch?: Transcriber['transcribeBatch']
+  whenReady?: Transcriber['whenReady']
+  getMemoryUsage?: Transcriber['getMemoryUsage']
+  getQueueStats?: Transcriber['getQueueStats']
+  benchmark?: Transcriber['benchmark']
+  destroy?: Transcriber['destroy']
+
+  constructor(
+    private readonly inner: Transcriber,
+    private readonly cache: TranscriptionResultCache,
+    private readonly fingerprint: string
+  ) {
+    // 可选能力保持与内部转写器一致：调用方按方法是否存在判断支持情况
+    this.transcribePcm = inner.transcribePcm?.bind(inner)
+    this.startStream = inner.startStream?.bind(inner)
+    this.whenReady = inner.whenReady?.bind(inner)
+    this.getMemoryUsage = inner.getMemoryUsage?.bind(inner)
+    this.getQueueStats = inner.getQueueStats?.bind(inner)
+    this.benchmark = inner.benchmark?.bind(inner)
+    this.destroy = inner.destroy?.bind(inner)
+    if (inner.transcribeLong) {
+      this.transcribeLong = (filePath, options) => this.transcribeLongCached(filePath, options)
+    }
+    if (inner.transcribeBatch) {
+      this.transcribeBatch = (filePaths, options) => this.transcribeBatchCached(filePaths, options)
+    }
+  }
+
+  async transcribe(filePath: string, options?: TranscribeOptions): Promise<TranscriptionResult> {
+    const key = await this.tryKey(filePath)
+    if (!key) return this.inner.transcribe(filePath, options)
+    return this.cache.getOrCompute(key, () => this.inner.transcribe(filePath, options))
+  }
+
+  /**
+   * 长音频结果带分段，与整段转写分开缓存；命中时一次性回放全部分段
+   */
+  private async transcribeLongCached(filePath: string, options: LongTranscribeOptions): Promise<TranscriptionResult> {
+    const key = await this.tryKey(filePath, 'long')
+    if (!key) return this.inner.transcribeLong!(filePath, options)
+    const cached = this.cache.get(key)
+    if (cached) {
+      options.onProgress?.({ segments: cached.segments ?? [], processedMs: cached.durationMs, totalMs: cached.durationMs })
+      return cached
+    }
+    const result = await this.inner.transcribeLong!(filePath, options)
+    this.cache.set(key, result)
+    return result
+  }
+
+  /**
+   * 命中的文件直接返回，只把未命中的文件提交给内部转写器批量解码
+   */
+  private async transcribeBatchCached(filePaths: string[], options?: TranscribeOptions): Promise<BatchTranscriptionItem[]> {
+    const keys = await Promise.all(filePaths.map((filePath) => this.tryKey(filePath)))
+    const results = new Map<number, BatchTranscriptionItem>()
+    const missing: number[] = []
+    keys.forEach((key, index) => {
+      const cached = key ? this.cache.get(key) : null
+      if (cached) {
+        results.set(index, { filePath: filePaths[index], result: cached })
+      } else {
+        missing.push(index)
+      }
+    })
+
+    if (missing.length > 0) {
+      const decoded = await this.inner.transcribeBatch!(missing.map((index) => filePaths[index]), options)
+      missing.forEach((index, position) => {
+        const item = decoded[position] ?? { filePath: filePaths[index], error: '批量转写缺少结果' }
+        const key = keys[index]
+        if (key && item.result) {
+          this.cache.set(key, item.result)
+        }
+        results.set(index, item)
+      })
+    }
+    return filePaths.map((_, index) => results.get(index)!)
+  }
+
+  /**
+   * 计算缓存键；文件不可读等情况交给内部转写器报告错误
+   */
+  private async tryKey(filePath: string, mode?: 'long'): Promise<string | null> {
+    try {
+      return await this.cache.keyForFile(filePath, mode ? `${this.fingerprint}|${mode}` : this.fingerprint)
+    } catch (error) {
+      logger.debug('无法计算缓存键，跳过缓存', { filePath, error: String(error) })
+      return null
+    }
+  }
+}
+
+/**
+ * 计算转写配置指纹（键顺序无关）
+ */
+export function fingerprintTranscriberConfig(config: TranscriberConfig): string {
+  const canonical = JSON.stringify(config, (_key, value: unknown) => {
+    if (value && typeof value === 'object' && !Array.isArray(value)) {
+      return Object.fromEntries(Object.entries(value as Record<string, unknown>).sort(([a], [b]) => a.localeCompare(b)))
+    }
+    return value
+  })
+  return crypto.createHash('sha256').update(canonical).digest('hex')
+}
+
+/**
+ * 在 RIFF/WAVE 文件中定位 data 块，返回其位置与采样格式；非 WAV 文件返回 null
+ */
+async function locateWaveData(
+  handle: FileHandle,
+  fileSize: number
+): Promise<{ offset: number; length: number; format: string } | null> {
+  const header = Buffer.alloc(12)
+  if ((await handle.read(header, 0, 12, 0)).bytesRead < 12) return null
+  if (header.toString('ascii', 0, 4) !== 'RIFF' || header.toString('ascii', 8, 12) !== 'WAVE') return null
+
+  let format = 'unknown'
+  const chunkHeader = Buffer.alloc(16)
+  for (let position = 12; position + 8 <= fileSize; ) {
+    await handle.read(chunkHeader, 0, 8, position)
+    const id = chunkHeader.toString('ascii', 0, 4)
+    const size = chunkHeader.readUInt32LE(4)
+    if (id === 'fmt ') {
+      await handle.read(chunkHeader, 0, 16, position + 8)
+      // audioFormat / channels / sampleRate / bitsPerSample
+      format = [
+        chunkHeader.readUInt16LE(0),
+        chunkHeader.readUInt16LE(2),
+        chunkHeader.readUInt32LE(4),
+        chunkHeader.readUInt16LE(14),
+      ].join('/')
+    } else if (id === 'data') {
+      // 录音中断的文件 data 长度可能大于实际内容
+      return { offset: position + 8, length: Math.min(size, fileSize - position - 8), format }
+    }
+    // 块按偶数字节对齐
+    position += 8 + size + (size % 2)
+  }
+  return null
+}
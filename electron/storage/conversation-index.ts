@@ -0,0 +1,401 @@
+/**
+ * 会话索引（只追加）
+ *
+ * 历史列表不再逐个读取 meta.json，而是查询 conversations/.index 下的两个文件：
+ *   records.bin  16 字节文件头 + 定长记录（每条 64 字节）
+ *   strings.bin  字符串堆，存放每条记录的 JSON
+ *
+ * 定长记录（小端）：
+ *   [0, 36)   会话 ID（ASCII，不足补 0）
+ *   [36, 40)  u32 标志位：RECORD_FLAG_DEAD 已删除或被新版本取代，RECORD_FLAG_TEST 测试记录
+ *   [40, 48)  f64 排序时间（finishedAt，缺失时用 startedAt）
+ *   [48, 56)  f64 JSON 在字符串堆中的偏移
+ *   [56, 60)  u32 JSON 字节数
+ *   [60, 64)  保留
+ *
+ * 写入时先追加字符串堆再追加记录，崩溃后只会留下未被引用的堆尾或半条记录，
+ * 打开时截掉即可。更新与删除只改写旧记录的标志位，不移动数据。
+ * 定长记录区在打开时一次读入内存（每千条约 64KB），按时间排序的位置表常驻内存；
+ * 字符串堆按需定位读取，list 只读取当前页的记录。
+ */
+
+import fs from 'node:fs/promises'
+import path from 'node:path'
+import type { ConversationRecord } from '../../shared/conversation'
+
+const MAGIC = 'STCI'
+const VERSION = 1
+const HEADER_BYTES = 16
+const RECORD_BYTES = 64
+const ID_BYTES = 36
+
+const RECORD_FLAG_DEAD = 1
+const RECORD_FLAG_TEST = 2
+
+/** 失效记录超过此数量且多于有效记录时，打开索引时重写 */
+const COMPACT_MIN_DEAD = 256
+
+const RECORDS_FILE = 'records.bin'
+const STRINGS_FILE = 'strings.bin'
+
+interface IndexEntry {
+  slot: number
+  id: string
+  flags: number
+  sortKey: number
+  heapOffset: number
+  heapLength: number
+}
+
+export interface IndexListOptions {
+  limit: number
+  offset: number
+  excludeTest: boolean
+}
+
+function sortKeyOf(record: ConversationRecord): number {
+  return record.finishedAt || record.startedAt || 0
+}
+
+/**
+ * 在按时间倒序的位置表中查找插入点（同一时间的新记录排在后面）
+ */
+function insertionPoint(order: IndexEntry[], sortKey: number): number {
+  let low = 0
+  let high = order.length
+  while (low < high) {
+    const mid = (low + high) >>> 1
+    if (order[mid].sortKey >= sortKey) low = mid + 1
+    else high = mid
+  }
+  return low
+}
+
+/**
+ * 按时间倒序排列，同一时间按写入顺序（与 insertionPoint 一致）
+ */
+function compareOrder(a: IndexEntry, b: IndexEntry): number {
+  return b.sortKey - a.sortKey || a.slot - b.slot
+}
+
+function removeFromOrder(order: IndexEntry[], entry: IndexEntry): void {
+  const index = order.indexOf(entry)
+  if (index >= 0) order.splice(index, 1)
+}
+
+export class ConversationIndex {
+  private readonly recordsPath: string
+  private readonly stringsPath: string
+  private entries: IndexEntry[] = []
+  /** 有效记录（含测试记录），按时间倒序 */
+  private ordered: IndexEntry[] = []
+  /** 有效的非测试记录，按时间倒序 */
+  private visible: IndexEntry[] = []
+  private byId = new Map<string, IndexEntry>()
+  private heapBytes = 0
+  private deadCount = 0
+
+  constructor(private readonly dir: string) {
+    this.recordsPath = path.join(dir, RECORDS_FILE)
+    this.stringsPath = path.join(dir, STRINGS_FILE)
+  }
+
+  get size(): number {
+    return this.byId.size
+  }
+
+  has(id: string): boolean {
+    return this.byId.has(id)
+  }
+
+  ids(excludeTest = false): string[] {
+    return (excludeTest ? this.visible : this.ordered).map((entry) => entry.id)
+  }
+
+  /**
+   * 加载索引；文件不存在或格式不符时返回 false，由调用方重建
+   */
+  async load(): Promise<boolean> {
+    let records: Buffer
+    let heapBytes: number
+    try {
+      records = await fs.readFile(this.recordsPath)
+      heapBytes = (await fs.stat(this.stringsPath)).size
+    } catch (error) {
+      if ((error as NodeJS.ErrnoException).code === 'ENOENT') return false
+      throw error
+    }
+    if (
+      records.length < HEADER_BYTES ||
+      records.toString('ascii', 0, 4) !== MAGIC ||
+      records.readUInt32LE(4) !== VERSION
+    ) {
+      return false
+    }
+
+    this.reset()
+    const count = Math.floor((records.length - HEADER_BYTES) / RECORD_BYTES)
+    let validCount = count
+    let validHeapBytes = 0
+    for (let slot = 0; slot < count; slot++) {
+      const entry = this.decodeEntry(records, slot)
+      // 引用了堆外数据的记录说明写入中断，之后的记录一并丢弃
+      if (entry.heapOffset + entry.heapLength > heapBytes) {
+        validCount = slot
+        break
+      }
+      validHeapBytes = Math.max(validHeapBytes, entry.heapOffset + entry.heapLength)
+      this.trackEntry(entry)
+    }
+    this.sortOrder()
+
+    // 截掉半条记录或未被引用的堆尾
+    const validRecordBytes = HEADER_BYTES + validCount * RECORD_BYTES
+    if (validRecordBytes !== records.length) {
+      await fs.truncate(this.recordsPath, validRecordBytes)
+    }
+    if (validHeapBytes !== heapBytes) {
+      await fs.truncate(this.stringsPath, validHeapBytes)
+    }
+    this.heapBytes = validHeapBytes
+
+    if (this.deadCount >= COMPACT_MIN_DEAD && this.deadCount > this.byId.size) {
+      await this.compact()
+    }
+    return true
+  }
+
+  /**
+   * 按时间倒序分页读取，只读取当前页的 JSON
+   */
+  async list(options: IndexListOptions): Promise<ConversationRecord[]> {
+    const order = options.excludeTest ? this.visible : this.ordered
+    return this.readEntries(order.slice(options.offset, options.offset + options.limit))
+  }
+
+  /**
+   * 按 ID 读取记录，顺序与输入一致，不存在的 ID 跳过
+   */
+  async get(ids: string[]): Promise<ConversationRecord[]> {
+    const entries = ids.map((id) => this.byId.get(id)).filter((entry): entry is IndexEntry => Boolean(entry))
+    return this.readEntries(entries)
+  }
+
+  /**
+   * 读取全部有效记录（按时间倒序）
+   */
+  async readAll(): Promise<ConversationRecord[]> {
+    return this.readEntries([...this.ordered])
+  }
+
+  /**
+   * 追加或更新记录；旧版本标记为失效
+   */
+  async upsert(record: ConversationRecord): Promise<void> {
+    const json = Buffer.from(JSON.stringify(record), 'utf8')
+    const heapOffset = this.heapBytes
+    await fs.appendFile(this.stringsPath, json)
+    this.heapBytes += json.length
+
+    const previous = this.byId.get(record.id)
+    const entry: IndexEntry = {
+      slot: this.entries.length,
+      id: record.id,
+      flags: record.test ? RECORD_FLAG_TEST : 0,
+      sortKey: sortKeyOf(record),
+      heapOffset,
+      heapLength: json.length,
+    }
+    await fs.appendFile(this.recordsPath, this.encodeEntry(entry))
+    if (previous) {
+      await this.markDead(previous)
+    }
+    this.addEntry(entry)
+  }
+
+  /**
+   * 将记录标记为已删除
+   */
+  async remove(ids: Iterable<string>): Promise<void> {
+    const entries: IndexEntry[] = []
+    for (const id of ids) {
+      const entry = this.byId.get(id)
+      if (entry) entries.push(entry)
+    }
+    if (entries.length === 0) return
+
+    const file = await fs.open(this.recordsPath, 'r+')
+    try {
+      for (const entry of entries) {
+        await this.writeDeadFlag(file, entry)
+      }
+    } finally {
+      await file.close()
+    }
+  }
+
+  /**
+   * 用给定记录重写整个索引（恢复路径）
+   */
+  async rebuild(records: ConversationRecord[]): Promise<void> {
+    await fs.mkdir(this.dir, { recursive: true })
+    this.reset()
+
+    // 按时间正序写入，使文件顺序与追加顺序一致
+    const sorted = [...records].sort((a, b) => sortKeyOf(a) - sortKeyOf(b))
+    const heapParts: Buffer[] = []
+    const recordParts: Buffer[] = [this.createHeader()]
+    for (const record of sorted) {
+      const json = Buffer.from(JSON.stringify(record), 'utf8')
+      const entry: IndexEntry = {
+        slot: this.entries.length,
+        id: record.id,
+        flags: record.test ? RECORD_FLAG_TEST : 0,
+        sortKey: sortKeyOf(record),
+        heapOffset: this.heapBytes,
+        heapLength: json.length,
+      }
+      heapParts.push(json)
+      recordParts.push(this.encodeEntry(entry))
+      this.heapBytes += json.length
+      this.trackEntry(entry)
+    }
+    this.sortOrder()
+
+    // 先写临时文件；替换前删除旧记录文件，中途崩溃时下次打开会重新构建
+    await fs.writeFile(`${this.stringsPath}.tmp`, Buffer.concat(heapParts))
+    await fs.writeFile(`${this.recordsPath}.tmp`, Buffer.concat(recordParts))
+    await fs.rm(this.recordsPath, { force: true })
+    await fs.rename(`${this.stringsPath}.tmp`, this.stringsPath)
+    await fs.rename(`${this.recordsPath}.tmp`, this.recordsPath)
+  }
+
+  /**
+   * 丢弃失效记录，重写索引
+   */
+  private async compact(): Promise<void> {
+    await this.rebuild(await this.readAll())
+  }
+
+  private async readEntries(entries: IndexEntry[]): Promise<ConversationRecord[]> {
+    if (entries.length === 0) return []
+    const file = await fs.open(this.stringsPath, 'r')
+    try {
+      return await Promise.all(entries.map((entry) => this.readRecord(file, entry)))
+    } finally {
+      await file.close()
+    }
+  }
+
+  private async readRecord(file: fs.FileHandle, entry: IndexEntry): Promise<ConversationRecord> {
+    const buffer = Buffer.alloc(entry.heapLength)
+    await file.read(buffer, 0, entry.heapLength, entry.heapOffset)
+    return JSON.parse(buffer.toString('utf8')) as ConversationRecord
+  }
+
+  private async markDead(entry: IndexEntry): Promise<void> {
+    const file = await fs.open(this.recordsPath, 'r+')
+    try {
+      await this.writeDeadFlag(file, entry)
+    } finally {
+      await file.close()
+    }
+  }
+
+  private async writeDeadFlag(file: fs.FileHandle, entry: IndexEntry): Promise<void> {
+    entry.flags |= RECORD_FLAG_DEAD
+    const flags = Buffer.alloc(4)
+    flags.writeUInt32LE(entry.flags, 0)
+    await file.write(flags, 0, 4, HEADER_BYTES + entry.slot * RECORD_BYTES + ID_BYTES)
+
+    if (this.byId.get(entry.id) === entry) {
+      this.byId.delete(entry.id)
+    }
+    removeFromOrder(this.ordered, entry)
+    if (!(entry.flags & RECORD_FLAG_TEST)) {
+      removeFromOrder(this.visible, entry)
+    }
+    this.deadCount++
+  }
+
+  /**
+   * 增量追加一条记录，按二分查找插入位置表
+   */
+  private addEntry(entry: IndexEntry): void {
+    const previous = this.byId.get(entry.id)
+    if (!this.trackEntry(entry)) return
+    if (previous) {
+      removeFromOrder(this.ordered, previous)
+      removeFromOrder(this.visible, previous)
+    }
+    this.ordered.splice(insertionPoint(this.ordered, entry.sortKey), 0, entry)
+    if (!(entry.flags & RECORD_FLAG_TEST)) {
+      this.visible.splice(insertionPoint(this.visible, entry.sortKey), 0, entry)
+    }
+  }
+
+  /**
+   * 登记记录但不更新位置表；批量加载后由 sortOrder() 一次排序
+   * @returns 记录是否有效
+   */
+  private trackEntry(entry: IndexEntry): boolean {
+    this.entries.push(entry)
+    if (entry.flags & RECORD_FLAG_DEAD) {
+      this.deadCount++
+      return false
+    }
+    // 文件中同一 ID 的后一条记录为准（标志位写入前崩溃时可能同时存在两条有效记录）
+    const previous = this.byId.get(entry.id)
+    if (previous) {
+      previous.flags |= RECORD_FLAG_DEAD
+      this.deadCount++
+    }
+    this.byId.set(entry.id, entry)
+    return true
+  }
+
+  private sortOrder(): void {
+    this.ordered = [...this.byId.values()].sort(compareOrder)
+    this.visible = this.ordered.filter((entry) => !(entry.flags & RECORD_FLAG_TEST))
+  }
+
+  private decodeEntry(records: Buffer, slot: number): IndexEntry {
+    const base = HEADER_BYTES + slot * RECORD_BYTES
+    const idEnd = records.indexOf(0, base)
+    return {
+      slot,
+      id: records.toString('ascii', base, idEnd >= base && idEnd < base + ID_BYTES ? idEnd : base + ID_BYTES),
+      flags: records.readUInt32LE(base + ID_BYTES),
+      sortKey: records.readDoubleLE(base + 40),
+      heapOffset: records.readDoubleLE(base + 48),
+      heapLength: records.readUInt32LE(base + 56),
+    }
+  }
+
+  private encodeEntry(entry: IndexEntry): Buffer {
+    const buffer = Buffer.alloc(RECORD_BYTES)
+    buffer.write(entry.id, 0, ID_BYTES, 'ascii')
+    buffer.writeUInt32LE(entry.flags, ID_BYTES)
+    buffer.writeDoubleLE(entry.sortKey, 40)
+    buffer.writeDoubleLE(entry.heapOffset, 48)
+    buffer.writeUInt32LE(entry.heapLength, 56)
+    return buffer
+  }
+
+  private createHeader(): Buffer {
+    const header = Buffer.alloc(HEADER_BYTES)
+    header.write(MAGIC, 0, 'ascii')
+    header.writeUInt32LE(VERSION, 4)
+    return header
+  }
+
+  private reset(): void {
+    this.entries = []
+    this.ordered = []
+    this.visible = []
+    this.byId = new Map()
+    this.heapBytes = 0
+    this.deadCount = 0
+  }
+}
+
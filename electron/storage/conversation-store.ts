@@ -1,13 +1,29 @@
 import fs from 'node:fs/promises'
 import path from 'node:path'
-import type { ConversationRecord } from '../../shared/conversation'
+import type { ConversationRecord, HistorySearchResult, UsageAnalytics, UsageAnalyticsOptions } from '../../shared/conversation'
 import { createModuleLogger } from '../utils/logger'
+import { ConversationIndex } from './conversation-index'
+import { TranscriptSearchIndex, type SearchDocument } from './transcript-search'
+import { SessionJournal } from './session-journal'
+import { SessionPackStore, type PackCompactResult } from './session-pack'
+import { UsageColumns } from './usage-columns'
 
 const logger = createModuleLogger('conversation-store')
 
 /** UUID 格式正则表达式 */
 const UUID_PATTERN = /^[a-f0-9]{8}-[a-f0-9]{4}-[a-f0-9]{4}-[a-f0-9]{4}-[a-f0-9]{12}$/i
 
+/** 索引目录名（非 UUID，不会被当作会话目录） */
+const INDEX_DIR_NAME = '.index'
+/** 打包存储目录名 */
+const PACK_DIR_NAME = '.packs'
+/** 播放已打包音频时导出的临时 WAV 目录 */
+const EXPORT_DIR_NAME = '.export'
+const AUDIO_FILE_NAME = 'audio.wav'
+
+/** 会话结束超过此时间后才打包（录音归档在后台写入，留出余量） */
+const SEAL_DELAY_MS = 60 * 1000
+
 /**
  * 判断是否为预期的文件读取错误（文件不存在或JSON解析失败）
  */
@@ -17,14 +33,119 @@ function isExpectedMetaError(error: unknown): boolean {
   return false
 }
 
+async function fileExists(filePath: string): Promise<boolean> {
+  try {
+    await fs.access(filePath)
+    return true
+  } catch {
+    return false
+  }
+}
+
+/**
+ * 目录占用字节数（不递归）；目录不存在时返回 null
+ */
+async function directorySize(dir: string): Promise<number | null> {
+  let files: string[]
+  try {
+    files = await fs.readdir(dir)
+  } catch (error) {
+    if ((error as NodeJS.ErrnoException).code === 'ENOENT') return null
+    throw error
+  }
+  let size = 0
+  for (const file of files) {
+    size += (await fs.stat(path.join(dir, file))).size
+  }
+  return size
+}
+
 export interface ListOptions {
   limit?: number
   offset?: number
   excludeTest?: boolean
 }
 
+/** 会话的存储占用（保留策略据此选择要清理的会话） */
+export interface SessionUsage {
+  id: string
+  sortKey: number
+  /** 音频占用字节数，没有音频时为 0 */
+  audioBytes: number
+}
+
+export interface SearchOptions {
+  limit?: number
+  offset?: number
+}
+
+function sortKeyOf(record: ConversationRecord): number {
+  return record.finishedAt || record.startedAt || 0
+}
+
+function toSearchDocument(record: ConversationRecord): SearchDocument {
+  return {
+    id: record.id,
+    sortKey: sortKeyOf(record),
+    text: record.transcript ?? '',
+  }
+}
+
 export class ConversationStore {
-  constructor(private readonly baseDir: string) {}
+  private readonly index: ConversationIndex
+  /** 转写全文检索（不含测试记录） */
+  private readonly searchIndex: TranscriptSearchIndex
+  /** 使用统计列存储（不含测试记录） */
+  private readonly usage: UsageColumns
+  /** 听写结果的预写日志，写入 meta.json 不阻塞文本插入 */
+  private readonly journal: SessionJournal
+  /** 已结束会话的打包存储；会话目录只在录音与写入记录期间使用 */
+  private readonly packs: SessionPackStore
+  /** 索引加载结果；加载失败后置空，下次访问时重试 */
+  private indexReady: Promise<void> | null = null
+  /** 索引的读写依次执行，避免并发追加交错 */
+  private indexQueue: Promise<unknown> = Promise.resolve()
+  /** 会话目录的写入、打包与删除依次执行，避免打包时目录被改写或删除 */
+  private writeQueue: Promise<unknown> = Promise.resolve()
+  private maintenanceTimer: NodeJS.Timeout | null = null
+
+  constructor(private readonly baseDir: string) {
+    this.index = new ConversationIndex(path.join(baseDir, INDEX_DIR_NAME))
+    this.searchIndex = new TranscriptSearchIndex(path.join(baseDir, INDEX_DIR_NAME))
+    this.usage = new UsageColumns(path.join(baseDir, INDEX_DIR_NAME, 'usage'))
+    this.packs = new SessionPackStore(path.join(baseDir, PACK_DIR_NAME))
+    this.journal = new SessionJournal(path.join(baseDir, INDEX_DIR_NAME, 'journal.log'), async (record) => {
+      await this.save(record)
+    })
+  }
+
+  /**
+   * 追加会话记录，立即返回；记录先写入预写日志，再在后台写入 meta.json 与索引
+   * @returns 记录写入日志并落盘后完成
+   */
+  enqueue(record: ConversationRecord): Promise<void> {
+    try {
+      this.validateRecord(record)
+    } catch (error) {
+      return Promise.reject(error)
+    }
+    return this.journal.append(record)
+  }
+
+  /**
+   * 重放上次退出前未写完的会话记录（启动时调用）
+   * 重放完成前，新记录的提交与读取操作都会等待
+   */
+  recover(): Promise<number> {
+    return this.journal.recover()
+  }
+
+  /**
+   * 同步写入尚未提交的记录（应用退出时调用）
+   */
+  flushSync(): void {
+    this.journal.flushSync()
+  }
 
   /**
    * 获取历史记录列表
@@ -33,9 +154,233 @@ export class ConversationStore {
    */
   async list(options: ListOptions = {}): Promise<ConversationRecord[]> {
     const { limit = 50, offset = 0, excludeTest = true } = options
+    await this.journal.drain()
+    try {
+      return await this.withIndex(() => this.index.list({ limit, offset, excludeTest }))
+    } catch (error) {
+      logger.warn('会话索引不可用，改为扫描目录', {
+        error: error instanceof Error ? error.message : String(error),
+      })
+      this.indexReady = null
+      const records = await this.scanRecords(excludeTest)
+      return records.slice(offset, offset + limit)
+    }
+  }
+
+  /**
+   * 全文检索转写内容
+   * @returns 按时间倒序的匹配记录与匹配总数
+   */
+  async search(query: string, options: SearchOptions = {}): Promise<HistorySearchResult> {
+    const { limit = 50, offset = 0 } = options
+    await this.journal.drain()
+    return this.withIndex(async () => {
+      const startedAt = performance.now()
+      const result = this.searchIndex.search(query, { limit, offset })
+      const elapsedMs = performance.now() - startedAt
+      const records = await this.index.get(result.ids)
+      return { records, total: result.total, elapsedMs }
+    })
+  }
+
+  /**
+   * 汇总使用统计：只扫描列存储，不读取会话记录
+   */
+  async getUsageAnalytics(options: UsageAnalyticsOptions = {}): Promise<UsageAnalytics> {
+    await this.journal.drain()
+    return this.withIndex(async () => this.usage.aggregate(options))
+  }
+
+  /**
+   * 从会话目录与打包存储重建索引（索引损坏或与目录不一致时使用）
+   */
+  async rebuildIndex(): Promise<number> {
+    await this.journal.drain()
+    return this.withIndex(async () => {
+      const records = (await this.scanRecords(false)).filter((record) => UUID_PATTERN.test(record.id))
+      await this.index.rebuild(records)
+      const visible = records.filter((record) => !record.test)
+      await this.searchIndex.rebuild(visible.map(toSearchDocument))
+      await this.usage.rebuild(visible)
+      logger.info('会话索引已重建', { count: records.length })
+      return records.length
+    })
+  }
+
+  /**
+   * 在索引队列中执行操作，首次调用时加载索引
+   */
+  private withIndex<T>(operation: () => Promise<T>): Promise<T> {
+    const run = async () => {
+      if (!this.indexReady) {
+        this.indexReady = this.openIndex()
+      }
+      try {
+        await this.indexReady
+      } catch (error) {
+        this.indexReady = null
+        throw error
+      }
+      return operation()
+    }
+    const result = this.indexQueue.then(run, run)
+    this.indexQueue = result.catch(() => undefined)
+    return result
+  }
+
+  /**
+   * 加载索引并与会话目录、打包存储对账：
+   * 已不存在的会话标记删除，索引中缺失的会话（写索引前崩溃）补读其记录
+   */
+  private async openIndex(): Promise<void> {
+    const startedAt = Date.now()
+    const loaded = await this.index.load()
+    const sessionIds = await this.listSessionIds()
+    await fs.rm(path.join(this.baseDir, EXPORT_DIR_NAME), { recursive: true, force: true })
+    this.scheduleMaintenance()
+
+    if (!loaded) {
+      const records = (await this.scanRecords(false)).filter((record) => UUID_PATTERN.test(record.id))
+      await this.index.rebuild(records)
+      const visible = records.filter((record) => !record.test)
+      await this.searchIndex.rebuild(visible.map(toSearchDocument))
+      await this.usage.rebuild(visible)
+      logger.info('会话索引已从目录构建', { count: records.length, elapsedMs: Date.now() - startedAt })
+      return
+    }
+
+    const present = new Set(sessionIds)
+    const stale = this.index.ids().filter((id) => !present.has(id))
+    await this.index.remove(stale)
+
+    let recovered = 0
+    for (const sessionId of sessionIds) {
+      if (this.index.has(sessionId)) continue
+      const record = await this.readRecord(sessionId)
+      if (record && record.id === sessionId) {
+        await this.index.upsert(record)
+        recovered++
+      }
+    }
+    if (stale.length > 0 || recovered > 0) {
+      logger.info('会话索引已与目录对账', { stale: stale.length, recovered })
+    }
+    await this.openSearchIndex()
+    await this.openUsage()
+  }
+
+  /**
+   * 加载全文索引并与会话索引对账；快照缺失或损坏时从会话索引重建
+   */
+  private async openSearchIndex(): Promise<void> {
+    const startedAt = Date.now()
+    if (!(await this.searchIndex.load())) {
+      const records = (await this.index.readAll()).filter((record) => !record.test)
+      await this.searchIndex.rebuild(records.map(toSearchDocument))
+      logger.info('全文索引已重建', { count: records.length, elapsedMs: Date.now() - startedAt })
+      return
+    }
+
+    const visibleIds = this.index.ids(true)
+    const visible = new Set(visibleIds)
+    const stale = this.searchIndex.ids().filter((id) => !visible.has(id))
+    await this.searchIndex.remove(stale)
+    const missing = visibleIds.filter((id) => !this.searchIndex.has(id))
+    for (const record of await this.index.get(missing)) {
+      await this.searchIndex.upsert(toSearchDocument(record))
+    }
+    if (stale.length > 0 || missing.length > 0) {
+      logger.info('全文索引已对账', { stale: stale.length, missing: missing.length })
+    }
+  }
+
+  /**
+   * 加载使用统计列并与会话索引对账；列文件缺失或损坏时从会话索引重建
+   */
+  private async openUsage(): Promise<void> {
+    const startedAt = Date.now()
+    if (!(await this.usage.load())) {
+      const records = (await this.index.readAll()).filter((record) => !record.test)
+      await this.usage.rebuild(records)
+      logger.info('使用统计已重建', { count: records.length, elapsedMs: Date.now() - startedAt })
+      return
+    }
+
+    const visibleIds = this.index.ids(true)
+    const visible = new Set(visibleIds)
+    const stale = this.usage.ids().filter((id) => !visible.has(id))
+    await this.usage.remove(stale)
+    const missing = visibleIds.filter((id) => !this.usage.has(id))
+    for (const record of await this.index.get(missing)) {
+      await this.usage.upsert(record)
+    }
+    if (stale.length > 0 || missing.length > 0) {
+      logger.info('使用统计已对账', { stale: stale.length, missing: missing.length })
+    }
+  }
+
+  /**
+   * 全部会话 ID：会话目录与已打包的会话
+   */
+  private async listSessionIds(): Promise<string[]> {
+    await this.packs.open()
+    const ids = new Set(await this.listSessionDirs())
+    for (const id of this.packs.ids()) ids.add(id)
+    return [...ids]
+  }
+
+  private async listSessionDirs(): Promise<string[]> {
+    try {
+      const entries = await fs.readdir(this.baseDir, { withFileTypes: true })
+      return entries.filter((entry) => entry.isDirectory() && UUID_PATTERN.test(entry.name)).map((entry) => entry.name)
+    } catch (error) {
+      if ((error as NodeJS.ErrnoException).code === 'ENOENT') return []
+      throw error
+    }
+  }
+
+  /**
+   * 读取会话记录：优先会话目录中的 meta.json，其次打包存储
+   */
+  private async readRecord(sessionId: string): Promise<ConversationRecord | null> {
+    const record = await this.readMeta(sessionId)
+    if (record) return record
+    await this.packs.open()
+    try {
+      return await this.packs.readRecord(sessionId)
+    } catch (error) {
+      logger.warn('读取打包记录失败', {
+        sessionId,
+        error: error instanceof Error ? error.message : String(error),
+      })
+      return null
+    }
+  }
+
+  private async readMeta(sessionId: string): Promise<ConversationRecord | null> {
+    try {
+      const metaContent = await fs.readFile(path.join(this.baseDir, sessionId, 'meta.json'), 'utf-8')
+      return JSON.parse(metaContent) as ConversationRecord
+    } catch (error) {
+      if (!isExpectedMetaError(error)) {
+        logger.warn('读取会话元数据失败', {
+          sessionId,
+          error: error instanceof Error ? error.message : String(error),
+        })
+      }
+      return null
+    }
+  }
+
+  /**
+   * 扫描全部会话目录与打包存储读取记录（索引重建与回退路径）
+   * @returns 按时间倒序排列的会话记录列表
+   */
+  private async scanRecords(excludeTest: boolean): Promise<ConversationRecord[]> {
     const records: ConversationRecord[] = []
 
     try {
+      await this.packs.open()
       const entries = await fs.readdir(this.baseDir, { withFileTypes: true })
 
       // 读取所有有效的会话记录
@@ -63,11 +408,17 @@ export class ConversationStore {
         }
       }
 
+      // 目录中的记录较新（尚未打包或正在更新），同一会话以目录为准
+      const seen = new Set(records.map((record) => record.id))
+      for (const record of await this.packs.readAllRecords()) {
+        if (seen.has(record.id)) continue
+        if (excludeTest && record.test) continue
+        records.push(record)
+      }
+
       // 按 finishedAt 倒序排列（最新的在前）
       records.sort((a, b) => (b.finishedAt || b.startedAt) - (a.finishedAt || a.startedAt))
-
-      // 应用分页
-      return records.slice(offset, offset + limit)
+      return records
     } catch (error) {
       if ((error as NodeJS.ErrnoException).code === 'ENOENT') {
         return []
@@ -87,16 +438,68 @@ export class ConversationStore {
       return null
     }
 
+    await this.journal.whenRecovered()
+    const pending = this.journal.peek(sessionId)
+    if (pending) {
+      return pending
+    }
+
     try {
       const metaPath = path.join(this.baseDir, sessionId, 'meta.json')
       const metaContent = await fs.readFile(metaPath, 'utf-8')
       return JSON.parse(metaContent) as ConversationRecord
     } catch (error) {
-      if (isExpectedMetaError(error)) {
-        return null
+      if (!isExpectedMetaError(error)) {
+        throw error
       }
-      throw error
     }
+    await this.packs.open()
+    return this.packs.readRecord(sessionId)
+  }
+
+  /**
+   * 获取可直接播放的音频文件路径；已打包的音频导出为临时 WAV
+   * @returns 会话没有音频时返回 null
+   */
+  async resolveAudioPath(sessionId: string): Promise<string | null> {
+    const record = await this.get(sessionId)
+    if (!record) return null
+    if (record.audioPath && (await fileExists(record.audioPath))) {
+      return record.audioPath
+    }
+    await this.packs.open()
+    if (!this.packs.hasAudio(sessionId)) return null
+    const cachePath = this.exportedAudioPath(sessionId)
+    if (await fileExists(cachePath)) return cachePath
+    return (await this.packs.exportAudio(sessionId, cachePath)) ? cachePath : null
+  }
+
+  private exportedAudioPath(sessionId: string): string {
+    return path.join(this.baseDir, EXPORT_DIR_NAME, `${sessionId}.wav`)
+  }
+
+  /**
+   * 删除 resolveAudioPath 导出的临时 WAV；会话或音频删除后不应再留在磁盘上
+   */
+  private async removeExportedAudio(sessionIds: string[]): Promise<void> {
+    for (const sessionId of sessionIds) {
+      await fs.rm(this.exportedAudioPath(sessionId), { force: true })
+    }
+  }
+
+  /**
+   * 把会话音频导出为普通 WAV 文件
+   * @returns 会话没有音频时返回 false
+   */
+  async exportAudio(sessionId: string, destPath: string): Promise<boolean> {
+    const record = await this.get(sessionId)
+    if (!record) return false
+    if (record.audioPath && (await fileExists(record.audioPath))) {
+      await fs.copyFile(record.audioPath, destPath)
+      return true
+    }
+    await this.packs.open()
+    return this.packs.exportAudio(sessionId, destPath)
   }
 
   /**
@@ -111,9 +514,22 @@ export class ConversationStore {
       return false
     }
 
+    // 等待排队中的记录写完，避免删除后又被写回
+    await this.journal.drain()
     try {
       const sessionDir = path.join(this.baseDir, sessionId)
-      await fs.rm(sessionDir, { recursive: true, force: true })
+      await this.serializeWrite(async () => {
+        await fs.rm(sessionDir, { recursive: true, force: true })
+        await this.packs.open()
+        await this.packs.remove([sessionId])
+        await this.removeExportedAudio([sessionId])
+      })
+      this.scheduleMaintenance()
+      await this.updateIndex('delete', async () => {
+        await this.index.remove([sessionId])
+        await this.searchIndex.remove([sessionId])
+        await this.usage.remove([sessionId])
+      })
       logger.info('会话已删除', { sessionId })
       return true
     } catch (error) {
@@ -129,6 +545,103 @@ export class ConversationStore {
   }
 
   async save(record: ConversationRecord) {
+    this.validateRecord(record)
+
+    const sessionDir = path.join(this.baseDir, record.id)
+    const metaPath = path.join(sessionDir, 'meta.json')
+    await this.serializeWrite(async () => {
+      // 已打包的会话直接追加新记录，不再重建目录
+      await this.packs.open()
+      if (this.packs.has(record.id) && !(await fileExists(sessionDir))) {
+        await this.packs.writeRecord(record)
+        return
+      }
+      await fs.mkdir(sessionDir, { recursive: true })
+      await fs.writeFile(metaPath, JSON.stringify(record, null, 2), 'utf-8')
+    })
+    // 列表只包含 UUID 目录下的会话，索引同样只收录这些记录
+    if (UUID_PATTERN.test(record.id)) {
+      await this.updateIndex('save', async () => {
+        await this.index.upsert(record)
+        if (record.test) {
+          await this.searchIndex.remove([record.id])
+          await this.usage.remove([record.id])
+        } else {
+          await this.searchIndex.upsert(toSearchDocument(record))
+          await this.usage.upsert(record)
+        }
+      })
+    }
+    this.scheduleMaintenance()
+    return metaPath
+  }
+
+  /**
+   * 依次执行会话目录与打包存储的写操作
+   */
+  private serializeWrite<T>(operation: () => Promise<T>): Promise<T> {
+    const result = this.writeQueue.then(operation)
+    this.writeQueue = result.catch(() => undefined)
+    return result
+  }
+
+  /**
+   * 安排后台维护（打包已结束的会话、压缩打包段），多次调用只执行一次
+   */
+  private scheduleMaintenance(): void {
+    if (this.maintenanceTimer) return
+    this.maintenanceTimer = setTimeout(() => {
+      this.maintenanceTimer = null
+      this.runMaintenance().catch((error) => {
+        logger.warn('会话打包失败', { error: error instanceof Error ? error.message : String(error) })
+      })
+    }, SEAL_DELAY_MS)
+    this.maintenanceTimer.unref?.()
+  }
+
+  private async runMaintenance(): Promise<void> {
+    await this.journal.whenRecovered()
+    const { sealed, deferred } = await this.sealSessions()
+    if (sealed > 0) {
+      logger.info('会话已打包', { sealed })
+    }
+    await this.packs.compact()
+    // 还有刚结束的会话，稍后再打包
+    if (deferred > 0) {
+      this.scheduleMaintenance()
+    }
+  }
+
+  /**
+   * 把结束超过 SEAL_DELAY_MS 的会话目录写入打包存储并删除目录
+   * 没有 meta.json 的目录（正在录音或写入中断）保持不动
+   */
+  private async sealSessions(): Promise<{ sealed: number; deferred: number }> {
+    const cutoff = Date.now() - SEAL_DELAY_MS
+    let sealed = 0
+    let deferred = 0
+    await this.packs.open()
+    for (const sessionId of await this.listSessionDirs()) {
+      if (this.journal.peek(sessionId)) {
+        deferred++
+        continue
+      }
+      const result = await this.serializeWrite(async () => {
+        const record = await this.readMeta(sessionId)
+        if (!record || record.id !== sessionId) return 'skipped'
+        if (sortKeyOf(record) > cutoff) return 'deferred'
+        const sessionDir = path.join(this.baseDir, sessionId)
+        await this.packs.add(record, path.join(sessionDir, AUDIO_FILE_NAME))
+        await fs.rm(sessionDir, { recursive: true, force: true })
+        return 'sealed'
+      })
+      if (result === 'sealed') sealed++
+      else if (result === 'deferred') deferred++
+    }
+    return { sealed, deferred }
+  }
+
+  private validateRecord(record: ConversationRecord): void {
     // 输入验证
     if (!record) {
       throw new Error('记录不能为空')
@@ -142,12 +655,137 @@ export class ConversationStore {
     if (sanitizedId !== record.id) {
       throw new Error('会话ID包含非法字符：只能包含字母、数字、下划线和连字符')
     }
+  }
 
-    const sessionDir = path.join(this.baseDir, sanitizedId)
-    await fs.mkdir(sessionDir, { recursive: true })
-    const metaPath = path.join(sessionDir, 'meta.json')
-    await fs.writeFile(metaPath, JSON.stringify(record, null, 2), 'utf-8')
-    return metaPath
+  /**
+   * 更新索引；meta.json 是权威数据，索引失败只记录日志，下次打开时对账修复
+   */
+  private async updateIndex(context: string, operation: () => Promise<void>): Promise<void> {
+    try {
+      await this.withIndex(operation)
+    } catch (error) {
+      this.indexReady = null
+      logger.warn('更新会话索引失败', {
+        context,
+        error: error instanceof Error ? error.message : String(error),
+      })
+    }
+  }
+
+  /**
+   * 列出全部已结束会话的时间与音频占用；没有 meta.json 的目录（正在录音）不计入
+   */
+  async listUsage(): Promise<SessionUsage[]> {
+    await this.journal.drain()
+    await this.packs.open()
+    const usage = new Map<string, SessionUsage>()
+    for (const info of this.packs.list()) {
+      usage.set(info.id, { id: info.id, sortKey: info.sortKey, audioBytes: info.audioBytes })
+    }
+    for (const sessionId of await this.listSessionDirs()) {
+      const record = await this.readMeta(sessionId)
+      if (!record || record.id !== sessionId) continue
+      let audioBytes = 0
+      try {
+        audioBytes = (await fs.stat(path.join(this.baseDir, sessionId, AUDIO_FILE_NAME))).size
+      } catch (error) {
+        if ((error as NodeJS.ErrnoException).code !== 'ENOENT') throw error
+      }
+      usage.set(sessionId, { id: sessionId, sortKey: sortKeyOf(record), audioBytes })
+    }
+    return [...usage.values()]
+  }
+
+  /**
+   * 批量删除会话；索引在一次队列操作中更新
+   * @returns 删除的会话数与会话目录释放的字节数（打包数据在压缩后才释放）
+   */
+  async deleteMany(sessionIds: string[]): Promise<{ deleted: number; reclaimedBytes: number }> {
+    const ids = sessionIds.filter((id) => UUID_PATTERN.test(id))
+    if (ids.length === 0) return { deleted: 0, reclaimedBytes: 0 }
+    await this.journal.drain()
+
+    let deleted = 0
+    let reclaimedBytes = 0
+    await this.serializeWrite(async () => {
+      await this.packs.open()
+      for (const sessionId of ids) {
+        const sessionDir = path.join(this.baseDir, sessionId)
+        const size = await directorySize(sessionDir)
+        if (size === null) continue
+        await fs.rm(sessionDir, { recursive: true, force: true })
+        reclaimedBytes += size
+        deleted++
+      }
+      deleted += await this.packs.remove(ids)
+      await this.removeExportedAudio(ids)
+    })
+    await this.updateIndex('deleteMany', async () => {
+      await this.index.remove(ids)
+      await this.searchIndex.remove(ids)
+      await this.usage.remove(ids)
+    })
+    this.scheduleMaintenance()
+    return { deleted, reclaimedBytes }
+  }
+
+  /**
+   * 批量删除会话音频、保留转写；记录的 audioPath 置空
+   * @returns 删除了音频的会话数与会话目录释放的字节数（打包数据在压缩后才释放）
+   */
+  async removeAudio(sessionIds: string[]): Promise<{ removed: number; reclaimedBytes: number }> {
+    const ids = sessionIds.filter((id) => UUID_PATTERN.test(id))
+    if (ids.length === 0) return { removed: 0, reclaimedBytes: 0 }
+    await this.journal.drain()
+
+    const updated: ConversationRecord[] = []
+    let reclaimedBytes = 0
+    await this.serializeWrite(async () => {
+      await this.packs.open()
+      const packed: ConversationRecord[] = []
+      for (const sessionId of ids) {
+        const record = await this.readMeta(sessionId)
+        if (record) {
+          const sessionDir = path.join(this.baseDir, sessionId)
+          const audioPath = path.join(sessionDir, AUDIO_FILE_NAME)
+          try {
+            reclaimedBytes += (await fs.stat(audioPath)).size
+            await fs.rm(audioPath)
+          } catch (error) {
+            if ((error as NodeJS.ErrnoException).code !== 'ENOENT') throw error
+            continue
+          }
+          const next = { ...record, audioPath: '' }
+          await fs.writeFile(path.join(sessionDir, 'meta.json'), JSON.stringify(next, null, 2), 'utf-8')
+          updated.push(next)
+        } else if (this.packs.hasAudio(sessionId)) {
+          const packedRecord = await this.packs.readRecord(sessionId)
+          if (packedRecord) packed.push({ ...packedRecord, audioPath: '' })
+        }
+      }
+      if (packed.length > 0) {
+        await this.packs.removeAudio(packed)
+        updated.push(...packed)
+      }
+      await this.removeExportedAudio(ids)
+    })
+    if (updated.length > 0) {
+      await this.updateIndex('removeAudio', async () => {
+        for (const record of updated) {
+          await this.index.upsert(record)
+        }
+      })
+      this.scheduleMaintenance()
+    }
+    return { removed: updated.length, reclaimedBytes }
+  }
+
+  /**
+   * 立即压缩打包段，回收已删除会话与音频占用的空间
+   */
+  async compactPacks(onProgress?: (completed: number, total: number) => void): Promise<PackCompactResult> {
+    await this.packs.open()
+    return this.packs.compact(onProgress)
   }
 
   /**
@@ -160,14 +798,18 @@ export class ConversationStore {
     let sizeBytes = 0
     const now = Date.now()
     const maxAgeMs = maxAgeDays * 24 * 60 * 60 * 1000
+    const seen = new Set<string>()
+    await this.journal.drain()
 
     try {
+      await this.packs.open()
       const entries = await fs.readdir(this.baseDir, { withFileTypes: true })
       for (const entry of entries) {
         if (!entry.isDirectory()) continue
 
         // 验证目录名格式（UUID），防止误计其他文件
         if (!UUID_PATTERN.test(entry.name)) continue
+        seen.add(entry.name)
 
         const sessionDir = path.join(this.baseDir, entry.name)
 
@@ -201,6 +843,14 @@ export class ConversationStore {
           sizeBytes += stat.size
         }
       }
+
+      // 已打包的会话按索引中的时间与数据块大小统计，不读取段文件
+      for (const info of this.packs.list()) {
+        if (seen.has(info.id)) continue
+        if (maxAgeDays > 0 && now - info.sortKey <= maxAgeMs) continue
+        count++
+        sizeBytes += info.sizeBytes
+      }
     } catch (error) {
       // 目录不存在时返回空统计
       if ((error as NodeJS.ErrnoException).code !== 'ENOENT') {
@@ -218,11 +868,13 @@ export class ConversationStore {
    * @returns 删除的会话数量
    */
   async clearByAge(maxAgeDays: number, excludeSessionId?: string): Promise<{ deletedCount: number }> {
-    let deletedCount = 0
+    const deletedIds = new Set<string>()
     const now = Date.now()
     const maxAgeMs = maxAgeDays * 24 * 60 * 60 * 1000
+    await this.journal.drain()
 
     try {
+      await this.packs.open()
       const entries = await fs.readdir(this.baseDir, { withFileTypes: true })
       for (const entry of entries) {
         if (!entry.isDirectory()) continue
@@ -264,16 +916,38 @@ export class ConversationStore {
         }
 
         if (shouldDelete) {
-          await fs.rm(sessionDir, { recursive: true, force: true })
-          deletedCount++
+          await this.serializeWrite(() => fs.rm(sessionDir, { recursive: true, force: true }))
+          deletedIds.add(entry.name)
         }
       }
+
+      // 已打包的会话（含清理期间刚被打包的）追加墓碑，空间由后台压缩回收
+      const packedIds = this.packs
+        .list()
+        .filter((info) => info.id !== excludeSessionId)
+        .filter((info) => maxAgeDays === 0 || now - info.sortKey > maxAgeMs)
+        .map((info) => info.id)
+      if (packedIds.length > 0) {
+        await this.serializeWrite(() => this.packs.remove(packedIds))
+        packedIds.forEach((id) => deletedIds.add(id))
+      }
     } catch (error) {
       if ((error as NodeJS.ErrnoException).code !== 'ENOENT') {
         throw error
       }
+    } finally {
+      if (deletedIds.size > 0) {
+        const ids = [...deletedIds]
+        await this.serializeWrite(() => this.removeExportedAudio(ids))
+        this.scheduleMaintenance()
+        await this.updateIndex('clearByAge', async () => {
+          await this.index.remove(ids)
+          await this.searchIndex.remove(ids)
+          await this.usage.remove(ids)
+        })
+      }
     }
 
-    return { deletedCount }
+    return { deletedCount: deletedIds.size }
   }
 }
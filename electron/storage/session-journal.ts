@@ -0,0 +1,315 @@
+/**
+ * 会话记录预写日志（write-behind）
+ *
+ * 听写结束后记录先追加到内存队列并立即返回，插入文本不再等待磁盘；
+ * 队列由后台批量提交（group commit）：一次追加写入多条记录并 fdatasync，
+ * 之后再逐条写入 meta.json 与索引。全部写入后清空日志（检查点）；写入失败的记录
+ * 在检查点时重写到新日志中，下次启动时重放。
+ * 文件 IO 与 fsync 在 libuv 线程池中执行，不占用主线程。
+ *
+ * 日志条目（小端）：u32 JSON 字节数 + u32 CRC32 + JSON
+ * 启动时重放日志中尚未写入的记录，校验失败或不完整的尾部条目丢弃。
+ */
+
+import fsSync from 'node:fs'
+import fs from 'node:fs/promises'
+import path from 'node:path'
+import type { ConversationRecord } from '../../shared/conversation'
+import { createModuleLogger } from '../utils/logger'
+import { crc32 } from './crc32'
+
+const logger = createModuleLogger('session-journal')
+
+const ENTRY_HEADER_BYTES = 8
+
+function encodeEntry(record: ConversationRecord): Buffer {
+  const json = Buffer.from(JSON.stringify(record), 'utf8')
+  const entry = Buffer.alloc(ENTRY_HEADER_BYTES + json.length)
+  entry.writeUInt32LE(json.length, 0)
+  entry.writeUInt32LE(crc32(json), 4)
+  json.copy(entry, ENTRY_HEADER_BYTES)
+  return entry
+}
+
+/**
+ * 解析日志，返回有效条目与有效字节数
+ */
+function decodeEntries(data: Buffer): { records: ConversationRecord[]; validBytes: number } {
+  const records: ConversationRecord[] = []
+  let offset = 0
+  while (offset + ENTRY_HEADER_BYTES <= data.length) {
+    const length = data.readUInt32LE(offset)
+    const end = offset + ENTRY_HEADER_BYTES + length
+    if (end > data.length) break
+    const json = data.subarray(offset + ENTRY_HEADER_BYTES, end)
+    if (crc32(json) !== data.readUInt32LE(offset + 4)) break
+    try {
+      records.push(JSON.parse(json.toString('utf8')) as ConversationRecord)
+    } catch {
+      break
+    }
+    offset = end
+  }
+  return { records, validBytes: offset }
+}
+
+interface PendingEntry {
+  record: ConversationRecord
+  resolve: () => void
+  reject: (error: Error) => void
+}
+
+export class SessionJournal {
+  /** 等待提交到日志的记录 */
+  private queue: PendingEntry[] = []
+  /** 已提交或待提交、但尚未写入 meta.json 的记录（按会话 ID，供读取时合并） */
+  private unapplied = new Map<string, ConversationRecord>()
+  private file: fs.FileHandle | null = null
+  private flushing: Promise<void> | null = null
+  private applying: Promise<void> = Promise.resolve()
+  /** 日志文件的写入、截断与启动重放依次执行，避免检查点截掉刚提交的条目 */
+  private io: Promise<unknown> = Promise.resolve()
+  /** 启动重放完成前，读取方需等待（重放中的记录尚未写入 meta.json） */
+  private recovering: Promise<unknown> = Promise.resolve()
+  /** 写入 meta.json 失败的记录（按会话 ID），检查点时保留在日志中 */
+  private failed = new Map<string, ConversationRecord>()
+  private commits = 0
+  private committedRecords = 0
+
+  constructor(
+    private readonly filePath: string,
+    private readonly apply: (record: ConversationRecord) => Promise<void>
+  ) {}
+
+  /**
+   * 追加记录，立即返回；Promise 在记录写入日志并落盘后完成
+   */
+  append(record: ConversationRecord): Promise<void> {
+    this.unapplied.set(record.id, record)
+    const committed = new Promise<void>((resolve, reject) => {
+      this.queue.push({ record, resolve, reject })
+    })
+    if (!this.flushing) {
+      this.flushing = new Promise<void>((resolve) => setImmediate(resolve)).then(() => this.flushLoop())
+    }
+    return committed
+  }
+
+  /**
+   * 尚未写入 meta.json 的最新记录
+   */
+  peek(sessionId: string): ConversationRecord | undefined {
+    return this.unapplied.get(sessionId)
+  }
+
+  /**
+   * 等待启动重放完成（无论成功与否）
+   */
+  async whenRecovered(): Promise<void> {
+    await this.recovering.catch(() => undefined)
+  }
+
+  /**
+   * 等待启动重放完成，以及所有已追加的记录写入 meta.json
+   */
+  async drain(): Promise<void> {
+    await this.whenRecovered()
+    while (this.flushing || this.unapplied.size > 0) {
+      await this.flushing
+      await this.applying
+    }
+  }
+
+  /**
+   * 启动时重放上次未写完的记录
+   * 在日志 IO 队列中执行：重放完成前新提交的记录只排队、不写入日志，
+   * 重放后的重写不会覆盖它们
+   * @returns 重放的记录数
+   */
+  recover(): Promise<number> {
+    const result = this.runIo(() => this.replay())
+    this.recovering = result
+    return result
+  }
+
+  private async replay(): Promise<number> {
+    let data: Buffer
+    try {
+      data = await fs.readFile(this.filePath)
+    } catch (error) {
+      if ((error as NodeJS.ErrnoException).code === 'ENOENT') return 0
+      throw error
+    }
+    const { records, validBytes } = decodeEntries(data)
+    if (validBytes !== data.length) {
+      logger.warn('会话日志尾部损坏，已丢弃', { validBytes, totalBytes: data.length })
+    }
+
+    for (const record of records) {
+      await this.applyRecord(record, 'recover')
+    }
+    await this.rewrite()
+    if (records.length > 0) {
+      logger.info('已重放会话日志', { count: records.length, failed: this.failed.size })
+    }
+    return records.length
+  }
+
+  getStats() {
+    return {
+      commits: this.commits,
+      committedRecords: this.committedRecords,
+      pending: this.queue.length,
+      unapplied: this.unapplied.size,
+    }
+  }
+
+  /**
+   * 同步写入尚未提交的记录（应用退出时调用），下次启动时重放
+   */
+  flushSync(): void {
+    if (this.queue.length === 0) return
+    const batch = this.queue
+    this.queue = []
+    try {
+      fsSync.mkdirSync(path.dirname(this.filePath), { recursive: true })
+      const fd = fsSync.openSync(this.filePath, 'a')
+      try {
+        fsSync.writeSync(fd, Buffer.concat(batch.map((entry) => encodeEntry(entry.record))))
+        fsSync.fdatasyncSync(fd)
+      } finally {
+        fsSync.closeSync(fd)
+      }
+      batch.forEach((entry) => entry.resolve())
+    } catch (error) {
+      const failure = error instanceof Error ? error : new Error(String(error))
+      logger.error(failure, { context: 'flushSync', count: batch.length })
+      batch.forEach((entry) => entry.reject(failure))
+    }
+  }
+
+  async close(): Promise<void> {
+    await this.drain()
+    await this.file?.close()
+    this.file = null
+  }
+
+  /**
+   * 每轮把当前队列中的全部记录作为一次提交写入，提交期间新到的记录进入下一轮
+   */
+  private async flushLoop(): Promise<void> {
+    try {
+      while (this.queue.length > 0) {
+        const batch = this.queue
+        this.queue = []
+        try {
+          const data = Buffer.concat(batch.map((entry) => encodeEntry(entry.record)))
+          await this.runIo(async () => {
+            const file = await this.openFile()
+            await file.write(data)
+            await file.datasync()
+          })
+          this.commits++
+          this.committedRecords += batch.length
+        } catch (error) {
+          const failure = error instanceof Error ? error : new Error(String(error))
+          logger.error(failure, { context: 'commit', count: batch.length })
+          // 日志不可写时退回直接写入，保证记录不丢
+          for (const entry of batch) {
+            this.applyInBackground(entry.record)
+            entry.reject(failure)
+          }
+          continue
+        }
+        for (const entry of batch) {
+          entry.resolve()
+          this.applyInBackground(entry.record)
+        }
+      }
+    } finally {
+      this.flushing = null
+    }
+  }
+
+  private applyInBackground(record: ConversationRecord): void {
+    this.applying = this.applying.then(async () => {
+      await this.applyRecord(record, 'apply')
+      if (this.unapplied.get(record.id) === record) {
+        this.unapplied.delete(record.id)
+      }
+      await this.checkpoint()
+    })
+  }
+
+  /**
+   * 写入 meta.json；失败的记录留待检查点写回日志，同一会话之后写入成功则不再保留
+   */
+  private async applyRecord(record: ConversationRecord, context: string): Promise<void> {
+    try {
+      await this.apply(record)
+      this.failed.delete(record.id)
+    } catch (error) {
+      this.failed.set(record.id, record)
+      logger.error(error instanceof Error ? error : new Error(String(error)), {
+        context,
+        sessionId: record.id,
+      })
+    }
+  }
+
+  /**
+   * 所有记录都已处理时清空日志，只保留写入失败的记录
+   */
+  private async checkpoint(): Promise<void> {
+    try {
+      await this.runIo(async () => {
+        // 进入 IO 队列后再检查，期间可能又有记录提交
+        if (this.queue.length > 0 || this.unapplied.size > 0 || !this.file) return
+        await this.rewrite()
+      })
+    } catch (error) {
+      logger.warn('清空会话日志失败', { error: error instanceof Error ? error.message : String(error) })
+    }
+  }
+
+  /**
+   * 用写入失败的记录替换日志内容（须在 IO 队列中调用）
+   * 没有失败记录时直接截断；否则写入临时文件后重命名，中途崩溃也不会丢失这些记录
+   */
+  private async rewrite(): Promise<void> {
+    if (this.failed.size === 0) {
+      if (this.file) {
+        await this.file.truncate(0)
+      } else {
+        await fs.truncate(this.filePath, 0)
+      }
+      return
+    }
+    const tempPath = `${this.filePath}.tmp`
+    const file = await fs.open(tempPath, 'w')
+    try {
+      await file.write(Buffer.concat([...this.failed.values()].map(encodeEntry)))
+      await file.datasync()
+    } finally {
+      await file.close()
+    }
+    await fs.rename(tempPath, this.filePath)
+    // 旧文件句柄指向已被替换的文件，下次提交时重新打开
+    await this.file?.close()
+    this.file = null
+  }
+
+  private runIo<T>(operation: () => Promise<T>): Promise<T> {
+    const result = this.io.then(operation)
+    this.io = result.catch(() => undefined)
+    return result
+  }
+
+  private async openFile(): Promise<fs.FileHandle> {
+    if (!this.file) {
+      await fs.mkdir(path.dirname(this.filePath), { recursive: true })
+      this.file = await fs.open(this.filePath, 'a')
+    }
+    return this.file
+  }
+}
@@ -0,0 +1,691 @@
+/**
+ * 会话打包存储
+ *
+ * 已结束的会话不再各占一个目录：meta.json 与 audio.wav 作为数据块追加写入
+ * conversations/.packs 下的滚动段文件，避免目录数量随使用无限增长。
+ *   seg-000001.pack …  段文件，超过 SEGMENT_MAX_BYTES 后换新段
+ *   packs.idx          偏移索引，16 字节文件头 + 每个数据块一条定长记录
+ *
+ * 数据块头（小端，64 字节）：
+ *   [0, 4)    魔数 'STPB'
+ *   [4, 5)    u8 类型：BLOB_META 记录 JSON，BLOB_AUDIO 完整 WAV，
+ *             BLOB_TOMBSTONE 删除会话，BLOB_DROP_AUDIO 只删除音频
+ *   [8, 44)   会话 ID（ASCII，不足补 0）
+ *   [44, 48)  u32 数据字节数
+ *   [48, 52)  u32 数据 CRC32
+ *   [56, 64)  f64 排序时间（finishedAt，缺失时用 startedAt）
+ *
+ * 索引记录（64 字节）：会话 ID、类型、段号、块偏移、数据字节数、CRC32、排序时间。
+ * 先写段文件（fdatasync）再追加索引；崩溃后索引未覆盖的段尾在打开时补扫，半个块截掉。
+ * 同一会话后写入的块取代先前的块，删除只追加墓碑；失效字节占比高的段由 compact()
+ * 把有效块复制到当前段（必要时先换新段）后整段删除，再重写索引。
+ */
+
+import fs from 'node:fs/promises'
+import path from 'node:path'
+import type { ConversationRecord } from '../../shared/conversation'
+import { createModuleLogger } from '../utils/logger'
+import { crc32 } from './crc32'
+
+const logger = createModuleLogger('session-pack')
+
+const BLOB_MAGIC = 'STPB'
+const INDEX_MAGIC = 'STPI'
+const INDEX_VERSION = 1
+const INDEX_HEADER_BYTES = 16
+const INDEX_RECORD_BYTES = 64
+const BLOB_HEADER_BYTES = 64
+const ID_BYTES = 36
+
+const BLOB_META = 1
+const BLOB_AUDIO = 2
+const BLOB_TOMBSTONE = 3
+const BLOB_DROP_AUDIO = 4
+
+/** 当前段超过此大小后新数据写入新段 */
+const SEGMENT_MAX_BYTES = 64 * 1024 * 1024
+/** 旧段失效字节占比达到此值时压缩 */
+const COMPACT_DEAD_RATIO = 0.5
+/** 压缩时每批复制的数据量 */
+const COMPACT_BATCH_BYTES = 8 * 1024 * 1024
+
+const INDEX_FILE = 'packs.idx'
+const SEGMENT_PATTERN = /^seg-(\d{6})\.pack$/
+
+interface PackEntry {
+  id: string
+  kind: number
+  segment: number
+  offset: number
+  length: number
+  crc: number
+  sortKey: number
+}
+
+interface Segment {
+  id: number
+  size: number
+  /** 写入该段的全部数据块（含已失效的），压缩时据此判断墓碑能否丢弃 */
+  entries: PackEntry[]
+}
+
+interface PackedSession {
+  meta?: PackEntry
+  audio?: PackEntry
+}
+
+interface PendingBlob {
+  id: string
+  kind: number
+  sortKey: number
+  data: Buffer
+}
+
+export interface PackedSessionInfo {
+  id: string
+  sortKey: number
+  /** 该会话有效数据块占用的字节数（含块头） */
+  sizeBytes: number
+  /** 音频数据块字节数，没有音频时为 0 */
+  audioBytes: number
+}
+
+export interface PackCompactResult {
+  segments: number
+  reclaimedBytes: number
+}
+
+export interface PackStats {
+  sessions: number
+  segments: number
+  totalBytes: number
+  liveBytes: number
+}
+
+function sortKeyOf(record: ConversationRecord): number {
+  return record.finishedAt || record.startedAt || 0
+}
+
+function segmentFileName(segment: number): string {
+  return `seg-${String(segment).padStart(6, '0')}.pack`
+}
+
+function blobBytes(entry: PackEntry): number {
+  return BLOB_HEADER_BYTES + entry.length
+}
+
+function encodeBlobHeader(blob: PendingBlob, crc: number): Buffer {
+  const header = Buffer.alloc(BLOB_HEADER_BYTES)
+  header.write(BLOB_MAGIC, 0, 'ascii')
+  header.writeUInt8(blob.kind, 4)
+  header.write(blob.id, 8, ID_BYTES, 'ascii')
+  header.writeUInt32LE(blob.data.length, 44)
+  header.writeUInt32LE(crc, 48)
+  header.writeDoubleLE(blob.sortKey, 56)
+  return header
+}
+
+function readId(buffer: Buffer, offset: number): string {
+  const end = buffer.indexOf(0, offset)
+  return buffer.toString('ascii', offset, end >= 0 && end < offset + ID_BYTES ? end : offset + ID_BYTES)
+}
+
+function encodeIndexEntry(entry: PackEntry): Buffer {
+  const record = Buffer.alloc(INDEX_RECORD_BYTES)
+  record.write(entry.id, 0, ID_BYTES, 'ascii')
+  record.writeUInt8(entry.kind, 36)
+  record.writeUInt32LE(entry.segment, 40)
+  record.writeUInt32LE(entry.offset, 44)
+  record.writeUInt32LE(entry.length, 48)
+  record.writeUInt32LE(entry.crc, 52)
+  record.writeDoubleLE(entry.sortKey, 56)
+  return record
+}
+
+function decodeIndexEntry(data: Buffer, offset: number): PackEntry {
+  return {
+    id: readId(data, offset),
+    kind: data.readUInt8(offset + 36),
+    segment: data.readUInt32LE(offset + 40),
+    offset: data.readUInt32LE(offset + 44),
+    length: data.readUInt32LE(offset + 48),
+    crc: data.readUInt32LE(offset + 52),
+    sortKey: data.readDoubleLE(offset + 56),
+  }
+}
+
+/** 删除标记（不含数据，压缩时按需保留） */
+function isMarker(kind: number): boolean {
+  return kind === BLOB_TOMBSTONE || kind === BLOB_DROP_AUDIO
+}
+
+function compareEntries(a: PackEntry, b: PackEntry): number {
+  return a.segment - b.segment || a.offset - b.offset
+}
+
+export class SessionPackStore {
+  private readonly indexPath: string
+  private segments = new Map<number, Segment>()
+  private sessions = new Map<string, PackedSession>()
+  private activeSegment = 0
+  private activeFile: fs.FileHandle | null = null
+  private indexFile: fs.FileHandle | null = null
+  private loaded: Promise<void> | null = null
+  /** 段文件与索引的读写依次执行 */
+  private queue: Promise<unknown> = Promise.resolve()
+
+  constructor(private readonly dir: string) {
+    this.indexPath = path.join(dir, INDEX_FILE)
+  }
+
+  /**
+   * 加载索引（可重复调用）；has/ids/list 在加载完成后才有效
+   */
+  open(): Promise<void> {
+    if (!this.loaded) {
+      this.loaded = this.load().catch((error) => {
+        this.loaded = null
+        throw error
+      })
+    }
+    return this.loaded
+  }
+
+  has(id: string): boolean {
+    return this.sessions.has(id)
+  }
+
+  hasAudio(id: string): boolean {
+    return Boolean(this.sessions.get(id)?.audio)
+  }
+
+  ids(): string[] {
+    return [...this.sessions.keys()]
+  }
+
+  /**
+   * 已打包会话的排序时间与占用空间（不读取段文件）
+   */
+  list(): PackedSessionInfo[] {
+    const result: PackedSessionInfo[] = []
+    for (const [id, session] of this.sessions) {
+      const primary = session.meta ?? session.audio!
+      result.push({
+        id,
+        sortKey: primary.sortKey,
+        sizeBytes: (session.meta ? blobBytes(session.meta) : 0) + (session.audio ? blobBytes(session.audio) : 0),
+        audioBytes: session.audio ? blobBytes(session.audio) : 0,
+      })
+    }
+    return result
+  }
+
+  getStats(): PackStats {
+    let totalBytes = 0
+    for (const segment of this.segments.values()) totalBytes += segment.size
+    let liveBytes = 0
+    for (const info of this.list()) liveBytes += info.sizeBytes
+    return { sessions: this.sessions.size, segments: this.segments.size, totalBytes, liveBytes }
+  }
+
+  /**
+   * 打包会话：音频文件（可选）与记录一起写入当前段
+   * @param audioPath 会话目录中的 audio.wav，不存在时只写记录
+   */
+  add(record: ConversationRecord, audioPath?: string): Promise<void> {
+    return this.run(async () => {
+      const sortKey = sortKeyOf(record)
+      const blobs: PendingBlob[] = []
+      if (audioPath) {
+        try {
+          blobs.push({ id: record.id, kind: BLOB_AUDIO, sortKey, data: await fs.readFile(audioPath) })
+        } catch (error) {
+          if ((error as NodeJS.ErrnoException).code !== 'ENOENT') throw error
+        }
+      }
+      blobs.push({ id: record.id, kind: BLOB_META, sortKey, data: Buffer.from(JSON.stringify(record), 'utf8') })
+      await this.appendBlobs(blobs)
+    })
+  }
+
+  /**
+   * 更新已打包会话的记录，音频保持不变
+   */
+  writeRecord(record: ConversationRecord): Promise<void> {
+    return this.run(async () => {
+      await this.appendBlobs([
+        { id: record.id, kind: BLOB_META, sortKey: sortKeyOf(record), data: Buffer.from(JSON.stringify(record), 'utf8') },
+      ])
+    })
+  }
+
+  /**
+   * 删除会话音频、保留记录：追加音频删除标记与更新后的记录
+   * @returns 实际删除了音频的会话数
+   */
+  removeAudio(records: ConversationRecord[]): Promise<number> {
+    return this.run(async () => {
+      const targets = records.filter((record) => this.sessions.get(record.id)?.audio)
+      if (targets.length === 0) return 0
+      await this.appendBlobs(
+        targets.flatMap((record) => [
+          { id: record.id, kind: BLOB_DROP_AUDIO, sortKey: sortKeyOf(record), data: Buffer.alloc(0) },
+          { id: record.id, kind: BLOB_META, sortKey: sortKeyOf(record), data: Buffer.from(JSON.stringify(record), 'utf8') },
+        ])
+      )
+      return targets.length
+    })
+  }
+
+  async readRecord(id: string): Promise<ConversationRecord | null> {
+    const data = await this.run(async () => {
+      const entry = this.sessions.get(id)?.meta
+      return entry ? this.readBlob(entry) : null
+    })
+    return data ? (JSON.parse(data.toString('utf8')) as ConversationRecord) : null
+  }
+
+  /**
+   * 读取全部已打包记录（重建会话索引时使用）
+   */
+  readAllRecords(): Promise<ConversationRecord[]> {
+    return this.run(async () => {
+      const records: ConversationRecord[] = []
+      for (const [id, session] of this.sessions) {
+        if (!session.meta) continue
+        try {
+          records.push(JSON.parse((await this.readBlob(session.meta)).toString('utf8')) as ConversationRecord)
+        } catch (error) {
+          logger.warn('读取打包记录失败', { sessionId: id, error: error instanceof Error ? error.message : String(error) })
+        }
+      }
+      return records
+    })
+  }
+
+  /**
+   * 把会话音频导出为普通 WAV 文件
+   * @returns 会话没有音频时返回 false
+   */
+  exportAudio(id: string, destPath: string): Promise<boolean> {
+    return this.run(async () => {
+      const entry = this.sessions.get(id)?.audio
+      if (!entry) return false
+      const data = await this.readBlob(entry)
+      await fs.mkdir(path.dirname(destPath), { recursive: true })
+      const tmpPath = `${destPath}.tmp`
+      await fs.writeFile(tmpPath, data)
+      await fs.rename(tmpPath, destPath)
+      return true
+    })
+  }
+
+  /**
+   * 删除会话：追加墓碑，空间在压缩时回收
+   * @returns 实际删除的会话数
+   */
+  remove(ids: string[]): Promise<number> {
+    return this.run(async () => {
+      const targets = ids.filter((id) => this.sessions.has(id))
+      if (targets.length === 0) return 0
+      await this.appendBlobs(
+        targets.map((id) => ({ id, kind: BLOB_TOMBSTONE, sortKey: 0, data: Buffer.alloc(0) }))
+      )
+      return targets.length
+    })
+  }
+
+  /**
+   * 压缩：失效字节占比达到阈值的段，有效块复制到当前段后删除整段
+   * @param onProgress 每压缩完一段回调一次
+   */
+  compact(onProgress?: (completed: number, total: number) => void): Promise<PackCompactResult> {
+    return this.run(async () => {
+      const candidates = [...this.segments.values()]
+        .filter((segment) => segment.size > 0)
+        .filter((segment) => 1 - this.liveBytesOf(segment) / segment.size >= COMPACT_DEAD_RATIO)
+        .sort((a, b) => a.id - b.id)
+      if (candidates.length === 0) return { segments: 0, reclaimedBytes: 0 }
+      // 当前段也需要压缩时先换新段，有效块复制到新段
+      if (candidates.some((segment) => segment.id === this.activeSegment)) {
+        await this.rollSegment()
+      }
+
+      const startedAt = Date.now()
+      const compacting = new Set(candidates.map((segment) => segment.id))
+      // 其余段中仍有数据块的会话，墓碑需要保留以屏蔽这些旧数据
+      const shadowed = new Set<string>()
+      for (const segment of this.segments.values()) {
+        if (compacting.has(segment.id)) continue
+        for (const entry of segment.entries) {
+          if (!isMarker(entry.kind)) shadowed.add(entry.id)
+        }
+      }
+
+      let reclaimedBytes = 0
+      for (const segment of candidates) {
+        let batch: PendingBlob[] = []
+        let batchBytes = 0
+        let copiedBytes = 0
+        for (const entry of segment.entries) {
+          let data: Buffer
+          if (entry.kind === BLOB_TOMBSTONE) {
+            if (this.sessions.has(entry.id) || !shadowed.has(entry.id)) continue
+            data = Buffer.alloc(0)
+          } else if (entry.kind === BLOB_DROP_AUDIO) {
+            if (!this.sessions.has(entry.id) || this.hasAudio(entry.id) || !shadowed.has(entry.id)) continue
+            data = Buffer.alloc(0)
+          } else {
+            if (!this.isLive(entry)) continue
+            data = await this.readBlob(entry)
+          }
+          batch.push({ id: entry.id, kind: entry.kind, sortKey: entry.sortKey, data })
+          batchBytes += data.length
+          copiedBytes += BLOB_HEADER_BYTES + data.length
+          if (batchBytes >= COMPACT_BATCH_BYTES) {
+            await this.appendBlobs(batch)
+            batch = []
+            batchBytes = 0
+          }
+        }
+        if (batch.length > 0) {
+          await this.appendBlobs(batch)
+        }
+        reclaimedBytes += segment.size - copiedBytes
+        onProgress?.(candidates.indexOf(segment) + 1, candidates.length)
+      }
+
+      // 先删旧段再重写索引：中途崩溃时索引指向的缺失段在加载时忽略，不会让已删除的会话复活
+      for (const segment of candidates) {
+        await fs.rm(path.join(this.dir, segmentFileName(segment.id)), { force: true })
+        this.segments.delete(segment.id)
+      }
+      await this.rewriteIndex()
+
+      logger.info('打包段已压缩', {
+        segments: candidates.length,
+        reclaimedBytes,
+        elapsedMs: Date.now() - startedAt,
+      })
+      return { segments: candidates.length, reclaimedBytes }
+    })
+  }
+
+  async close(): Promise<void> {
+    await this.run(async () => {
+      await this.activeFile?.close()
+      await this.indexFile?.close()
+      this.activeFile = null
+      this.indexFile = null
+    })
+  }
+
+  /**
+   * 在存储队列中执行操作，首次调用时加载
+   */
+  private async run<T>(operation: () => Promise<T>): Promise<T> {
+    await this.open()
+    const result = this.queue.then(operation)
+    this.queue = result.catch(() => undefined)
+    return result
+  }
+
+  private isLive(entry: PackEntry): boolean {
+    const session = this.sessions.get(entry.id)
+    if (!session) return false
+    return (entry.kind === BLOB_META ? session.meta : session.audio) === entry
+  }
+
+  private liveBytesOf(segment: Segment): number {
+    let bytes = 0
+    for (const entry of segment.entries) {
+      if (!isMarker(entry.kind) && this.isLive(entry)) bytes += blobBytes(entry)
+    }
+    return bytes
+  }
+
+  private applyEntry(entry: PackEntry): void {
+    this.segments.get(entry.segment)!.entries.push(entry)
+    if (entry.kind === BLOB_TOMBSTONE) {
+      this.sessions.delete(entry.id)
+      return
+    }
+    if (entry.kind === BLOB_DROP_AUDIO) {
+      const session = this.sessions.get(entry.id)
+      if (session) delete session.audio
+      return
+    }
+    const session = this.sessions.get(entry.id) ?? {}
+    if (entry.kind === BLOB_META) session.meta = entry
+    else session.audio = entry
+    this.sessions.set(entry.id, session)
+  }
+
+  /**
+   * 读取段文件与索引；索引缺失、损坏或落后于段文件时从段文件补扫并重写索引
+   */
+  private async load(): Promise<void> {
+    const startedAt = Date.now()
+    this.segments.clear()
+    this.sessions.clear()
+
+    let names: string[]
+    try {
+      names = await fs.readdir(this.dir)
+    } catch (error) {
+      if ((error as NodeJS.ErrnoException).code === 'ENOENT') return
+      throw error
+    }
+    for (const name of names) {
+      const match = SEGMENT_PATTERN.exec(name)
+      if (!match) continue
+      const id = Number(match[1])
+      const { size } = await fs.stat(path.join(this.dir, name))
+      this.segments.set(id, { id, size, entries: [] })
+      this.activeSegment = Math.max(this.activeSegment, id)
+    }
+
+    const entries: PackEntry[] = []
+    let indexDirty = false
+    try {
+      const data = await fs.readFile(this.indexPath)
+      if (
+        data.length >= INDEX_HEADER_BYTES &&
+        data.toString('ascii', 0, 4) === INDEX_MAGIC &&
+        data.readUInt32LE(4) === INDEX_VERSION
+      ) {
+        const count = Math.floor((data.length - INDEX_HEADER_BYTES) / INDEX_RECORD_BYTES)
+        if (INDEX_HEADER_BYTES + count * INDEX_RECORD_BYTES !== data.length) indexDirty = true
+        for (let i = 0; i < count; i++) {
+          entries.push(decodeIndexEntry(data, INDEX_HEADER_BYTES + i * INDEX_RECORD_BYTES))
+        }
+      } else {
+        indexDirty = true
+      }
+    } catch (error) {
+      if ((error as NodeJS.ErrnoException).code !== 'ENOENT') throw error
+      indexDirty = this.segments.size > 0
+    }
+
+    // 丢弃指向缺失段或段外数据的索引记录，记下每段已被索引覆盖的位置
+    const indexedEnd = new Map<number, number>()
+    const valid = entries.filter((entry) => {
+      const segment = this.segments.get(entry.segment)
+      const end = entry.offset + BLOB_HEADER_BYTES + entry.length
+      if (!segment || end > segment.size) {
+        indexDirty = true
+        return false
+      }
+      indexedEnd.set(entry.segment, Math.max(indexedEnd.get(entry.segment) ?? 0, end))
+      return true
+    })
+
+    let recovered = 0
+    for (const segment of this.segments.values()) {
+      const from = indexedEnd.get(segment.id) ?? 0
+      if (from >= segment.size) continue
+      const { entries: tail, validEnd } = await this.scanSegment(segment.id, from, segment.size)
+      valid.push(...tail)
+      recovered += tail.length
+      indexDirty = true
+      if (validEnd < segment.size) {
+        logger.warn('打包段尾部损坏，已截断', { segment: segment.id, validEnd, size: segment.size })
+        await fs.truncate(path.join(this.dir, segmentFileName(segment.id)), validEnd)
+        segment.size = validEnd
+      }
+    }
+
+    valid.sort(compareEntries)
+    for (const entry of valid) this.applyEntry(entry)
+    if (indexDirty) {
+      await this.rewriteIndex()
+    }
+    if (this.segments.size > 0) {
+      logger.info('打包存储已加载', {
+        sessions: this.sessions.size,
+        segments: this.segments.size,
+        recovered,
+        elapsedMs: Date.now() - startedAt,
+      })
+    }
+  }
+
+  /**
+   * 顺序扫描段文件中的数据块，遇到不完整或校验失败的块停止
+   */
+  private async scanSegment(
+    segmentId: number,
+    from: number,
+    size: number
+  ): Promise<{ entries: PackEntry[]; validEnd: number }> {
+    const entries: PackEntry[] = []
+    const file = await fs.open(path.join(this.dir, segmentFileName(segmentId)), 'r')
+    let offset = from
+    try {
+      const header = Buffer.alloc(BLOB_HEADER_BYTES)
+      while (offset + BLOB_HEADER_BYTES <= size) {
+        await file.read(header, 0, BLOB_HEADER_BYTES, offset)
+        if (header.toString('ascii', 0, 4) !== BLOB_MAGIC) break
+        const length = header.readUInt32LE(44)
+        if (offset + BLOB_HEADER_BYTES + length > size) break
+        const data = Buffer.alloc(length)
+        if (length > 0) await file.read(data, 0, length, offset + BLOB_HEADER_BYTES)
+        const crc = header.readUInt32LE(48)
+        if (crc32(data) !== crc) break
+        entries.push({
+          id: readId(header, 8),
+          kind: header.readUInt8(4),
+          segment: segmentId,
+          offset,
+          length,
+          crc,
+          sortKey: header.readDoubleLE(56),
+        })
+        offset += BLOB_HEADER_BYTES + length
+      }
+    } finally {
+      await file.close()
+    }
+    return { entries, validEnd: offset }
+  }
+
+  private async readBlob(entry: PackEntry): Promise<Buffer> {
+    const file = await fs.open(path.join(this.dir, segmentFileName(entry.segment)), 'r')
+    try {
+      const data = Buffer.alloc(entry.length)
+      const { bytesRead } = await file.read(data, 0, entry.length, entry.offset + BLOB_HEADER_BYTES)
+      if (bytesRead !== entry.length || crc32(data) !== entry.crc) {
+        throw new Error(`打包数据校验失败: ${entry.id}`)
+      }
+      return data
+    } finally {
+      await file.close()
+    }
+  }
+
+  /**
+   * 追加数据块：写入当前段并落盘后再追加索引
+   */
+  private async appendBlobs(blobs: PendingBlob[]): Promise<void> {
+    const totalBytes = blobs.reduce((sum, blob) => sum + BLOB_HEADER_BYTES + blob.data.length, 0)
+    const current = this.segments.get(this.activeSegment)
+    if (!current || (current.size > 0 && current.size + totalBytes > SEGMENT_MAX_BYTES)) {
+      await this.rollSegment()
+    }
+    const segment = this.segments.get(this.activeSegment)!
+    const file = await this.openActiveFile()
+
+    const buffers: Buffer[] = []
+    const entries: PackEntry[] = []
+    let offset = segment.size
+    for (const blob of blobs) {
+      const crc = crc32(blob.data)
+      buffers.push(encodeBlobHeader(blob, crc), blob.data)
+      entries.push({
+        id: blob.id,
+        kind: blob.kind,
+        segment: segment.id,
+        offset,
+        length: blob.data.length,
+        crc,
+        sortKey: blob.sortKey,
+      })
+      offset += BLOB_HEADER_BYTES + blob.data.length
+    }
+    await file.writev(buffers)
+    await file.datasync()
+    segment.size = offset
+
+    const index = await this.openIndexFile()
+    await index.write(Buffer.concat(entries.map(encodeIndexEntry)))
+    for (const entry of entries) this.applyEntry(entry)
+  }
+
+  private async rollSegment(): Promise<void> {
+    await this.activeFile?.close()
+    this.activeFile = null
+    this.activeSegment++
+    this.segments.set(this.activeSegment, { id: this.activeSegment, size: 0, entries: [] })
+  }
+
+  private async openActiveFile(): Promise<fs.FileHandle> {
+    if (!this.activeFile) {
+      await fs.mkdir(this.dir, { recursive: true })
+      this.activeFile = await fs.open(path.join(this.dir, segmentFileName(this.activeSegment)), 'a')
+    }
+    return this.activeFile
+  }
+
+  private async openIndexFile(): Promise<fs.FileHandle> {
+    if (!this.indexFile) {
+      await fs.mkdir(this.dir, { recursive: true })
+      try {
+        await fs.access(this.indexPath)
+      } catch {
+        await fs.writeFile(this.indexPath, this.indexHeader())
+      }
+      this.indexFile = await fs.open(this.indexPath, 'a')
+    }
+    return this.indexFile
+  }
+
+  private indexHeader(): Buffer {
+    const header = Buffer.alloc(INDEX_HEADER_BYTES)
+    header.write(INDEX_MAGIC, 0, 'ascii')
+    header.writeUInt32LE(INDEX_VERSION, 4)
+    return header
+  }
+
+  /**
+   * 按段与偏移顺序重写索引（临时文件 + 重命名）
+   */
+  private async rewriteIndex(): Promise<void> {
+    await this.indexFile?.close()
+    this.indexFile = null
+    const entries = [...this.segments.values()].flatMap((segment) => segment.entries).sort(compareEntries)
+    await fs.mkdir(this.dir, { recursive: true })
+    const tmpPath = `${this.indexPath}.tmp`
+    await fs.writeFile(tmpPath, Buffer.concat([this.indexHeader(), ...entries.map(encodeIndexEntry)]))
+    await fs.rename(tmpPath, this.indexPath)
+  }
+}
@@ -0,0 +1,726 @@
+/**
+ * 转写文本全文检索
+ *
+ * 分词：文本经 NFKC 归一化并转小写；中日韩文字按二元组（bigram）切分，
+ * 每段连续 CJK 文字的最后一个字额外记一个单字词，使任意单字都能以前缀命中；
+ * 拉丁字母与数字按词切分。每个词元带位置，CJK 每个字占一个位置，拉丁词占一个位置。
+ *
+ * 倒排表：每个词一条只追加的压缩链表，条目为
+ *   varint(文档号差值) varint(位置数) varint(位置差值)...
+ * 新文档的文档号单调递增，因此增量写入只需在链表尾部追加；删除只登记墓碑。
+ *
+ * 持久化（conversations/.index 下）：
+ *   search.bin  快照：文档表 + 词典 + 压缩倒排表
+ *   search.log  快照之后的增量操作（追加 / 删除），打开时重放，损坏的尾部截掉
+ * 快照在打开时一次读入内存；日志过长或墓碑过多时重写。
+ */
+
+import fs from 'node:fs/promises'
+import path from 'node:path'
+
+const SNAPSHOT_MAGIC = 'STFS'
+const SNAPSHOT_VERSION = 1
+const SNAPSHOT_FILE = 'search.bin'
+const LOG_FILE = 'search.log'
+const ID_BYTES = 36
+
+const OP_ADD = 1
+const OP_REMOVE = 2
+/** 日志条目头：u8 操作 + u32 负载长度 */
+const LOG_ENTRY_HEADER_BYTES = 5
+
+/** 重放的日志条目超过此数量时重写快照 */
+const SNAPSHOT_LOG_ENTRIES = 2000
+/** 前缀查询最多展开的词数，防止单字母前缀拖慢查询 */
+const MAX_PREFIX_TERMS = 2048
+
+const CJK_PATTERN = /[\p{Script=Han}\p{Script=Hiragana}\p{Script=Katakana}\p{Script=Hangul}]/u
+const WORD_PATTERN = /[\p{L}\p{N}]/u
+
+export interface SearchToken {
+  term: string
+  position: number
+}
+
+export interface SearchDocument {
+  id: string
+  sortKey: number
+  text: string
+}
+
+export interface SearchResult {
+  /** 按时间倒序的会话 ID */
+  ids: string[]
+  total: number
+}
+
+interface QueryToken {
+  term: string
+  prefix: boolean
+  /** 在短语中的相对位置 */
+  offset: number
+}
+
+interface DocumentSlot {
+  id: string
+  sortKey: number
+  alive: boolean
+}
+
+type CharClass = 'cjk' | 'word' | 'other'
+
+function classify(char: string): CharClass {
+  if (CJK_PATTERN.test(char)) return 'cjk'
+  if (WORD_PATTERN.test(char)) return 'word'
+  return 'other'
+}
+
+function normalize(text: string): string {
+  return text.normalize('NFKC').toLowerCase()
+}
+
+/**
+ * 把文本切分为连续的 CJK 段与词段
+ */
+function splitRuns(text: string): Array<{ kind: 'cjk' | 'word'; chars: string[] }> {
+  const runs: Array<{ kind: 'cjk' | 'word'; chars: string[] }> = []
+  let current: { kind: 'cjk' | 'word'; chars: string[] } | null = null
+  for (const char of normalize(text)) {
+    const kind = classify(char)
+    if (kind === 'other') {
+      current = null
+      continue
+    }
+    if (!current || current.kind !== kind) {
+      current = { kind, chars: [] }
+      runs.push(current)
+    }
+    current.chars.push(char)
+  }
+  return runs
+}
+
+/**
+ * 文档分词
+ */
+export function tokenize(text: string): SearchToken[] {
+  const tokens: SearchToken[] = []
+  let position = 0
+  for (const run of splitRuns(text)) {
+    if (run.kind === 'word') {
+      tokens.push({ term: run.chars.join(''), position: position++ })
+      continue
+    }
+    const { chars } = run
+    for (let i = 0; i + 1 < chars.length; i++) {
+      tokens.push({ term: chars[i] + chars[i + 1], position: position + i })
+    }
+    tokens.push({ term: chars[chars.length - 1], position: position + chars.length - 1 })
+    position += chars.length
+  }
+  return tokens
+}
+
+/**
+ * 把一段查询文本切分为短语内的词元
+ * CJK 段末字仅在段长为 1 或后面还有词段时保留（与文档分词对齐）；
+ * allowPrefix 时，末尾的词或单字按前缀匹配
+ */
+function tokenizePhrase(text: string, allowPrefix: boolean): QueryToken[] {
+  const tokens: QueryToken[] = []
+  const runs = splitRuns(text)
+  let position = 0
+  runs.forEach((run, index) => {
+    const isLast = index === runs.length - 1
+    if (run.kind === 'word') {
+      tokens.push({ term: run.chars.join(''), prefix: allowPrefix && isLast, offset: position++ })
+      return
+    }
+    const { chars } = run
+    for (let i = 0; i + 1 < chars.length; i++) {
+      tokens.push({ term: chars[i] + chars[i + 1], prefix: false, offset: position + i })
+    }
+    if (chars.length === 1 || !isLast) {
+      tokens.push({
+        term: chars[chars.length - 1],
+        prefix: allowPrefix && isLast,
+        offset: position + chars.length - 1,
+      })
+    }
+    position += chars.length
+  })
+  return tokens
+}
+
+/**
+ * 解析查询：引号内为精确短语，其余按空白拆分，每段为一个允许前缀的短语；各段取交集
+ */
+export function parseQuery(query: string): QueryToken[][] {
+  const clauses: QueryToken[][] = []
+  const pattern = /"([^"]*)"?|(\S+)/g
+  let match: RegExpExecArray | null
+  while ((match = pattern.exec(query)) !== null) {
+    const tokens = match[1] !== undefined ? tokenizePhrase(match[1], false) : tokenizePhrase(match[2], true)
+    if (tokens.length > 0) clauses.push(tokens)
+  }
+  return clauses
+}
+
+/**
+ * 只追加的压缩倒排链表
+ */
+class PostingList {
+  data: Uint8Array
+  length: number
+  lastDoc: number
+  docCount: number
+
+  constructor(data = new Uint8Array(16), length = 0, lastDoc = -1, docCount = 0) {
+    this.data = data
+    this.length = length
+    this.lastDoc = lastDoc
+    this.docCount = docCount
+  }
+
+  append(doc: number, positions: number[]): void {
+    this.ensure(5 * (positions.length + 2))
+    this.writeVarint(doc - this.lastDoc)
+    this.writeVarint(positions.length)
+    let previous = 0
+    for (const position of positions) {
+      this.writeVarint(position - previous)
+      previous = position
+    }
+    this.lastDoc = doc
+    this.docCount++
+  }
+
+  private ensure(extra: number): void {
+    if (this.length + extra <= this.data.length) return
+    const next = new Uint8Array(Math.max(this.data.length * 2, this.length + extra))
+    next.set(this.data.subarray(0, this.length))
+    this.data = next
+  }
+
+  private writeVarint(value: number): void {
+    while (value >= 0x80) {
+      this.data[this.length++] = (value & 0x7f) | 0x80
+      value = Math.floor(value / 128)
+    }
+    this.data[this.length++] = value
+  }
+}
+
+/**
+ * 读取 varint，返回值与新的偏移；绝大多数差值小于 128，单字节时直接返回
+ */
+function readVarint(data: Uint8Array, offset: number): [number, number] {
+  let byte = data[offset++]
+  let value = byte & 0x7f
+  for (let scale = 128; byte & 0x80; scale *= 128) {
+    byte = data[offset++]
+    value += (byte & 0x7f) * scale
+  }
+  return [value, offset]
+}
+
+/**
+ * 倒排游标：doc 为当前文档号，耗尽后为 Infinity
+ */
+interface PostingCursor {
+  doc: number
+  readonly docCount: number
+  /** 前进到第一个不小于 target 的文档 */
+  seek(target: number): void
+  /** 当前文档中的位置 */
+  positions(): number[]
+}
+
+/** 一个短语内各词元及其游标 */
+type PhraseClause = Array<{ token: QueryToken; cursor: PostingCursor }>
+
+/**
+ * 单条链表的游标；跳过文档时只扫描位置的 varint 边界，不解码
+ */
+class ListCursor implements PostingCursor {
+  doc = -1
+  private offset = 0
+  private positionsOffset = 0
+  private positionCount = 0
+
+  constructor(private readonly list: PostingList) {
+    this.next()
+  }
+
+  get docCount(): number {
+    return this.list.docCount
+  }
+
+  seek(target: number): void {
+    while (this.doc < target) this.next()
+  }
+
+  positions(): number[] {
+    const positions = new Array<number>(this.positionCount)
+    let offset = this.positionsOffset
+    let position = 0
+    for (let i = 0; i < this.positionCount; i++) {
+      const [delta, next] = readVarint(this.list.data, offset)
+      position += delta
+      positions[i] = position
+      offset = next
+    }
+    return positions
+  }
+
+  private next(): void {
+    const { data, length } = this.list
+    let offset = this.offset
+    if (offset >= length) {
+      this.doc = Infinity
+      return
+    }
+    let byte = data[offset++]
+    if (byte < 0x80) {
+      this.doc += byte
+    } else {
+      const [delta, next] = readVarint(data, offset - 1)
+      this.doc += delta
+      offset = next
+    }
+    byte = data[offset++]
+    if (byte < 0x80) {
+      this.positionCount = byte
+    } else {
+      const [count, next] = readVarint(data, offset - 1)
+      this.positionCount = count
+      offset = next
+    }
+    this.positionsOffset = offset
+    for (let i = 0; i < this.positionCount; i++) {
+      while (data[offset++] & 0x80) {
+        // 跳过多字节 varint 的后续字节
+      }
+    }
+    this.offset = offset
+  }
+}
+
+/**
+ * 前缀展开为多个词时，预先合并为一个有序的文档表
+ */
+class MergedCursor implements PostingCursor {
+  doc = Infinity
+  readonly docCount: number
+  private readonly docs: number[]
+  private readonly byDoc = new Map<number, number[]>()
+  private index = 0
+
+  constructor(lists: PostingList[]) {
+    for (const list of lists) {
+      const cursor = new ListCursor(list)
+      for (; cursor.doc !== Infinity; cursor.seek(cursor.doc + 1)) {
+        const existing = this.byDoc.get(cursor.doc)
+        if (existing) existing.push(...cursor.positions())
+        else this.byDoc.set(cursor.doc, cursor.positions())
+      }
+    }
+    this.docs = [...this.byDoc.keys()].sort((a, b) => a - b)
+    this.docCount = this.docs.length
+    this.doc = this.docs[0] ?? Infinity
+  }
+
+  seek(target: number): void {
+    while (this.index < this.docs.length && this.docs[this.index] < target) this.index++
+    this.doc = this.docs[this.index] ?? Infinity
+  }
+
+  positions(): number[] {
+    return this.byDoc.get(this.doc) ?? []
+  }
+}
+
+export class TranscriptSearchIndex {
+  private readonly snapshotPath: string
+  private readonly logPath: string
+  private docs: DocumentSlot[] = []
+  private docById = new Map<string, number>()
+  private postings = new Map<string, PostingList>()
+  /** 按字典序排列的词表，用于前缀查找；新增词时置空，查询时按需重建 */
+  private sortedTerms: string[] | null = null
+  private deadCount = 0
+  private logEntries = 0
+
+  constructor(private readonly dir: string) {
+    this.snapshotPath = path.join(dir, SNAPSHOT_FILE)
+    this.logPath = path.join(dir, LOG_FILE)
+  }
+
+  get size(): number {
+    return this.docById.size
+  }
+
+  has(id: string): boolean {
+    return this.docById.has(id)
+  }
+
+  ids(): string[] {
+    return [...this.docById.keys()]
+  }
+
+  /**
+   * 加载快照并重放日志；快照缺失或格式不符时返回 false，由调用方重建
+   */
+  async load(): Promise<boolean> {
+    let snapshot: Buffer
+    try {
+      snapshot = await fs.readFile(this.snapshotPath)
+    } catch (error) {
+      if ((error as NodeJS.ErrnoException).code === 'ENOENT') return false
+      throw error
+    }
+    this.reset()
+    if (!this.readSnapshot(snapshot)) {
+      this.reset()
+      return false
+    }
+    await this.replayLog()
+    // 墓碑占多数时由调用方重建，否则只把日志合并进快照
+    if (this.deadCount > this.docById.size && this.deadCount >= SNAPSHOT_LOG_ENTRIES) {
+      return false
+    }
+    if (this.logEntries >= SNAPSHOT_LOG_ENTRIES) {
+      await this.writeSnapshot()
+    }
+    return true
+  }
+
+  /**
+   * 新增或替换文档（空文本也登记，便于与会话索引对账）
+   */
+  async upsert(document: SearchDocument): Promise<void> {
+    await this.remove([document.id])
+    const docId = this.docs.length
+    await this.appendLog(OP_ADD, this.encodeAdd(docId, document))
+    this.addDocument(docId, document)
+  }
+
+  async remove(ids: Iterable<string>): Promise<void> {
+    const payloads: Buffer[] = []
+    for (const id of ids) {
+      const docId = this.docById.get(id)
+      if (docId === undefined) continue
+      const payload = Buffer.alloc(4)
+      payload.writeUInt32LE(docId, 0)
+      payloads.push(payload)
+      this.removeDocument(docId)
+    }
+    if (payloads.length > 0) {
+      await this.appendLog(OP_REMOVE, ...payloads)
+    }
+  }
+
+  /**
+   * 用给定文档重建索引
+   */
+  async rebuild(documents: SearchDocument[]): Promise<void> {
+    this.reset()
+    const sorted = [...documents].sort((a, b) => a.sortKey - b.sortKey)
+    for (const document of sorted) {
+      this.addDocument(this.docs.length, document)
+    }
+    await fs.mkdir(this.dir, { recursive: true })
+    await this.writeSnapshot()
+  }
+
+  /**
+   * 查询；结果按时间倒序分页
+   * 所有词元的游标做跳跃式求交（由最稀有的词驱动），命中文档再校验短语位置，
+   * 只保留当前页所需的前 offset + limit 条
+   */
+  search(query: string, options: { limit: number; offset: number }): SearchResult {
+    const clauses: PhraseClause[] = []
+    const cursors: PostingCursor[] = []
+    for (const tokens of parseQuery(query)) {
+      const clause: PhraseClause = []
+      for (const token of tokens) {
+        const cursor = this.openCursor(token)
+        if (!cursor) return { ids: [], total: 0 }
+        clause.push({ token, cursor })
+        cursors.push(cursor)
+      }
+      clauses.push(clause)
+    }
+    if (clauses.length === 0) return { ids: [], total: 0 }
+    cursors.sort((a, b) => a.docCount - b.docCount)
+
+    const keep = options.offset + options.limit
+    const top: number[] = []
+    let total = 0
+    let target = 0
+    outer: for (;;) {
+      for (const cursor of cursors) {
+        cursor.seek(target)
+        if (cursor.doc === Infinity) break outer
+        if (cursor.doc > target) {
+          target = cursor.doc
+          continue outer
+        }
+      }
+      if (this.docs[target].alive && clauses.every((clause) => this.matchPhrase(clause))) {
+        total++
+        this.keepTop(top, target, keep)
+      }
+      target++
+    }
+
+    return {
+      ids: top.slice(options.offset).map((docId) => this.docs[docId].id),
+      total,
+    }
+  }
+
+  /**
+   * 按（时间, 文档号）倒序维护前 keep 条
+   */
+  private keepTop(top: number[], docId: number, keep: number): void {
+    const before = (a: number, b: number) =>
+      this.docs[a].sortKey > this.docs[b].sortKey || (this.docs[a].sortKey === this.docs[b].sortKey && a > b)
+    if (top.length >= keep && !before(docId, top[top.length - 1])) return
+    let low = 0
+    let high = top.length
+    while (low < high) {
+      const mid = (low + high) >>> 1
+      if (before(top[mid], docId)) low = mid + 1
+      else high = mid
+    }
+    top.splice(low, 0, docId)
+    if (top.length > keep) top.pop()
+  }
+
+  /**
+   * 词元的游标；前缀匹配时合并多条链表，无匹配时返回 null
+   */
+  private openCursor(token: QueryToken): PostingCursor | null {
+    if (!token.prefix) {
+      const list = this.postings.get(token.term)
+      return list ? new ListCursor(list) : null
+    }
+    const terms = this.getSortedTerms()
+    let low = 0
+    let high = terms.length
+    while (low < high) {
+      const mid = (low + high) >>> 1
+      if (terms[mid] < token.term) low = mid + 1
+      else high = mid
+    }
+    const lists: PostingList[] = []
+    for (let i = low; i < terms.length && terms[i].startsWith(token.term); i++) {
+      lists.push(this.postings.get(terms[i])!)
+      if (lists.length >= MAX_PREFIX_TERMS) break
+    }
+    if (lists.length === 0) return null
+    return lists.length === 1 ? new ListCursor(lists[0]) : new MergedCursor(lists)
+  }
+
+  /**
+   * 短语校验（各游标已停在同一文档）：存在起点 p，使每个词元都出现在 p + offset
+   */
+  private matchPhrase(clause: PhraseClause): boolean {
+    if (clause.length === 1) return true
+    let anchor = clause[0]
+    for (const item of clause) {
+      if (item.cursor.docCount < anchor.cursor.docCount) anchor = item
+    }
+    const positions = clause.map((item) => (item === anchor ? [] : item.cursor.positions()))
+    return anchor.cursor.positions().some((position) => {
+      const start = position - anchor.token.offset
+      return clause.every((item, index) => item === anchor || positions[index].includes(start + item.token.offset))
+    })
+  }
+
+  private getSortedTerms(): string[] {
+    if (!this.sortedTerms) {
+      this.sortedTerms = [...this.postings.keys()].sort()
+    }
+    return this.sortedTerms
+  }
+
+  private addDocument(docId: number, document: SearchDocument): void {
+    this.docs[docId] = { id: document.id, sortKey: document.sortKey, alive: true }
+    this.docById.set(document.id, docId)
+    const byTerm = new Map<string, number[]>()
+    for (const token of tokenize(document.text)) {
+      const positions = byTerm.get(token.term)
+      if (positions) positions.push(token.position)
+      else byTerm.set(token.term, [token.position])
+    }
+    for (const [term, positions] of byTerm) {
+      let list = this.postings.get(term)
+      if (!list) {
+        list = new PostingList()
+        this.postings.set(term, list)
+        this.sortedTerms = null
+      }
+      list.append(docId, positions)
+    }
+  }
+
+  private removeDocument(docId: number): void {
+    const slot = this.docs[docId]
+    if (!slot?.alive) return
+    slot.alive = false
+    if (this.docById.get(slot.id) === docId) {
+      this.docById.delete(slot.id)
+    }
+    this.deadCount++
+  }
+
+  private encodeAdd(docId: number, document: SearchDocument): Buffer {
+    const text = Buffer.from(document.text, 'utf8')
+    const payload = Buffer.alloc(4 + 8 + ID_BYTES + text.length)
+    payload.writeUInt32LE(docId, 0)
+    payload.writeDoubleLE(document.sortKey, 4)
+    payload.write(document.id, 12, ID_BYTES, 'ascii')
+    text.copy(payload, 12 + ID_BYTES)
+    return payload
+  }
+
+  private async appendLog(op: number, ...payloads: Buffer[]): Promise<void> {
+    const parts: Buffer[] = []
+    for (const payload of payloads) {
+      const header = Buffer.alloc(LOG_ENTRY_HEADER_BYTES)
+      header.writeUInt8(op, 0)
+      header.writeUInt32LE(payload.length, 1)
+      parts.push(header, payload)
+    }
+    await fs.appendFile(this.logPath, Buffer.concat(parts))
+    this.logEntries += payloads.length
+  }
+
+  private async replayLog(): Promise<void> {
+    let log: Buffer
+    try {
+      log = await fs.readFile(this.logPath)
+    } catch (error) {
+      if ((error as NodeJS.ErrnoException).code === 'ENOENT') return
+      throw error
+    }
+    let offset = 0
+    while (offset + LOG_ENTRY_HEADER_BYTES <= log.length) {
+      const op = log.readUInt8(offset)
+      const length = log.readUInt32LE(offset + 1)
+      const end = offset + LOG_ENTRY_HEADER_BYTES + length
+      if (end > log.length) break
+      const payload = log.subarray(offset + LOG_ENTRY_HEADER_BYTES, end)
+      if (op === OP_ADD && payload.length >= 12 + ID_BYTES) {
+        const docId = payload.readUInt32LE(0)
+        // 文档号必须接续，否则说明日志与快照不匹配，之后的条目丢弃
+        if (docId !== this.docs.length) break
+        const idEnd = payload.indexOf(0, 12)
+        this.addDocument(docId, {
+          id: payload.toString('ascii', 12, idEnd >= 12 && idEnd < 12 + ID_BYTES ? idEnd : 12 + ID_BYTES),
+          sortKey: payload.readDoubleLE(4),
+          text: payload.toString('utf8', 12 + ID_BYTES),
+        })
+      } else if (op === OP_REMOVE && payload.length === 4) {
+        this.removeDocument(payload.readUInt32LE(0))
+      } else {
+        break
+      }
+      this.logEntries++
+      offset = end
+    }
+    if (offset !== log.length) {
+      await fs.truncate(this.logPath, offset)
+    }
+  }
+
+  /**
+   * 快照格式（小端）：
+   *   'STFS' u32 版本 u32 文档数 u32 词数
+   *   文档：ID(36) f64 排序时间 u8 是否有效
+   *   词：u16 词长 词 UTF-8 u32 末文档号+1 u32 文档数 u32 数据长度 数据
+   */
+  private readSnapshot(snapshot: Buffer): boolean {
+    if (snapshot.length < 16 || snapshot.toString('ascii', 0, 4) !== SNAPSHOT_MAGIC) return false
+    if (snapshot.readUInt32LE(4) !== SNAPSHOT_VERSION) return false
+    try {
+      const docCount = snapshot.readUInt32LE(8)
+      const termCount = snapshot.readUInt32LE(12)
+      let offset = 16
+      for (let docId = 0; docId < docCount; docId++) {
+        const idEnd = snapshot.indexOf(0, offset)
+        const id = snapshot.toString('ascii', offset, idEnd >= offset && idEnd < offset + ID_BYTES ? idEnd : offset + ID_BYTES)
+        const sortKey = snapshot.readDoubleLE(offset + ID_BYTES)
+        const alive = snapshot.readUInt8(offset + ID_BYTES + 8) === 1
+        offset += ID_BYTES + 9
+        this.docs.push({ id, sortKey, alive })
+        if (alive) this.docById.set(id, docId)
+        else this.deadCount++
+      }
+      for (let i = 0; i < termCount; i++) {
+        const termLength = snapshot.readUInt16LE(offset)
+        const term = snapshot.toString('utf8', offset + 2, offset + 2 + termLength)
+        offset += 2 + termLength
+        const lastDoc = snapshot.readUInt32LE(offset) - 1
+        const count = snapshot.readUInt32LE(offset + 4)
+        const length = snapshot.readUInt32LE(offset + 8)
+        offset += 12
+        if (offset + length > snapshot.length) return false
+        // 指向快照缓冲区的视图，追加时才复制
+        this.postings.set(term, new PostingList(snapshot.subarray(offset, offset + length), length, lastDoc, count))
+        offset += length
+      }
+      return offset === snapshot.length
+    } catch {
+      return false
+    }
+  }
+
+  /**
+   * 写入快照并清空日志；先写临时文件再替换
+   */
+  private async writeSnapshot(): Promise<void> {
+    const header = Buffer.alloc(16)
+    header.write(SNAPSHOT_MAGIC, 0, 'ascii')
+    header.writeUInt32LE(SNAPSHOT_VERSION, 4)
+    header.writeUInt32LE(this.docs.length, 8)
+    header.writeUInt32LE(this.postings.size, 12)
+
+    const docs = Buffer.alloc(this.docs.length * (ID_BYTES + 9))
+    this.docs.forEach((slot, docId) => {
+      const base = docId * (ID_BYTES + 9)
+      docs.write(slot.id, base, ID_BYTES, 'ascii')
+      docs.writeDoubleLE(slot.sortKey, base + ID_BYTES)
+      docs.writeUInt8(slot.alive ? 1 : 0, base + ID_BYTES + 8)
+    })
+
+    const parts: Buffer[] = [header, docs]
+    for (const [term, list] of this.postings) {
+      const termBytes = Buffer.from(term, 'utf8')
+      const meta = Buffer.alloc(2 + termBytes.length + 12)
+      meta.writeUInt16LE(termBytes.length, 0)
+      termBytes.copy(meta, 2)
+      meta.writeUInt32LE(list.lastDoc + 1, 2 + termBytes.length)
+      meta.writeUInt32LE(list.docCount, 6 + termBytes.length)
+      meta.writeUInt32LE(list.length, 10 + termBytes.length)
+      parts.push(meta, Buffer.from(list.data.buffer, list.data.byteOffset, list.length))
+    }
+
+    const tempPath = `${this.snapshotPath}.tmp`
+    await fs.writeFile(tempPath, Buffer.concat(parts))
+    await fs.rename(tempPath, this.snapshotPath)
+    await fs.rm(this.logPath, { force: true })
+    this.logEntries = 0
+  }
+
+  private reset(): void {
+    this.docs = []
+    this.docById = new Map()
+    this.postings = new Map()
+    this.sortedTerms = null
+    this.deadCount = 0
+    this.logEntries = 0
+  }
+}
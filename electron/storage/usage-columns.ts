@@ -0,0 +1,455 @@
+/**
+ * 使用统计列存储
+ *
+ * 统计历史记录（每日次数、录音时长、各模型耗时与语速、失败率）不再读取每条记录，
+ * 而是扫描 conversations/.index/usage 下按列存放的定长数据，每列一个文件：
+ *   ids.col       16 字节会话 UUID
+ *   finished.col  f64 完成时间
+ *   duration.col  u32 录音时长（毫秒）
+ *   latency.col   u32 录音结束到出结果的耗时（毫秒，估算）
+ *   words.col     u32 字数（中日韩按字、其他按词计）
+ *   model.col     u16 模型编号，对应 models.json 中的下标
+ *   flags.col     u8  USAGE_FLAG_ERROR 失败，USAGE_FLAG_DEAD 已删除或被新版本取代
+ *
+ * 写入只追加新行；删除和更新只改写旧行的 flags。行数取各列完整行数的最小值，
+ * 崩溃后的半行在打开时丢弃，由调用方与会话索引对账补齐。
+ * 各列在内存中为定型数组，统计时对数组做一次顺序扫描。
+ */
+
+import fs from 'node:fs/promises'
+import path from 'node:path'
+import type { ConversationRecord, ModelUsageStats, UsageAnalytics, UsageAnalyticsOptions } from '../../shared/conversation'
+
+const USAGE_FLAG_ERROR = 1
+const USAGE_FLAG_DEAD = 2
+
+const DAY_MS = 24 * 60 * 60 * 1000
+const INITIAL_CAPACITY = 1024
+const MODELS_FILE = 'models.json'
+const UNKNOWN_MODEL = '未知'
+
+type ColumnName = 'ids' | 'finished' | 'duration' | 'latency' | 'words' | 'model' | 'flags'
+
+/** 每列每行的字节数 */
+const COLUMN_WIDTHS: Record<ColumnName, number> = {
+  ids: 16,
+  finished: 8,
+  duration: 4,
+  latency: 4,
+  words: 4,
+  model: 2,
+  flags: 1,
+}
+
+const COLUMN_NAMES = Object.keys(COLUMN_WIDTHS) as ColumnName[]
+
+const CJK_PATTERN = /[\p{Script=Han}\p{Script=Hiragana}\p{Script=Katakana}\p{Script=Hangul}]/gu
+const WORD_PATTERN = /[\p{L}\p{N}]+/gu
+
+/**
+ * 字数：中日韩字符逐字计数，其余按连续字母数字计词
+ */
+export function countWords(text: string): number {
+  const cjk = text.match(CJK_PATTERN)?.length ?? 0
+  const words = text.replace(CJK_PATTERN, ' ').match(WORD_PATTERN)?.length ?? 0
+  return cjk + words
+}
+
+/** 行索引以去掉连字符的小写十六进制为键，加载时可直接从整列的十六进制串切出 */
+function rowKey(id: string): string {
+  return id.replace(/-/g, '').toLowerCase()
+}
+
+function keyToUuid(key: string): string {
+  return `${key.slice(0, 8)}-${key.slice(8, 12)}-${key.slice(12, 16)}-${key.slice(16, 20)}-${key.slice(20)}`
+}
+
+function clampU32(value: number): number {
+  return Number.isFinite(value) ? Math.min(Math.max(Math.round(value), 0), 0xffffffff) : 0
+}
+
+interface UsageRow {
+  finished: number
+  duration: number
+  latency: number
+  words: number
+  model: number
+  flags: number
+}
+
+export class UsageColumns {
+  private rows = 0
+  private capacity = 0
+  private idBytes = new Uint8Array(0)
+  private finished = new Float64Array(0)
+  private duration = new Uint32Array(0)
+  private latency = new Uint32Array(0)
+  private words = new Uint32Array(0)
+  private model = new Uint16Array(0)
+  private flags = new Uint8Array(0)
+  private models: string[] = []
+  /** 已写入 models.json 的模型数 */
+  private modelsWritten = 0
+  private modelCodes = new Map<string, number>()
+  private rowById = new Map<string, number>()
+  private files = new Map<ColumnName, fs.FileHandle>()
+
+  constructor(private readonly dir: string) {}
+
+  get size(): number {
+    return this.rowById.size
+  }
+
+  has(id: string): boolean {
+    return this.rowById.has(rowKey(id))
+  }
+
+  ids(): string[] {
+    return [...this.rowById.keys()].map(keyToUuid)
+  }
+
+  /**
+   * 加载各列；目录不存在时返回 false，由调用方重建
+   */
+  async load(): Promise<boolean> {
+    const buffers = new Map<ColumnName, Buffer>()
+    try {
+      for (const name of COLUMN_NAMES) {
+        buffers.set(name, await fs.readFile(this.columnPath(name)))
+      }
+      this.models = JSON.parse(await fs.readFile(path.join(this.dir, MODELS_FILE), 'utf-8')) as string[]
+    } catch (error) {
+      if ((error as NodeJS.ErrnoException).code === 'ENOENT' || error instanceof SyntaxError) return false
+      throw error
+    }
+    await this.closeFiles()
+
+    const rows = Math.min(...COLUMN_NAMES.map((name) => Math.floor(buffers.get(name)!.length / COLUMN_WIDTHS[name])))
+    this.reset(rows)
+    this.rows = rows
+    const copy = (name: ColumnName, target: ArrayBufferView) => {
+      const source = buffers.get(name)!
+      new Uint8Array(target.buffer, target.byteOffset, rows * COLUMN_WIDTHS[name]).set(source.subarray(0, rows * COLUMN_WIDTHS[name]))
+    }
+    copy('ids', this.idBytes)
+    copy('finished', this.finished)
+    copy('duration', this.duration)
+    copy('latency', this.latency)
+    copy('words', this.words)
+    copy('model', this.model)
+    copy('flags', this.flags)
+
+    this.modelCodes = new Map(this.models.map((modelId, code) => [modelId, code]))
+    const hex = buffers.get('ids')!.toString('hex', 0, rows * 16)
+    for (let row = 0; row < rows; row++) {
+      if (this.flags[row] & USAGE_FLAG_DEAD) continue
+      this.rowById.set(hex.slice(row * 32, row * 32 + 32), row)
+    }
+    return true
+  }
+
+  /**
+   * 写入或更新一条记录（旧行标记删除后追加新行）
+   */
+  async upsert(record: ConversationRecord): Promise<void> {
+    const key = rowKey(record.id)
+    const previous = this.rowById.get(key)
+    if (previous !== undefined) {
+      await this.markDead(previous)
+    }
+    const row = this.toRow(record)
+    await this.ensureModels()
+    await this.appendRow(key, row)
+  }
+
+  async remove(ids: Iterable<string>): Promise<void> {
+    for (const id of ids) {
+      const key = rowKey(id)
+      const row = this.rowById.get(key)
+      if (row === undefined) continue
+      await this.markDead(row)
+      this.rowById.delete(key)
+    }
+  }
+
+  /**
+   * 用给定记录重写全部列（临时目录 + 重命名）
+   */
+  async rebuild(records: ConversationRecord[]): Promise<void> {
+    await this.closeFiles()
+    this.models = []
+    this.modelCodes.clear()
+    this.reset(records.length)
+    for (const record of records) {
+      const key = rowKey(record.id)
+      if (this.rowById.has(key)) continue
+      this.setRow(this.rows, key, this.toRow(record))
+      this.rowById.set(key, this.rows)
+      this.rows++
+    }
+
+    const tmpDir = `${this.dir}.tmp`
+    await fs.rm(tmpDir, { recursive: true, force: true })
+    await fs.mkdir(tmpDir, { recursive: true })
+    for (const name of COLUMN_NAMES) {
+      await fs.writeFile(path.join(tmpDir, `${name}.col`), this.columnBytes(name, 0, this.rows))
+    }
+    await fs.writeFile(path.join(tmpDir, MODELS_FILE), JSON.stringify(this.models), 'utf-8')
+    await fs.rm(this.dir, { recursive: true, force: true })
+    await fs.rename(tmpDir, this.dir)
+    this.modelsWritten = this.models.length
+  }
+
+  /**
+   * 按时间范围汇总：对各列做一次顺序扫描
+   */
+  aggregate(options: UsageAnalyticsOptions = {}): UsageAnalytics {
+    const startedAt = performance.now()
+    const from = options.from ?? -Infinity
+    const to = options.to ?? Infinity
+    const offsetMs = (options.timezoneOffsetMinutes ?? new Date().getTimezoneOffset()) * 60 * 1000
+
+    const modelCount = this.models.length + 1
+    const byModelCount = new Float64Array(modelCount)
+    const byModelErrors = new Float64Array(modelCount)
+    const byModelSpoken = new Float64Array(modelCount)
+    const byModelOkSpoken = new Float64Array(modelCount)
+    const byModelLatency = new Float64Array(modelCount)
+    const byModelWords = new Float64Array(modelCount)
+    const dayCounts = new Map<number, { count: number; spokenMs: number }>()
+
+    const { finished, duration, latency, words, model, flags } = this
+    let lastDay = NaN
+    let lastBucket: { count: number; spokenMs: number } | undefined
+    for (let row = 0; row < this.rows; row++) {
+      const flag = flags[row]
+      if (flag & USAGE_FLAG_DEAD) continue
+      const time = finished[row]
+      if (time < from || time >= to) continue
+      // 未知编号（模型表写入前崩溃）归入最后一格
+      const code = model[row] < modelCount - 1 ? model[row] : modelCount - 1
+      const spoken = duration[row]
+      byModelCount[code]++
+      byModelSpoken[code] += spoken
+      if (flag & USAGE_FLAG_ERROR) {
+        byModelErrors[code]++
+      } else {
+        byModelOkSpoken[code] += spoken
+        byModelLatency[code] += latency[row]
+        byModelWords[code] += words[row]
+      }
+      // 记录大致按时间追加，相邻行多在同一天
+      const day = Math.floor((time - offsetMs) / DAY_MS)
+      if (day !== lastDay) {
+        lastDay = day
+        lastBucket = dayCounts.get(day)
+        if (!lastBucket) {
+          lastBucket = { count: 0, spokenMs: 0 }
+          dayCounts.set(day, lastBucket)
+        }
+      }
+      lastBucket!.count++
+      lastBucket!.spokenMs += spoken
+    }
+
+    let count = 0
+    let errorCount = 0
+    let spokenMs = 0
+    let okSpokenMs = 0
+    let latencyMs = 0
+    let totalWords = 0
+    const models: ModelUsageStats[] = []
+    for (let code = 0; code < modelCount; code++) {
+      const rows = byModelCount[code]
+      if (rows === 0) continue
+      const okRows = rows - byModelErrors[code]
+      count += rows
+      errorCount += byModelErrors[code]
+      spokenMs += byModelSpoken[code]
+      okSpokenMs += byModelOkSpoken[code]
+      latencyMs += byModelLatency[code]
+      totalWords += byModelWords[code]
+      models.push({
+        modelId: this.models[code] ?? UNKNOWN_MODEL,
+        count: rows,
+        spokenMs: byModelSpoken[code],
+        avgLatencyMs: okRows > 0 ? byModelLatency[code] / okRows : null,
+        wordsPerMinute: byModelOkSpoken[code] > 0 ? byModelWords[code] / (byModelOkSpoken[code] / 60000) : null,
+        errorRate: byModelErrors[code] / rows,
+      })
+    }
+    models.sort((a, b) => b.count - a.count)
+
+    const daily = [...dayCounts.entries()]
+      .sort((a, b) => a[0] - b[0])
+      .map(([day, bucket]) => ({
+        day: new Date(day * DAY_MS).toISOString().slice(0, 10),
+        count: bucket.count,
+        spokenMs: bucket.spokenMs,
+      }))
+
+    const okCount = count - errorCount
+    return {
+      count,
+      errorCount,
+      errorRate: count > 0 ? errorCount / count : 0,
+      spokenMs,
+      words: totalWords,
+      wordsPerMinute: okSpokenMs > 0 ? totalWords / (okSpokenMs / 60000) : null,
+      avgLatencyMs: okCount > 0 ? latencyMs / okCount : null,
+      daily,
+      models,
+      rows: this.rows,
+      elapsedMs: performance.now() - startedAt,
+    }
+  }
+
+  async close(): Promise<void> {
+    await this.closeFiles()
+  }
+
+  private toRow(record: ConversationRecord): UsageRow {
+    const finished = record.finishedAt || record.startedAt || 0
+    return {
+      finished,
+      duration: clampU32(record.durationMs),
+      latency: clampU32(finished - (record.startedAt || finished) - (record.durationMs || 0)),
+      words: countWords(record.transcript ?? ''),
+      model: this.modelCode(record.modelId || UNKNOWN_MODEL),
+      flags: record.error ? USAGE_FLAG_ERROR : 0,
+    }
+  }
+
+  private modelCode(modelId: string): number {
+    let code = this.modelCodes.get(modelId)
+    if (code === undefined) {
+      code = this.models.length
+      this.models.push(modelId)
+      this.modelCodes.set(modelId, code)
+    }
+    return code
+  }
+
+  /**
+   * 模型表有新增时先写入，保证行引用的编号已落盘
+   */
+  private async ensureModels(): Promise<void> {
+    if (this.models.length === this.modelsWritten) return
+    await fs.mkdir(this.dir, { recursive: true })
+    const filePath = path.join(this.dir, MODELS_FILE)
+    await fs.writeFile(`${filePath}.tmp`, JSON.stringify(this.models), 'utf-8')
+    await fs.rename(`${filePath}.tmp`, filePath)
+    this.modelsWritten = this.models.length
+  }
+
+  private async appendRow(key: string, row: UsageRow): Promise<void> {
+    const index = this.rows
+    this.grow(index + 1)
+    this.setRow(index, key, row)
+    for (const name of COLUMN_NAMES) {
+      const width = COLUMN_WIDTHS[name]
+      const file = await this.openColumn(name)
+      await file.write(this.columnBytes(name, index, index + 1), 0, width, index * width)
+    }
+    this.rows++
+    this.rowById.set(key, index)
+  }
+
+  private async markDead(row: number): Promise<void> {
+    this.flags[row] |= USAGE_FLAG_DEAD
+    const file = await this.openColumn('flags')
+    await file.write(this.flags, row, 1, row)
+  }
+
+  private setRow(index: number, key: string, row: UsageRow): void {
+    Buffer.from(this.idBytes.buffer, this.idBytes.byteOffset + index * 16, 16).write(key, 'hex')
+    this.finished[index] = row.finished
+    this.duration[index] = row.duration
+    this.latency[index] = row.latency
+    this.words[index] = row.words
+    this.model[index] = row.model
+    this.flags[index] = row.flags
+  }
+
+  private columnBytes(name: ColumnName, start: number, end: number): Buffer {
+    const column = this.columnArray(name)
+    const width = COLUMN_WIDTHS[name]
+    return Buffer.from(column.buffer, column.byteOffset + start * width, (end - start) * width)
+  }
+
+  private columnArray(name: ColumnName): ArrayBufferView {
+    switch (name) {
+      case 'ids': return this.idBytes
+      case 'finished': return this.finished
+      case 'duration': return this.duration
+      case 'latency': return this.latency
+      case 'words': return this.words
+      case 'model': return this.model
+      case 'flags': return this.flags
+    }
+  }
+
+  private reset(capacity: number): void {
+    this.rows = 0
+    this.capacity = 0
+    this.rowById.clear()
+    this.modelsWritten = this.models.length
+    this.grow(Math.max(capacity, INITIAL_CAPACITY))
+  }
+
+  /**
+   * 容量按倍数扩展，保留已有数据
+   */
+  private grow(required: number): void {
+    if (required <= this.capacity) return
+    let capacity = Math.max(this.capacity, INITIAL_CAPACITY)
+    while (capacity < required) capacity *= 2
+    const ids = new Uint8Array(capacity * 16)
+    ids.set(this.idBytes.subarray(0, this.rows * 16))
+    const finished = new Float64Array(capacity)
+    finished.set(this.finished.subarray(0, this.rows))
+    const duration = new Uint32Array(capacity)
+    duration.set(this.duration.subarray(0, this.rows))
+    const latency = new Uint32Array(capacity)
+    latency.set(this.latency.subarray(0, this.rows))
+    const words = new Uint32Array(capacity)
+    words.set(this.words.subarray(0, this.rows))
+    const model = new Uint16Array(capacity)
+    model.set(this.model.subarray(0, this.rows))
+    const flags = new Uint8Array(capacity)
+    flags.set(this.flags.subarray(0, this.rows))
+    this.idBytes = ids
+    this.finished = finished
+    this.duration = duration
+    this.latency = latency
+    this.words = words
+    this.model = model
+    this.flags = flags
+    this.capacity = capacity
+  }
+
+  private columnPath(name: ColumnName): string {
+    return path.join(this.dir, `${name}.col`)
+  }
+
+  private async openColumn(name: ColumnName): Promise<fs.FileHandle> {
+    let file = this.files.get(name)
+    if (!file) {
+      await fs.mkdir(this.dir, { recursive: true })
+      // 'a' 模式下 Linux 会忽略写入位置，这里需要按位置写入
+      file = await fs.open(this.columnPath(name), 'r+').catch(async (error: NodeJS.ErrnoException) => {
+        if (error.code !== 'ENOENT') throw error
+        return fs.open(this.columnPath(name), 'w+')
+      })
+      this.files.set(name, file)
+    }
+    return file
+  }
+
+  private async closeFiles(): Promise<void> {
+    for (const file of this.files.values()) {
+      await file.close()
+    }
+    this.files.clear()
+  }
+}
@@ -0,0 +1,53 @@
+/**
+ * 主进程加载 native/audio-dsp 原生模块
+ * 识别 worker 侧的加载与 JS 回退见 audio-dsp.cjs
+ */
+
+import path from 'node:path'
+import { createModuleLogger } from '../utils/logger'
+
+const logger = createModuleLogger('audio-dsp')
+
+export interface NativeFlacEncoder {
+  /** 输入单声道 16-bit 样本，返回新产生的字节（首次调用包含流头） */
+  encode(samples: Int16Array): Buffer
+  /** 编码剩余样本并结束流 */
+  finish(): Buffer
+}
+
+export interface AudioDspModule {
+  int16ToFloat(samples: Int16Array, channels: number): Float32Array
+  frameEnergy(samples: Float32Array, frameSize: number): Float32Array
+  FlacEncoder: new (sampleRate: number) => NativeFlacEncoder
+}
+
+let cachedModule: AudioDspModule | null | undefined
+
+/**
+ * 加载原生模块，结果缓存；不可用时返回 null
+ */
+export function loadAudioDsp(): AudioDspModule | null {
+  if (cachedModule !== undefined) return cachedModule
+
+  const possiblePaths = [
+    // 开发模式：从源码目录加载
+    path.join(process.cwd(), 'native', 'audio-dsp', 'build', 'Release', 'audio_dsp.node'),
+    path.join(__dirname, '..', '..', 'native', 'audio-dsp', 'build', 'Release', 'audio_dsp.node'),
+    // 生产模式：从 Resources 目录加载
+    path.join(process.resourcesPath ?? '', 'native', 'audio_dsp.node'),
+  ]
+
+  cachedModule = null
+  for (const modulePath of possiblePaths) {
+    try {
+      cachedModule = require(modulePath) as AudioDspModule
+      break
+    } catch {
+      // 尝试下一个路径
+    }
+  }
+  if (!cachedModule) {
+    logger.warn('音频 DSP 原生模块不可用')
+  }
+  return cachedModule
+}
@@ -0,0 +1,132 @@
+// 音频 DSP 内核：优先使用 native/audio-dsp 原生模块（运行时按 CPU 特性选择 SIMD 实现），
+// 模块不可用时回退到等价的 JS 实现。识别 worker 与离线基准测试脚本共用
+const fs = require('fs')
+const path = require('path')
+
+/**
+ * 原生模块候选路径
+ * 1. 主进程通过 SPEECHTIDE_AUDIO_DSP_PATH 传入（生产模式位于 Resources/native/）
+ * 2. 源码目录下的编译产物（开发模式、基准测试脚本）
+ */
+function resolveCandidates() {
+  const candidates = []
+  if (process.env.SPEECHTIDE_AUDIO_DSP_PATH) {
+    candidates.push(process.env.SPEECHTIDE_AUDIO_DSP_PATH)
+  }
+  candidates.push(path.join(__dirname, '..', '..', 'native', 'audio-dsp', 'build', 'Release', 'audio_dsp.node'))
+  if (process.resourcesPath) {
+    candidates.push(path.join(process.resourcesPath, 'native', 'audio_dsp.node'))
+  }
+  return candidates
+}
+
+function loadNative() {
+  for (const candidate of resolveCandidates()) {
+    if (!fs.existsSync(candidate)) continue
+    try {
+      const nativeModule = require(candidate)
+      // 加载时与参考实现逐级比对，任一 SIMD 内核不符则整体退回 scalar
+      const verification = nativeModule.verifyKernels()
+      if (!verification.passed) {
+        const failed = verification.results.filter((item) => !item.passed)
+        console.error('[AudioDsp] SIMD 内核校验失败，回退到 scalar:', JSON.stringify(failed))
+        nativeModule.selectLevel('scalar')
+      }
+      return nativeModule
+    } catch (error) {
+      console.error('[AudioDsp] 无法加载原生模块:', candidate, error.message)
+    }
+  }
+  return null
+}
+
+const nativeModule = loadNative()
+
+/**
+ * 16-bit 交错 PCM 转单声道 Float32（[-1, 1)），多声道取平均
+ * @param {Int16Array} int16
+ * @param {number} channels
+ * @returns {Float32Array}
+ */
+function int16ToFloat(int16, channels) {
+  if (nativeModule) {
+    return nativeModule.int16ToFloat(int16, channels)
+  }
+  const frames = Math.floor(int16.length / channels)
+  const samples = new Float32Array(frames)
+  if (channels === 1) {
+    for (let i = 0; i < frames; i++) {
+      samples[i] = int16[i] / 0x8000
+    }
+    return samples
+  }
+  for (let i = 0; i < frames; i++) {
+    let sample = 0
+    for (let ch = 0; ch < channels; ch++) {
+      sample += int16[i * channels + ch] / 0x8000
+    }
+    samples[i] = sample / channels
+  }
+  return samples
+}
+
+/**
+ * 线性插值重采样（与 electron/utils/wav-parser.ts 的实现一致）
+ * @param {Float32Array} samples
+ * @param {number} sourceSampleRate
+ * @param {number} targetSampleRate
+ */
+function resampleLinear(samples, sourceSampleRate, targetSampleRate) {
+  if (sourceSampleRate === targetSampleRate) return samples
+  if (nativeModule) {
+    return nativeModule.resampleLinear(samples, sourceSampleRate, targetSampleRate)
+  }
+  const ratio = sourceSampleRate / targetSampleRate
+  const outputLength = Math.floor(samples.length / ratio)
+  const output = new Float32Array(outputLength)
+
+  for (let i = 0; i < outputLength; i++) {
+    const srcIndex = i * ratio
+    const srcIndexFloor = Math.floor(srcIndex)
+    const srcIndexCeil = Math.min(srcIndexFloor + 1, samples.length - 1)
+    const fraction = srcIndex - srcIndexFloor
+    output[i] = samples[srcIndexFloor] * (1 - fraction) + samples[srcIndexCeil] * fraction
+  }
+
+  return output
+}
+
+/**
+ * 按帧计算均方根能量，不足一帧的尾部忽略
+ * @param {Float32Array} samples
+ * @param {number} frameSize
+ * @returns {Float32Array}
+ */
+function frameEnergy(samples, frameSize) {
+  if (nativeModule) {
+    return nativeModule.frameEnergy(samples, frameSize)
+  }
+  const frameCount = Math.floor(samples.length / frameSize)
+  const energies = new Float32Array(frameCount)
+  for (let frame = 0; frame < frameCount; frame++) {
+    let sum = 0
+    const start = frame * frameSize
+    for (let i = start; i < start + frameSize; i++) {
+      sum += samples[i] * samples[i]
+    }
+    energies[frame] = Math.sqrt(sum / frameSize)
+  }
+  return energies
+}
+
+/**
+ * 当前使用的实现：CPU 特性、检测到的最高级别与各内核实际级别
+ */
+function getDiagnostics() {
+  if (!nativeModule) {
+    return { native: false }
+  }
+  return { native: true, ...nativeModule.getDiagnostics() }
+}
+
+module.exports = { int16ToFloat, resampleLinear, frameEnergy, getDiagnostics }
@@ -1,18 +1,136 @@
 import type { SenseVoiceTranscriberConfig } from '../config'
-import type { OnlineTranscriptionConfig } from '../../shared/app-state'
+import type { AutotuneCandidateResult, OnlineTranscriptionConfig, TranscriptSegment, TranscriptionPriority, WorkerQueueStats } from '../../shared/app-state'
 import { SenseVoiceTranscriber } from './sensevoice-transcriber'
 import { OpenAITranscriber } from './openai-transcriber'
 
+export { StreamFallbackError } from './stream-fallback'
+
 // 类型定义
 export interface TranscriptionResult {
   text: string
   modelId: string
   durationMs: number
   language?: string
+  /** 长音频分窗转写时的分段结果（带时间戳） */
+  segments?: TranscriptSegment[]
+  /** 识别出的 token 及起始时间，由支持 token 时间戳的转写器提供 */
+  tokens?: TranscriptToken[]
+}
+
+/** 单个 token 及其起始时间（毫秒，相对音频开头） */
+export interface TranscriptToken {
+  start: number
+  text: string
+}
+
+/**
+ * 内存中的原始 PCM 音频（16-bit 小端）
+ * 录音结束后直接交给转写器，避免先写盘再读回
+ */
+export interface PcmAudio {
+  sampleRate: number
+  channels: number
+  bitsPerSample: 16
+  data: Buffer
+}
+
+/**
+ * 流式转写会话：录音期间持续送入 PCM 块，松开按键后只需处理尾段
+ */
+export interface TranscriptionStream {
+  /** 送入一块 16-bit PCM */
+  push(chunk: Buffer): void
+  /** 结束输入并获取完整结果；抛出 StreamFallbackError 时调用方可改为整段转写 */
+  finish(): Promise<TranscriptionResult>
+  /** 放弃本次会话 */
+  cancel(): void
+}
+
+export interface TranscriptionStreamOptions {
+  sampleRate: number
+  channels: number
+  /** 结束时将最后一个已缓存分段与尾段合并重解码 */
+  redecodeBoundary?: boolean
+}
+
+/** 批量转写中单个文件的结果 */
+export interface BatchTranscriptionItem {
+  filePath: string
+  result?: TranscriptionResult
+  error?: string
+}
+
+export interface TranscriberOptions {
+  supportDir: string
+  /** 后台任务（文件转写）使用：降低 worker 进程调度优先级，让位于实时听写 */
+  background?: boolean
+  /** 仅用于基准测试：不加载默认识别器，由 benchmark() 按候选配置逐个创建 */
+  benchmarkOnly?: boolean
+}
+
+/** 基准测试的候选配置 */
+export interface BenchmarkCandidate {
+  /** 模型目录下的模型文件名 */
+  variant: string
+  numThreads: number
+}
+
+export interface BenchmarkRequest {
+  audioPath: string
+  candidates: BenchmarkCandidate[]
+  /** 每个候选计时解码的次数（预热一次不计入） */
+  runs: number
+  onProgress?: (completed: number, total: number) => void
+}
+
+export interface BenchmarkReport {
+  /** 测试音频时长（毫秒） */
+  audioMs: number
+  results: AutotuneCandidateResult[]
+}
+
+export interface TranscribeOptions {
+  /** 默认 live；后台任务在 worker 中按分段解码并让位于实时请求 */
+  priority?: TranscriptionPriority
+  /** 中止后 worker 放弃该请求，Promise 以“转写已取消”拒绝 */
+  signal?: AbortSignal
+}
+
+/** 长音频转写的增量结果 */
+export interface LongTranscriptionProgress {
+  /** 本次新解码的分段 */
+  segments: TranscriptSegment[]
+  /** 已处理的音频时长 / 总时长（毫秒） */
+  processedMs: number
+  totalMs: number
+}
+
+export interface LongTranscribeOptions {
+  /** 每次读取的音频窗口（毫秒），决定内存占用上限 */
+  windowMs: number
+  onProgress?: (progress: LongTranscriptionProgress) => void
+  /** 中止后 worker 在下一个分段边界停止读取与解码 */
+  signal?: AbortSignal
 }
 
 export interface Transcriber {
-  transcribe(filePath: string): Promise<TranscriptionResult>
+  transcribe(filePath: string, options?: TranscribeOptions): Promise<TranscriptionResult>
+  /** 直接转写内存中的 PCM，未实现的转写器回退到 transcribe(filePath) */
+  transcribePcm?(pcm: PcmAudio): Promise<TranscriptionResult>
+  /** 开启流式转写会话，不支持（或当前配置无法流式）时返回 undefined */
+  startStream?(options: TranscriptionStreamOptions): TranscriptionStream | undefined
+  /** 分窗转写长音频，边解码边回传带时间戳的分段；以后台优先级运行 */
+  transcribeLong?(filePath: string, options: LongTranscribeOptions): Promise<TranscriptionResult>
+  /** 一次提交多个文件批量解码，单个文件失败不影响其他文件 */
+  transcribeBatch?(filePaths: string[], options?: TranscribeOptions): Promise<BatchTranscriptionItem[]>
+  /** 等待模型加载完成，返回 worker 内部的加载耗时（毫秒） */
+  whenReady?(): Promise<number | null>
+  /** 查询识别器进程的常驻内存（字节），不可用时返回 null */
+  getMemoryUsage?(): Promise<number | null>
+  /** 查询识别器调度队列的排队时延统计 */
+  getQueueStats?(): Promise<WorkerQueueStats | null>
+  /** 测量候选模型/线程数的加载耗时与实时率 */
+  benchmark?(request: BenchmarkRequest): Promise<BenchmarkReport>
   destroy?(): void
 }
 
@@ -22,9 +140,9 @@ export interface OpenAITranscriberConfig extends OnlineTranscriptionConfig {
 
 export type TranscriberConfig = SenseVoiceTranscriberConfig | OpenAITranscriberConfig
 
-export function createTranscriber(config: TranscriberConfig, options: { supportDir: string }): Transcriber {
+export function createTranscriber(config: TranscriberConfig, options: TranscriberOptions): Transcriber {
   if (config.engine === 'openai') {
     return new OpenAITranscriber(config)
   }
-  return new SenseVoiceTranscriber(config, { supportDir: options.supportDir })
+  return new SenseVoiceTranscriber(config, options)
 }
@@ -0,0 +1,166 @@
+// worker 内的识别任务调度器
+// 实时听写（live）任务总是优先于后台文件转写（background）任务；
+// 任务以生成器表示，每次 next() 只执行一个工作单元（通常是一个 VAD 分段），
+// 单元之间让出事件循环，新到达的实时请求因此最多等待一个分段的解码时间。
+
+const PRIORITIES = ['live', 'background']
+// 每个优先级保留的最近排队时延样本数（用于计算分位数）
+const DELAY_SAMPLE_LIMIT = 200
+
+class DelayStats {
+  constructor() {
+    this.count = 0
+    this.totalMs = 0
+    this.maxMs = 0
+    this.samples = []
+  }
+
+  record(delayMs) {
+    this.count++
+    this.totalMs += delayMs
+    this.maxMs = Math.max(this.maxMs, delayMs)
+    this.samples.push(delayMs)
+    if (this.samples.length > DELAY_SAMPLE_LIMIT) {
+      this.samples.shift()
+    }
+  }
+
+  snapshot() {
+    const sorted = [...this.samples].sort((a, b) => a - b)
+    const p95 = sorted.length > 0 ? sorted[Math.min(sorted.length - 1, Math.floor(sorted.length * 0.95))] : null
+    return {
+      count: this.count,
+      avgMs: this.count > 0 ? Math.round(this.totalMs / this.count) : null,
+      p95Ms: p95,
+      maxMs: this.count > 0 ? this.maxMs : null,
+    }
+  }
+}
+
+class JobScheduler {
+  constructor() {
+    this.queues = { live: [], background: [] }
+    this.delays = { live: new DelayStats(), background: new DelayStats() }
+    // 实时任务插队时，已开始但未完成的后台任务数
+    this.preemptions = 0
+    this.scheduled = false
+  }
+
+  /**
+   * 提交任务
+   * @param {'live' | 'background'} priority
+   * @param {string} label 任务标识，仅用于日志
+   * @param {Iterator<unknown>} steps 生成器，每次 next() 执行一个工作单元
+   */
+  enqueue(priority, label, steps) {
+    const queue = this.queues[priority] || this.queues.background
+    queue.push({ priority, label, steps, enqueuedAt: Date.now(), started: false })
+    this.schedule()
+  }
+
+  /**
+   * 取消尚未开始的任务（已开始的任务由其自身检查会话状态后退出）
+   * @param {(label: string) => boolean} predicate
+   */
+  cancelPending(predicate) {
+    for (const priority of PRIORITIES) {
+      this.queues[priority] = this.queues[priority].filter((job) => job.started || !predicate(job.label))
+    }
+  }
+
+  /**
+   * 取消任务：排队中的直接出队，已开始的通过 return() 结束生成器（执行其 finally）
+   * @param {(label: string) => boolean} predicate
+   * @returns {number} 被取消的任务数
+   */
+  cancel(predicate) {
+    let cancelled = 0
+    for (const priority of PRIORITIES) {
+      this.queues[priority] = this.queues[priority].filter((job) => {
+        if (!predicate(job.label)) return true
+        cancelled++
+        if (job.started) {
+          try {
+            job.steps.return?.()
+          } catch (error) {
+            console.error(`[Worker] 任务 ${job.label} 取消异常:`, error)
+          }
+        }
+        return false
+      })
+    }
+    return cancelled
+  }
+
+  /**
+   * 把匹配的任务移到另一优先级队列末尾，已开始的任务保持进度
+   * @param {(label: string) => boolean} predicate
+   * @param {'live' | 'background'} priority
+   */
+  setPriority(predicate, priority) {
+    const target = this.queues[priority]
+    if (!target) return
+    for (const source of PRIORITIES) {
+      if (source === priority) continue
+      this.queues[source] = this.queues[source].filter((job) => {
+        if (!predicate(job.label)) return true
+        job.priority = priority
+        target.push(job)
+        return false
+      })
+    }
+    this.schedule()
+  }
+
+  get pending() {
+    return this.queues.live.length + this.queues.background.length
+  }
+
+  getStats() {
+    return {
+      live: { ...this.delays.live.snapshot(), pending: this.queues.live.length },
+      background: { ...this.delays.background.snapshot(), pending: this.queues.background.length },
+      preemptions: this.preemptions,
+    }
+  }
+
+  schedule() {
+    if (this.scheduled) return
+    this.scheduled = true
+    setImmediate(() => {
+      this.scheduled = false
+      this.runNext()
+      if (this.pending > 0) {
+        this.schedule()
+      }
+    })
+  }
+
+  runNext() {
+    const priority = this.queues.live.length > 0 ? 'live' : 'background'
+    const queue = this.queues[priority]
+    const job = queue[0]
+    if (!job) return
+
+    if (!job.started) {
+      job.started = true
+      this.delays[priority].record(Date.now() - job.enqueuedAt)
+      if (priority === 'live' && this.queues.background.some((pending) => pending.started)) {
+        this.preemptions++
+      }
+    }
+
+    let done = true
+    try {
+      done = job.steps.next().done === true
+    } catch (error) {
+      // 任务应自行处理并上报错误，这里只兜底防止调度中断
+      console.error(`[Worker] 任务 ${job.label} 执行异常:`, error)
+    }
+    if (done) {
+      queue.shift()
+    }
+  }
+}
+
+module.exports = { JobScheduler }
@@ -0,0 +1,67 @@
+/**
+ * 流式 multipart/form-data 请求体
+ * 文件部分直接来自异步分块，边编码边发送，无需预先拼出完整请求体
+ */
+
+import { randomBytes } from 'node:crypto'
+
+export interface MultipartFile {
+  field: string
+  fileName: string
+  contentType: string
+  chunks: AsyncIterable<Uint8Array>
+}
+
+export interface MultipartBody {
+  body: ReadableStream<Uint8Array>
+  contentType: string
+  /** 已交给网络层的字节数 */
+  bytesSent: () => number
+}
+
+function escapeQuoted(value: string): string {
+  return value.replace(/[\r\n"]/g, (ch) => encodeURIComponent(ch))
+}
+
+export function createMultipartBody(fields: Array<[string, string]>, file: MultipartFile): MultipartBody {
+  const boundary = `----SpeechTide${randomBytes(12).toString('hex')}`
+  const encoder = new TextEncoder()
+  let sent = 0
+
+  async function* parts(): AsyncGenerator<Uint8Array> {
+    for (const [name, value] of fields) {
+      yield encoder.encode(
+        `--${boundary}\r\nContent-Disposition: form-data; name="${escapeQuoted(name)}"\r\n\r\n${value}\r\n`
+      )
+    }
+    yield encoder.encode(
+      `--${boundary}\r\nContent-Disposition: form-data; name="${escapeQuoted(file.field)}"; ` +
+        `filename="${escapeQuoted(file.fileName)}"\r\nContent-Type: ${file.contentType}\r\n\r\n`
+    )
+    yield* file.chunks
+    yield encoder.encode(`\r\n--${boundary}--\r\n`)
+  }
+
+  const iterator = parts()
+  const body = new ReadableStream<Uint8Array>({
+    async pull(controller) {
+      const { value, done } = await iterator.next()
+      if (done) {
+        controller.close()
+        return
+      }
+      sent += value.byteLength
+      controller.enqueue(value)
+    },
+    async cancel() {
+      // 请求中止时结束生成器，释放打开的文件
+      await iterator.return(undefined)
+    },
+  })
+
+  return {
+    body,
+    contentType: `multipart/form-data; boundary=${boundary}`,
+    bytesSent: () => sent,
+  }
+}
@@ -0,0 +1,169 @@
+/**
+ * 在线转写边录边传会话
+ * 录音期间逐块裁剪静音并编码为 FLAC，通过分块（chunked）请求持续上传，
+ * 松开按键后只需发送尾部并等待服务端返回结果
+ */
+
+import type { TranscriptionResult, TranscriptionStream } from './index'
+import type { AudioDspModule, NativeFlacEncoder } from './audio-dsp-native'
+import type { MultipartFile } from './multipart-body'
+import { downmixToMono, SilenceGate } from './upload-encoder'
+
+export interface UploadStreamStats {
+  /** 录音 PCM 字节数 */
+  sourceBytes: number
+  trimmedMs: number
+}
+
+export interface OnlineUploadStreamOptions {
+  sampleRate: number
+  channels: number
+  trimSilence: boolean
+  dsp: AudioDspModule
+  /** finish() 之后等待结果的超时 */
+  timeoutMs: number
+  /** 发起上传请求；文件分块在 finish() 之后结束 */
+  upload: (file: MultipartFile, signal: AbortSignal, stats: () => UploadStreamStats) => Promise<TranscriptionResult>
+}
+
+/**
+ * 超时计时器以 TimeoutError 中止请求，与 cancel() 的主动取消区分
+ */
+export function abortForTimeout(controller: AbortController): void {
+  controller.abort(new DOMException('在线转写超时', 'TimeoutError'))
+}
+
+export function isTimeoutAbort(signal: AbortSignal): boolean {
+  const reason = signal.reason as unknown
+  return reason instanceof DOMException && reason.name === 'TimeoutError'
+}
+
+/**
+ * 单生产者单消费者的字节块队列
+ * 消费端是请求体，网络层取完已有分块后在此等待下一块
+ */
+class ChunkQueue implements AsyncIterable<Uint8Array> {
+  private items: Uint8Array[] = []
+  private closed = false
+  private wake: (() => void) | null = null
+
+  push(chunk: Uint8Array): void {
+    if (this.closed || chunk.byteLength === 0) return
+    this.items.push(chunk)
+    this.notify()
+  }
+
+  close(): void {
+    this.closed = true
+    this.items = []
+    this.notify()
+  }
+
+  /** 标记输入结束，已入队的分块仍会发出 */
+  end(): void {
+    this.closed = true
+    this.notify()
+  }
+
+  private notify(): void {
+    const wake = this.wake
+    this.wake = null
+    wake?.()
+  }
+
+  async *[Symbol.asyncIterator](): AsyncGenerator<Uint8Array> {
+    while (true) {
+      const next = this.items.shift()
+      if (next) {
+        yield next
+        continue
+      }
+      if (this.closed) return
+      await new Promise<void>((resolve) => {
+        this.wake = resolve
+      })
+    }
+  }
+}
+
+export class OnlineUploadStream implements TranscriptionStream {
+  private readonly queue = new ChunkQueue()
+  private readonly controller = new AbortController()
+  private readonly encoder: NativeFlacEncoder
+  private readonly gate: SilenceGate | null
+  private readonly frameBytes: number
+  private readonly result: Promise<TranscriptionResult>
+  /** 上一块末尾不足一帧的字节 */
+  private carry = Buffer.alloc(0)
+  private sourceBytes = 0
+  private settled = false
+  private finished = false
+
+  constructor(private readonly options: OnlineUploadStreamOptions) {
+    this.encoder = new options.dsp.FlacEncoder(options.sampleRate)
+    this.gate = options.trimSilence ? new SilenceGate(options.sampleRate, options.dsp) : null
+    this.frameBytes = 2 * options.channels
+
+    // 录音开始即发起请求，之后的音频都追加在同一个请求体里
+    this.result = options.upload(
+      { field: 'file', fileName: 'recording.flac', contentType: 'audio/flac', chunks: this.queue },
+      this.controller.signal,
+      () => ({ sourceBytes: this.sourceBytes, trimmedMs: this.gate?.trimmedMs ?? 0 })
+    )
+    this.result
+      .catch(() => {
+        // 错误由 finish() 抛出
+      })
+      .finally(() => {
+        // 服务端提前结束请求（例如拒绝分块上传）后不再编码
+        this.settled = true
+        this.queue.close()
+      })
+  }
+
+  push(chunk: Buffer): void {
+    if (this.finished || this.settled) return
+    this.sourceBytes += chunk.length
+
+    const input = this.carry.length > 0 ? Buffer.concat([this.carry, chunk]) : chunk
+    const usable = input.length - (input.length % this.frameBytes)
+    this.carry = Buffer.from(input.subarray(usable))
+    if (usable === 0) return
+
+    // 复制到独立的 ArrayBuffer，保证 2 字节对齐
+    const interleaved = new Int16Array(usable / 2)
+    Buffer.from(interleaved.buffer).set(input.subarray(0, usable))
+    const mono = downmixToMono(interleaved, this.options.channels)
+    this.encode(this.gate ? this.gate.push(mono) : mono)
+  }
+
+  async finish(): Promise<TranscriptionResult> {
+    if (!this.finished && !this.settled) {
+      this.finished = true
+      if (this.gate) {
+        this.encode(this.gate.finish())
+      }
+      this.queue.push(this.encoder.finish())
+      this.queue.end()
+    }
+    this.finished = true
+
+    const timeoutId = setTimeout(() => abortForTimeout(this.controller), this.options.timeoutMs)
+    try {
+      return await this.result
+    } finally {
+      clearTimeout(timeoutId)
+    }
+  }
+
+  cancel(): void {
+    this.finished = true
+    this.queue.close()
+    this.controller.abort()
+  }
+
+  private encode(samples: Int16Array): void {
+    if (samples.length === 0) return
+    this.queue.push(this.encoder.encode(samples))
+  }
+}
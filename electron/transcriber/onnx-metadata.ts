@@ -0,0 +1,302 @@
+/**
+ * ONNX 模型元数据补丁
+ *
+ * sherpa-onnx 需要从 ModelProto.metadata_props 读取 SenseVoice 的特征参数，
+ * 部分导出的模型缺少这些键。protobuf 允许在消息末尾追加 repeated 字段，
+ * 因此只需扫描顶层字段标签、找出已有的键，再把缺失的条目追加到文件副本末尾，
+ * 无需把整个模型读入内存解码再重新编码。
+ *
+ * 补丁结果按源文件内容哈希缓存，之后的启动只需一次 stat 即可命中。
+ */
+
+import fs from 'node:fs'
+import fsPromises from 'node:fs/promises'
+import path from 'node:path'
+import crypto from 'node:crypto'
+
+/** ModelProto.metadata_props 字段号 */
+const METADATA_PROPS_FIELD = 14
+/** StringStringEntryProto 字段号 */
+const ENTRY_KEY_FIELD = 1
+const ENTRY_VALUE_FIELD = 2
+
+const WIRE_VARINT = 0
+const WIRE_FIXED64 = 1
+const WIRE_LENGTH_DELIMITED = 2
+const WIRE_FIXED32 = 5
+
+const MANIFEST_FILE = 'manifest.json'
+/** 读取字段头时的预读长度：tag + length 两个 varint 最多 20 字节 */
+const HEADER_PROBE_BYTES = 20
+
+interface ManifestEntry {
+  /** 源文件大小与修改时间，用于免哈希快速命中 */
+  size: number
+  mtimeMs: number
+  /** 源文件内容哈希 + 期望元数据的指纹 */
+  cacheKey: string
+  /** 补丁后的模型路径；null 表示源模型已包含所有键，直接使用源文件 */
+  patchedPath: string | null
+}
+
+type Manifest = Record<string, ManifestEntry>
+
+/** 进行中的补丁任务：同一模型与元数据的并发请求共用一次补丁 */
+const inflight = new Map<string, Promise<string>>()
+/** 清单的读改写依次执行，避免并发补丁不同模型时互相覆盖 */
+let manifestQueue: Promise<unknown> = Promise.resolve()
+
+/**
+ * 确保模型包含指定的 metadata_props，返回可直接加载的模型路径
+ * @param modelPath 源模型路径
+ * @param metadata 期望存在的键值（已存在的键不会被覆盖）
+ * @param cacheDir 补丁模型与缓存清单所在目录
+ */
+export function ensureOnnxMetadata(
+  modelPath: string,
+  metadata: Record<string, string>,
+  cacheDir: string
+): Promise<string> {
+  const metadataFingerprint = hashString(JSON.stringify(Object.entries(metadata).sort()))
+  const key = `${cacheDir}\0${modelPath}\0${metadataFingerprint}`
+  let task = inflight.get(key)
+  if (!task) {
+    task = patchModel(modelPath, metadata, metadataFingerprint, cacheDir).finally(() => {
+      inflight.delete(key)
+    })
+    inflight.set(key, task)
+  }
+  return task
+}
+
+async function patchModel(
+  modelPath: string,
+  metadata: Record<string, string>,
+  metadataFingerprint: string,
+  cacheDir: string
+): Promise<string> {
+  const stat = await fsPromises.stat(modelPath)
+  const manifest = await readManifest(cacheDir)
+
+  // 快速路径：源文件未变化且补丁产物仍在
+  const cached = manifest[modelPath]
+  if (cached && cached.size === stat.size && cached.mtimeMs === stat.mtimeMs && cached.cacheKey.endsWith(metadataFingerprint)) {
+    if (cached.patchedPath === null) {
+      return modelPath
+    }
+    if (fs.existsSync(cached.patchedPath)) {
+      return cached.patchedPath
+    }
+  }
+
+  const contentHash = await hashFile(modelPath)
+  const cacheKey = `${contentHash}-${metadataFingerprint}`
+  const targetPath = path.join(cacheDir, `sensevoice-${cacheKey.slice(0, 16)}-${metadataFingerprint.slice(0, 8)}.onnx`)
+
+  let patchedPath: string | null
+  if (fs.existsSync(targetPath)) {
+    // 同内容的模型此前已补丁过（例如重新下载后 mtime 变化）
+    patchedPath = targetPath
+  } else {
+    const existingKeys = await scanMetadataKeys(modelPath)
+    const missing = Object.entries(metadata).filter(([key]) => !existingKeys.has(key))
+    if (missing.length === 0) {
+      patchedPath = null
+    } else {
+      await fsPromises.mkdir(cacheDir, { recursive: true })
+      await writePatchedCopy(modelPath, targetPath, missing)
+      patchedPath = targetPath
+      console.log('[Transcriber] 已追加模型元数据:', missing.map(([key]) => key).join(', '))
+    }
+  }
+
+  await updateManifest(cacheDir, modelPath, { size: stat.size, mtimeMs: stat.mtimeMs, cacheKey, patchedPath })
+  return patchedPath ?? modelPath
+}
+
+/**
+ * 扫描 ModelProto 顶层字段，收集 metadata_props 中已有的键
+ * 只读取字段头，graph 等大字段通过长度直接跳过
+ */
+export async function scanMetadataKeys(modelPath: string): Promise<Set<string>> {
+  const keys = new Set<string>()
+  const file = await fsPromises.open(modelPath, 'r')
+  try {
+    const { size } = await file.stat()
+    const probe = Buffer.alloc(HEADER_PROBE_BYTES)
+    let position = 0
+
+    while (position < size) {
+      const { bytesRead } = await file.read(probe, 0, HEADER_PROBE_BYTES, position)
+      const header = probe.subarray(0, bytesRead)
+      const tag = readVarint(header, 0)
+      const fieldNumber = Number(tag.value >> 3n)
+      const wireType = Number(tag.value & 7n)
+      let cursor = position + tag.length
+
+      switch (wireType) {
+        case WIRE_VARINT: {
+          cursor += readVarint(header, tag.length).length
+          break
+        }
+        case WIRE_FIXED64:
+          cursor += 8
+          break
+        case WIRE_FIXED32:
+          cursor += 4
+          break
+        case WIRE_LENGTH_DELIMITED: {
+          const length = readVarint(header, tag.length)
+          const payloadStart = cursor + length.length
+          const payloadLength = Number(length.value)
+          if (fieldNumber === METADATA_PROPS_FIELD) {
+            const payload = Buffer.alloc(payloadLength)
+            await file.read(payload, 0, payloadLength, payloadStart)
+            const key = readEntryKey(payload)
+            if (key !== null) keys.add(key)
+          }
+          cursor = payloadStart + payloadLength
+          break
+        }
+        default:
+          throw new Error(`不支持的 protobuf wire type: ${wireType}（偏移 ${position}）`)
+      }
+
+      if (cursor > size) {
+        throw new Error('模型文件被截断：字段长度超出文件末尾')
+      }
+      position = cursor
+    }
+  } finally {
+    await file.close()
+  }
+  return keys
+}
+
+/**
+ * 复制源模型并在末尾追加缺失的 metadata_props 条目
+ * 优先使用写时复制克隆（APFS/btrfs），不支持时回退为普通复制
+ */
+async function writePatchedCopy(sourcePath: string, targetPath: string, entries: Array<[string, string]>): Promise<void> {
+  const tempPath = `${targetPath}.${crypto.randomUUID()}.tmp`
+  try {
+    await fsPromises.copyFile(sourcePath, tempPath, fs.constants.COPYFILE_FICLONE)
+    await fsPromises.appendFile(tempPath, Buffer.concat(entries.map(([key, value]) => encodeMetadataEntry(key, value))))
+    await fsPromises.rename(tempPath, targetPath)
+  } catch (error) {
+    await fsPromises.rm(tempPath, { force: true })
+    throw error
+  }
+}
+
+/**
+ * 编码一个顶层 metadata_props 字段（StringStringEntryProto）
+ */
+function encodeMetadataEntry(key: string, value: string): Buffer {
+  const entry = Buffer.concat([
+    encodeLengthDelimited(ENTRY_KEY_FIELD, Buffer.from(key, 'utf-8')),
+    encodeLengthDelimited(ENTRY_VALUE_FIELD, Buffer.from(value, 'utf-8')),
+  ])
+  return encodeLengthDelimited(METADATA_PROPS_FIELD, entry)
+}
+
+function encodeLengthDelimited(fieldNumber: number, payload: Buffer): Buffer {
+  return Buffer.concat([
+    encodeVarint((fieldNumber << 3) | WIRE_LENGTH_DELIMITED),
+    encodeVarint(payload.length),
+    payload,
+  ])
+}
+
+function encodeVarint(value: number): Buffer {
+  const bytes: number[] = []
+  let remaining = value
+  while (remaining > 0x7f) {
+    bytes.push((remaining & 0x7f) | 0x80)
+    remaining = Math.floor(remaining / 128)
+  }
+  bytes.push(remaining)
+  return Buffer.from(bytes)
+}
+
+function readVarint(buffer: Buffer, offset: number): { value: bigint; length: number } {
+  let value = 0n
+  let shift = 0n
+  for (let i = offset; i < buffer.length && i < offset + 10; i++) {
+    const byte = buffer[i]
+    value |= BigInt(byte & 0x7f) << shift
+    if ((byte & 0x80) === 0) {
+      return { value, length: i - offset + 1 }
+    }
+    shift += 7n
+  }
+  throw new Error('protobuf varint 格式错误')
+}
+
+/**
+ * 从 StringStringEntryProto 中读取 key 字段
+ */
+function readEntryKey(payload: Buffer): string | null {
+  let offset = 0
+  while (offset < payload.length) {
+    const tag = readVarint(payload, offset)
+    offset += tag.length
+    const fieldNumber = Number(tag.value >> 3n)
+    const wireType = Number(tag.value & 7n)
+    if (wireType !== WIRE_LENGTH_DELIMITED) {
+      return null
+    }
+    const length = readVarint(payload, offset)
+    offset += length.length
+    const end = offset + Number(length.value)
+    if (fieldNumber === ENTRY_KEY_FIELD) {
+      return payload.toString('utf-8', offset, end)
+    }
+    offset = end
+  }
+  return null
+}
+
+async function hashFile(filePath: string): Promise<string> {
+  const hash = crypto.createHash('sha256')
+  for await (const chunk of fs.createReadStream(filePath, { highWaterMark: 1024 * 1024 })) {
+    hash.update(chunk as Buffer)
+  }
+  return hash.digest('hex')
+}
+
+function hashString(value: string): string {
+  return crypto.createHash('sha256').update(value).digest('hex').slice(0, 16)
+}
+
+async function readManifest(cacheDir: string): Promise<Manifest> {
+  try {
+    const raw = await fsPromises.readFile(path.join(cacheDir, MANIFEST_FILE), 'utf-8')
+    return JSON.parse(raw) as Manifest
+  } catch {
+    return {}
+  }
+}
+
+/**
+ * 重新读取清单后写入单个条目；先写临时文件再重命名，崩溃时不会留下截断的清单
+ */
+function updateManifest(cacheDir: string, modelPath: string, entry: ManifestEntry): Promise<void> {
+  const run = async () => {
+    const manifest = await readManifest(cacheDir)
+    manifest[modelPath] = entry
+    await fsPromises.mkdir(cacheDir, { recursive: true })
+    const manifestPath = path.join(cacheDir, MANIFEST_FILE)
+    const tempPath = `${manifestPath}.${crypto.randomUUID()}.tmp`
+    try {
+      await fsPromises.writeFile(tempPath, JSON.stringify(manifest, null, 2), 'utf-8')
+      await fsPromises.rename(tempPath, manifestPath)
+    } catch (error) {
+      await fsPromises.rm(tempPath, { force: true })
+      throw error
+    }
+  }
+  const result = manifestQueue.then(run, run)
+  manifestQueue = result.catch(() => undefined)
+  return result
+}
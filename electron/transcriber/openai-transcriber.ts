@@ -1,8 +1,11 @@
-import fs from 'node:fs/promises'
-import path from 'node:path'
 import type { OnlineTranscriptionConfig } from '../../shared/app-state'
 import { TRANSCRIPTION_PROVIDERS } from '../../shared/app-state'
-import type { Transcriber, TranscriptionResult } from './index'
+import type { Transcriber, TranscriptionResult, TranscriptionStream, TranscriptionStreamOptions } from './index'
+import { loadAudioDsp } from './audio-dsp-native'
+import { createMultipartBody, type MultipartFile } from './multipart-body'
+import { abortForTimeout, isTimeoutAbort, OnlineUploadStream } from './online-upload-stream'
+import { StreamFallbackError } from './stream-fallback'
+import { prepareUploadAudio } from './upload-encoder'
 import { createModuleLogger } from '../utils/logger'
 
 const logger = createModuleLogger('openai-transcriber')
@@ -24,11 +27,25 @@ function getTimeoutMs(config: OnlineTranscriptionConfig): number {
     : 120000
 }
 
+/** 服务端返回的非 2xx 响应 */
+class HttpStatusError extends Error {
+  constructor(message: string, readonly status: number) {
+    super(message)
+  }
+}
+
+/** 服务端不接受分块请求体时常见的状态码 */
+const CHUNKED_REJECTED_STATUS = new Set([411, 501])
+
 export class OpenAITranscriber implements Transcriber {
+  /** 服务端曾拒绝分块上传，之后的录音改为整段上传，直到配置变更 */
+  private chunkedRejected = false
+
   constructor(private config: OnlineTranscriptionConfig) {}
 
   updateConfig(config: OnlineTranscriptionConfig): void {
     this.config = config
+    this.chunkedRejected = false
   }
 
   private isConfigValid(): boolean {
@@ -40,42 +57,113 @@ export class OpenAITranscriber implements Transcriber {
       throw new Error('在线转写配置无效：请检查 API Key 和模型 ID')
     }
 
-    const startTime = Date.now()
-    const baseUrl = normalizeBaseUrl(this.config.baseUrl, this.config.provider)
-    const url = `${baseUrl}/audio/transcriptions`
-
     logger.info('开始在线转写', { provider: this.config.provider, modelId: this.config.modelId })
 
-    const fileBuffer = await fs.readFile(filePath)
-    const fileName = path.basename(filePath)
-    const file = new File([fileBuffer], fileName, { type: 'audio/wav' })
+    const audio = await prepareUploadAudio(filePath, {
+      format: this.config.uploadFormat ?? 'flac',
+      trimSilence: this.config.trimSilence ?? true,
+    })
+
+    const controller = new AbortController()
+    const timeoutId = setTimeout(() => abortForTimeout(controller), getTimeoutMs(this.config))
+    try {
+      return await this.upload(
+        { field: 'file', fileName: audio.fileName, contentType: audio.mimeType, chunks: audio.chunks },
+        controller.signal,
+        () => ({ format: audio.format, sourceBytes: audio.sourceBytes, trimmedMs: audio.trimmedMs })
+      )
+    } finally {
+      clearTimeout(timeoutId)
+    }
+  }
+
+  /**
+   * 开启边录边传会话
+   * 需要原生 FLAC 编码器（分块上传无法预知 WAV 长度）；服务端拒绝过分块请求时返回 undefined，
+   * 由调用方在录音结束后整段上传
+   */
+  startStream(options: TranscriptionStreamOptions): TranscriptionStream | undefined {
+    if (!this.isConfigValid() || this.chunkedRejected || (this.config.uploadFormat ?? 'flac') !== 'flac') {
+      return undefined
+    }
+    const dsp = loadAudioDsp()
+    if (!dsp) {
+      return undefined
+    }
 
-    const form = new FormData()
-    form.append('file', file)
-    form.append('model', this.config.modelId)
+    logger.info('开始在线转写（边录边传）', { provider: this.config.provider, modelId: this.config.modelId })
+    return new OnlineUploadStream({
+      sampleRate: options.sampleRate,
+      channels: options.channels,
+      trimSilence: this.config.trimSilence ?? true,
+      dsp,
+      timeoutMs: getTimeoutMs(this.config),
+      upload: (file, signal, stats) => {
+        // describe 在收到响应后才调用
+        let responded = false
+        const describe = () => {
+          responded = true
+          return { format: 'flac', streaming: true, ...stats() }
+        }
+        return this.upload(file, signal, describe).catch((error: unknown) => {
+          const message = error instanceof Error ? error.message : String(error)
+          if (error instanceof HttpStatusError && CHUNKED_REJECTED_STATUS.has(error.status)) {
+            this.chunkedRejected = true
+            logger.warn('服务端不支持分块上传，之后改为整段上传', { status: error.status })
+            throw new StreamFallbackError(message)
+          }
+          // 连接失败等未得到任何响应的网络错误，整段重传仍可能成功；超时与取消不重传
+          if (!responded && !signal.aborted) {
+            throw new StreamFallbackError(message)
+          }
+          throw error
+        })
+      },
+    })
+  }
 
+  private buildFields(): Array<[string, string]> {
+    const fields: Array<[string, string]> = [['model', this.config.modelId]]
     if (this.config.language) {
-      form.append('language', this.config.language)
+      fields.push(['language', this.config.language])
     }
     if (this.config.responseFormat) {
-      form.append('response_format', this.config.responseFormat)
+      fields.push(['response_format', this.config.responseFormat])
     }
     if (this.config.temperature !== undefined && this.config.temperature !== null) {
-      form.append('temperature', String(this.config.temperature))
+      fields.push(['temperature', String(this.config.temperature)])
     }
+    return fields
+  }
 
-    const controller = new AbortController()
-    const timeoutId = setTimeout(() => controller.abort(), getTimeoutMs(this.config))
+  /**
+   * 以流式请求体上传音频并解析结果
+   * describe 在请求体发送完后调用，用于记录上传统计
+   */
+  private async upload(
+    file: MultipartFile,
+    signal: AbortSignal,
+    describe: () => Record<string, unknown>
+  ): Promise<TranscriptionResult> {
+    const startTime = Date.now()
+    const baseUrl = normalizeBaseUrl(this.config.baseUrl, this.config.provider)
+    const url = `${baseUrl}/audio/transcriptions`
+    const multipart = createMultipartBody(this.buildFields(), file)
 
     try {
-      const response = await fetch(url, {
+      // 流式请求体需要 duplex: 'half'（DOM 类型定义中尚未包含该字段）
+      const init: RequestInit & { duplex: 'half' } = {
         method: 'POST',
         headers: {
           Authorization: `Bearer ${this.config.apiKey}`,
+          'Content-Type': multipart.contentType,
         },
-        body: form,
-        signal: controller.signal,
-      })
+        body: multipart.body,
+        signal,
+        duplex: 'half',
+      }
+      const response = await fetch(url, init)
+      logger.info('音频上传完成', { ...describe(), uploadBytes: multipart.bytesSent() })
 
       if (!response.ok) {
         const errorText = await response.text()
@@ -88,7 +176,7 @@ export class OpenAITranscriber implements Transcriber {
         } catch {
           // ignore json parse
         }
-        throw new Error(errorMessage)
+        throw new HttpStatusError(errorMessage, response.status)
       }
 
       const durationMs = Date.now() - startTime
@@ -120,16 +208,17 @@ export class OpenAITranscriber implements Transcriber {
       }
     } catch (error) {
       const durationMs = Date.now() - startTime
-      if (error instanceof Error) {
-        if (error.name === 'AbortError') {
+      if (signal.aborted) {
+        if (isTimeoutAbort(signal)) {
           throw new Error(`在线转写超时（${Math.round(getTimeoutMs(this.config) / 1000)}秒）`)
         }
+        throw new Error('在线转写已取消')
+      }
+      if (error instanceof Error) {
         logger.error(error, { durationMs })
         throw error
       }
       throw new Error('在线转写失败：未知错误')
-    } finally {
-      clearTimeout(timeoutId)
     }
   }
 
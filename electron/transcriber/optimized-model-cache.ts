@@ -0,0 +1,253 @@
+/**
+ * ONNX Runtime 优化模型缓存
+ *
+ * 每次创建识别器时 ONNX Runtime 都要解析模型并重新做图优化。
+ * 首次加载后在后台生成 ORT 格式的优化模型，经 sherpa-onnx 加载验证后写入缓存，
+ * 之后的启动直接加载该产物。缓存键包含模型内容哈希、运行时版本与 CPU 特征，
+ * 任一变化都会重新生成；生成或加载失败的条目会被记录，不再重复尝试。
+ */
+
+import fs from 'node:fs'
+import fsPromises from 'node:fs/promises'
+import os from 'node:os'
+import path from 'node:path'
+import crypto from 'node:crypto'
+import type { ChildProcess } from 'node:child_process'
+
+const MANIFEST_FILE = 'manifest.json'
+/** 等待优化进程的最长时间（fp32 模型优化 + 验证加载） */
+const BUILD_TIMEOUT_MS = 10 * 60 * 1000
+
+interface ManifestEntry {
+  /** 源模型大小与修改时间，用于免哈希快速命中 */
+  size: number
+  mtimeMs: number
+  /** 源模型内容哈希 + 运行时/CPU 指纹 */
+  cacheKey: string
+  status: 'ready' | 'failed'
+  artifactPath: string | null
+  createdAt: number
+  error?: string
+}
+
+type Manifest = Record<string, ManifestEntry>
+
+export interface OptimizedModelBuildOptions {
+  /** 源模型（已补齐元数据） */
+  modelPath: string
+  tokensPath: string
+  cacheDir: string
+  /** 运行时指纹，见 describeRuntime() */
+  runtimeKey: string
+  /** 启动优化进程 */
+  spawn: () => ChildProcess
+}
+
+export interface OptimizedModelBuildResult {
+  artifactPath: string
+  optimizeMs: number
+  verifyLoadMs: number
+}
+
+// 同一模型只允许一个优化进程；未安装 onnxruntime-node 时本次运行不再尝试
+const inflight = new Map<string, Promise<OptimizedModelBuildResult | null>>()
+let optimizerUnavailable = false
+// 清单的读-改-写串行执行，避免并发更新互相覆盖
+let manifestQueue: Promise<unknown> = Promise.resolve()
+
+/**
+ * 运行时与 CPU 指纹：sherpa-onnx 原生库版本（含 onnxruntime 动态库文件名）+ CPU 型号与指令集
+ */
+export function describeRuntime(runtimeDir: string | null): string {
+  const parts: string[] = [process.platform, process.arch, os.cpus()[0]?.model ?? 'unknown-cpu']
+  if (runtimeDir) {
+    try {
+      const pkg = JSON.parse(fs.readFileSync(path.join(runtimeDir, 'package.json'), 'utf-8')) as { version?: string }
+      parts.push(`sherpa-${pkg.version ?? 'unknown'}`)
+    } catch {
+      parts.push('sherpa-unknown')
+    }
+    try {
+      parts.push(...fs.readdirSync(runtimeDir).filter((name) => name.includes('onnxruntime')).sort())
+    } catch {
+      // 目录不可读时仅以版本号区分
+    }
+  }
+  if (process.platform === 'linux') {
+    // 同型号名下指令集仍可能不同（虚拟机屏蔽 AVX-512 等）
+    try {
+      const flags = fs.readFileSync('/proc/cpuinfo', 'utf-8').match(/^flags\s*:\s*(.*)$/m)?.[1]
+      if (flags) parts.push(hashString(flags))
+    } catch {
+      // 无法读取时忽略
+    }
+  }
+  return hashString(parts.join('|'))
+}
+
+/**
+ * 查找可直接加载的优化模型
+ * @returns 产物路径；null 表示没有可用产物
+ */
+export async function lookupOptimizedModel(modelPath: string, cacheDir: string, runtimeKey: string): Promise<string | null> {
+  const entry = await findEntry(modelPath, cacheDir, runtimeKey)
+  if (entry?.status === 'ready' && entry.artifactPath && fs.existsSync(entry.artifactPath)) {
+    return entry.artifactPath
+  }
+  return null
+}
+
+/**
+ * 是否应该为该模型生成优化产物（尚无产物且此前未失败）
+ */
+export async function shouldBuildOptimizedModel(modelPath: string, cacheDir: string, runtimeKey: string): Promise<boolean> {
+  if (optimizerUnavailable || inflight.has(modelPath)) return false
+  const entry = await findEntry(modelPath, cacheDir, runtimeKey)
+  if (!entry) return true
+  return entry.status === 'ready' && !(entry.artifactPath && fs.existsSync(entry.artifactPath))
+}
+
+/**
+ * 记录产物加载失败，之后回退到源模型
+ */
+export async function markOptimizedModelFailed(modelPath: string, cacheDir: string, error: string): Promise<void> {
+  await updateManifest(cacheDir, async (manifest) => {
+    const entry = manifest[modelPath]
+    if (!entry) return false
+    if (entry.artifactPath) {
+      await fsPromises.rm(entry.artifactPath, { force: true })
+    }
+    manifest[modelPath] = { ...entry, status: 'failed', artifactPath: null, error }
+    return true
+  })
+}
+
+/**
+ * 在独立进程中生成并验证优化模型，成功后登记到缓存清单
+ */
+export function buildOptimizedModel(options: OptimizedModelBuildOptions): Promise<OptimizedModelBuildResult | null> {
+  const existing = inflight.get(options.modelPath)
+  if (existing) return existing
+  const task = runBuild(options).finally(() => inflight.delete(options.modelPath))
+  inflight.set(options.modelPath, task)
+  return task
+}
+
+async function runBuild(options: OptimizedModelBuildOptions): Promise<OptimizedModelBuildResult | null> {
+  const { modelPath, tokensPath, cacheDir, runtimeKey } = options
+  const stat = await fsPromises.stat(modelPath)
+  const cacheKey = `${await hashFile(modelPath)}-${runtimeKey}`
+  const artifactPath = path.join(cacheDir, `sensevoice-${cacheKey.slice(0, 16)}-${runtimeKey.slice(0, 8)}.ort`)
+  const tempPath = `${artifactPath}.${crypto.randomUUID()}.tmp.ort`
+  await fsPromises.mkdir(cacheDir, { recursive: true })
+
+  const register = (entry: Pick<ManifestEntry, 'status' | 'artifactPath' | 'error'>) =>
+    updateManifest(cacheDir, (manifest) => {
+      manifest[modelPath] = { size: stat.size, mtimeMs: stat.mtimeMs, cacheKey, createdAt: Date.now(), ...entry }
+    })
+
+  const outcome = await runOptimizer(options.spawn(), { modelPath, outputPath: tempPath, tokensPath })
+  if (outcome.type === 'unsupported') {
+    optimizerUnavailable = true
+    await fsPromises.rm(tempPath, { force: true })
+    console.log('[Transcriber] 跳过优化模型缓存:', outcome.reason)
+    return null
+  }
+  if (outcome.type !== 'done') {
+    await fsPromises.rm(tempPath, { force: true })
+    await register({ status: 'failed', artifactPath: null, error: outcome.error })
+    console.warn('[Transcriber] 生成优化模型失败，继续使用原模型:', outcome.error)
+    return null
+  }
+
+  await fsPromises.rename(tempPath, artifactPath)
+  await register({ status: 'ready', artifactPath })
+  console.log('[Transcriber] 优化模型已缓存:', path.basename(artifactPath), {
+    optimizeMs: outcome.optimizeMs,
+    verifyLoadMs: outcome.verifyLoadMs,
+    ortVersion: outcome.ortVersion,
+  })
+  return { artifactPath, optimizeMs: outcome.optimizeMs, verifyLoadMs: outcome.verifyLoadMs }
+}
+
+type OptimizerOutcome =
+  | { type: 'done'; optimizeMs: number; verifyLoadMs: number; ortVersion: string }
+  | { type: 'unsupported'; reason: string }
+  | { type: 'error'; error: string }
+
+function runOptimizer(child: ChildProcess, request: { modelPath: string; outputPath: string; tokensPath: string }): Promise<OptimizerOutcome> {
+  return new Promise((resolve) => {
+    let outcome: OptimizerOutcome | null = null
+    const timer = setTimeout(() => {
+      outcome = { type: 'error', error: '生成优化模型超时' }
+      child.kill()
+    }, BUILD_TIMEOUT_MS)
+    child.on('message', (message: OptimizerOutcome) => {
+      outcome ??= message
+    })
+    child.on('exit', (code) => {
+      clearTimeout(timer)
+      // 验证加载时 sherpa-onnx 可能直接退出进程，此时没有结果消息
+      resolve(outcome ?? { type: 'error', error: `优化进程异常退出，code=${code ?? 'unknown'}` })
+    })
+    child.on('error', (error) => {
+      outcome ??= { type: 'error', error: error.message }
+    })
+    child.send(request)
+  })
+}
+
+async function findEntry(modelPath: string, cacheDir: string, runtimeKey: string): Promise<ManifestEntry | null> {
+  const entry = (await readManifest(cacheDir))[modelPath]
+  if (!entry || !entry.cacheKey.endsWith(runtimeKey)) return null
+  try {
+    const stat = await fsPromises.stat(modelPath)
+    return stat.size === entry.size && stat.mtimeMs === entry.mtimeMs ? entry : null
+  } catch {
+    return null
+  }
+}
+
+async function hashFile(filePath: string): Promise<string> {
+  const hash = crypto.createHash('sha256')
+  for await (const chunk of fs.createReadStream(filePath, { highWaterMark: 1024 * 1024 })) {
+    hash.update(chunk as Buffer)
+  }
+  return hash.digest('hex')
+}
+
+function hashString(value: string): string {
+  return crypto.createHash('sha256').update(value).digest('hex').slice(0, 16)
+}
+
+async function readManifest(cacheDir: string): Promise<Manifest> {
+  try {
+    const raw = await fsPromises.readFile(path.join(cacheDir, MANIFEST_FILE), 'utf-8')
+    return JSON.parse(raw) as Manifest
+  } catch {
+    return {}
+  }
+}
+
+/**
+ * 重新读取清单后交给 update 修改（返回 false 表示无需写回）；先写临时文件再重命名，崩溃时不会留下截断的清单
+ */
+function updateManifest(cacheDir: string, update: (manifest: Manifest) => unknown): Promise<void> {
+  const run = async () => {
+    const manifest = await readManifest(cacheDir)
+    if ((await update(manifest)) === false) return
+    await fsPromises.mkdir(cacheDir, { recursive: true })
+    const manifestPath = path.join(cacheDir, MANIFEST_FILE)
+    const tempPath = `${manifestPath}.${crypto.randomUUID()}.tmp`
+    try {
+      await fsPromises.writeFile(tempPath, JSON.stringify(manifest, null, 2), 'utf-8')
+      await fsPromises.rename(tempPath, manifestPath)
+    } catch (error) {
+      await fsPromises.rm(tempPath, { force: true })
+      throw error
+    }
+  }
+  const result = manifestQueue.then(run, run)
+  manifestQueue = result.catch(() => undefined)
+  return result
+}
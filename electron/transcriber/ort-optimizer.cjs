@@ -0,0 +1,82 @@
+#!/usr/bin/env node
+// 生成 ONNX Runtime 图优化后的模型（ORT 格式），并用 sherpa-onnx 加载验证
+// 由主进程 fork，环境变量（原生库路径）与识别 worker 相同。
+// sherpa-onnx 未暴露 ORT 会话选项，因此借助 onnxruntime-node 的 optimizedModelFilePath 序列化优化结果；
+// sherpa-onnx 内置的 ONNX Runtime 会根据文件内容自动识别 ORT 格式，无需额外配置。
+const fs = require('fs')
+
+/**
+ * 发送结果并等待写入 IPC 通道
+ */
+function reply(message) {
+  return new Promise((resolve) => {
+    if (!process.send) {
+      resolve()
+      return
+    }
+    process.send(message, () => resolve())
+  })
+}
+
+/**
+ * 优化并验证，成功后产物留在 outputPath
+ */
+async function optimize({ modelPath, outputPath, tokensPath }) {
+  let ort
+  try {
+    ort = require('onnxruntime-node')
+  } catch (error) {
+    // 区分未安装与原生库加载失败（打包后未解包、签名或架构不符），便于排查
+    const reason = error && error.code === 'MODULE_NOT_FOUND' ? '未安装 onnxruntime-node' : `onnxruntime-node 加载失败: ${error.message}`
+    await reply({ type: 'unsupported', reason })
+    return
+  }
+
+  const optimizeStartedAt = Date.now()
+  const session = await ort.InferenceSession.create(modelPath, {
+    executionProviders: ['cpu'],
+    graphOptimizationLevel: 'all',
+    // .ort 扩展名使 ONNX Runtime 以 ORT 格式保存，免去后续加载时的 protobuf 解析与图优化
+    optimizedModelFilePath: outputPath,
+  })
+  await session.release?.()
+  const optimizeMs = Date.now() - optimizeStartedAt
+  if (!fs.existsSync(outputPath)) {
+    throw new Error('ONNX Runtime 未生成优化模型')
+  }
+
+  // 用 sherpa-onnx 实际加载一次：版本不兼容或元数据缺失时 sherpa 会直接退出进程，
+  // 主进程据退出码丢弃产物，避免识别 worker 加载失败
+  const sherpa = require('sherpa-onnx-node')
+  const loadStartedAt = Date.now()
+  new sherpa.OfflineRecognizer({
+    featConfig: { sampleRate: 16000, featureDim: 80 },
+    modelConfig: {
+      senseVoice: { model: outputPath, useInverseTextNormalization: 1 },
+      tokens: tokensPath,
+      numThreads: 1,
+      provider: 'cpu',
+      debug: 0,
+    },
+  })
+  const verifyLoadMs = Date.now() - loadStartedAt
+
+  let ortVersion = 'unknown'
+  try {
+    ortVersion = require('onnxruntime-node/package.json').version
+  } catch {
+    // 版本号只用于日志
+  }
+  await reply({ type: 'done', optimizeMs, verifyLoadMs, ortVersion })
+}
+
+process.once('message', (message) => {
+  optimize(message)
+    .catch((error) => {
+      console.error('[Optimizer] 生成优化模型失败:', error)
+      return reply({ type: 'error', error: error instanceof Error ? error.message : String(error) })
+    })
+    .finally(() => {
+      process.exit(0)
+    })
+})
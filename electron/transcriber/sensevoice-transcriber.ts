@@ -1,13 +1,43 @@
 import fs from 'node:fs'
 import fsPromises from 'node:fs/promises'
+import os from 'node:os'
 import path from 'node:path'
 import { fork, type ChildProcess } from 'node:child_process'
-import { randomUUID } from 'node:crypto'
-import * as onnx from 'onnx-proto'
+import type { Duplex } from 'node:stream'
 import { app } from 'electron'
-const ModelProto = onnx.onnx.ModelProto
 import type { SenseVoiceTranscriberConfig } from '../config'
-import type { Transcriber, TranscriptionResult } from './index'
+import type { AutotuneCandidateResult, TranscriptSegment, WorkerQueueStats } from '../../shared/app-state'
+import type {
+  BatchTranscriptionItem,
+  BenchmarkReport,
+  BenchmarkRequest,
+  LongTranscribeOptions,
+  PcmAudio,
+  TranscribeOptions,
+  Transcriber,
+  TranscriberOptions,
+  TranscriptionResult,
+  TranscriptionStream,
+  TranscriptionStreamOptions,
+} from './index'
+import { ensureOnnxMetadata } from './onnx-metadata'
+import { StreamFallbackError } from './stream-fallback'
+import {
+  createChannel,
+  PCM_CHUNK_BYTES,
+  WORKER_PIPE_FD,
+  type ProtocolChannel,
+  type WorkerRequest,
+  type WorkerResponse,
+} from './worker-protocol.cjs'
+import {
+  buildOptimizedModel,
+  describeRuntime,
+  lookupOptimizedModel,
+  markOptimizedModelFailed,
+  shouldBuildOptimizedModel,
+} from './optimized-model-cache'
+import { metrics } from '../utils/metrics'
 
 // 判断是否为开发模式
 const isDev = !!process.env.VITE_DEV_SERVER_URL
@@ -23,33 +53,47 @@ import {
   SNIP_EDGES,
 } from './constants'
 
-interface WorkerReadyMessage {
-  type: 'ready'
+/** 本次加载使用的模型 */
+interface LoadedModel {
+  /** 补齐元数据后的源模型 */
+  sourcePath: string
+  tokensPath: string
+  /** 命中的优化模型缓存，未命中为 null */
+  optimizedPath: string | null
 }
 
-interface WorkerInitErrorMessage {
-  type: 'init-error'
-  error: string
+/** worker 上报的内存与调度统计 */
+interface WorkerStats {
+  rss: number
+  queue: WorkerQueueStats
 }
 
-interface WorkerResultMessage {
-  type: 'transcribe-success'
-  id: string
-  text: string
-  durationMs: number
-  language?: string
-}
+/** 内存查询超时，worker 正在解码长音频时不阻塞调用方 */
+const STATS_TIMEOUT_MS = 2000
+/** 后台 worker 的进程 nice 值 */
+const BACKGROUND_PRIORITY = 10
+/** 首次加载后延迟多久在后台生成优化模型，避开刚开始的口述 */
+const OPTIMIZE_DELAY_MS = 30 * 1000
+/** 模型目录下可选的模型文件：fp32 与 int8 量化版本 */
+export const MODEL_VARIANTS = ['model.onnx', 'model.int8.onnx']
 
-interface WorkerFailureMessage {
-  type: 'transcribe-error'
-  id: string
-  error: string
+interface PendingRequest {
+  resolve: (result: TranscriptionResult) => void
+  reject: (error: Error) => void
+  /** 长音频转写：累积的分段与增量回调 */
+  segments?: TranscriptSegment[]
+  onProgress?: LongTranscribeOptions['onProgress']
 }
 
-type WorkerMessage = WorkerReadyMessage | WorkerInitErrorMessage | WorkerResultMessage | WorkerFailureMessage
+interface PendingBatch {
+  filePaths: string[]
+  resolve: (items: BatchTranscriptionItem[]) => void
+  reject: (error: Error) => void
+}
 
-interface PendingRequest {
-  resolve: (result: TranscriptionResult) => void
+interface PendingBenchmark {
+  onProgress?: (completed: number, total: number) => void
+  resolve: (report: BenchmarkReport) => void
   reject: (error: Error) => void
 }
 
@@ -61,52 +105,60 @@ interface TokensInfo {
 export class SenseVoiceTranscriber implements Transcriber {
   private cachedTokens: TokensInfo | null = null
   private readonly worker: ChildProcess
-  private readonly pending = new Map<string, PendingRequest>()
+  /** 与 worker 之间的二进制协议通道（见 worker-protocol.cjs） */
+  private readonly channel: ProtocolChannel<WorkerRequest>
+  private nextRequestId = 1
+  private readonly pending = new Map<number, PendingRequest>()
+  private readonly pendingBatches = new Map<number, PendingBatch>()
+  private readonly pendingBenchmarks = new Map<number, PendingBenchmark>()
+  private readonly pendingStats = new Map<number, (stats: WorkerStats | null) => void>()
   private readyResolver: { resolve: () => void; reject: (reason: Error) => void } | null = null
   private readonly ready: Promise<void>
   private workerExited = false
+  private loadMs: number | null = null
+  private loadedModel: LoadedModel | null = null
+  private readonly runtimeDir: string | null
 
-  constructor(private readonly config: SenseVoiceTranscriberConfig, private readonly options: { supportDir: string }) {
-    // 计算 worker 入口路径
-    let workerEntry: string
-    if (isDev) {
-      // 开发模式：使用源码目录
-      workerEntry = path.join(
-        process.env.APP_ROOT ?? process.cwd(),
-        'electron',
-        'transcriber',
-        'sensevoice-worker.cjs'
-      )
-    } else {
-      // 生产模式：worker 被打包到 app.asar 内
-      workerEntry = path.join(
-        app.getAppPath(),
-        'electron',
-        'transcriber',
-        'sensevoice-worker.cjs'
-      )
-    }
+  constructor(private readonly config: SenseVoiceTranscriberConfig, private readonly options: TranscriberOptions) {
+    this.runtimeDir = this.resolveRuntimeDirectory()
+    const workerEntry = this.resolveScriptPath('sensevoice-worker.cjs')
     const env = this.buildWorkerEnv()
+    // 请求与结果走 fd 4 上的专用管道（长度前缀二进制帧），日志仍直接输出到 stdio；
+    // fork() 要求保留 IPC 通道，但不再用于收发消息
     this.worker = fork(workerEntry, [], {
       env,
-      stdio: 'inherit',
+      stdio: ['inherit', 'inherit', 'inherit', 'ipc', 'pipe'],
+      // 基准测试依次创建多个识别器，需要主动 GC 释放上一个模型
+      execArgv: options.benchmarkOnly ? [...process.execArgv, '--expose-gc'] : process.execArgv,
     })
-    this.worker.on('message', (message: WorkerMessage) => this.handleWorkerMessage(message))
+    if (options.background && this.worker.pid !== undefined) {
+      try {
+        os.setPriority(this.worker.pid, BACKGROUND_PRIORITY)
+      } catch (error) {
+        console.warn('[Transcriber] 无法降低后台 Worker 优先级:', error)
+      }
+    }
+    this.channel = createChannel<WorkerResponse, WorkerRequest>(
+      this.worker.stdio[WORKER_PIPE_FD] as Duplex,
+      (message) => this.handleWorkerMessage(message),
+      (error) => {
+        console.error('[Transcriber] Worker 协议错误，终止 Worker:', error)
+        this.worker.kill()
+      }
+    )
     this.worker.on('exit', (code) => {
       this.workerExited = true
       const error = new Error(`SenseVoice worker 已退出，code=${code ?? 'unknown'}`)
-      this.readyResolver?.reject(error)
-      for (const [, pending] of this.pending) {
-        pending.reject(error)
+      // 加载优化模型时退出：作废该产物，下次回退到源模型
+      if (this.readyResolver && this.loadedModel?.optimizedPath) {
+        void markOptimizedModelFailed(this.loadedModel.sourcePath, this.optimizedCacheDir(), error.message)
       }
-      this.pending.clear()
+      this.readyResolver?.reject(error)
+      this.rejectAllPending(error)
     })
     this.worker.on('error', (error) => {
       this.readyResolver?.reject(error)
-      for (const [, pending] of this.pending) {
-        pending.reject(error)
-      }
-      this.pending.clear()
+      this.rejectAllPending(error)
     })
 
     this.ready = new Promise<void>((resolve, reject) => {
@@ -116,9 +168,18 @@ export class SenseVoiceTranscriber implements Transcriber {
     void this.bootstrapWorker()
   }
 
+  /**
+   * transcriber 目录下 .cjs 脚本的路径
+   * 开发模式使用源码目录，生产模式被打包到 app.asar 内
+   */
+  private resolveScriptPath(fileName: string) {
+    const root = isDev ? (process.env.APP_ROOT ?? process.cwd()) : app.getAppPath()
+    return path.join(root, 'electron', 'transcriber', fileName)
+  }
+
   private buildWorkerEnv() {
     const env = { ...process.env }
-    const runtimeDir = this.resolveRuntimeDirectory()
+    const runtimeDir = this.runtimeDir
 
     if (runtimeDir) {
       const key =
@@ -129,6 +190,14 @@ export class SenseVoiceTranscriber implements Transcriber {
         env[key] = currentValue ? `${runtimeDir}${delimiter}${currentValue}` : runtimeDir
       }
     }
+
+    // 生产模式：DSP 原生模块在 Resources/native/，worker 位于 app.asar 内无法按相对路径找到
+    if (!isDev && !env.SPEECHTIDE_AUDIO_DSP_PATH) {
+      const candidate = path.join(path.dirname(app.getAppPath()), 'native', 'audio_dsp.node')
+      if (fs.existsSync(candidate)) {
+        env.SPEECHTIDE_AUDIO_DSP_PATH = candidate
+      }
+    }
     return env
   }
 
@@ -195,22 +264,39 @@ export class SenseVoiceTranscriber implements Transcriber {
   }
 
   private async bootstrapWorker() {
+    if (this.options.benchmarkOnly) {
+      this.readyResolver?.resolve()
+      this.readyResolver = null
+      return
+    }
     try {
+      const prepareStartedAt = Date.now()
       const tokensInfo = await this.resolveTokensInfo()
-      const modelPath = await this.resolveModelPath(tokensInfo.count)
+      const sourcePath = await this.resolveModelPath(tokensInfo.count)
+      const optimizedPath = await this.resolveOptimizedModel(sourcePath)
+      this.loadedModel = { sourcePath, tokensPath: tokensInfo.path, optimizedPath }
+      metrics.recordMetric({
+        operation: 'model_load',
+        startTime: prepareStartedAt,
+        duration: Date.now() - prepareStartedAt,
+        memoryUsage: process.memoryUsage().heapUsed,
+        metadata: { stage: 'prepare', optimized: optimizedPath !== null },
+      })
       if (this.workerExited) {
         throw new Error('SenseVoice worker 已退出')
       }
       // 明确指定语言为中文，避免自动检测错误
       const language = this.config.language || 'zh'
       console.log(`[Transcriber] 初始化 SenseVoice，语言: ${language}`)
-      this.worker.send({
+      this.channel.send({
         type: 'init',
+        id: 0,
         payload: {
-          modelPath,
+          modelPath: optimizedPath ?? sourcePath,
           tokensPath: tokensInfo.path,
           language,
           useITN: this.config.useInverseTextNormalization !== false,
+          numThreads: this.config.numThreads,
         },
       })
     } catch (error) {
@@ -218,10 +304,53 @@ export class SenseVoiceTranscriber implements Transcriber {
     }
   }
 
-  private handleWorkerMessage(message: WorkerMessage) {
+  private allocateRequestId(): number {
+    const id = this.nextRequestId
+    this.nextRequestId = id >= 0xffffffff ? 1 : id + 1
+    return id
+  }
+
+  /**
+   * 发送请求消息；编码失败（如超过单帧上限）时移除等待项并拒绝
+   */
+  private sendRequest(id: number, messages: WorkerRequest[], reject: (error: Error) => void): void {
+    try {
+      for (const message of messages) {
+        this.channel.send(message)
+      }
+    } catch (error) {
+      this.pending.delete(id)
+      this.pendingBatches.delete(id)
+      this.pendingBenchmarks.delete(id)
+      reject(error instanceof Error ? error : new Error(String(error)))
+    }
+  }
+
+  /**
+   * 调用方放弃请求时通知 worker 取消（未开始的任务直接出队，进行中的任务在下一个分段边界退出）
+   */
+  private bindAbort(id: number, signal: AbortSignal | undefined, reject: (error: Error) => void): void {
+    if (!signal) return
+    const onAbort = () => {
+      if (!this.pending.has(id) && !this.pendingBatches.has(id)) return
+      this.pending.delete(id)
+      this.pendingBatches.delete(id)
+      this.channel.send({ type: 'cancel', id })
+      reject(new Error('转写已取消'))
+    }
+    if (signal.aborted) {
+      queueMicrotask(onAbort)
+      return
+    }
+    signal.addEventListener('abort', onAbort, { once: true })
+  }
+
+  private handleWorkerMessage(message: WorkerResponse) {
     if (message.type === 'ready') {
+      this.loadMs = message.loadMs ?? null
       this.readyResolver?.resolve()
       this.readyResolver = null
+      this.onModelLoaded()
       return
     }
     if (message.type === 'init-error') {
@@ -238,16 +367,81 @@ export class SenseVoiceTranscriber implements Transcriber {
           durationMs: message.durationMs,
           modelId: this.config.modelId ?? 'SenseVoice-Small',
           language: message.language || this.config.language || undefined,
+          segments: pending.segments,
+          tokens: message.tokens.length > 0 ? message.tokens : undefined,
         })
       }
       return
     }
+    if (message.type === 'transcribe-partial') {
+      const pending = this.pending.get(message.id)
+      if (pending?.segments) {
+        pending.segments.push(...message.segments)
+        pending.onProgress?.({ segments: message.segments, processedMs: message.processedMs, totalMs: message.totalMs })
+      }
+      return
+    }
     if (message.type === 'transcribe-error') {
       const pending = this.pending.get(message.id)
       if (pending) {
         this.pending.delete(message.id)
         pending.reject(new Error(message.error))
       }
+      const batch = this.pendingBatches.get(message.id)
+      if (batch) {
+        this.pendingBatches.delete(message.id)
+        batch.reject(new Error(message.error))
+      }
+      const benchmark = this.pendingBenchmarks.get(message.id)
+      if (benchmark) {
+        this.pendingBenchmarks.delete(message.id)
+        benchmark.reject(new Error(message.error))
+      }
+      return
+    }
+    if (message.type === 'benchmark-progress') {
+      this.pendingBenchmarks.get(message.id)?.onProgress?.(message.completed, message.total)
+      return
+    }
+    if (message.type === 'benchmark-success') {
+      const benchmark = this.pendingBenchmarks.get(message.id)
+      if (benchmark) {
+        this.pendingBenchmarks.delete(message.id)
+        benchmark.resolve({ audioMs: message.audioMs, results: message.results as AutotuneCandidateResult[] })
+      }
+      return
+    }
+    if (message.type === 'transcribe-batch-success') {
+      const batch = this.pendingBatches.get(message.id)
+      if (batch) {
+        this.pendingBatches.delete(message.id)
+        const modelId = this.config.modelId ?? 'SenseVoice-Small'
+        batch.resolve(
+          batch.filePaths.map((filePath, index) => {
+            const item = message.items[index]
+            if (!item || item.error !== undefined) {
+              return { filePath, error: item?.error ?? '批量转写结果缺失' }
+            }
+            return {
+              filePath,
+              result: {
+                text: item.text ?? '',
+                durationMs: item.durationMs ?? 0,
+                modelId,
+                language: item.language || this.config.language || undefined,
+              },
+            }
+          })
+        )
+      }
+      return
+    }
+    if (message.type === 'stats-result') {
+      const resolve = this.pendingStats.get(message.id)
+      if (resolve) {
+        this.pendingStats.delete(message.id)
+        resolve({ rss: message.rss, queue: message.queue as WorkerQueueStats })
+      }
     }
   }
 
@@ -280,8 +474,9 @@ export class SenseVoiceTranscriber implements Transcriber {
       if (modelFile) {
         candidates.push(path.join(modelDir, modelFile))
       }
-      candidates.push(path.join(modelDir, 'model.onnx'))
-      candidates.push(path.join(modelDir, 'model.int8.onnx'))
+      for (const variant of MODEL_VARIANTS) {
+        candidates.push(path.join(modelDir, variant))
+      }
     }
     console.log('[Transcriber] 候选模型文件:', candidates)
     const existing = candidates.find((candidate) => candidate && fs.existsSync(candidate))
@@ -295,16 +490,85 @@ export class SenseVoiceTranscriber implements Transcriber {
     return patched
   }
 
-  private async ensureOnnxMetadata(modelPath: string, vocabSize: number) {
+  private optimizedCacheDir() {
+    return path.join(this.options.supportDir, 'models', 'optimized')
+  }
+
+  /**
+   * 查找源模型对应的优化模型缓存
+   */
+  private async resolveOptimizedModel(sourcePath: string): Promise<string | null> {
     try {
-      const data = await fsPromises.readFile(modelPath)
-      if (typeof ModelProto?.decode !== 'function') {
-        return modelPath
+      const optimizedPath = await lookupOptimizedModel(sourcePath, this.optimizedCacheDir(), describeRuntime(this.runtimeDir))
+      if (optimizedPath) {
+        console.log('[Transcriber] 使用优化模型缓存:', path.basename(optimizedPath))
       }
-      const proto = ModelProto.decode(data)
-      const metadata: Array<{ key: string; value: string }> = Array.isArray(proto.metadataProps)
-        ? (proto.metadataProps as Array<{ key: string; value: string }>)
-        : []
+      return optimizedPath
+    } catch (error) {
+      console.warn('[Transcriber] 读取优化模型缓存失败，使用原模型', error)
+      return null
+    }
+  }
+
+  /**
+   * 记录 worker 加载耗时；未命中缓存时在后台生成优化模型
+   */
+  private onModelLoaded() {
+    const loaded = this.loadedModel
+    if (!loaded) return
+    metrics.recordMetric({
+      operation: 'model_load',
+      startTime: Date.now() - (this.loadMs ?? 0),
+      duration: this.loadMs ?? 0,
+      memoryUsage: process.memoryUsage().heapUsed,
+      // 分开聚合，便于对比命中优化模型缓存前后的加载耗时
+      metadata: {
+        stage: loaded.optimizedPath ? 'session_optimized' : 'session',
+        model: path.basename(loaded.sourcePath),
+      },
+    })
+    if (loaded.optimizedPath) return
+
+    const cacheDir = this.optimizedCacheDir()
+    const runtimeKey = describeRuntime(this.runtimeDir)
+    const timer = setTimeout(() => {
+      void (async () => {
+        if (!(await shouldBuildOptimizedModel(loaded.sourcePath, cacheDir, runtimeKey))) return
+        console.log('[Transcriber] 后台生成优化模型:', path.basename(loaded.sourcePath))
+        await buildOptimizedModel({
+          modelPath: loaded.sourcePath,
+          tokensPath: loaded.tokensPath,
+          cacheDir,
+          runtimeKey,
+          spawn: () => this.spawnOptimizer(),
+        })
+      })().catch((error) => {
+        console.warn('[Transcriber] 生成优化模型出错:', error)
+      })
+    }, OPTIMIZE_DELAY_MS)
+    timer.unref()
+  }
+
+  /**
+   * 启动优化进程：与 worker 相同的原生库环境，低调度优先级
+   */
+  private spawnOptimizer(): ChildProcess {
+    const child = fork(this.resolveScriptPath('ort-optimizer.cjs'), [], {
+      env: this.buildWorkerEnv(),
+      stdio: 'inherit',
+    })
+    if (child.pid !== undefined) {
+      try {
+        os.setPriority(child.pid, BACKGROUND_PRIORITY)
+      } catch {
+        // 无法调整优先级时按默认优先级运行
+      }
+    }
+    return child
+  }
+
+  private async ensureOnnxMetadata(modelPath: string, vocabSize: number) {
+    try {
       const defaults: Record<string, string> = {
         vocab_size: String(vocabSize ?? 0),
         feat_dim: String(FEATURE_DIM),
@@ -317,22 +581,8 @@ export class SenseVoiceTranscriber implements Transcriber {
         normalize_samples: String(NORMALIZE_SAMPLES),
         snip_edges: String(SNIP_EDGES),
       }
-      let patched = false
-      for (const [key, value] of Object.entries(defaults)) {
-        if (!metadata.some((item) => item.key === key)) {
-          metadata.push({ key, value })
-          patched = true
-        }
-      }
-      if (!patched) {
-        return modelPath
-      }
-      proto.metadataProps = metadata
       const targetDir = path.join(this.options.supportDir, 'models', 'patched')
-      await fsPromises.mkdir(targetDir, { recursive: true })
-      const targetPath = path.join(targetDir, `sensevoice-${path.basename(modelPath)}`)
-      await fsPromises.writeFile(targetPath, ModelProto.encode(proto).finish())
-      return targetPath
+      return await ensureOnnxMetadata(modelPath, defaults, targetDir)
     } catch (error) {
       console.warn('[speech] SenseVoice 元数据写入失败，将继续使用原模型', error)
       return modelPath
@@ -387,7 +637,7 @@ export class SenseVoiceTranscriber implements Transcriber {
     return content.split(/\r?\n/).filter(Boolean).length
   }
 
-  async transcribe(filePath: string): Promise<TranscriptionResult> {
+  async transcribe(filePath: string, options: TranscribeOptions = {}): Promise<TranscriptionResult> {
     console.log('[Transcriber] 开始转录，文件路径:', filePath)
     await this.ready
     console.log('[Transcriber] Worker 已就绪')
@@ -396,16 +646,240 @@ export class SenseVoiceTranscriber implements Transcriber {
       throw new Error('SenseVoice worker 已退出')
     }
 
-    const id = randomUUID()
+    const id = this.allocateRequestId()
     console.log('[Transcriber] 创建转录请求，ID:', id)
     return new Promise<TranscriptionResult>((resolve, reject) => {
       this.pending.set(id, { resolve, reject })
+      this.bindAbort(id, options.signal, reject)
       console.log('[Transcriber] 发送转录请求到 Worker')
-      this.worker.send({
+      this.sendRequest(id, [{
         type: 'transcribe',
         id,
         audioPath: filePath,
+        priority: options.priority ?? 'live',
+      }], reject)
+    })
+  }
+
+  /**
+   * 分窗转写长音频
+   * worker 每次只读取一个窗口，分段解码后立即回传，主进程与 worker 都不持有整段波形
+   */
+  async transcribeLong(filePath: string, options: LongTranscribeOptions): Promise<TranscriptionResult> {
+    await this.ready
+    if (this.workerExited) {
+      throw new Error('SenseVoice worker 已退出')
+    }
+
+    const id = this.allocateRequestId()
+    console.log('[Transcriber] 发送长音频转录请求到 Worker，ID:', id, '窗口:', options.windowMs)
+    return new Promise<TranscriptionResult>((resolve, reject) => {
+      this.pending.set(id, { resolve, reject, segments: [], onProgress: options.onProgress })
+      this.bindAbort(id, options.signal, reject)
+      this.sendRequest(id, [{ type: 'transcribe-long', id, audioPath: filePath, windowMs: options.windowMs }], reject)
+    })
+  }
+
+  /**
+   * 直接转写内存中的 PCM 数据
+   * 录音数据不经磁盘中转，原始字节直接写入协议管道；长录音按 PCM_CHUNK_BYTES 分帧发送
+   */
+  async transcribePcm(pcm: PcmAudio): Promise<TranscriptionResult> {
+    await this.ready
+    if (this.workerExited) {
+      throw new Error('SenseVoice worker 已退出')
+    }
+
+    const id = this.allocateRequestId()
+    console.log('[Transcriber] 发送 PCM 转录请求到 Worker，ID:', id, '字节数:', pcm.data.length)
+    const messages: WorkerRequest[] = []
+    let offset = 0
+    for (; pcm.data.length - offset > PCM_CHUNK_BYTES; offset += PCM_CHUNK_BYTES) {
+      messages.push({ type: 'pcm-chunk', id, pcm: pcm.data.subarray(offset, offset + PCM_CHUNK_BYTES) })
+    }
+    messages.push({
+      type: 'transcribe-pcm',
+      id,
+      sampleRate: pcm.sampleRate,
+      channels: pcm.channels,
+      pcm: pcm.data.subarray(offset),
+    })
+    return new Promise<TranscriptionResult>((resolve, reject) => {
+      this.pending.set(id, { resolve, reject })
+      this.sendRequest(id, messages, reject)
+    })
+  }
+
+  /**
+   * 批量转写多个 WAV 文件
+   * worker 为每个文件创建 stream 后一次解码，减少逐个请求的调度与 IPC 往返
+   */
+  async transcribeBatch(filePaths: string[], options: TranscribeOptions = {}): Promise<BatchTranscriptionItem[]> {
+    if (filePaths.length === 0) return []
+    await this.ready
+    if (this.workerExited) {
+      throw new Error('SenseVoice worker 已退出')
+    }
+
+    const id = this.allocateRequestId()
+    console.log('[Transcriber] 发送批量转录请求到 Worker，ID:', id, '文件数:', filePaths.length)
+    return new Promise<BatchTranscriptionItem[]>((resolve, reject) => {
+      this.pendingBatches.set(id, { filePaths, resolve, reject })
+      this.bindAbort(id, options.signal, reject)
+      this.sendRequest(id, [{ type: 'transcribe-batch', id, audioPaths: filePaths, priority: options.priority ?? 'background' }], reject)
+    })
+  }
+
+  /**
+   * 测量候选模型文件与线程数组合的加载耗时和实时率
+   * 每个模型文件先补齐元数据，worker 逐个创建独立识别器测量
+   */
+  async benchmark(request: BenchmarkRequest): Promise<BenchmarkReport> {
+    await this.ready
+    if (this.workerExited) {
+      throw new Error('SenseVoice worker 已退出')
+    }
+    const { modelDir } = this.config
+    const tokensInfo = await this.resolveTokensInfo()
+    const patchedPaths = new Map<string, string>()
+    for (const { variant } of request.candidates) {
+      if (!patchedPaths.has(variant)) {
+        patchedPaths.set(variant, await this.ensureOnnxMetadata(path.resolve(modelDir, variant), tokensInfo.count))
+      }
+    }
+
+    const id = this.allocateRequestId()
+    console.log('[Transcriber] 发送基准测试请求到 Worker，候选数:', request.candidates.length)
+    return new Promise<BenchmarkReport>((resolve, reject) => {
+      this.pendingBenchmarks.set(id, { onProgress: request.onProgress, resolve, reject })
+      this.sendRequest(id, [{
+        type: 'benchmark',
+        id,
+        priority: 'background',
+        payload: {
+          audioPath: request.audioPath,
+          runs: request.runs,
+          tokensPath: tokensInfo.path,
+          language: this.config.language || 'zh',
+          useITN: this.config.useInverseTextNormalization !== false,
+          candidates: request.candidates.map((candidate) => ({
+            ...candidate,
+            modelPath: patchedPaths.get(candidate.variant),
+          })),
+        },
+      }], reject)
+    })
+  }
+
+  /**
+   * 开启流式转写会话
+   * worker 在录音期间按 VAD 分段提前解码并缓存结果，finish() 时只需解码尾段
+   */
+  startStream(options: TranscriptionStreamOptions): TranscriptionStream {
+    const id = this.allocateRequestId()
+    // worker 就绪前到达的音频块先缓存在主进程
+    const backlog: Buffer[] = []
+    let started = false
+    let cancelled = false
+
+    void this.ready
+      .then(() => {
+        if (cancelled || this.workerExited) return
+        this.channel.send({
+          type: 'stream-start',
+          id,
+          sampleRate: options.sampleRate,
+          channels: options.channels,
+          redecodeBoundary: options.redecodeBoundary === true,
+        })
+        started = true
+        for (const chunk of backlog) {
+          this.channel.send({ type: 'stream-chunk', id, pcm: chunk })
+        }
+        backlog.length = 0
+      })
+      .catch(() => {
+        // 初始化失败由 finish() 抛出
       })
+
+    return {
+      push: (chunk: Buffer) => {
+        if (cancelled || this.workerExited) return
+        if (!started) {
+          backlog.push(chunk)
+          return
+        }
+        this.channel.send({ type: 'stream-chunk', id, pcm: chunk })
+      },
+      finish: async () => {
+        // 会话中断时录音仍完整，调用方可改为整段解码
+        try {
+          await this.ready
+          if (this.workerExited) {
+            throw new Error('SenseVoice worker 已退出')
+          }
+          if (cancelled || !started) {
+            throw new Error('流式会话已取消')
+          }
+          return await new Promise<TranscriptionResult>((resolve, reject) => {
+            this.pending.set(id, { resolve, reject })
+            this.sendRequest(id, [{ type: 'stream-finish', id }], reject)
+          })
+        } catch (error) {
+          throw new StreamFallbackError(error instanceof Error ? error.message : String(error))
+        }
+      },
+      cancel: () => {
+        if (cancelled) return
+        cancelled = true
+        backlog.length = 0
+        if (started && !this.workerExited) {
+          this.channel.send({ type: 'cancel', id })
+        }
+      },
+    }
+  }
+
+  /**
+   * 等待模型加载完成
+   */
+  async whenReady(): Promise<number | null> {
+    await this.ready
+    return this.loadMs
+  }
+
+  /**
+   * 查询 worker 进程常驻内存（字节）
+   */
+  async getMemoryUsage(): Promise<number | null> {
+    return (await this.requestStats())?.rss ?? null
+  }
+
+  /**
+   * 查询 worker 调度队列的排队时延统计
+   */
+  async getQueueStats(): Promise<WorkerQueueStats | null> {
+    return (await this.requestStats())?.queue ?? null
+  }
+
+  /**
+   * worker 忙于解码时可能无法及时响应，超时返回 null
+   */
+  private requestStats(): Promise<WorkerStats | null> {
+    if (this.workerExited) {
+      return Promise.resolve(null)
+    }
+    const id = this.allocateRequestId()
+    return new Promise<WorkerStats | null>((resolve) => {
+      const timer = setTimeout(() => {
+        this.pendingStats.delete(id)
+        resolve(null)
+      }, STATS_TIMEOUT_MS)
+      this.pendingStats.set(id, (stats) => {
+        clearTimeout(timer)
+        resolve(stats)
+      })
+      this.channel.send({ type: 'stats', id })
     })
   }
 
@@ -419,9 +893,25 @@ export class SenseVoiceTranscriber implements Transcriber {
       this.workerExited = true
     }
     // 清理所有待处理的请求
+    this.rejectAllPending(new Error('Transcriber 已销毁'))
+    for (const [, resolve] of this.pendingStats) {
+      resolve(null)
+    }
+    this.pendingStats.clear()
+  }
+
+  private rejectAllPending(error: Error): void {
     for (const [, pending] of this.pending) {
-      pending.reject(new Error('Transcriber 已销毁'))
+      pending.reject(error)
     }
     this.pending.clear()
+    for (const [, batch] of this.pendingBatches) {
+      batch.reject(error)
+    }
+    this.pendingBatches.clear()
+    for (const [, benchmark] of this.pendingBenchmarks) {
+      benchmark.reject(error)
+    }
+    this.pendingBenchmarks.clear()
   }
 }
@@ -6,22 +6,55 @@
 // 3. 在生产环境下，原生库在 Resources/native/ 目录
 const path = require('path');
 const fs = require('fs');
+const net = require('net');
 
 const sherpa = require('sherpa-onnx-node')
+const { VadSegmenter, joinSegmentTexts } = require('./vad-segmenter.cjs')
+const { JobScheduler } = require('./job-scheduler.cjs')
+const { readWaveFile, openWaveReader } = require('./wave-reader.cjs')
+const { int16ToFloat, getDiagnostics: getDspDiagnostics } = require('./audio-dsp.cjs')
+const { createChannel, WORKER_PIPE_FD } = require('./worker-protocol.cjs')
+
+// 与主进程之间的二进制协议通道（fork 时的第 5 个 stdio，见 worker-protocol.cjs）
+const pipe = new net.Socket({ fd: WORKER_PIPE_FD, readable: true, writable: true })
+const channel = createChannel(
+  pipe,
+  handleMessage,
+  (error) => {
+    console.error('[Worker] 协议错误:', error.message)
+    process.exit(1)
+  },
+  // 处理请求时同步抛出的异常：回复该请求失败，避免主进程一直等待
+  (error, message) => {
+    console.error('[Worker] 处理请求失败:', { type: message.type, id: message.id }, error.message)
+    send({ type: 'transcribe-error', id: message.id, error: error.message })
+  }
+)
+// 主进程关闭管道后 worker 已无法接收请求
+pipe.on('close', () => {
+  console.log('[Worker] 协议管道已关闭，退出')
+  process.exit(0)
+})
+
+function send(message) {
+  channel.send(message)
+}
 
 // 全局错误处理器，防止 worker 意外退出
 process.on('uncaughtException', (error) => {
   console.error('[Worker] 未捕获的异常:', error.message)
-  process.send?.({
+  send({
     type: 'transcribe-error',
+    id: 0,
     error: `未捕获异常: ${error.message}`,
   })
 })
 
 process.on('unhandledRejection', (reason, promise) => {
   console.error('[Worker] 未处理的 Promise 拒绝:', reason)
-  process.send?.({
+  send({
     type: 'transcribe-error',
+    id: 0,
     error: `未处理的Promise拒绝: ${reason}`,
   })
 })
@@ -29,14 +62,88 @@ process.on('unhandledRejection', (reason, promise) => {
 let recognizer = null
 let language = ''
 let activeStreams = new Set()
+// 流式转写会话：id -> 会话状态
+const streamSessions = new Map()
+// 分帧发送的 PCM：id -> 已收到的分片，收到 transcribe-pcm 时拼接
+const pcmChunks = new Map()
+// 识别任务调度：实时听写优先，后台任务按分段让出
+const scheduler = new JobScheduler()
+// 后台音频短于该时长时整体解码，更长的按 VAD 分段解码
+const BACKGROUND_SEGMENT_MIN_MS = 30000
+// 批量转写每一步最多一起解码的分段数
+const BATCH_DECODE_WIDTH = 8
+// 未经自动调优时的推理线程数
+const DEFAULT_NUM_THREADS = 2
+// 长音频每次读取的窗口时长（未指定时）
+const DEFAULT_LONG_WINDOW_MS = 60000
+
+/**
+ * 读取请求的优先级，未指定时使用默认值
+ */
+function resolvePriority(message, fallback) {
+  return message.priority === 'live' || message.priority === 'background' ? message.priority : fallback
+}
+
+/**
+ * 提取识别结果中的 token 时间戳（秒）并换算为毫秒
+ * offsetMs 为该段音频在整段中的起点
+ */
+function collectTokens(result, offsetMs, out) {
+  const tokens = Array.isArray(result.tokens) ? result.tokens : []
+  const timestamps = Array.isArray(result.timestamps) ? result.timestamps : []
+  const count = Math.min(tokens.length, timestamps.length)
+  for (let i = 0; i < count; i++) {
+    out.push({ start: Math.round(offsetMs + timestamps[i] * 1000), text: tokens[i] })
+  }
+  return out
+}
+
+/**
+ * 把一个同步操作包装为单步任务
+ */
+function* singleStep(fn) {
+  fn()
+}
+
+/**
+ * 构建 Sherpa-ONNX 离线识别器配置
+ */
+function buildRecognizerConfig(payload, modelPath, numThreads) {
+  // ⚠ 警告：SenseVoice-ONNX 可能将 language 参数视为自动检测输出而非输入
+  const senseVoiceConfig = {
+    model: modelPath,
+    useInverseTextNormalization: payload.useITN ? 1 : 0,
+  }
+
+  // 尝试添加 language 参数（可能无效）
+  if (payload.language && payload.language !== 'auto') {
+    senseVoiceConfig.language = payload.language
+  }
+
+  return {
+    featConfig: {
+      sampleRate: 16000,
+      featureDim: 80,
+    },
+    modelConfig: {
+      senseVoice: senseVoiceConfig,
+      tokens: payload.tokensPath,
+      numThreads: Number.isInteger(numThreads) && numThreads > 0 ? numThreads : DEFAULT_NUM_THREADS,
+      provider: 'cpu',
+      debug: 1,
+    },
+  }
+}
 
 function handleInit(payload) {
+  const initStartedAt = Date.now()
   try {
     // 明确指定语言，避免 auto 检测错误
     // 支持的语言: zh(中文), en(英文), yue(粤语), ja(日语), ko(韩语)
     const lang = payload.language || 'zh'
     language = lang
     console.log('[Worker] 初始化识别器，语言设置为:', language)
+    console.log('[Worker] 音频 DSP 内核:', JSON.stringify(getDspDiagnostics()))
 
     // 检查音频文件是否存在并验证模型
     if (!fs.existsSync(payload.modelPath)) {
@@ -46,55 +153,48 @@ function handleInit(payload) {
       throw new Error(`tokens 文件不存在: ${payload.tokensPath}`)
     }
 
-    // Sherpa-ONNX 配置
-    // ⚠ 警告：SenseVoice-ONNX 可能将 language 参数视为自动检测输出而非输入
-    const senseVoiceConfig = {
-      model: payload.modelPath,
-      useInverseTextNormalization: payload.useITN ? 1 : 0,
-    }
-
-    // 尝试添加 language 参数（可能无效）
-    if (payload.language && payload.language !== 'auto') {
-      senseVoiceConfig.language = payload.language
-    }
-
-    const config = {
-      featConfig: {
-        sampleRate: 16000,
-        featureDim: 80,
-      },
-      modelConfig: {
-        senseVoice: senseVoiceConfig,
-        tokens: payload.tokensPath,
-        numThreads: 2,
-        provider: 'cpu',
-        debug: 1,
-      },
-    }
+    const config = buildRecognizerConfig(payload, payload.modelPath, payload.numThreads)
 
     console.log('[Worker] 创建识别器，配置:', JSON.stringify({
-      language: senseVoiceConfig.language || 'auto',
+      language: config.modelConfig.senseVoice.language || 'auto',
       modelPath: path.basename(payload.modelPath),
       tokensPath: path.basename(payload.tokensPath),
-      useITN: senseVoiceConfig.useInverseTextNormalization,
+      useITN: config.modelConfig.senseVoice.useInverseTextNormalization,
+      numThreads: config.modelConfig.numThreads,
     }, null, 2))
     console.log('[Worker] ⚠ 注意：ONNX 版本可能忽略 language 参数，lang 是检测结果而非输入')
 
     recognizer = new sherpa.OfflineRecognizer(config)
-    console.log('[Worker] 识别器初始化成功')
-    process.send?.({ type: 'ready' })
+    const loadMs = Date.now() - initStartedAt
+    console.log(`[Worker] 识别器初始化成功，耗时 ${loadMs}ms`)
+    send({ type: 'ready', loadMs })
   } catch (error) {
     console.error('[Worker] 识别器初始化失败:', error.message)
-    process.send?.({
+    send({
       type: 'init-error',
       error: error instanceof Error ? error.message : String(error),
     })
   }
 }
 
+/**
+ * 将主进程直接传来的 16-bit PCM 转为单声道 Float32 波形
+ * data 是指向协议帧的字节视图，起始地址不一定 2 字节对齐
+ */
+function pcm16ToWave(pcm) {
+  const bytes = pcm.data
+  const numChannels = pcm.channels || 1
+  // Int16Array 视图要求 2 字节对齐，否则先复制一份
+  const aligned = bytes.byteOffset % 2 === 0 ? bytes : new Uint8Array(bytes)
+  const int16 = new Int16Array(aligned.buffer, aligned.byteOffset, Math.floor(aligned.byteLength / 2))
+  const samples = int16ToFloat(int16, numChannels)
+
+  return { sampleRate: pcm.sampleRate, samples }
+}
+
 function handleTranscribe(message) {
   if (!recognizer) {
-    process.send?.({
+    send({
       type: 'transcribe-error',
       id: message.id,
       error: '识别器尚未初始化',
@@ -102,93 +202,278 @@ function handleTranscribe(message) {
     return
   }
 
-  let stream = null
+  const priority = resolvePriority(message, 'live')
+  scheduler.enqueue(priority, message.id, transcribeFileJob(message.id, message.audioPath, priority))
+}
+
+/**
+ * 文件转写任务：读取文件后，实时请求整段解码，后台请求按分段解码
+ */
+function* transcribeFileJob(id, audioPath, priority) {
+  let waveData
   try {
     // 检查音频文件是否存在
-    if (!fs.existsSync(message.audioPath)) {
-      throw new Error(`音频文件不存在: ${message.audioPath}`)
+    if (!fs.existsSync(audioPath)) {
+      throw new Error(`音频文件不存在: ${audioPath}`)
     }
-
-    stream = recognizer.createStream()
-    activeStreams.add(stream)
-
     // 手动解析 WAV 文件
-    let waveData
     try {
-      const audioBuffer = fs.readFileSync(message.audioPath)
+      waveData = readWaveFile(audioPath)
+    } catch (readError) {
+      throw new Error(`读取音频文件失败: ${readError instanceof Error ? readError.message : String(readError)}`)
+    }
+  } catch (error) {
+    console.error('[Worker] 转录失败:', error)
+    send({
+      type: 'transcribe-error',
+      id,
+      error: error instanceof Error ? error.message : String(error),
+    })
+    return
+  }
 
-      // 解析 WAV 头部 (44 bytes)
-      if (audioBuffer.length < 44) {
-        throw new Error('WAV文件太小')
-      }
+  if (priority === 'live') {
+    recognizeWave(id, waveData)
+    return
+  }
+  yield
+  yield* backgroundRecognizeJob(id, waveData)
+}
 
-      // 检查 RIFF 头
-      const riff = audioBuffer.readUInt32LE(0)
-      if (riff !== 0x46464952) {
-        throw new Error('不是有效的 RIFF 文件')
-      }
+/**
+ * 将整段波形按 VAD 切分为待解码的分段
+ * 短音频不切分；全部为静音时返回空数组
+ */
+function splitWave(waveData) {
+  const { sampleRate, samples } = waveData
+  if ((samples.length / sampleRate) * 1000 < BACKGROUND_SEGMENT_MIN_MS) {
+    return [{ start: 0, end: samples.length }]
+  }
+  const segmenter = new VadSegmenter(sampleRate)
+  const segments = segmenter.push(samples)
+  const tailStart = segmenter.openSegmentStart
+  if (segmenter.openSegmentHasSpeech && tailStart < samples.length) {
+    segments.push({ start: tailStart, end: samples.length })
+  }
+  return segments
+}
 
-      // 检查 WAVE 标识
-      const wave = audioBuffer.readUInt32LE(8)
-      if (wave !== 0x45564157) {
-        throw new Error('不是有效的 WAVE 文件')
-      }
+/**
+ * 后台转写：逐段解码，每段之后让出，使实时请求可以插队
+ */
+function* backgroundRecognizeJob(id, waveData) {
+  try {
+    const startedAt = Date.now()
+    if (!waveData || !waveData.samples || waveData.samples.length === 0) {
+      throw new Error('音频数据为空或无效')
+    }
+    const segments = splitWave(waveData)
+    const texts = []
+    const tokens = []
+    let detectedLanguage = ''
+    for (const segment of segments) {
+      const result = decodeSamples(waveData.sampleRate, waveData.samples.slice(segment.start, segment.end))
+      texts.push(result.text ?? '')
+      collectTokens(result, (segment.start / waveData.sampleRate) * 1000, tokens)
+      detectedLanguage = result.language || detectedLanguage
+      yield
+    }
 
-      // 查找 fmt chunk
-      let offset = 12
-      let sampleRate = 0
-      let bitsPerSample = 0
-      let numChannels = 0
-      let dataOffset = 0
-      let dataSize = 0
-
-      while (offset < audioBuffer.length) {
-        const chunkId = audioBuffer.readUInt32LE(offset)
-        const chunkSize = audioBuffer.readUInt32LE(offset + 4)
-
-        if (chunkId === 0x20746d66) { // 'fmt '
-          numChannels = audioBuffer.readUInt16LE(offset + 10)  // 偏移量10-11: 通道数
-          sampleRate = audioBuffer.readUInt32LE(offset + 12)  // 偏移量12-15: 采样率
-          bitsPerSample = audioBuffer.readUInt16LE(offset + 22) // 偏移量22-23: 位深度
-        } else if (chunkId === 0x61746164) { // 'data'
-          dataOffset = offset + 8
-          dataSize = chunkSize
-          break
-        }
+    const text = joinSegmentTexts(texts)
+    const durationMs = Math.round((waveData.samples.length / waveData.sampleRate) * 1000)
+    console.log('[Worker] 后台转录完成:', {
+      id,
+      segments: segments.length,
+      durationMs,
+      elapsedMs: Date.now() - startedAt,
+      textLength: text.length,
+    })
+    send({
+      type: 'transcribe-success',
+      id,
+      text,
+      durationMs,
+      language: detectedLanguage || language,
+      tokens,
+    })
+  } catch (error) {
+    console.error('[Worker] 转录失败:', error)
+    send({
+      type: 'transcribe-error',
+      id,
+      error: error instanceof Error ? error.message : String(error),
+    })
+  }
+}
 
-        offset += 8 + chunkSize + (chunkSize % 2)
-      }
+// ============ 长音频：分窗读取，逐段输出带时间戳的结果 ============
+
+function handleTranscribeLong(message) {
+  if (!recognizer) {
+    send({
+      type: 'transcribe-error',
+      id: message.id,
+      error: '识别器尚未初始化',
+    })
+    return
+  }
+  const windowMs = message.windowMs > 0 ? message.windowMs : DEFAULT_LONG_WINDOW_MS
+  scheduler.enqueue('background', message.id, longFileJob(message.id, message.audioPath, windowMs))
+}
+
+/**
+ * 长音频转写：每次只读取一个窗口送入 VAD，已关闭的分段立即解码并回传；
+ * 内存中只保留当前窗口和尚未关闭的分段（不超过 VAD 最大段长），与文件总时长无关
+ */
+function* longFileJob(id, audioPath, windowMs) {
+  let reader
+  try {
+    reader = openWaveReader(audioPath)
+  } catch (error) {
+    console.error('[Worker] 长音频转录失败:', error)
+    send({
+      type: 'transcribe-error',
+      id,
+      error: `读取音频文件失败: ${error instanceof Error ? error.message : String(error)}`,
+    })
+    return
+  }
+
+  try {
+    const startedAt = Date.now()
+    const { sampleRate, totalFrames } = reader
+    const toMs = (frames) => Math.round((frames / sampleRate) * 1000)
+    const totalMs = toMs(totalFrames)
+    const windowFrames = Math.max(sampleRate, Math.round((sampleRate * windowMs) / 1000))
+    const segmenter = new VadSegmenter(sampleRate)
+    // 尚未丢弃的样本，buffer[0] 对应第 bufferStart 帧
+    let buffer = new Float32Array(0)
+    let bufferStart = 0
+    const texts = []
+    let detectedLanguage = ''
+    let segmentCount = 0
+
+    const decodeSegment = (start, end) => {
+      const result = decodeSamples(sampleRate, buffer.slice(start - bufferStart, end - bufferStart))
+      const text = (result.text ?? '').trim()
+      detectedLanguage = result.language || detectedLanguage
+      segmentCount++
+      if (text) texts.push(text)
+      return text ? [{ start: toMs(start), end: toMs(end), text }] : []
+    }
+
+    for (let position = 0; position < totalFrames; ) {
+      const samples = reader.read(position, windowFrames)
+      if (samples.length === 0) break
+      position += samples.length
+
+      const merged = new Float32Array(buffer.length + samples.length)
+      merged.set(buffer, 0)
+      merged.set(samples, buffer.length)
+      buffer = merged
 
-      if (!sampleRate || !dataOffset) {
-        throw new Error('WAV文件格式错误')
+      const closed = segmenter.push(samples)
+      if (closed.length === 0) {
+        send({ type: 'transcribe-partial', id, segments: [], processedMs: toMs(position), totalMs })
+      }
+      for (const segment of closed) {
+        const segments = decodeSegment(segment.start, segment.end)
+        send({ type: 'transcribe-partial', id, segments, processedMs: toMs(segment.end), totalMs })
+        yield
       }
 
-      // 提取音频数据
-      const totalSamples = dataSize / (bitsPerSample / 8)
-      const samplesPerChannel = totalSamples / numChannels
-      const samples = new Float32Array(samplesPerChannel)
-
-      for (let i = 0; i < samplesPerChannel; i++) {
-        let sample = 0
-        // 混合多通道为单声道
-        for (let ch = 0; ch < numChannels; ch++) {
-          if (bitsPerSample === 16) {
-            const int16 = audioBuffer.readInt16LE(dataOffset + (i * numChannels + ch) * 2)
-            sample += int16 / 0x8000 // 转换为[-1, 1]范围
-          } else if (bitsPerSample === 8) {
-            const uint8 = audioBuffer.readUInt8(dataOffset + i * numChannels + ch)
-            sample += (uint8 - 128) / 128 // 转换为[-1, 1]范围
-          } else {
-            throw new Error(`不支持的位深度: ${bitsPerSample}`)
-          }
-        }
-        samples[i] = sample / numChannels // 平均值
+      // 已关闭分段的样本不再需要
+      const keepFrom = segmenter.openSegmentStart
+      if (keepFrom > bufferStart) {
+        buffer = buffer.slice(keepFrom - bufferStart)
+        bufferStart = keepFrom
       }
+      yield
+    }
 
-      waveData = { sampleRate, samples }
-    } catch (readError) {
-      throw new Error(`读取音频文件失败: ${readError instanceof Error ? readError.message : String(readError)}`)
+    const tailStart = segmenter.openSegmentStart
+    if (segmenter.openSegmentHasSpeech && bufferStart + buffer.length > tailStart) {
+      const segments = decodeSegment(tailStart, bufferStart + buffer.length)
+      send({ type: 'transcribe-partial', id, segments, processedMs: totalMs, totalMs })
+    }
+
+    const text = joinSegmentTexts(texts)
+    console.log('[Worker] 长音频转录完成:', {
+      id,
+      segments: segmentCount,
+      durationMs: totalMs,
+      windowMs,
+      elapsedMs: Date.now() - startedAt,
+      textLength: text.length,
+    })
+    send({
+      type: 'transcribe-success',
+      id,
+      text,
+      durationMs: totalMs,
+      language: detectedLanguage || language,
+    })
+  } catch (error) {
+    console.error('[Worker] 长音频转录失败:', error)
+    send({
+      type: 'transcribe-error',
+      id,
+      error: error instanceof Error ? error.message : String(error),
+    })
+  } finally {
+    reader.close()
+  }
+}
+
+function handlePcmChunk(message) {
+  const chunks = pcmChunks.get(message.id) ?? []
+  // 帧体只是读缓冲的视图，需复制后再保留
+  chunks.push(Buffer.from(message.pcm))
+  pcmChunks.set(message.id, chunks)
+}
+
+function handleTranscribePcm(message) {
+  const chunks = pcmChunks.get(message.id)
+  if (chunks) {
+    pcmChunks.delete(message.id)
+    chunks.push(message.pcm)
+    message.pcm = Buffer.concat(chunks)
+  }
+  if (!recognizer) {
+    send({
+      type: 'transcribe-error',
+      id: message.id,
+      error: '识别器尚未初始化',
+    })
+    return
+  }
+
+  let waveData
+  try {
+    if (!message.pcm || message.pcm.length === 0 || !message.sampleRate) {
+      throw new Error('PCM 数据无效')
     }
+    waveData = pcm16ToWave({ sampleRate: message.sampleRate, channels: message.channels, data: message.pcm })
+  } catch (error) {
+    console.error('[Worker] 转录失败:', error)
+    send({
+      type: 'transcribe-error',
+      id: message.id,
+      error: error instanceof Error ? error.message : String(error),
+    })
+    return
+  }
+
+  const priority = resolvePriority(message, 'live')
+  const job = priority === 'live' ? singleStep(() => recognizeWave(message.id, waveData)) : backgroundRecognizeJob(message.id, waveData)
+  scheduler.enqueue(priority, message.id, job)
+}
+
+function recognizeWave(id, waveData) {
+  let stream = null
+  try {
+    stream = recognizer.createStream()
+    activeStreams.add(stream)
 
     // 检查wave数据有效性
     if (!waveData || !waveData.samples || waveData.samples.length === 0) {
@@ -235,7 +520,7 @@ function handleTranscribe(message) {
     const durationMs = Math.round((waveData.samples.length / waveData.sampleRate) * 1000)
 
     console.log('[Worker] 转录成功！结果:', {
-      id: message.id,
+      id,
       text: result.text ?? '',
       textLength: result.text ? result.text.length : 0,
       durationMs,
@@ -248,59 +533,511 @@ function handleTranscribe(message) {
     } else {
       console.log('[Worker] 警告：转录结果为空')
     }
-    process.send?.({
+    send({
       type: 'transcribe-success',
-      id: message.id,
+      id,
       text: result.text ?? '',
       durationMs,
       language: result.language ?? language,
+      tokens: collectTokens(result, 0, []),
     })
   } catch (error) {
     console.error('[Worker] 转录失败:', error)
-    process.send?.({
+    send({
+      type: 'transcribe-error',
+      id,
+      error: error instanceof Error ? error.message : String(error),
+    })
+  } finally {
+    releaseStream(stream)
+  }
+}
+
+/**
+ * 安全地释放 stream
+ */
+function releaseStream(stream) {
+  if (!stream || !activeStreams.has(stream)) return
+  activeStreams.delete(stream)
+  try {
+    console.log('[Worker] 开始释放 stream 对象')
+    if (typeof stream.free === 'function') {
+      console.log('[Worker] 调用 stream.free()')
+      stream.free()
+    } else if (typeof stream.release === 'function') {
+      console.log('[Worker] 调用 stream.release()')
+      stream.release()
+    } else if (typeof stream.delete === 'function') {
+      console.log('[Worker] 调用 stream.delete()')
+      stream.delete()
+    } else {
+      console.log('[Worker] stream 对象无释放方法，依赖 GC 回收')
+    }
+    console.log('[Worker] Stream 释放完成')
+  } catch (releaseError) {
+    console.error('[Worker] 释放 stream 时出错:', releaseError)
+  }
+}
+
+/**
+ * 解码一段波形并返回识别结果（同步执行）
+ */
+function decodeSamples(sampleRate, samples) {
+  const stream = recognizer.createStream()
+  activeStreams.add(stream)
+  try {
+    stream.acceptWaveform({ sampleRate, samples })
+    recognizer.decode(stream)
+    return recognizer.getResult(stream)
+  } finally {
+    releaseStream(stream)
+  }
+}
+
+// ============ 批量转写：多个文件一次解码 ============
+
+/**
+ * 一次解码多个 stream
+ * 绑定提供多 stream 批量解码接口时一次调用完成，否则逐个解码
+ */
+function decodeStreamBatch(streams) {
+  if (typeof recognizer.decodeStreams === 'function') {
+    recognizer.decodeStreams(streams)
+    return
+  }
+  for (const stream of streams) {
+    recognizer.decode(stream)
+  }
+}
+
+function handleTranscribeBatch(message) {
+  if (!recognizer) {
+    send({
       type: 'transcribe-error',
       id: message.id,
+      error: '识别器尚未初始化',
+    })
+    return
+  }
+
+  const audioPaths = Array.isArray(message.audioPaths) ? message.audioPaths : []
+  scheduler.enqueue(resolvePriority(message, 'background'), message.id, transcribeBatchJob(message.id, audioPaths))
+}
+
+/**
+ * 批量转写任务
+ * 所有文件先按 VAD 切分，再跨文件每次取若干分段一起解码，每步之间让出
+ */
+function* transcribeBatchJob(id, audioPaths) {
+  const startedAt = Date.now()
+  const items = new Array(audioPaths.length)
+  const files = []
+  const units = []
+
+  // 读取失败的文件单独报错，不影响同批次其他文件
+  for (let i = 0; i < audioPaths.length; i++) {
+    try {
+      if (!fs.existsSync(audioPaths[i])) {
+        throw new Error(`音频文件不存在: ${audioPaths[i]}`)
+      }
+      const waveData = readWaveFile(audioPaths[i])
+      if (waveData.samples.length === 0) {
+        throw new Error('音频数据为空或无效')
+      }
+      const file = { index: i, waveData, texts: [], language: '' }
+      files.push(file)
+      for (const segment of splitWave(waveData)) {
+        units.push({ file, segment, text: '' })
+      }
+    } catch (error) {
+      items[i] = { error: error instanceof Error ? error.message : String(error) }
+    }
+    yield
+  }
+
+  try {
+    for (let offset = 0; offset < units.length; offset += BATCH_DECODE_WIDTH) {
+      const group = units.slice(offset, offset + BATCH_DECODE_WIDTH)
+      const streams = []
+      try {
+        for (const unit of group) {
+          const { sampleRate, samples } = unit.file.waveData
+          const stream = recognizer.createStream()
+          activeStreams.add(stream)
+          streams.push(stream)
+          stream.acceptWaveform({ sampleRate, samples: samples.slice(unit.segment.start, unit.segment.end) })
+        }
+        decodeStreamBatch(streams)
+        group.forEach((unit, k) => {
+          const result = recognizer.getResult(streams[k])
+          unit.file.texts.push(result.text ?? '')
+          unit.file.language = result.language || unit.file.language
+        })
+      } finally {
+        for (const stream of streams) {
+          releaseStream(stream)
+        }
+      }
+      yield
+    }
+
+    for (const file of files) {
+      const { sampleRate, samples } = file.waveData
+      items[file.index] = {
+        text: joinSegmentTexts(file.texts),
+        durationMs: Math.round((samples.length / sampleRate) * 1000),
+        language: file.language || language,
+      }
+    }
+
+    console.log('[Worker] 批量转录完成:', {
+      id,
+      files: audioPaths.length,
+      decoded: files.length,
+      segments: units.length,
+      elapsedMs: Date.now() - startedAt,
+    })
+    send({ type: 'transcribe-batch-success', id, items })
+  } catch (error) {
+    console.error('[Worker] 批量转录失败:', error)
+    send({
+      type: 'transcribe-error',
+      id,
       error: error instanceof Error ? error.message : String(error),
     })
+  }
+}
+
+// ============ 流式会话：录音期间按 VAD 分段提前解码 ============
+
+// 短于该时长的尾段视为静音，不再解码
+const MIN_TAIL_MS = 100
+
+function handleStreamStart(message) {
+  const sampleRate = message.sampleRate || 16000
+  streamSessions.set(message.id, {
+    sampleRate,
+    channels: message.channels || 1,
+    // 结束时将最后一个分段与尾段合并重解码，避免分段边界处丢字
+    redecodeBoundary: Boolean(message.redecodeBoundary),
+    samples: new Float32Array(sampleRate * 30),
+    length: 0,
+    segmenter: new VadSegmenter(sampleRate),
+    // 已关闭、等待解码的分段
+    queue: [],
+    // 已解码分段的缓存结果，按时间顺序：{ start, end, text, language }
+    segments: [],
+    decodeScheduled: false,
+  })
+  console.log('[Worker] 流式会话开始:', message.id)
+}
+
+function appendSessionSamples(session, samples) {
+  if (session.length + samples.length > session.samples.length) {
+    const grown = new Float32Array(Math.max(session.samples.length * 2, session.length + samples.length))
+    grown.set(session.samples.subarray(0, session.length))
+    session.samples = grown
+  }
+  session.samples.set(samples, session.length)
+  session.length += samples.length
+}
+
+function handleStreamChunk(message) {
+  const session = streamSessions.get(message.id)
+  if (!session) return
+  const { samples } = pcm16ToWave({
+    sampleRate: session.sampleRate,
+    channels: session.channels,
+    bitsPerSample: 16,
+    data: message.pcm,
+  })
+  appendSessionSamples(session, samples)
+  const closed = session.segmenter.push(samples)
+  if (closed.length > 0) {
+    session.queue.push(...closed)
+    scheduleSegmentDecode(message.id)
+  }
+}
+
+/**
+ * 以实时优先级逐段解码，每步只处理一段，让新到达的音频块得以及时入队
+ */
+function scheduleSegmentDecode(id) {
+  const session = streamSessions.get(id)
+  if (!session || session.decodeScheduled) return
+  session.decodeScheduled = true
+  scheduler.enqueue('live', `${id}:segments`, decodeSessionSegments(id, session))
+}
+
+function* decodeSessionSegments(id, session) {
+  try {
+    while (session.queue.length > 0 && streamSessions.get(id) === session && recognizer) {
+      decodeNextSegment(session)
+      yield
+    }
   } finally {
-    // 安全地释放 stream
-    if (stream && activeStreams.has(stream)) {
-      const streamRef = stream  // 保存引用，避免后续设为 null 导致删除失败
-      activeStreams.delete(streamRef)
+    session.decodeScheduled = false
+  }
+}
+
+function decodeRange(session, start, end) {
+  const result = decodeSamples(session.sampleRate, session.samples.slice(start, end))
+  return {
+    start,
+    end,
+    text: result.text ?? '',
+    language: result.language || '',
+    tokens: collectTokens(result, (start / session.sampleRate) * 1000, []),
+  }
+}
+
+function decodeNextSegment(session) {
+  const segment = session.queue.shift()
+  if (!segment) return
+  const startedAt = Date.now()
+  session.segments.push(decodeRange(session, segment.start, segment.end))
+  console.log('[Worker] 分段解码完成:', {
+    startSec: (segment.start / session.sampleRate).toFixed(2),
+    endSec: (segment.end / session.sampleRate).toFixed(2),
+    decodeMs: Date.now() - startedAt,
+  })
+}
+
+function handleStreamFinish(message) {
+  const session = streamSessions.get(message.id)
+  streamSessions.delete(message.id)
+  if (!session) {
+    send({ type: 'transcribe-error', id: message.id, error: '流式会话不存在' })
+    return
+  }
+  if (!recognizer) {
+    send({ type: 'transcribe-error', id: message.id, error: '识别器尚未初始化' })
+    return
+  }
+
+  // 会话已结束，尚未开始的分段任务由 finish 一并处理
+  scheduler.cancelPending((label) => label === `${message.id}:segments`)
+  scheduler.enqueue('live', message.id, singleStep(() => finishStreamSession(message, session)))
+}
+
+function finishStreamSession(message, session) {
+  try {
+    const finishStartedAt = Date.now()
+    // 录音期间已解码的分段直接复用缓存结果
+    const cachedSegments = session.segments.length
+    // 先补齐录音期间尚未来得及解码的分段
+    while (session.queue.length > 0) {
+      decodeNextSegment(session)
+    }
+
+    const tailStart = session.segmenter.openSegmentStart
+    const tailMs = ((session.length - tailStart) / session.sampleRate) * 1000
+    // 尾段没有任何语音帧时无需解码
+    const tailHasSpeech = tailMs >= MIN_TAIL_MS && session.segmenter.openSegmentHasSpeech
+    const segments = session.segments
+    let redecoded = false
+
+    if (session.redecodeBoundary && segments.length > 0 && tailHasSpeech) {
+      // 最后一个分段与尾段合并解码，替换缓存中的最后一段
+      const last = segments[segments.length - 1]
+      segments[segments.length - 1] = decodeRange(session, last.start, session.length)
+      redecoded = true
+    } else if (tailHasSpeech) {
+      segments.push(decodeRange(session, tailStart, session.length))
+    }
+
+    const text = joinSegmentTexts(segments.map((segment) => segment.text))
+    const detectedLanguage = segments.reduce((lang, segment) => segment.language || lang, '')
+    const durationMs = Math.round((session.length / session.sampleRate) * 1000)
+    console.log('[Worker] 流式转录完成:', {
+      id: message.id,
+      segments: segments.length,
+      cachedSegments,
+      redecoded,
+      tailMs: Math.round(tailMs),
+      finishMs: Date.now() - finishStartedAt,
+      durationMs,
+      textLength: text.length,
+    })
+    send({
+      type: 'transcribe-success',
+      id: message.id,
+      text,
+      durationMs,
+      language: detectedLanguage || language,
+      tokens: segments.flatMap((segment) => segment.tokens),
+    })
+  } catch (error) {
+    console.error('[Worker] 流式转录失败:', error)
+    send({
+      type: 'transcribe-error',
+      id: message.id,
+      error: error instanceof Error ? error.message : String(error),
+    })
+  }
+}
+
+// ============ 自动调优：测量不同模型与线程数的加载耗时和实时率 ============
+
+/**
+ * 用独立的识别器解码一次，返回耗时与文本
+ */
+function benchmarkDecode(candidateRecognizer, waveData) {
+  const stream = candidateRecognizer.createStream()
+  try {
+    stream.acceptWaveform({ sampleRate: waveData.sampleRate, samples: waveData.samples })
+    const startedAt = process.hrtime.bigint()
+    candidateRecognizer.decode(stream)
+    const decodeMs = Number(process.hrtime.bigint() - startedAt) / 1e6
+    return { decodeMs, text: candidateRecognizer.getResult(stream).text ?? '' }
+  } finally {
+    if (typeof stream.free === 'function') stream.free()
+  }
+}
+
+function handleBenchmark(message) {
+  scheduler.enqueue(resolvePriority(message, 'background'), message.id, benchmarkJob(message))
+}
+
+/**
+ * 依次测量每个候选配置：创建识别器计时、预热解码一次、再计时解码若干次取中位数
+ * 每个候选之间让出，不影响同一 worker 内的实时请求
+ */
+function* benchmarkJob(message) {
+  const { id, payload } = message
+  const results = []
+  try {
+    const waveData = readWaveFile(payload.audioPath)
+    const audioMs = (waveData.samples.length / waveData.sampleRate) * 1000
+    const runs = Math.max(1, payload.runs || 1)
+
+    for (const [index, candidate] of payload.candidates.entries()) {
+      yield
+      const result = { variant: candidate.variant, numThreads: candidate.numThreads }
       try {
-        console.log('[Worker] 开始释放 stream 对象')
-        if (typeof streamRef === 'object' && streamRef !== null) {
-          if (typeof streamRef.free === 'function') {
-            console.log('[Worker] 调用 stream.free()')
-            streamRef.free()
-          } else if (typeof streamRef.release === 'function') {
-            console.log('[Worker] 调用 stream.release()')
-            streamRef.release()
-          } else if (typeof streamRef.delete === 'function') {
-            console.log('[Worker] 调用 stream.delete()')
-            streamRef.delete()
-          } else {
-            console.log('[Worker] stream 对象无释放方法，依赖 GC 回收')
-          }
+        const loadStartedAt = Date.now()
+        const candidateRecognizer = new sherpa.OfflineRecognizer(
+          buildRecognizerConfig(payload, candidate.modelPath, candidate.numThreads)
+        )
+        result.loadMs = Date.now() - loadStartedAt
+
+        // 首次解码包含内存分配等一次性开销，不计入
+        benchmarkDecode(candidateRecognizer, waveData)
+        const timings = []
+        let text = ''
+        for (let run = 0; run < runs; run++) {
+          const decoded = benchmarkDecode(candidateRecognizer, waveData)
+          timings.push(decoded.decodeMs)
+          text = decoded.text
         }
-        console.log('[Worker] Stream 释放完成')
-      } catch (releaseError) {
-        console.error('[Worker] 释放 stream 时出错:', releaseError)
+        timings.sort((a, b) => a - b)
+        result.decodeMs = Math.round(timings[Math.floor(timings.length / 2)] * 10) / 10
+        result.rtf = Math.round((result.decodeMs / audioMs) * 10000) / 10000
+        result.text = text
+      } catch (error) {
+        result.error = error instanceof Error ? error.message : String(error)
       }
+      // 识别器只能依赖 GC 释放，及时回收以免多个模型副本同时驻留
+      if (typeof global.gc === 'function') global.gc()
+      console.log('[Worker] 调优候选结果:', JSON.stringify(result))
+      results.push(result)
+      send({ type: 'benchmark-progress', id, completed: index + 1, total: payload.candidates.length })
     }
+    send({ type: 'benchmark-success', id, audioMs: Math.round(audioMs), results })
+  } catch (error) {
+    console.error('[Worker] 自动调优失败:', error)
+    send({
+      type: 'transcribe-error',
+      id,
+      error: error instanceof Error ? error.message : String(error),
+    })
   }
 }
 
-process.on('message', (message) => {
-  if (!message || typeof message !== 'object') return
+/**
+ * 上报 worker 内存占用，供主进程判断是否需要卸载模型
+ */
+function handleStats(message) {
+  send({
+    type: 'stats-result',
+    id: message.id,
+    rss: process.memoryUsage().rss,
+    queue: scheduler.getStats(),
+  })
+}
+
+/**
+ * 取消请求：流式会话直接丢弃，排队中的任务出队，进行中的任务在当前分段结束后终止
+ */
+function handleCancel(message) {
+  const isSession = streamSessions.delete(message.id) || pcmChunks.delete(message.id)
+  const cancelled = scheduler.cancel((label) => label === message.id || label === `${message.id}:segments`)
+  if (isSession || cancelled > 0) {
+    console.log('[Worker] 请求已取消:', { id: message.id, jobs: cancelled })
+  }
+}
+
+/**
+ * 调整请求的优先级（例如后台文件转写转为用户正在等待的前台任务）
+ */
+function handleSetPriority(message) {
+  if (!message.priority) return
+  scheduler.setPriority((label) => label === message.id || label === `${message.id}:segments`, message.priority)
+}
+
+function handleMessage(message) {
   if (message.type === 'init') {
     handleInit(message.payload)
     return
   }
   if (message.type === 'transcribe') {
     handleTranscribe(message)
+    return
   }
-})
+  if (message.type === 'transcribe-long') {
+    handleTranscribeLong(message)
+    return
+  }
+  if (message.type === 'pcm-chunk') {
+    handlePcmChunk(message)
+    return
+  }
+  if (message.type === 'transcribe-pcm') {
+    handleTranscribePcm(message)
+    return
+  }
+  if (message.type === 'transcribe-batch') {
+    handleTranscribeBatch(message)
+    return
+  }
+  if (message.type === 'stream-start') {
+    handleStreamStart(message)
+    return
+  }
+  if (message.type === 'stream-chunk') {
+    handleStreamChunk(message)
+    return
+  }
+  if (message.type === 'stream-finish') {
+    handleStreamFinish(message)
+    return
+  }
+  if (message.type === 'cancel') {
+    handleCancel(message)
+    return
+  }
+  if (message.type === 'set-priority') {
+    handleSetPriority(message)
+    return
+  }
+  if (message.type === 'benchmark') {
+    handleBenchmark(message)
+    return
+  }
+  if (message.type === 'stats') {
+    handleStats(message)
+  }
+}
 
 // 进程退出时清理所有资源
 process.on('exit', (code) => {
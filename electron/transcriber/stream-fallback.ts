@@ -0,0 +1,11 @@
+/**
+ * 流式转写失败、但录音仍可整段重新转写时抛出
+ * 例如服务端不接受分块请求体、请求未得到任何响应，或离线识别会话中断；
+ * 超时、鉴权、限流等错误整段重试也会失败，不使用此类型
+ */
+export class StreamFallbackError extends Error {
+  constructor(message: string) {
+    super(message)
+    this.name = 'StreamFallbackError'
+  }
+}
@@ -0,0 +1,386 @@
+/**
+ * 在线转写上传前的音频处理
+ * 按需裁掉首尾静音，编码为 FLAC（原生模块不可用时为单声道 WAV），
+ * 按窗口读取并逐块产出字节，不在内存中同时持有原始与编码后的整段音频
+ */
+
+import { createReadStream } from 'node:fs'
+import fs, { type FileHandle } from 'node:fs/promises'
+import path from 'node:path'
+import type { UploadAudioFormat } from '../../shared/app-state'
+import { readWavHeader, type WavInfo } from '../utils/wav-parser'
+import { loadAudioDsp, type AudioDspModule } from './audio-dsp-native'
+
+/** 每次读取的音频时长 */
+const READ_WINDOW_MS = 1000
+/** 静音检测的帧长 */
+const TRIM_FRAME_MS = 30
+/** 语音判定的最低 RMS，与 VadSegmenter 默认阈值一致 */
+const TRIM_ENERGY_THRESHOLD = 0.004
+/** 裁剪后两端保留的静音，避免截断首尾音节 */
+const TRIM_PADDING_MS = 200
+/** 边录边传时最多暂存的句间静音 */
+const STREAM_HOLD_MS = 2000
+
+export interface UploadAudioOptions {
+  format: UploadAudioFormat
+  trimSilence: boolean
+}
+
+export interface UploadAudio {
+  fileName: string
+  mimeType: string
+  /** 实际上传的格式，original 表示原文件直接上传 */
+  format: UploadAudioFormat | 'original'
+  sourceBytes: number
+  /** 裁掉的静音时长 */
+  trimmedMs: number
+  chunks: AsyncIterable<Uint8Array>
+}
+
+interface PcmLayout {
+  info: WavInfo
+  totalFrames: number
+}
+
+/**
+ * 生成上传用的音频流
+ * 非 16-bit PCM 的文件无法裁剪与编码，原样上传
+ */
+export async function prepareUploadAudio(filePath: string, options: UploadAudioOptions): Promise<UploadAudio> {
+  const sourceBytes = (await fs.stat(filePath)).size
+  const baseName = path.basename(filePath, path.extname(filePath))
+
+  let layout: PcmLayout | null = null
+  try {
+    const info = await readWavHeader(filePath)
+    if (info.bitsPerSample === 16 && info.channels > 0) {
+      const dataBytes = Math.min(info.dataLength, sourceBytes - info.dataOffset)
+      layout = { info, totalFrames: Math.floor(dataBytes / (2 * info.channels)) }
+    }
+  } catch {
+    // 无法解析的文件交给服务端处理
+  }
+
+  const dsp = loadAudioDsp()
+  const format: UploadAudioFormat = options.format === 'flac' && dsp ? 'flac' : 'wav'
+  const needsProcessing = layout && (format === 'flac' || options.trimSilence || layout.info.channels !== 1)
+  if (!layout || !needsProcessing) {
+    return {
+      fileName: path.basename(filePath),
+      mimeType: 'audio/wav',
+      format: 'original',
+      sourceBytes,
+      trimmedMs: 0,
+      chunks: createReadStream(filePath),
+    }
+  }
+
+  const { info, totalFrames } = layout
+  const bounds = options.trimSilence
+    ? await findSpeechBounds(filePath, layout, dsp)
+    : { start: 0, end: totalFrames }
+  const trimmedMs = Math.round(((totalFrames - (bounds.end - bounds.start)) * 1000) / info.sampleRate)
+
+  return {
+    fileName: `${baseName}.${format}`,
+    mimeType: format === 'flac' ? 'audio/flac' : 'audio/wav',
+    format,
+    sourceBytes,
+    trimmedMs,
+    chunks: encodeRange(filePath, layout, bounds, format === 'flac' ? dsp : null),
+  }
+}
+
+/**
+ * 读取 [startFrame, startFrame + frames) 并混合为单声道 16-bit
+ */
+async function readMonoWindow(
+  handle: FileHandle,
+  layout: PcmLayout,
+  startFrame: number,
+  frames: number,
+  scratch: Buffer
+): Promise<Int16Array> {
+  const { channels, dataOffset } = layout.info
+  const byteLength = frames * channels * 2
+  const { bytesRead } = await handle.read(scratch, 0, byteLength, dataOffset + startFrame * channels * 2)
+  const framesRead = Math.floor(bytesRead / (channels * 2))
+  // scratch 由 Buffer.alloc 分配，不在共享池中，起始地址满足 2 字节对齐
+  const interleaved = new Int16Array(scratch.buffer, scratch.byteOffset, framesRead * channels)
+  return downmixToMono(interleaved, channels)
+}
+
+/**
+ * 交错多声道 16-bit 混合为单声道，返回新数组（不引用输入）
+ */
+export function downmixToMono(interleaved: Int16Array, channels: number): Int16Array {
+  if (channels === 1) {
+    return interleaved.slice()
+  }
+  const frames = Math.floor(interleaved.length / channels)
+  const mono = new Int16Array(frames)
+  for (let i = 0; i < frames; i++) {
+    let sum = 0
+    for (let ch = 0; ch < channels; ch++) {
+      sum += interleaved[i * channels + ch]
+    }
+    mono[i] = Math.trunc(sum / channels)
+  }
+  return mono
+}
+
+function frameRms(samples: Int16Array, frameSize: number, dsp: AudioDspModule | null): Float32Array {
+  if (dsp) {
+    return dsp.frameEnergy(dsp.int16ToFloat(samples, 1), frameSize)
+  }
+  const frameCount = Math.floor(samples.length / frameSize)
+  const energies = new Float32Array(frameCount)
+  for (let frame = 0; frame < frameCount; frame++) {
+    let sum = 0
+    for (let i = frame * frameSize; i < (frame + 1) * frameSize; i++) {
+      const sample = samples[i] / 0x8000
+      sum += sample * sample
+    }
+    energies[frame] = Math.sqrt(sum / frameSize)
+  }
+  return energies
+}
+
+/**
+ * 扫描整段音频，找出首个与最后一个语音帧，两端加上 padding
+ * 没有检测到语音时保留全部内容，交给服务端判断
+ */
+async function findSpeechBounds(
+  filePath: string,
+  layout: PcmLayout,
+  dsp: AudioDspModule | null
+): Promise<{ start: number; end: number }> {
+  const { sampleRate, channels } = layout.info
+  const { totalFrames } = layout
+  const frameSize = Math.max(1, Math.round((sampleRate * TRIM_FRAME_MS) / 1000))
+  const windowFrames = frameSize * Math.max(1, Math.round((sampleRate * READ_WINDOW_MS) / 1000 / frameSize))
+  const padding = Math.round((sampleRate * TRIM_PADDING_MS) / 1000)
+  const scratch = Buffer.alloc(windowFrames * channels * 2)
+
+  let firstSpeech = -1
+  let lastSpeechEnd = -1
+  const handle = await fs.open(filePath, 'r')
+  try {
+    for (let start = 0; start < totalFrames; start += windowFrames) {
+      const mono = await readMonoWindow(handle, layout, start, Math.min(windowFrames, totalFrames - start), scratch)
+      const energies = frameRms(mono, frameSize, dsp)
+      for (let frame = 0; frame < energies.length; frame++) {
+        if (energies[frame] > TRIM_ENERGY_THRESHOLD) {
+          const frameStart = start + frame * frameSize
+          if (firstSpeech < 0) firstSpeech = frameStart
+          lastSpeechEnd = frameStart + frameSize
+        }
+      }
+    }
+  } finally {
+    await handle.close()
+  }
+
+  if (firstSpeech < 0) {
+    return { start: 0, end: totalFrames }
+  }
+  return {
+    start: Math.max(0, firstSpeech - padding),
+    end: Math.min(totalFrames, lastSpeechEnd + padding),
+  }
+}
+
+/**
+ * 单声道 16-bit WAV 文件头
+ */
+function createWavHeader(sampleRate: number, dataBytes: number): Buffer {
+  const header = Buffer.alloc(44)
+  header.write('RIFF', 0, 'ascii')
+  header.writeUInt32LE(36 + dataBytes, 4)
+  header.write('WAVE', 8, 'ascii')
+  header.write('fmt ', 12, 'ascii')
+  header.writeUInt32LE(16, 16)
+  header.writeUInt16LE(1, 20) // PCM
+  header.writeUInt16LE(1, 22) // 单声道
+  header.writeUInt32LE(sampleRate, 24)
+  header.writeUInt32LE(sampleRate * 2, 28)
+  header.writeUInt16LE(2, 32)
+  header.writeUInt16LE(16, 34)
+  header.write('data', 36, 'ascii')
+  header.writeUInt32LE(dataBytes, 40)
+  return header
+}
+
+/**
+ * 逐窗口读取并编码 [start, end)；dsp 为空时输出单声道 WAV
+ */
+async function* encodeRange(
+  filePath: string,
+  layout: PcmLayout,
+  bounds: { start: number; end: number },
+  dsp: AudioDspModule | null
+): AsyncGenerator<Uint8Array> {
+  const { sampleRate, channels } = layout.info
+  const windowFrames = Math.max(1, Math.round((sampleRate * READ_WINDOW_MS) / 1000))
+  const scratch = Buffer.alloc(windowFrames * channels * 2)
+  const encoder = dsp ? new dsp.FlacEncoder(sampleRate) : null
+
+  if (!encoder) {
+    yield createWavHeader(sampleRate, (bounds.end - bounds.start) * 2)
+  }
+
+  const handle = await fs.open(filePath, 'r')
+  try {
+    for (let start = bounds.start; start < bounds.end; start += windowFrames) {
+      const mono = await readMonoWindow(handle, layout, start, Math.min(windowFrames, bounds.end - start), scratch)
+      if (mono.length === 0) break
+      if (encoder) {
+        const bytes = encoder.encode(mono)
+        if (bytes.length > 0) yield bytes
+      } else {
+        yield new Uint8Array(mono.buffer, mono.byteOffset, mono.byteLength)
+      }
+    }
+    if (encoder) {
+      yield encoder.finish()
+    }
+  } finally {
+    await handle.close()
+  }
+}
+
+function concatInt16(parts: Int16Array[], total: number): Int16Array {
+  if (parts.length === 1) return parts[0]
+  const out = new Int16Array(total)
+  let offset = 0
+  for (const part of parts) {
+    out.set(part, offset)
+    offset += part.length
+  }
+  return out
+}
+
+/**
+ * 录音过程中增量裁剪静音（单声道 16-bit）
+ * 首个语音帧之前只保留 padding 长度的静音；语音之间的静音先暂存，
+ * 再次出现语音时整体放行，结束时只保留 padding 长度，效果与整段裁剪一致，
+ * 只是静音部分会延迟到确定不是结尾时才发送；超过 STREAM_HOLD_MS 的长停顿会提前发送
+ */
+export class SilenceGate {
+  private readonly frameSize: number
+  private readonly padding: number
+  private readonly holdLimit: number
+  private started = false
+  private remainder = new Int16Array(0)
+  private preRoll: Int16Array[] = []
+  private preRollLength = 0
+  private held: Int16Array[] = []
+  private heldLength = 0
+  private droppedSamples = 0
+
+  constructor(
+    private readonly sampleRate: number,
+    private readonly dsp: AudioDspModule | null
+  ) {
+    this.frameSize = Math.max(1, Math.round((sampleRate * TRIM_FRAME_MS) / 1000))
+    this.padding = Math.round((sampleRate * TRIM_PADDING_MS) / 1000)
+    this.holdLimit = Math.max(this.padding, Math.round((sampleRate * STREAM_HOLD_MS) / 1000))
+  }
+
+  /** 已裁掉的静音时长（毫秒） */
+  get trimmedMs(): number {
+    return Math.round((this.droppedSamples * 1000) / this.sampleRate)
+  }
+
+  /**
+   * 输入样本，返回可以立即发送的部分
+   * 暂存的静音直接引用 samples，调用方不能复用传入的数组
+   */
+  push(samples: Int16Array): Int16Array {
+    let input = samples
+    if (this.remainder.length > 0) {
+      input = concatInt16([this.remainder, samples], this.remainder.length + samples.length)
+    }
+    const energies = frameRms(input, this.frameSize, this.dsp)
+    const output: Int16Array[] = []
+    let outputLength = 0
+
+    for (let frame = 0; frame < energies.length; frame++) {
+      const samplesOfFrame = input.subarray(frame * this.frameSize, (frame + 1) * this.frameSize)
+      const isSpeech = energies[frame] > TRIM_ENERGY_THRESHOLD
+      if (!this.started) {
+        if (isSpeech) {
+          this.started = true
+          for (const part of this.takeTail(this.preRoll, this.preRollLength, this.padding)) {
+            output.push(part)
+            outputLength += part.length
+          }
+          this.preRoll = []
+          this.preRollLength = 0
+          output.push(samplesOfFrame)
+          outputLength += samplesOfFrame.length
+        } else {
+          this.preRoll.push(samplesOfFrame)
+          this.preRollLength += samplesOfFrame.length
+          // 只需保留最近 padding 长度的前导静音
+          while (this.preRoll.length > 1 && this.preRollLength - this.preRoll[0].length >= this.padding) {
+            this.droppedSamples += this.preRoll[0].length
+            this.preRollLength -= this.preRoll.shift()!.length
+          }
+        }
+      } else if (isSpeech) {
+        for (const part of this.held) {
+          output.push(part)
+          outputLength += part.length
+        }
+        this.held = []
+        this.heldLength = 0
+        output.push(samplesOfFrame)
+        outputLength += samplesOfFrame.length
+      } else {
+        this.held.push(samplesOfFrame)
+        this.heldLength += samplesOfFrame.length
+        // 停顿过长时先发送较早的部分，避免积压到松开按键后才上传
+        while (this.held.length > 1 && this.heldLength - this.held[0].length >= this.holdLimit) {
+          const part = this.held.shift()!
+          this.heldLength -= part.length
+          output.push(part)
+          outputLength += part.length
+        }
+      }
+    }
+
+    this.remainder = input.subarray(energies.length * this.frameSize)
+    return output.length === 1 ? output[0].slice() : concatInt16(output, outputLength)
+  }
+
+  /**
+   * 结束输入，返回尾部保留的 padding
+   * 整段都没有检测到语音时返回保留的前导部分，交给服务端判断
+   */
+  finish(): Int16Array {
+    const pending = this.started ? this.held : this.preRoll
+    const pendingLength = this.started ? this.heldLength : this.preRollLength
+    const all = concatInt16([...pending, this.remainder], pendingLength + this.remainder.length)
+    const keep = this.started ? Math.min(all.length, this.padding) : all.length
+    this.droppedSamples += all.length - keep
+    this.held = []
+    this.heldLength = 0
+    this.preRoll = []
+    this.preRollLength = 0
+    this.remainder = new Int16Array(0)
+    return all.subarray(0, keep)
+  }
+
+  /**
+   * 取 parts 末尾 length 个样本，其余计入已裁剪
+   */
+  private takeTail(parts: Int16Array[], total: number, length: number): Int16Array[] {
+    const drop = Math.max(0, total - length)
+    this.droppedSamples += drop
+    if (drop === 0) return parts
+    const merged = concatInt16(parts, total)
+    return [merged.subarray(drop)]
+  }
+}
@@ -0,0 +1,162 @@
+// 基于能量的轻量 VAD 分段器
+// 录音过程中按帧计算能量，检测到足够长的静音后关闭当前语音段，
+// 供 worker 在用户说话期间提前解码已完成的片段。
+
+const { frameEnergy } = require('./audio-dsp.cjs')
+
+const DEFAULT_OPTIONS = {
+  frameMs: 30,             // 帧长（毫秒）
+  minSilenceMs: 600,       // 静音持续多久视为分段点
+  minSpeechMs: 300,        // 语音段最短长度，过短的段并入下一段
+  maxSegmentMs: 20000,     // 语音段最长长度，超出后在最安静的帧处强制切分
+  energyThreshold: 0.004,  // 最低 RMS 阈值
+  noiseRatio: 3,           // 语音判定：能量 > 噪声底 × 该倍数
+  paddingMs: 200,          // 段两端保留的静音，避免截断首尾音节
+}
+
+class VadSegmenter {
+  /**
+   * @param {number} sampleRate 输入采样率
+   * @param {Partial<typeof DEFAULT_OPTIONS>} [options]
+   */
+  constructor(sampleRate, options = {}) {
+    this.sampleRate = sampleRate
+    this.options = { ...DEFAULT_OPTIONS, ...options }
+    this.frameSize = Math.max(1, Math.round((sampleRate * this.options.frameMs) / 1000))
+    this.noiseFloor = this.options.energyThreshold
+    this.totalSamples = 0
+    // 当前未关闭段的起点（样本下标）
+    this.segmentStart = 0
+    this.inSpeech = false
+    this.speechFrames = 0
+    this.silenceFrames = 0
+    this.lastSpeechEnd = 0
+    // 当前段内的帧能量，用于强制切分时寻找最安静的位置
+    this.frameEnergies = []
+    this.pending = new Float32Array(0)
+  }
+
+  /**
+   * 输入新的样本，返回本次新关闭的语音段
+   * @param {Float32Array} samples
+   * @returns {Array<{ start: number, end: number }>}
+   */
+  push(samples) {
+    const closed = []
+    let buffer = samples
+    if (this.pending.length > 0) {
+      buffer = new Float32Array(this.pending.length + samples.length)
+      buffer.set(this.pending, 0)
+      buffer.set(samples, this.pending.length)
+    }
+
+    const { frameMs, minSilenceMs, minSpeechMs, maxSegmentMs, energyThreshold, noiseRatio, paddingMs } = this.options
+    const silenceLimit = Math.ceil(minSilenceMs / frameMs)
+    const minSpeechFrames = Math.ceil(minSpeechMs / frameMs)
+    const maxSegmentSamples = Math.round((this.sampleRate * maxSegmentMs) / 1000)
+    const padding = Math.round((this.sampleRate * paddingMs) / 1000)
+
+    // 先一次算出所有完整帧的能量，再逐帧更新状态
+    const energies = frameEnergy(buffer, this.frameSize)
+    let offset = 0
+    for (let frame = 0; frame < energies.length; frame++) {
+      const energy = energies[frame]
+      const frameEnd = this.totalSamples + this.frameSize
+      this.frameEnergies.push(energy)
+
+      const isSpeech = energy > Math.max(energyThreshold, this.noiseFloor * noiseRatio)
+      if (!isSpeech) {
+        // 噪声底只在非语音帧上缓慢跟踪
+        this.noiseFloor = this.noiseFloor * 0.95 + energy * 0.05
+      }
+
+      if (isSpeech) {
+        this.inSpeech = true
+        this.speechFrames++
+        this.silenceFrames = 0
+        this.lastSpeechEnd = frameEnd
+      } else if (this.inSpeech) {
+        this.silenceFrames++
+        if (this.silenceFrames >= silenceLimit && this.speechFrames >= minSpeechFrames) {
+          const end = Math.min(this.lastSpeechEnd + padding, frameEnd)
+          closed.push({ start: this.segmentStart, end })
+          this.resetSegment(end)
+        }
+      }
+
+      if (frameEnd - this.segmentStart >= maxSegmentSamples) {
+        if (this.speechFrames === 0) {
+          // 整段都是静音：直接丢弃，不产生解码任务
+          this.resetSegment(Math.max(this.segmentStart, frameEnd - padding))
+        } else {
+          const end = this.quietestBoundary()
+          closed.push({ start: this.segmentStart, end })
+          this.resetSegment(end)
+        }
+      }
+
+      this.totalSamples = frameEnd
+      offset += this.frameSize
+    }
+
+    this.pending = buffer.slice(offset)
+    return closed
+  }
+
+  /**
+   * 当前尚未关闭的尾段起点
+   */
+  get openSegmentStart() {
+    return this.segmentStart
+  }
+
+  /**
+   * 尾段中是否已检测到语音帧
+   */
+  get openSegmentHasSpeech() {
+    return this.speechFrames > 0
+  }
+
+  resetSegment(start) {
+    // 被切分位置之后的帧能量需要保留给下一段
+    const keepFrames = Math.max(0, Math.round((this.totalSamples + this.frameSize - start) / this.frameSize))
+    this.frameEnergies = keepFrames > 0 ? this.frameEnergies.slice(-keepFrames) : []
+    this.segmentStart = start
+    this.inSpeech = false
+    this.speechFrames = 0
+    this.silenceFrames = 0
+  }
+
+  quietestBoundary() {
+    // 只在段的后半部分寻找，避免切出过短的段
+    const half = Math.floor(this.frameEnergies.length / 2)
+    let minIndex = this.frameEnergies.length - 1
+    let minEnergy = Infinity
+    for (let i = half; i < this.frameEnergies.length; i++) {
+      if (this.frameEnergies[i] < minEnergy) {
+        minEnergy = this.frameEnergies[i]
+        minIndex = i
+      }
+    }
+    return this.segmentStart + (minIndex + 1) * this.frameSize
+  }
+}
+
+/**
+ * 合并分段转写文本：拉丁字母/数字之间补空格，CJK 直接拼接
+ * @param {string[]} texts
+ */
+function joinSegmentTexts(texts) {
+  let merged = ''
+  for (const raw of texts) {
+    const text = (raw || '').trim()
+    if (!text) continue
+    if (merged && /[A-Za-z0-9,.!?;:]$/.test(merged) && /^[A-Za-z0-9]/.test(text)) {
+      merged += ' '
+    }
+    merged += text
+  }
+  return merged
+}
+
+module.exports = { VadSegmenter, joinSegmentTexts, DEFAULT_VAD_OPTIONS: DEFAULT_OPTIONS }
@@ -0,0 +1,190 @@
+// WAV 解析：识别 worker 与离线基准测试脚本共用
+const fs = require('fs')
+const { int16ToFloat, resampleLinear } = require('./audio-dsp.cjs')
+
+/**
+ * Buffer 中一段 16-bit PCM 的 Int16Array 视图
+ * Int16Array 要求 2 字节对齐，未对齐时先复制一份
+ */
+function int16View(buffer, byteOffset, byteLength) {
+  const start = buffer.byteOffset + byteOffset
+  const length = Math.floor(byteLength / 2)
+  if (start % 2 === 0) {
+    return new Int16Array(buffer.buffer, start, length)
+  }
+  const copy = new Uint8Array(length * 2)
+  copy.set(buffer.subarray(byteOffset, byteOffset + length * 2))
+  return new Int16Array(copy.buffer, 0, length)
+}
+
+/**
+ * 解析 WAV 文件为单声道 Float32 波形
+ */
+function readWaveFile(audioPath) {
+  const audioBuffer = fs.readFileSync(audioPath)
+
+  // 解析 WAV 头部 (44 bytes)
+  if (audioBuffer.length < 44) {
+    throw new Error('WAV文件太小')
+  }
+
+  // 检查 RIFF 头
+  const riff = audioBuffer.readUInt32LE(0)
+  if (riff !== 0x46464952) {
+    throw new Error('不是有效的 RIFF 文件')
+  }
+
+  // 检查 WAVE 标识
+  const wave = audioBuffer.readUInt32LE(8)
+  if (wave !== 0x45564157) {
+    throw new Error('不是有效的 WAVE 文件')
+  }
+
+  // 查找 fmt chunk
+  let offset = 12
+  let sampleRate = 0
+  let bitsPerSample = 0
+  let numChannels = 0
+  let dataOffset = 0
+  let dataSize = 0
+
+  while (offset < audioBuffer.length) {
+    const chunkId = audioBuffer.readUInt32LE(offset)
+    const chunkSize = audioBuffer.readUInt32LE(offset + 4)
+
+    if (chunkId === 0x20746d66) { // 'fmt '
+      numChannels = audioBuffer.readUInt16LE(offset + 10)  // 偏移量10-11: 通道数
+      sampleRate = audioBuffer.readUInt32LE(offset + 12)  // 偏移量12-15: 采样率
+      bitsPerSample = audioBuffer.readUInt16LE(offset + 22) // 偏移量22-23: 位深度
+    } else if (chunkId === 0x61746164) { // 'data'
+      dataOffset = offset + 8
+      dataSize = chunkSize
+      break
+    }
+
+    offset += 8 + chunkSize + (chunkSize % 2)
+  }
+
+  if (!sampleRate || !dataOffset) {
+    throw new Error('WAV文件格式错误')
+  }
+
+  // 提取音频数据
+  if (bitsPerSample === 16) {
+    const byteLength = Math.min(dataSize, audioBuffer.length - dataOffset)
+    return { sampleRate, samples: int16ToFloat(int16View(audioBuffer, dataOffset, byteLength), numChannels) }
+  }
+  const totalSamples = dataSize / (bitsPerSample / 8)
+  const samplesPerChannel = totalSamples / numChannels
+  const samples = new Float32Array(samplesPerChannel)
+
+  for (let i = 0; i < samplesPerChannel; i++) {
+    let sample = 0
+    // 混合多通道为单声道
+    for (let ch = 0; ch < numChannels; ch++) {
+      if (bitsPerSample === 8) {
+        const uint8 = audioBuffer.readUInt8(dataOffset + i * numChannels + ch)
+        sample += (uint8 - 128) / 128 // 转换为[-1, 1]范围
+      } else {
+        throw new Error(`不支持的位深度: ${bitsPerSample}`)
+      }
+    }
+    samples[i] = sample / numChannels // 平均值
+  }
+
+  return { sampleRate, samples }
+}
+
+/**
+ * 按需读取 WAV 的单声道波形，内存占用只与单次读取的帧数有关
+ * 用于长音频分窗转写，不会一次性载入整个文件
+ */
+function openWaveReader(audioPath) {
+  const fd = fs.openSync(audioPath, 'r')
+  try {
+    const fileSize = fs.fstatSync(fd).size
+    const header = Buffer.alloc(16)
+    if (fs.readSync(fd, header, 0, 12, 0) < 12) {
+      throw new Error('WAV文件太小')
+    }
+    if (header.readUInt32LE(0) !== 0x46464952) {
+      throw new Error('不是有效的 RIFF 文件')
+    }
+    if (header.readUInt32LE(8) !== 0x45564157) {
+      throw new Error('不是有效的 WAVE 文件')
+    }
+
+    let offset = 12
+    let sampleRate = 0
+    let bitsPerSample = 0
+    let numChannels = 0
+    let dataOffset = 0
+    let dataSize = 0
+    while (offset + 8 <= fileSize) {
+      fs.readSync(fd, header, 0, 8, offset)
+      const chunkId = header.readUInt32LE(0)
+      const chunkSize = header.readUInt32LE(4)
+      if (chunkId === 0x20746d66) { // 'fmt '
+        fs.readSync(fd, header, 0, 16, offset + 8)
+        numChannels = header.readUInt16LE(2)
+        sampleRate = header.readUInt32LE(4)
+        bitsPerSample = header.readUInt16LE(14)
+      } else if (chunkId === 0x61746164) { // 'data'
+        dataOffset = offset + 8
+        // 录音中断的文件 data 长度可能大于实际内容
+        dataSize = Math.min(chunkSize, fileSize - dataOffset)
+        break
+      }
+      offset += 8 + chunkSize + (chunkSize % 2)
+    }
+
+    if (!sampleRate || !dataOffset || !numChannels) {
+      throw new Error('WAV文件格式错误')
+    }
+    if (bitsPerSample !== 16 && bitsPerSample !== 8) {
+      throw new Error(`不支持的位深度: ${bitsPerSample}`)
+    }
+
+    const bytesPerFrame = (bitsPerSample / 8) * numChannels
+    const totalFrames = Math.floor(dataSize / bytesPerFrame)
+    let scratch = Buffer.alloc(0)
+
+    return {
+      sampleRate,
+      channels: numChannels,
+      totalFrames,
+      /**
+       * 读取 [startFrame, startFrame + frameCount) 并混合为单声道
+       */
+      read(startFrame, frameCount) {
+        const frames = Math.max(0, Math.min(frameCount, totalFrames - startFrame))
+        const byteLength = frames * bytesPerFrame
+        if (scratch.length < byteLength) {
+          scratch = Buffer.alloc(byteLength)
+        }
+        const bytesRead = fs.readSync(fd, scratch, 0, byteLength, dataOffset + startFrame * bytesPerFrame)
+        const framesRead = Math.floor(bytesRead / bytesPerFrame)
+        if (bitsPerSample === 16) {
+          return int16ToFloat(int16View(scratch, 0, framesRead * bytesPerFrame), numChannels)
+        }
+        const samples = new Float32Array(framesRead)
+        for (let i = 0; i < framesRead; i++) {
+          let sample = 0
+          for (let ch = 0; ch < numChannels; ch++) {
+            sample += (scratch.readUInt8(i * numChannels + ch) - 128) / 128
+          }
+          samples[i] = sample / numChannels
+        }
+        return samples
+      },
+      close() {
+        fs.closeSync(fd)
+      },
+    }
+  } catch (error) {
+    fs.closeSync(fd)
+    throw error
+  }
+}
+
+module.exports = { readWaveFile, openWaveReader, resampleLinear }
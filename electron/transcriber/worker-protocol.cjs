@@ -0,0 +1,370 @@
+// SenseVoice worker 二进制协议
+// 主进程与 worker 之间通过 fork() 额外创建的管道（子进程 fd 4）交换长度前缀帧，
+// 音频与识别结果按字段直接编码为二进制，不经过 JSON 或结构化克隆；
+// 只有初始化、批量、基准测试等低频控制消息的复杂参数以 JSON 字段携带。
+//
+// 帧格式（小端）：
+//   [0, 4)   u32 帧体长度（不含 12 字节帧头）
+//   [4]      u8  消息类型
+//   [5]      u8  优先级：0 未指定，1 live，2 background
+//   [6, 8)   u16 保留
+//   [8, 12)  u32 请求 ID，0 表示与请求无关
+//   帧体     按消息类型的字段表依次编码
+
+const HEADER_BYTES = 12
+/** 单帧上限，超过视为协议错误（约 35 分钟 16kHz 单声道 PCM，立体声约 17 分钟） */
+const MAX_BODY_BYTES = 64 * 1024 * 1024
+/** 整段 PCM 超过此大小时先以 pcm-chunk 分帧发送，最后一帧为 transcribe-pcm（4 字节对齐，不拆开采样） */
+const PCM_CHUNK_BYTES = 16 * 1024 * 1024
+/** worker 端协议管道的文件描述符（stdio 数组下标） */
+const WORKER_PIPE_FD = 4
+
+const PRIORITY_CODES = { live: 1, background: 2 }
+const PRIORITY_NAMES = [undefined, 'live', 'background']
+
+/**
+ * 消息类型与字段表
+ * 字段类型：u32、f64、str（u32 长度 + UTF-8）、json（以 str 编码）、
+ * bytes（u32 长度 + 原始字节，只能放在最后且解码为指向帧缓冲的视图）、
+ * segments（u32 数量 + [u32 start, u32 end, str text]）、tokens（u32 数量 + [u32 start, str text]）
+ */
+const MESSAGES = {
+  // 主进程 → worker
+  init: { code: 1, fields: [['payload', 'json']] },
+  transcribe: { code: 2, fields: [['audioPath', 'str']] },
+  'transcribe-long': { code: 3, fields: [['audioPath', 'str'], ['windowMs', 'u32']] },
+  'transcribe-pcm': { code: 4, fields: [['sampleRate', 'u32'], ['channels', 'u32'], ['pcm', 'bytes']] },
+  // 同一请求 ID 的 transcribe-pcm 之前的 PCM 分片，worker 按到达顺序拼接
+  'pcm-chunk': { code: 13, fields: [['pcm', 'bytes']] },
+  'transcribe-batch': { code: 5, fields: [['audioPaths', 'json']] },
+  'stream-start': { code: 6, fields: [['sampleRate', 'u32'], ['channels', 'u32'], ['redecodeBoundary', 'u32']] },
+  'stream-chunk': { code: 7, fields: [['pcm', 'bytes']] },
+  'stream-finish': { code: 8, fields: [] },
+  cancel: { code: 9, fields: [] },
+  'set-priority': { code: 10, fields: [] },
+  benchmark: { code: 11, fields: [['payload', 'json']] },
+  stats: { code: 12, fields: [] },
+  // worker → 主进程
+  ready: { code: 64, fields: [['loadMs', 'u32']] },
+  'init-error': { code: 65, fields: [['error', 'str']] },
+  'transcribe-success': {
+    code: 66,
+    fields: [['durationMs', 'u32'], ['text', 'str'], ['language', 'str'], ['tokens', 'tokens']],
+  },
+  'transcribe-partial': {
+    code: 67,
+    fields: [['processedMs', 'u32'], ['totalMs', 'u32'], ['segments', 'segments']],
+  },
+  'transcribe-error': { code: 68, fields: [['error', 'str']] },
+  'transcribe-batch-success': { code: 69, fields: [['items', 'json']] },
+  'benchmark-progress': { code: 70, fields: [['completed', 'u32'], ['total', 'u32']] },
+  'benchmark-success': { code: 71, fields: [['audioMs', 'u32'], ['results', 'json']] },
+  'stats-result': { code: 72, fields: [['rss', 'f64'], ['queue', 'json']] },
+}
+
+const TYPES_BY_CODE = new Map(Object.entries(MESSAGES).map(([type, spec]) => [spec.code, type]))
+
+function toU32(value) {
+  const number = Number(value)
+  return Number.isFinite(number) && number > 0 ? Math.min(0xffffffff, Math.round(number)) >>> 0 : 0
+}
+
+/**
+ * 计算字段（bytes 除外）的编码长度，同时缓存字符串的 UTF-8 字节
+ */
+function measureField(kind, value, strings) {
+  const encodeString = (text) => {
+    const bytes = Buffer.from(text ?? '', 'utf8')
+    strings.push(bytes)
+    return 4 + bytes.length
+  }
+  switch (kind) {
+    case 'u32':
+      return 4
+    case 'f64':
+      return 8
+    case 'str':
+      return encodeString(value === undefined || value === null ? '' : String(value))
+    case 'json':
+      return encodeString(value === undefined ? '' : JSON.stringify(value))
+    case 'segments':
+      return (value ?? []).reduce((size, segment) => size + 8 + encodeString(segment.text), 4)
+    case 'tokens':
+      return (value ?? []).reduce((size, token) => size + 4 + encodeString(token.text), 4)
+    default:
+      throw new Error(`未知字段类型: ${kind}`)
+  }
+}
+
+/**
+ * 编码一条消息，返回待写入的缓冲区列表
+ * bytes 字段不复制，作为单独的缓冲区追加在最后
+ */
+function encodeMessage(message) {
+  const spec = MESSAGES[message.type]
+  if (!spec) {
+    throw new Error(`未知消息类型: ${message.type}`)
+  }
+  const strings = []
+  let fixedBytes = 0
+  let payload = null
+  for (const [name, kind] of spec.fields) {
+    if (kind === 'bytes') {
+      const value = message[name]
+      payload = value ? Buffer.from(value.buffer, value.byteOffset, value.byteLength) : Buffer.alloc(0)
+      fixedBytes += 4
+      continue
+    }
+    fixedBytes += measureField(kind, message[name], strings)
+  }
+  const bodyBytes = fixedBytes + (payload ? payload.length : 0)
+  if (bodyBytes > MAX_BODY_BYTES) {
+    throw new Error(`消息过大: ${bodyBytes} 字节`)
+  }
+
+  const head = Buffer.allocUnsafe(HEADER_BYTES + fixedBytes)
+  head.writeUInt32LE(bodyBytes, 0)
+  head.writeUInt8(spec.code, 4)
+  head.writeUInt8(PRIORITY_CODES[message.priority] ?? 0, 5)
+  head.writeUInt16LE(0, 6)
+  head.writeUInt32LE(toU32(message.id), 8)
+
+  let offset = HEADER_BYTES
+  let stringIndex = 0
+  const writeString = () => {
+    const bytes = strings[stringIndex++]
+    head.writeUInt32LE(bytes.length, offset)
+    bytes.copy(head, offset + 4)
+    offset += 4 + bytes.length
+  }
+  for (const [name, kind] of spec.fields) {
+    const value = message[name]
+    switch (kind) {
+      case 'u32':
+        head.writeUInt32LE(toU32(typeof value === 'boolean' ? Number(value) : value), offset)
+        offset += 4
+        break
+      case 'f64':
+        head.writeDoubleLE(Number(value) || 0, offset)
+        offset += 8
+        break
+      case 'str':
+      case 'json':
+        writeString()
+        break
+      case 'segments':
+        head.writeUInt32LE((value ?? []).length, offset)
+        offset += 4
+        for (const segment of value ?? []) {
+          head.writeUInt32LE(toU32(segment.start), offset)
+          head.writeUInt32LE(toU32(segment.end), offset + 4)
+          offset += 8
+          writeString()
+        }
+        break
+      case 'tokens':
+        head.writeUInt32LE((value ?? []).length, offset)
+        offset += 4
+        for (const token of value ?? []) {
+          head.writeUInt32LE(toU32(token.start), offset)
+          offset += 4
+          writeString()
+        }
+        break
+      case 'bytes':
+        head.writeUInt32LE(payload.length, offset)
+        offset += 4
+        break
+    }
+  }
+  return payload && payload.length > 0 ? [head, payload] : [head]
+}
+
+/**
+ * 解码一帧（含帧头）
+ */
+function decodeFrame(frame) {
+  const code = frame.readUInt8(4)
+  const type = TYPES_BY_CODE.get(code)
+  if (!type) {
+    throw new Error(`未知消息类型编码: ${code}`)
+  }
+  const message = { type, id: frame.readUInt32LE(8) }
+  const priority = PRIORITY_NAMES[frame.readUInt8(5)]
+  if (priority) {
+    message.priority = priority
+  }
+
+  let offset = HEADER_BYTES
+  const readString = () => {
+    const length = frame.readUInt32LE(offset)
+    const text = frame.toString('utf8', offset + 4, offset + 4 + length)
+    offset += 4 + length
+    return text
+  }
+  for (const [name, kind] of MESSAGES[type].fields) {
+    switch (kind) {
+      case 'u32':
+        message[name] = frame.readUInt32LE(offset)
+        offset += 4
+        break
+      case 'f64':
+        message[name] = frame.readDoubleLE(offset)
+        offset += 8
+        break
+      case 'str':
+        message[name] = readString()
+        break
+      case 'json': {
+        const text = readString()
+        message[name] = text ? JSON.parse(text) : undefined
+        break
+      }
+      case 'segments': {
+        const count = frame.readUInt32LE(offset)
+        offset += 4
+        const segments = []
+        for (let i = 0; i < count; i++) {
+          const start = frame.readUInt32LE(offset)
+          const end = frame.readUInt32LE(offset + 4)
+          offset += 8
+          segments.push({ start, end, text: readString() })
+        }
+        message[name] = segments
+        break
+      }
+      case 'tokens': {
+        const count = frame.readUInt32LE(offset)
+        offset += 4
+        const tokens = []
+        for (let i = 0; i < count; i++) {
+          const start = frame.readUInt32LE(offset)
+          offset += 4
+          tokens.push({ start, text: readString() })
+        }
+        message[name] = tokens
+        break
+      }
+      case 'bytes': {
+        const length = frame.readUInt32LE(offset)
+        message[name] = frame.subarray(offset + 4, offset + 4 + length)
+        offset += 4 + length
+        break
+      }
+    }
+  }
+  return message
+}
+
+function logHandlerError(error, message) {
+  console.error('[Protocol] 消息处理失败:', { type: message.type, id: message.id }, error)
+}
+
+/**
+ * 流式拆帧：累积读到的数据块，每凑齐一帧回调一次
+ */
+class FrameReader {
+  constructor(onMessage, onHandlerError = logHandlerError) {
+    this.onMessage = onMessage
+    this.onHandlerError = onHandlerError
+    this.chunks = []
+    this.buffered = 0
+  }
+
+  push(chunk) {
+    this.chunks.push(chunk)
+    this.buffered += chunk.length
+    while (this.buffered >= HEADER_BYTES) {
+      const head = this.peek(4)
+      const frameBytes = HEADER_BYTES + head.readUInt32LE(0)
+      if (frameBytes - HEADER_BYTES > MAX_BODY_BYTES) {
+        throw new Error(`帧长度异常: ${frameBytes}`)
+      }
+      if (this.buffered < frameBytes) return
+      this.dispatch(decodeFrame(this.take(frameBytes)))
+    }
+  }
+
+  /**
+   * 消息处理函数抛出的异常不属于协议错误：不中断拆帧，交给 onHandlerError 报告
+   */
+  dispatch(message) {
+    try {
+      this.onMessage(message)
+    } catch (error) {
+      try {
+        this.onHandlerError(error instanceof Error ? error : new Error(String(error)), message)
+      } catch (reportError) {
+        logHandlerError(reportError, message)
+      }
+    }
+  }
+
+  peek(length) {
+    return this.chunks[0].length >= length ? this.chunks[0] : Buffer.concat(this.chunks, length)
+  }
+
+  /**
+   * 取出前 length 字节；整帧位于第一个数据块内时不复制
+   */
+  take(length) {
+    let frame
+    if (this.chunks[0].length >= length) {
+      frame = this.chunks[0].subarray(0, length)
+      const rest = this.chunks[0].subarray(length)
+      if (rest.length > 0) this.chunks[0] = rest
+      else this.chunks.shift()
+    } else {
+      const merged = Buffer.concat(this.chunks, this.buffered)
+      frame = merged.subarray(0, length)
+      const rest = merged.subarray(length)
+      this.chunks = rest.length > 0 ? [rest] : []
+    }
+    this.buffered -= length
+    return frame
+  }
+}
+
+/**
+ * 在双工流上建立协议通道
+ * @param {import('stream').Duplex} stream
+ * @param {(message: object) => void} onMessage
+ * @param {(error: Error) => void} [onError] 收到无法解析的数据时调用，之后通道关闭；
+ *   onMessage 抛出的异常不会触发
+ * @param {(error: Error, message: object) => void} [onHandlerError] onMessage 抛出异常时调用，通道继续工作；
+ *   默认只记录日志
+ */
+function createChannel(stream, onMessage, onError, onHandlerError) {
+  const reader = new FrameReader(onMessage, onHandlerError)
+  stream.on('data', (chunk) => {
+    try {
+      reader.push(chunk)
+    } catch (error) {
+      stream.destroy()
+      onError?.(error instanceof Error ? error : new Error(String(error)))
+    }
+  })
+  return {
+    send(message) {
+      if (stream.destroyed || !stream.writable) return false
+      const parts = encodeMessage(message)
+      if (parts.length === 1) {
+        return stream.write(parts[0])
+      }
+      stream.cork()
+      for (const part of parts) stream.write(part)
+      process.nextTick(() => stream.uncork())
+      return true
+    },
+  }
+}
+
+module.exports = {
+  HEADER_BYTES,
+  WORKER_PIPE_FD,
+  PCM_CHUNK_BYTES,
+  encodeMessage,
+  decodeFrame,
+  FrameReader,
+  createChannel,
+}
@@ -0,0 +1,79 @@
+import type { Duplex } from 'node:stream'
+
+type Priority = 'live' | 'background'
+
+interface MessageBase {
+  id: number
+  priority?: Priority
+}
+
+export interface ProtocolSegment {
+  start: number
+  end: number
+  text: string
+}
+
+export interface ProtocolToken {
+  /** 相对音频开头的毫秒数 */
+  start: number
+  text: string
+}
+
+/** 主进程 → worker */
+export type WorkerRequest = MessageBase & (
+  | { type: 'init'; payload: unknown }
+  | { type: 'transcribe'; audioPath: string }
+  | { type: 'transcribe-long'; audioPath: string; windowMs: number }
+  | { type: 'transcribe-pcm'; sampleRate: number; channels: number; pcm: Uint8Array }
+  | { type: 'pcm-chunk'; pcm: Uint8Array }
+  | { type: 'transcribe-batch'; audioPaths: string[] }
+  | { type: 'stream-start'; sampleRate: number; channels: number; redecodeBoundary: boolean | number }
+  | { type: 'stream-chunk'; pcm: Uint8Array }
+  | { type: 'stream-finish' }
+  | { type: 'cancel' }
+  | { type: 'set-priority' }
+  | { type: 'benchmark'; payload: unknown }
+  | { type: 'stats' }
+)
+
+/** worker → 主进程 */
+export type WorkerResponse = MessageBase & (
+  | { type: 'ready'; loadMs: number }
+  | { type: 'init-error'; error: string }
+  | { type: 'transcribe-success'; durationMs: number; text: string; language: string; tokens: ProtocolToken[] }
+  | { type: 'transcribe-partial'; processedMs: number; totalMs: number; segments: ProtocolSegment[] }
+  | { type: 'transcribe-error'; error: string }
+  | { type: 'transcribe-batch-success'; items: Array<{ text?: string; durationMs?: number; language?: string; error?: string }> }
+  | { type: 'benchmark-progress'; completed: number; total: number }
+  | { type: 'benchmark-success'; audioMs: number; results: unknown }
+  | { type: 'stats-result'; rss: number; queue: unknown }
+)
+
+export type ProtocolMessage = WorkerRequest | WorkerResponse
+
+export interface ProtocolChannel<Outgoing> {
+  /** 写入一条消息；通道已关闭时返回 false，超过单帧上限时抛出 */
+  send(message: Outgoing): boolean
+}
+
+export declare const HEADER_BYTES: number
+export declare const WORKER_PIPE_FD: number
+export declare const PCM_CHUNK_BYTES: number
+
+export declare function encodeMessage(message: ProtocolMessage): Buffer[]
+export declare function decodeFrame(frame: Buffer): ProtocolMessage
+
+export declare class FrameReader {
+  constructor(
+    onMessage: (message: ProtocolMessage) => void,
+    onHandlerError?: (error: Error, message: ProtocolMessage) => void
+  )
+  push(chunk: Buffer): void
+}
+
+export declare function createChannel<Incoming extends ProtocolMessage, Outgoing extends ProtocolMessage>(
+  stream: Duplex,
+  onMessage: (message: Incoming) => void,
+  onError?: (error: Error) => void,
+  onHandlerError?: (error: Error, message: Incoming) => void
+): ProtocolChannel<Outgoing>
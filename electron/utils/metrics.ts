@@ -129,7 +129,16 @@ export class MetricsCollector {
    * 更新聚合统计数据
    */
   private updateStats(metric: PerformanceMetric): void {
-    const existing = this.stats.get(metric.operation)
+    this.accumulate(metric.operation, metric)
+    // 带阶段信息的指标（如 model_load 的 prepare/session）另按 operation:stage 单独聚合
+    const stage = metric.metadata?.stage
+    if (typeof stage === 'string') {
+      this.accumulate(`${metric.operation}:${stage}`, metric)
+    }
+  }
+
+  private accumulate(key: string, metric: PerformanceMetric): void {
+    const existing = this.stats.get(key)
     if (existing) {
       existing.count++
       existing.totalDuration += metric.duration
@@ -138,7 +147,7 @@ export class MetricsCollector {
       existing.maxDuration = Math.max(existing.maxDuration, metric.duration)
       existing.lastUpdated = Date.now()
     } else {
-      this.stats.set(metric.operation, {
+      this.stats.set(key, {
         count: 1,
         totalDuration: metric.duration,
         avgDuration: metric.duration,
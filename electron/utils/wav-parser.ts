@@ -5,11 +5,16 @@
 
 import * as fs from 'node:fs/promises'
 
+/** Header bytes read by readWavHeader; enough for fmt plus typical LIST/bext chunks */
+const HEADER_PROBE_BYTES = 64 * 1024
+
 export interface WavInfo {
   sampleRate: number
   channels: number
   bitsPerSample: number
   dataLength: number
+  /** Byte offset of the PCM payload (start of the data chunk body) */
+  dataOffset: number
   duration: number // in seconds
 }
 
@@ -21,6 +26,21 @@ export async function parseWavFile(filePath: string): Promise<WavInfo> {
   return parseWavHeader(buffer)
 }
 
+/**
+ * Read only the WAV header (first 64 KB) and return metadata
+ * Suitable for large recordings where loading the whole file is wasteful
+ */
+export async function readWavHeader(filePath: string): Promise<WavInfo> {
+  const handle = await fs.open(filePath, 'r')
+  try {
+    const buffer = Buffer.alloc(HEADER_PROBE_BYTES)
+    const { bytesRead } = await handle.read(buffer, 0, buffer.length, 0)
+    return parseWavHeader(buffer.subarray(0, bytesRead))
+  } finally {
+    await handle.close()
+  }
+}
+
 /**
  * Extract audio as Float32Array (mono, normalized to [-1, 1])
  */
@@ -101,6 +121,7 @@ function parseWavHeader(buffer: Buffer): WavInfo {
     channels: fmtInfo.channels,
     bitsPerSample: fmtInfo.bitsPerSample,
     dataLength,
+    dataOffset,
     duration,
   }
 }
@@ -0,0 +1,112 @@
+{
+  "target_defaults": {
+    "defines": [
+      "NAPI_DISABLE_CPP_EXCEPTIONS"
+    ],
+    "cflags_cc": [
+      "-std=c++17",
+      "-ffp-contract=off"
+    ],
+    "xcode_settings": {
+      "MACOSX_DEPLOYMENT_TARGET": "10.14",
+      "CLANG_CXX_LIBRARY": "libc++",
+      "CLANG_CXX_LANGUAGE_STANDARD": "c++17",
+      "OTHER_CPLUSPLUSFLAGS": [
+        "-ffp-contract=off"
+      ]
+    }
+  },
+  "targets": [
+    {
+      "target_name": "audio_dsp",
+      "sources": [
+        "src/audio-dsp.cpp",
+        "src/cpu-features.cpp",
+        "src/dispatch.cpp",
+        "src/flac-encoder.cpp",
+        "src/kernels-scalar.cpp",
+        "src/parallel-kernels.cpp",
+        "src/thread-pool.cpp",
+        "src/verify.cpp"
+      ],
+      "include_dirs": [
+        "<!@(node -p \"require('path').dirname(require.resolve('node-addon-api/package.json'))\")"
+      ],
+      "conditions": [
+        ['target_arch=="x64"', {
+          "dependencies": [
+            "audio_dsp_sse41",
+            "audio_dsp_avx2",
+            "audio_dsp_avx512"
+          ]
+        }],
+        ['target_arch=="arm64"', {
+          "sources": [
+            "src/kernels-neon.cpp"
+          ]
+        }]
+      ]
+    }
+  ],
+  "conditions": [
+    # 每个指令集单独成库，只有对应的源文件使用扩展指令编译，
+    # 其余代码保持基线指令集，由运行时分发决定是否调用
+    ['target_arch=="x64"', {
+      "targets": [
+        {
+          "target_name": "audio_dsp_sse41",
+          "type": "static_library",
+          "sources": [
+            "src/kernels-sse41.cpp"
+          ],
+          "cflags_cc": [
+            "-fPIC",
+            "-msse4.1"
+          ],
+          "xcode_settings": {
+            "OTHER_CPLUSPLUSFLAGS": [
+              "-ffp-contract=off",
+              "-msse4.1"
+            ]
+          }
+        },
+        {
+          "target_name": "audio_dsp_avx2",
+          "type": "static_library",
+          "sources": [
+            "src/kernels-avx2.cpp"
+          ],
+          "cflags_cc": [
+            "-fPIC",
+            "-mavx2"
+          ],
+          "xcode_settings": {
+            "OTHER_CPLUSPLUSFLAGS": [
+              "-ffp-contract=off",
+              "-mavx2"
+            ]
+          }
+        },
+        {
+          "target_name": "audio_dsp_avx512",
+          "type": "static_library",
+          "sources": [
+            "src/kernels-avx512.cpp"
+          ],
+          "cflags_cc": [
+            "-fPIC",
+            "-mavx512f",
+            "-mavx512bw"
+          ],
+          "xcode_settings": {
+            "OTHER_CPLUSPLUSFLAGS": [
+              "-ffp-contract=off",
+              "-mavx512f",
+              "-mavx512bw"
+            ]
+          }
+        }
+      ]
+    }]
+  ]
+}
@@ -0,0 +1,16 @@
+/**
+ * AudioDsp Node.js 模块
+ * 音频转换、重采样与帧能量的 SIMD 内核，运行时按 CPU 特性选择实现
+ */
+
+'use strict';
+
+let nativeModule = null;
+try {
+  nativeModule = require('./build/Release/audio_dsp.node');
+} catch (error) {
+  console.error('[AudioDsp] 无法加载原生模块:', error.message);
+  console.error('[AudioDsp] 请运行: npm install 或 npm run rebuild');
+}
+
+module.exports = nativeModule;
@@ -0,0 +1,279 @@
+#include <napi.h>
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cpu-features.h"
+#include "dispatch.h"
+#include "flac-encoder.h"
+#include "kernels.h"
+#include "parallel-kernels.h"
+#include "thread-pool.h"
+#include "verify.h"
+
+namespace AudioDspBinding {
+
+using namespace AudioDsp;
+
+/**
+ * 16-bit 交错 PCM 转单声道 Float32Array，长音频自动分块并行
+ * 参数: (Int16Array, channels)
+ */
+Napi::Value Int16ToFloat(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[0].IsTypedArray() || !info[1].IsNumber()) {
+        Napi::TypeError::New(env, "参数必须是 (Int16Array, channels)").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    Napi::TypedArray typed = info[0].As<Napi::TypedArray>();
+    if (typed.TypedArrayType() != napi_int16_array) {
+        Napi::TypeError::New(env, "输入必须是 Int16Array").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    const int channels = info[1].As<Napi::Number>().Int32Value();
+    if (channels <= 0) {
+        Napi::RangeError::New(env, "声道数必须大于 0").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Int16Array input = info[0].As<Napi::Int16Array>();
+    const size_t frames = input.ElementLength() / static_cast<size_t>(channels);
+    Napi::Float32Array output = Napi::Float32Array::New(env, frames);
+    int16ToFloatParallel(kernels(), input.Data(), frames, channels, output.Data());
+    return output;
+}
+
+/**
+ * 线性插值重采样，长音频自动分块并行
+ * 参数: (Float32Array, fromRate, toRate)
+ */
+Napi::Value ResampleLinear(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 3 || !info[0].IsTypedArray() || !info[1].IsNumber() || !info[2].IsNumber()) {
+        Napi::TypeError::New(env, "参数必须是 (Float32Array, fromRate, toRate)").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    if (info[0].As<Napi::TypedArray>().TypedArrayType() != napi_float32_array) {
+        Napi::TypeError::New(env, "输入必须是 Float32Array").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    const double fromRate = info[1].As<Napi::Number>().DoubleValue();
+    const double toRate = info[2].As<Napi::Number>().DoubleValue();
+    if (!(fromRate > 0) || !(toRate > 0)) {
+        Napi::RangeError::New(env, "采样率必须大于 0").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Float32Array input = info[0].As<Napi::Float32Array>();
+    const size_t inputLength = input.ElementLength();
+    if (fromRate == toRate || inputLength == 0) {
+        Napi::Float32Array copy = Napi::Float32Array::New(env, inputLength);
+        if (inputLength > 0) {
+            std::memcpy(copy.Data(), input.Data(), inputLength * sizeof(float));
+        }
+        return copy;
+    }
+
+    const double step = fromRate / toRate;
+    const size_t outputLength = static_cast<size_t>(std::floor(static_cast<double>(inputLength) / step));
+    Napi::Float32Array output = Napi::Float32Array::New(env, outputLength);
+    resampleLinearParallel(kernels(), input.Data(), inputLength, step, output.Data(), outputLength);
+    return output;
+}
+
+/**
+ * 按帧计算均方根能量，不足一帧的尾部忽略
+ * 参数: (Float32Array, frameSize)
+ */
+Napi::Value FrameEnergy(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 2 || !info[0].IsTypedArray() || !info[1].IsNumber()) {
+        Napi::TypeError::New(env, "参数必须是 (Float32Array, frameSize)").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    if (info[0].As<Napi::TypedArray>().TypedArrayType() != napi_float32_array) {
+        Napi::TypeError::New(env, "输入必须是 Float32Array").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    const int64_t frameSize = info[1].As<Napi::Number>().Int64Value();
+    if (frameSize <= 0) {
+        Napi::RangeError::New(env, "帧长必须大于 0").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+
+    Napi::Float32Array input = info[0].As<Napi::Float32Array>();
+    const size_t frameCount = input.ElementLength() / static_cast<size_t>(frameSize);
+    Napi::Float32Array output = Napi::Float32Array::New(env, frameCount);
+    kernels().frameEnergy(input.Data(), frameCount, static_cast<size_t>(frameSize), output.Data());
+    return output;
+}
+
+/**
+ * CPU 特性与各内核实际使用的实现级别
+ */
+Napi::Value GetDiagnostics(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    const CpuFeatures& features = cpuFeatures();
+    const KernelTable& table = kernels();
+
+    Napi::Object cpu = Napi::Object::New(env);
+    cpu.Set("sse41", Napi::Boolean::New(env, features.sse41));
+    cpu.Set("avx2", Napi::Boolean::New(env, features.avx2));
+    cpu.Set("avx512f", Napi::Boolean::New(env, features.avx512f));
+    cpu.Set("avx512bw", Napi::Boolean::New(env, features.avx512bw));
+    cpu.Set("neon", Napi::Boolean::New(env, features.neon));
+
+    Napi::Object selected = Napi::Object::New(env);
+    selected.Set("int16ToFloat", Napi::String::New(env, levelName(table.int16ToFloatLevel)));
+    selected.Set("resampleLinear", Napi::String::New(env, levelName(table.resampleLinearLevel)));
+    selected.Set("frameEnergy", Napi::String::New(env, levelName(table.frameEnergyLevel)));
+
+    Napi::Array available = Napi::Array::New(env);
+    uint32_t count = 0;
+    for (int i = 0; i < static_cast<int>(SimdLevel::Count); i++) {
+        if (kernelsFor(static_cast<SimdLevel>(i)) != nullptr) {
+            available.Set(count++, Napi::String::New(env, levelName(static_cast<SimdLevel>(i))));
+        }
+    }
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("cpu", cpu);
+    result.Set("detectedLevel", Napi::String::New(env, levelName(detectedLevel())));
+    result.Set("activeLevel", Napi::String::New(env, levelName(table.level)));
+    result.Set("availableLevels", available);
+    result.Set("kernels", selected);
+    result.Set("threads", Napi::Number::New(env, static_cast<double>(parallelThreadCount())));
+    return result;
+}
+
+/**
+ * 逐级对比 SIMD 内核与参考实现
+ */
+Napi::Value VerifyKernels(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    const std::vector<KernelCheck> checks = verifyKernels();
+
+    Napi::Array results = Napi::Array::New(env, checks.size());
+    bool passed = true;
+    for (size_t i = 0; i < checks.size(); i++) {
+        const KernelCheck& check = checks[i];
+        Napi::Object item = Napi::Object::New(env);
+        item.Set("level", Napi::String::New(env, levelName(check.level)));
+        item.Set("kernel", Napi::String::New(env, check.kernel));
+        item.Set("maxAbsError", Napi::Number::New(env, check.maxAbsError));
+        item.Set("exact", Napi::Boolean::New(env, check.exact));
+        item.Set("passed", Napi::Boolean::New(env, check.passed));
+        results.Set(static_cast<uint32_t>(i), item);
+        passed = passed && check.passed;
+    }
+
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("passed", Napi::Boolean::New(env, passed));
+    result.Set("results", results);
+    return result;
+}
+
+/**
+ * 切换内核级别（如校验失败时回退到 scalar）
+ * 参数: (levelName)，返回是否切换成功
+ */
+Napi::Value SelectLevel(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "参数必须是级别名称").ThrowAsJavaScriptException();
+        return env.Null();
+    }
+    const std::string name = info[0].As<Napi::String>().Utf8Value();
+    SimdLevel level;
+    if (!parseLevel(name.c_str(), &level)) {
+        return Napi::Boolean::New(env, false);
+    }
+    return Napi::Boolean::New(env, selectLevel(level));
+}
+
+/**
+ * 流式 FLAC 编码器，用于在线转写上传前压缩
+ * new FlacEncoder(sampleRate)；encode(Int16Array) 与 finish() 返回新产生的字节
+ */
+class FlacEncoderWrap : public Napi::ObjectWrap<FlacEncoderWrap> {
+public:
+    static Napi::Function Define(Napi::Env env) {
+        return DefineClass(env, "FlacEncoder", {
+            InstanceMethod("encode", &FlacEncoderWrap::Encode),
+            InstanceMethod("finish", &FlacEncoderWrap::Finish),
+        });
+    }
+
+    explicit FlacEncoderWrap(const Napi::CallbackInfo& info) : Napi::ObjectWrap<FlacEncoderWrap>(info) {
+        Napi::Env env = info.Env();
+        if (info.Length() < 1 || !info[0].IsNumber()) {
+            Napi::TypeError::New(env, "参数必须是 (sampleRate)").ThrowAsJavaScriptException();
+            return;
+        }
+        const int64_t sampleRate = info[0].As<Napi::Number>().Int64Value();
+        // STREAMINFO 中采样率占 20 位
+        if (sampleRate <= 0 || sampleRate >= (1 << 20)) {
+            Napi::RangeError::New(env, "不支持的采样率").ThrowAsJavaScriptException();
+            return;
+        }
+        encoder_.reset(new FlacEncoder(static_cast<uint32_t>(sampleRate)));
+    }
+
+private:
+    Napi::Value Encode(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        if (!encoder_) {
+            Napi::Error::New(env, "编码器未初始化").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        if (info.Length() < 1 || !info[0].IsTypedArray() ||
+            info[0].As<Napi::TypedArray>().TypedArrayType() != napi_int16_array) {
+            Napi::TypeError::New(env, "输入必须是 Int16Array（单声道）").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        Napi::Int16Array input = info[0].As<Napi::Int16Array>();
+        std::vector<uint8_t> out;
+        encoder_->encode(input.Data(), input.ElementLength(), out);
+        return Napi::Buffer<uint8_t>::Copy(env, out.data(), out.size());
+    }
+
+    Napi::Value Finish(const Napi::CallbackInfo& info) {
+        Napi::Env env = info.Env();
+        if (!encoder_) {
+            Napi::Error::New(env, "编码器未初始化").ThrowAsJavaScriptException();
+            return env.Null();
+        }
+        std::vector<uint8_t> out;
+        encoder_->finish(out);
+        return Napi::Buffer<uint8_t>::Copy(env, out.data(), out.size());
+    }
+
+    std::unique_ptr<FlacEncoder> encoder_;
+};
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+    exports.Set("int16ToFloat", Napi::Function::New(env, Int16ToFloat));
+    exports.Set("resampleLinear", Napi::Function::New(env, ResampleLinear));
+    exports.Set("frameEnergy", Napi::Function::New(env, FrameEnergy));
+    exports.Set("getDiagnostics", Napi::Function::New(env, GetDiagnostics));
+    exports.Set("verifyKernels", Napi::Function::New(env, VerifyKernels));
+    exports.Set("selectLevel", Napi::Function::New(env, SelectLevel));
+    exports.Set("FlacEncoder", FlacEncoderWrap::Define(env));
+    return exports;
+}
+
+} // namespace AudioDspBinding
+
+// 模块初始化函数（放在命名空间外）
+Napi::Object InitModule(Napi::Env env, Napi::Object exports) {
+    return AudioDspBinding::Init(env, exports);
+}
+
+NODE_API_MODULE(audio_dsp, InitModule)
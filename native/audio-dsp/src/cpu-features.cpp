@@ -0,0 +1,107 @@
+#include "cpu-features.h"
+#include "kernels.h"
+
+#if defined(AUDIO_DSP_X86)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+
+namespace AudioDsp {
+namespace {
+
+#if defined(AUDIO_DSP_X86)
+
+void cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4]) {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; i++) regs[i] = static_cast<unsigned>(info[i]);
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+unsigned long long readXcr0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    unsigned eax = 0;
+    unsigned edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+}
+
+#if defined(__APPLE__)
+// macOS 按需启用 AVX-512 寄存器状态，XCR0 初始可能未置位，以内核报告为准
+bool sysctlFlag(const char* name) {
+    int value = 0;
+    size_t size = sizeof(value);
+    if (sysctlbyname(name, &value, &size, nullptr, 0) != 0) return false;
+    return value != 0;
+}
+#endif
+
+CpuFeatures detect() {
+    CpuFeatures features = {};
+    unsigned regs[4] = {0, 0, 0, 0};
+    cpuid(0, 0, regs);
+    const unsigned maxLeaf = regs[0];
+    if (maxLeaf < 1) return features;
+
+    cpuid(1, 0, regs);
+    features.sse41 = (regs[2] & (1u << 19)) != 0;
+    const bool osxsave = (regs[2] & (1u << 27)) != 0;
+    const bool avx = (regs[2] & (1u << 28)) != 0;
+    if (!osxsave || !avx || maxLeaf < 7) return features;
+
+    const unsigned long long xcr0 = readXcr0();
+    // XMM + YMM 状态
+    const bool ymmEnabled = (xcr0 & 0x6) == 0x6;
+    // 额外需要 opmask 与 ZMM 高位状态
+    bool zmmEnabled = (xcr0 & 0xe6) == 0xe6;
+
+    cpuid(7, 0, regs);
+    features.avx2 = ymmEnabled && (regs[1] & (1u << 5)) != 0;
+    bool avx512f = (regs[1] & (1u << 16)) != 0;
+    bool avx512bw = (regs[1] & (1u << 30)) != 0;
+#if defined(__APPLE__)
+    if (!zmmEnabled && ymmEnabled) {
+        zmmEnabled = sysctlFlag("hw.optional.avx512f");
+        avx512f = avx512f && zmmEnabled;
+        avx512bw = avx512bw && sysctlFlag("hw.optional.avx512bw");
+    }
+#endif
+    features.avx512f = zmmEnabled && avx512f;
+    features.avx512bw = zmmEnabled && avx512bw;
+    return features;
+}
+
+#else
+
+CpuFeatures detect() {
+    CpuFeatures features = {};
+#if defined(AUDIO_DSP_ARM64)
+    features.neon = true;
+#endif
+    return features;
+}
+
+#endif
+
+} // namespace
+
+const CpuFeatures& cpuFeatures() {
+    // 局部静态变量的初始化是线程安全的，检测只执行一次
+    static const CpuFeatures features = detect();
+    return features;
+}
+
+} // namespace AudioDsp
@@ -0,0 +1,25 @@
+#ifndef AUDIO_DSP_CPU_FEATURES_H
+#define AUDIO_DSP_CPU_FEATURES_H
+
+namespace AudioDsp {
+
+/**
+ * 运行时检测到的 CPU 特性
+ * x86 上的 AVX 系列还要求操作系统已启用对应寄存器状态（XCR0）
+ */
+struct CpuFeatures {
+    bool sse41;
+    bool avx2;
+    bool avx512f;
+    bool avx512bw;
+    bool neon;
+};
+
+/**
+ * 检测结果，仅在首次调用时执行检测
+ */
+const CpuFeatures& cpuFeatures();
+
+} // namespace AudioDsp
+
+#endif // AUDIO_DSP_CPU_FEATURES_H
@@ -0,0 +1,120 @@
+#include "dispatch.h"
+
+#include "cpu-features.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+namespace AudioDsp {
+namespace {
+
+const int kLevelCount = static_cast<int>(SimdLevel::Count);
+
+KernelTable gTables[kLevelCount];
+bool gAvailable[kLevelCount];
+SimdLevel gDetected = SimdLevel::Scalar;
+std::atomic<const KernelTable*> gActive{nullptr};
+std::once_flag gInitOnce;
+
+/**
+ * 以 base 为底构建下一级表：先整体复制，再由 fill 覆盖已实现的内核
+ */
+void buildLevel(SimdLevel level, SimdLevel base, void (*fill)(KernelTable&)) {
+    const int index = static_cast<int>(level);
+    gTables[index] = gTables[static_cast<int>(base)];
+    gTables[index].level = level;
+    fill(gTables[index]);
+    gAvailable[index] = true;
+    gDetected = level;
+}
+
+void initialize() {
+    fillScalarKernels(gTables[0]);
+    gTables[0].level = SimdLevel::Scalar;
+    gAvailable[0] = true;
+
+    const CpuFeatures& features = cpuFeatures();
+#if defined(AUDIO_DSP_X86)
+    if (features.sse41) {
+        buildLevel(SimdLevel::Sse41, SimdLevel::Scalar, fillSse41Kernels);
+        if (features.avx2) {
+            buildLevel(SimdLevel::Avx2, SimdLevel::Sse41, fillAvx2Kernels);
+            if (features.avx512f && features.avx512bw) {
+                buildLevel(SimdLevel::Avx512, SimdLevel::Avx2, fillAvx512Kernels);
+            }
+        }
+    }
+#endif
+#if defined(AUDIO_DSP_ARM64)
+    if (features.neon) {
+        buildLevel(SimdLevel::Neon, SimdLevel::Scalar, fillNeonKernels);
+    }
+#endif
+    (void)features;
+
+    // 环境变量只能降低级别，便于排查特定指令集上的问题
+    SimdLevel initial = gDetected;
+    SimdLevel cap;
+    const char* override = std::getenv("SPEECHTIDE_DSP_LEVEL");
+    if (override != nullptr && parseLevel(override, &cap) && gAvailable[static_cast<int>(cap)]) {
+        initial = cap;
+    }
+    gActive.store(&gTables[static_cast<int>(initial)], std::memory_order_release);
+}
+
+void ensureInitialized() {
+    std::call_once(gInitOnce, initialize);
+}
+
+} // namespace
+
+const KernelTable& kernels() {
+    ensureInitialized();
+    return *gActive.load(std::memory_order_acquire);
+}
+
+const KernelTable* kernelsFor(SimdLevel level) {
+    ensureInitialized();
+    const int index = static_cast<int>(level);
+    if (index < 0 || index >= kLevelCount || !gAvailable[index]) return nullptr;
+    return &gTables[index];
+}
+
+SimdLevel detectedLevel() {
+    ensureInitialized();
+    return gDetected;
+}
+
+bool selectLevel(SimdLevel level) {
+    const KernelTable* table = kernelsFor(level);
+    if (table == nullptr) return false;
+    gActive.store(table, std::memory_order_release);
+    return true;
+}
+
+const char* levelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return "scalar";
+        case SimdLevel::Sse41: return "sse4.1";
+        case SimdLevel::Avx2: return "avx2";
+        case SimdLevel::Avx512: return "avx512";
+        case SimdLevel::Neon: return "neon";
+        default: return "unknown";
+    }
+}
+
+bool parseLevel(const char* name, SimdLevel* level) {
+    if (name == nullptr) return false;
+    for (int i = 0; i < kLevelCount; i++) {
+        const SimdLevel candidate = static_cast<SimdLevel>(i);
+        if (std::strcmp(name, levelName(candidate)) == 0) {
+            *level = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace AudioDsp
@@ -0,0 +1,38 @@
+#ifndef AUDIO_DSP_DISPATCH_H
+#define AUDIO_DSP_DISPATCH_H
+
+#include "kernels.h"
+
+namespace AudioDsp {
+
+/**
+ * 当前生效的内核表
+ * 首次调用时按 CPU 特性选择最高可用级别，环境变量 SPEECHTIDE_DSP_LEVEL 可设定上限
+ */
+const KernelTable& kernels();
+
+/**
+ * 指定级别的内核表，本机不支持该级别时返回 nullptr
+ */
+const KernelTable* kernelsFor(SimdLevel level);
+
+/**
+ * 本机支持的最高级别（不受上限影响）
+ */
+SimdLevel detectedLevel();
+
+/**
+ * 切换当前级别，不支持时返回 false 且保持不变
+ */
+bool selectLevel(SimdLevel level);
+
+const char* levelName(SimdLevel level);
+
+/**
+ * 解析级别名称（scalar / sse4.1 / avx2 / avx512 / neon），无法识别时返回 false
+ */
+bool parseLevel(const char* name, SimdLevel* level);
+
+} // namespace AudioDsp
+
+#endif // AUDIO_DSP_DISPATCH_H
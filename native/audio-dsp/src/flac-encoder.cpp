@@ -0,0 +1,330 @@
+#include "flac-encoder.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace AudioDsp {
+namespace {
+
+const int kBitsPerSample = 16;
+const int kMaxFixedOrder = 4;
+const int kMaxPartitionOrder = 8;
+// 4 位 Rice 参数，15 保留为转义
+const int kMaxRiceParameter = 14;
+
+uint8_t gCrc8Table[256];
+uint16_t gCrc16Table[256];
+
+struct CrcTables {
+    CrcTables() {
+        for (int i = 0; i < 256; i++) {
+            uint8_t crc8 = static_cast<uint8_t>(i);
+            for (int bit = 0; bit < 8; bit++) {
+                crc8 = static_cast<uint8_t>((crc8 & 0x80) ? (crc8 << 1) ^ 0x07 : crc8 << 1);
+            }
+            gCrc8Table[i] = crc8;
+
+            uint16_t crc16 = static_cast<uint16_t>(i << 8);
+            for (int bit = 0; bit < 8; bit++) {
+                crc16 = static_cast<uint16_t>((crc16 & 0x8000) ? (crc16 << 1) ^ 0x8005 : crc16 << 1);
+            }
+            gCrc16Table[i] = crc16;
+        }
+    }
+};
+const CrcTables gCrcTables;
+
+uint8_t crc8(const uint8_t* data, size_t length) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < length; i++) crc = gCrc8Table[crc ^ data[i]];
+    return crc;
+}
+
+uint16_t crc16(const uint8_t* data, size_t length) {
+    uint16_t crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        crc = static_cast<uint16_t>((crc << 8) ^ gCrc16Table[(crc >> 8) ^ data[i]]);
+    }
+    return crc;
+}
+
+/**
+ * 高位在前的位写入器
+ */
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+    void write(uint32_t value, int bits) {
+        if (bits == 0) return;
+        const uint64_t mask = (bits == 32) ? 0xffffffffull : ((1ull << bits) - 1);
+        acc_ = (acc_ << bits) | (value & mask);
+        count_ += bits;
+        while (count_ >= 8) {
+            count_ -= 8;
+            out_.push_back(static_cast<uint8_t>(acc_ >> count_));
+        }
+        acc_ &= (1ull << count_) - 1;
+    }
+
+    void writeSigned(int32_t value, int bits) { write(static_cast<uint32_t>(value), bits); }
+
+    /**
+     * q 个 0 后跟一个 1
+     */
+    void writeUnary(uint32_t q) {
+        while (q >= 32) {
+            write(0, 32);
+            q -= 32;
+        }
+        write(1, static_cast<int>(q) + 1);
+    }
+
+    void alignToByte() {
+        if (count_ > 0) write(0, 8 - count_);
+    }
+
+private:
+    std::vector<uint8_t>& out_;
+    uint64_t acc_ = 0;
+    int count_ = 0;
+};
+
+void computeResidual(const int32_t* samples, uint32_t blockSize, int order, int32_t* residual) {
+    for (uint32_t i = static_cast<uint32_t>(order); i < blockSize; i++) {
+        const int32_t* x = samples + i;
+        switch (order) {
+            case 0: residual[i] = x[0]; break;
+            case 1: residual[i] = x[0] - x[-1]; break;
+            case 2: residual[i] = x[0] - 2 * x[-1] + x[-2]; break;
+            case 3: residual[i] = x[0] - 3 * x[-1] + 3 * x[-2] - x[-3]; break;
+            default: residual[i] = x[0] - 4 * x[-1] + 6 * x[-2] - 4 * x[-3] + x[-4]; break;
+        }
+    }
+}
+
+inline uint32_t zigzag(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+uint64_t riceBits(const uint32_t* values, size_t count, int parameter) {
+    uint64_t bits = static_cast<uint64_t>(count) * (parameter + 1);
+    for (size_t i = 0; i < count; i++) bits += values[i] >> parameter;
+    return bits;
+}
+
+/**
+ * 在均值估计附近取实际位数最少的 Rice 参数
+ */
+int bestRiceParameter(const uint32_t* values, size_t count, uint64_t* bitsOut) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < count; i++) sum += values[i];
+    int estimate = 0;
+    if (count > 0) {
+        const uint64_t mean = sum / count;
+        while (estimate < kMaxRiceParameter && (1ull << (estimate + 1)) <= mean) estimate++;
+    }
+    int best = estimate;
+    uint64_t bestBits = riceBits(values, count, estimate);
+    for (int candidate = std::max(0, estimate - 1); candidate <= std::min(kMaxRiceParameter, estimate + 1); candidate++) {
+        if (candidate == estimate) continue;
+        const uint64_t bits = riceBits(values, count, candidate);
+        if (bits < bestBits) {
+            best = candidate;
+            bestBits = bits;
+        }
+    }
+    *bitsOut = bestBits;
+    return best;
+}
+
+struct ResidualPlan {
+    int partitionOrder = 0;
+    std::vector<int> parameters;
+    uint64_t bits = 0;
+};
+
+/**
+ * 选择总位数最少的分区阶数；第一个分区要扣除预测阶数个预热样本
+ */
+ResidualPlan planResidual(const uint32_t* values, uint32_t blockSize, int order) {
+    ResidualPlan best;
+    best.bits = UINT64_MAX;
+    for (int partitionOrder = 0; partitionOrder <= kMaxPartitionOrder; partitionOrder++) {
+        const uint32_t partitions = 1u << partitionOrder;
+        if (blockSize % partitions != 0) break;
+        const uint32_t partitionSize = blockSize / partitions;
+        if (partitionSize <= static_cast<uint32_t>(order)) break;
+
+        ResidualPlan plan;
+        plan.partitionOrder = partitionOrder;
+        plan.bits = 2 + 4;
+        for (uint32_t p = 0; p < partitions; p++) {
+            const uint32_t start = p == 0 ? static_cast<uint32_t>(order) : p * partitionSize;
+            const uint32_t end = (p + 1) * partitionSize;
+            uint64_t bits = 0;
+            plan.parameters.push_back(bestRiceParameter(values + start, end - start, &bits));
+            plan.bits += 4 + bits;
+        }
+        if (plan.bits < best.bits) best = std::move(plan);
+    }
+    return best;
+}
+
+void writeUtf8FrameNumber(uint64_t value, std::vector<uint8_t>& out) {
+    if (value < 0x80) {
+        out.push_back(static_cast<uint8_t>(value));
+        return;
+    }
+    // 与 UTF-8 相同的扩展编码，最多 36 位
+    int bytes = 2;
+    while (bytes < 7 && value >= (1ull << (5 * bytes + 1))) bytes++;
+    const int continuation = bytes - 1;
+    const uint8_t lead = static_cast<uint8_t>((0xff00 >> bytes) & 0xff);
+    out.push_back(static_cast<uint8_t>(lead | (value >> (6 * continuation))));
+    for (int i = continuation - 1; i >= 0; i--) {
+        out.push_back(static_cast<uint8_t>(0x80 | ((value >> (6 * i)) & 0x3f)));
+    }
+}
+
+} // namespace
+
+FlacEncoder::FlacEncoder(uint32_t sampleRate) : sampleRate_(sampleRate) {
+    pending_.reserve(kBlockSize);
+}
+
+void FlacEncoder::writeStreamHeader(std::vector<uint8_t>& out) {
+    const uint8_t magic[] = {'f', 'L', 'a', 'C'};
+    out.insert(out.end(), magic, magic + 4);
+    // 最后一个元数据块，类型 STREAMINFO，长度 34
+    const uint8_t blockHeader[] = {0x80, 0x00, 0x00, 0x22};
+    out.insert(out.end(), blockHeader, blockHeader + 4);
+
+    std::vector<uint8_t> info;
+    BitWriter writer(info);
+    writer.write(kBlockSize, 16);
+    writer.write(kBlockSize, 16);
+    writer.write(0, 24);  // 最小帧长未知
+    writer.write(0, 24);  // 最大帧长未知
+    writer.write(sampleRate_, 20);
+    writer.write(0, 3);  // 声道数 - 1
+    writer.write(kBitsPerSample - 1, 5);
+    writer.write(0, 4);  // 总样本数未知（36 位）
+    writer.write(0, 32);
+    for (int i = 0; i < 4; i++) writer.write(0, 32);  // MD5 未计算
+    out.insert(out.end(), info.begin(), info.end());
+}
+
+void FlacEncoder::encodeBlock(const int32_t* samples, uint32_t blockSize, std::vector<uint8_t>& out) {
+    std::vector<uint8_t> frame;
+    frame.reserve(blockSize * 2 + 32);
+
+    // 帧头
+    uint8_t blockSizeCode;
+    if (blockSize == kBlockSize) {
+        blockSizeCode = 0x0c;  // 4096
+    } else if (blockSize <= 256) {
+        blockSizeCode = 0x06;  // 帧头末尾 8 位 (blockSize - 1)
+    } else {
+        blockSizeCode = 0x07;  // 帧头末尾 16 位 (blockSize - 1)
+    }
+    frame.push_back(0xff);
+    frame.push_back(0xf8);  // 同步码尾部 + 固定块长
+    frame.push_back(static_cast<uint8_t>(blockSizeCode << 4));  // 采样率取 STREAMINFO
+    frame.push_back(0x08);  // 单声道，16-bit
+    writeUtf8FrameNumber(frameNumber_, frame);
+    if (blockSizeCode == 0x06) {
+        frame.push_back(static_cast<uint8_t>(blockSize - 1));
+    } else if (blockSizeCode == 0x07) {
+        frame.push_back(static_cast<uint8_t>((blockSize - 1) >> 8));
+        frame.push_back(static_cast<uint8_t>(blockSize - 1));
+    }
+    frame.push_back(crc8(frame.data(), frame.size()));
+
+    BitWriter writer(frame);
+    const bool constant = std::all_of(samples, samples + blockSize, [&](int32_t v) { return v == samples[0]; });
+    if (constant) {
+        writer.write(0x00, 8);
+        writer.writeSigned(samples[0], kBitsPerSample);
+    } else {
+        // 绝对残差和最小的固定预测阶数
+        std::vector<int32_t> residual(blockSize);
+        int bestOrder = 0;
+        uint64_t bestSum = UINT64_MAX;
+        const int maxOrder = std::min<int>(kMaxFixedOrder, static_cast<int>(blockSize) - 1);
+        for (int order = 0; order <= maxOrder; order++) {
+            computeResidual(samples, blockSize, order, residual.data());
+            uint64_t sum = 0;
+            for (uint32_t i = static_cast<uint32_t>(order); i < blockSize; i++) sum += static_cast<uint64_t>(std::llabs(residual[i]));
+            if (sum < bestSum) {
+                bestSum = sum;
+                bestOrder = order;
+            }
+        }
+        computeResidual(samples, blockSize, bestOrder, residual.data());
+        std::vector<uint32_t> values(blockSize, 0);
+        for (uint32_t i = static_cast<uint32_t>(bestOrder); i < blockSize; i++) values[i] = zigzag(residual[i]);
+
+        const ResidualPlan plan = planResidual(values.data(), blockSize, bestOrder);
+        const uint64_t fixedBits = 8 + static_cast<uint64_t>(bestOrder) * kBitsPerSample + plan.bits;
+        const uint64_t verbatimBits = 8 + static_cast<uint64_t>(blockSize) * kBitsPerSample;
+
+        if (plan.parameters.empty() || fixedBits >= verbatimBits) {
+            writer.write(0x02, 8);
+            for (uint32_t i = 0; i < blockSize; i++) writer.writeSigned(samples[i], kBitsPerSample);
+        } else {
+            writer.write(static_cast<uint32_t>((0x08 | bestOrder) << 1), 8);
+            for (int i = 0; i < bestOrder; i++) writer.writeSigned(samples[i], kBitsPerSample);
+            writer.write(0, 2);  // Rice 编码，4 位参数
+            writer.write(static_cast<uint32_t>(plan.partitionOrder), 4);
+            const uint32_t partitions = 1u << plan.partitionOrder;
+            const uint32_t partitionSize = blockSize / partitions;
+            for (uint32_t p = 0; p < partitions; p++) {
+                const int parameter = plan.parameters[p];
+                writer.write(static_cast<uint32_t>(parameter), 4);
+                const uint32_t start = p == 0 ? static_cast<uint32_t>(bestOrder) : p * partitionSize;
+                const uint32_t end = (p + 1) * partitionSize;
+                for (uint32_t i = start; i < end; i++) {
+                    writer.writeUnary(values[i] >> parameter);
+                    writer.write(values[i], parameter);
+                }
+            }
+        }
+    }
+    writer.alignToByte();
+
+    const uint16_t crc = crc16(frame.data(), frame.size());
+    frame.push_back(static_cast<uint8_t>(crc >> 8));
+    frame.push_back(static_cast<uint8_t>(crc));
+
+    out.insert(out.end(), frame.begin(), frame.end());
+    frameNumber_++;
+    samplesEncoded_ += blockSize;
+}
+
+void FlacEncoder::encode(const int16_t* samples, size_t count, std::vector<uint8_t>& out) {
+    if (!headerWritten_) {
+        writeStreamHeader(out);
+        headerWritten_ = true;
+    }
+    for (size_t i = 0; i < count; i++) {
+        pending_.push_back(samples[i]);
+        if (pending_.size() == kBlockSize) {
+            encodeBlock(pending_.data(), kBlockSize, out);
+            pending_.clear();
+        }
+    }
+}
+
+void FlacEncoder::finish(std::vector<uint8_t>& out) {
+    if (!headerWritten_) {
+        writeStreamHeader(out);
+        headerWritten_ = true;
+    }
+    if (!pending_.empty()) {
+        encodeBlock(pending_.data(), static_cast<uint32_t>(pending_.size()), out);
+        pending_.clear();
+    }
+}
+
+} // namespace AudioDsp
@@ -0,0 +1,47 @@
+#ifndef AUDIO_DSP_FLAC_ENCODER_H
+#define AUDIO_DSP_FLAC_ENCODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace AudioDsp {
+
+/**
+ * 流式 FLAC 编码器（单声道 16-bit，固定块长）
+ * 每个块在 CONSTANT / FIXED(0-4 阶) / VERBATIM 中选最短的子帧，残差用分区 Rice 编码
+ * STREAMINFO 中总样本数、帧长范围与 MD5 记为未知，输出可以边编码边发送
+ */
+class FlacEncoder {
+public:
+    static const uint32_t kBlockSize = 4096;
+
+    explicit FlacEncoder(uint32_t sampleRate);
+
+    /**
+     * 输入样本，把新产生的字节追加到 out（首次调用时包含流头）
+     * 不足一个块的样本留到下次或 finish
+     */
+    void encode(const int16_t* samples, size_t count, std::vector<uint8_t>& out);
+
+    /**
+     * 编码剩余样本（最后一个块可以短于 kBlockSize）
+     */
+    void finish(std::vector<uint8_t>& out);
+
+    uint64_t samplesEncoded() const { return samplesEncoded_; }
+
+private:
+    void writeStreamHeader(std::vector<uint8_t>& out);
+    void encodeBlock(const int32_t* samples, uint32_t blockSize, std::vector<uint8_t>& out);
+
+    uint32_t sampleRate_;
+    bool headerWritten_ = false;
+    uint64_t frameNumber_ = 0;
+    uint64_t samplesEncoded_ = 0;
+    std::vector<int32_t> pending_;
+};
+
+} // namespace AudioDsp
+
+#endif // AUDIO_DSP_FLAC_ENCODER_H
@@ -0,0 +1,104 @@
+// 编译参数: -mavx2（见 binding.gyp 中的 audio_dsp_avx2）
+#include "kernels.h"
+
+#include <climits>
+#include <cmath>
+#include <immintrin.h>
+
+namespace AudioDsp {
+namespace {
+
+void int16ToFloatAvx2(const int16_t* input, size_t frames, int channels, float* output) {
+    size_t i = 0;
+    if (channels == 1) {
+        const __m256 scale = _mm256_set1_ps(1.0f / 32768.0f);
+        for (; i + 16 <= frames; i += 16) {
+            const __m256i pcm = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+            const __m256i low = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(pcm));
+            const __m256i high = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(pcm, 1));
+            _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(low), scale));
+            _mm256_storeu_ps(output + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(high), scale));
+        }
+    } else if (channels == 2) {
+        const __m256i ones = _mm256_set1_epi16(1);
+        const __m256 scale = _mm256_set1_ps(1.0f / 65536.0f);
+        for (; i + 8 <= frames; i += 8) {
+            const __m256i pcm = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + 2 * i));
+            const __m256i sums = _mm256_madd_epi16(pcm, ones);
+            _mm256_storeu_ps(output + i, _mm256_mul_ps(_mm256_cvtepi32_ps(sums), scale));
+        }
+    }
+    Scalar::int16ToFloat(input + i * channels, frames - i, channels, output + i);
+}
+
+/**
+ * 一次计算 8 个输出：位置在 double 中计算（与参考实现相同的舍入），
+ * 再用 gather 取相邻两个样本做插值
+ */
+void resampleLinearAvx2(const float* input, size_t inputLength, double step, float* output, size_t begin, size_t end) {
+    // gather 下标为 int32，超长输入直接使用参考实现
+    if (inputLength == 0 || inputLength > static_cast<size_t>(INT_MAX)) {
+        Scalar::resampleLinear(input, inputLength, step, output, begin, end);
+        return;
+    }
+    const __m256d steps = _mm256_set1_pd(step);
+    const __m256d laneOffsets = _mm256_set_pd(3.0, 2.0, 1.0, 0.0);
+    const __m256i last = _mm256_set1_epi32(static_cast<int>(inputLength - 1));
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256 ones = _mm256_set1_ps(1.0f);
+
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        const __m256d base = _mm256_set1_pd(static_cast<double>(i));
+        const __m256d positionLow = _mm256_mul_pd(_mm256_add_pd(base, laneOffsets), steps);
+        const __m256d positionHigh = _mm256_mul_pd(_mm256_add_pd(base, _mm256_add_pd(laneOffsets, _mm256_set1_pd(4.0))), steps);
+        // 位置非负，截断即向下取整
+        const __m128i indexLow = _mm256_cvttpd_epi32(positionLow);
+        const __m128i indexHigh = _mm256_cvttpd_epi32(positionHigh);
+        const __m128 fractionLow = _mm256_cvtpd_ps(_mm256_sub_pd(positionLow, _mm256_cvtepi32_pd(indexLow)));
+        const __m128 fractionHigh = _mm256_cvtpd_ps(_mm256_sub_pd(positionHigh, _mm256_cvtepi32_pd(indexHigh)));
+
+        const __m256i index = _mm256_inserti128_si256(_mm256_castsi128_si256(indexLow), indexHigh, 1);
+        const __m256i next = _mm256_min_epi32(_mm256_add_epi32(index, one), last);
+        const __m256 fraction = _mm256_insertf128_ps(_mm256_castps128_ps256(fractionLow), fractionHigh, 1);
+
+        const __m256 current = _mm256_i32gather_ps(input, index, 4);
+        const __m256 following = _mm256_i32gather_ps(input, next, 4);
+        const __m256 value = _mm256_add_ps(_mm256_mul_ps(current, _mm256_sub_ps(ones, fraction)), _mm256_mul_ps(following, fraction));
+        _mm256_storeu_ps(output + i, value);
+    }
+    Scalar::resampleLinear(input, inputLength, step, output, i, end);
+}
+
+void frameEnergyAvx2(const float* input, size_t frameCount, size_t frameSize, float* output) {
+    for (size_t frame = 0; frame < frameCount; frame++) {
+        const float* samples = input + frame * frameSize;
+        __m256 acc = _mm256_setzero_ps();
+        size_t i = 0;
+        for (; i + 8 <= frameSize; i += 8) {
+            const __m256 v = _mm256_loadu_ps(samples + i);
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(v, v));
+        }
+        __m128 half = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+        half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+        half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 1));
+        float sum = _mm_cvtss_f32(half);
+        for (; i < frameSize; i++) {
+            sum += samples[i] * samples[i];
+        }
+        output[frame] = std::sqrt(sum / static_cast<float>(frameSize));
+    }
+}
+
+} // namespace
+
+void fillAvx2Kernels(KernelTable& table) {
+    table.int16ToFloat = int16ToFloatAvx2;
+    table.int16ToFloatLevel = SimdLevel::Avx2;
+    table.resampleLinear = resampleLinearAvx2;
+    table.resampleLinearLevel = SimdLevel::Avx2;
+    table.frameEnergy = frameEnergyAvx2;
+    table.frameEnergyLevel = SimdLevel::Avx2;
+}
+
+} // namespace AudioDsp
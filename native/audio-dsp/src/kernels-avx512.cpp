@@ -0,0 +1,56 @@
+// 编译参数: -mavx512f -mavx512bw（见 binding.gyp 中的 audio_dsp_avx512）
+#include "kernels.h"
+
+#include <cmath>
+#include <immintrin.h>
+
+namespace AudioDsp {
+namespace {
+
+void int16ToFloatAvx512(const int16_t* input, size_t frames, int channels, float* output) {
+    size_t i = 0;
+    if (channels == 1) {
+        const __m512 scale = _mm512_set1_ps(1.0f / 32768.0f);
+        for (; i + 16 <= frames; i += 16) {
+            const __m256i pcm = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input + i));
+            _mm512_storeu_ps(output + i, _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(pcm)), scale));
+        }
+    } else if (channels == 2) {
+        const __m512i ones = _mm512_set1_epi16(1);
+        const __m512 scale = _mm512_set1_ps(1.0f / 65536.0f);
+        for (; i + 16 <= frames; i += 16) {
+            const __m512i pcm = _mm512_loadu_si512(input + 2 * i);
+            const __m512i sums = _mm512_madd_epi16(pcm, ones);
+            _mm512_storeu_ps(output + i, _mm512_mul_ps(_mm512_cvtepi32_ps(sums), scale));
+        }
+    }
+    Scalar::int16ToFloat(input + i * channels, frames - i, channels, output + i);
+}
+
+void frameEnergyAvx512(const float* input, size_t frameCount, size_t frameSize, float* output) {
+    for (size_t frame = 0; frame < frameCount; frame++) {
+        const float* samples = input + frame * frameSize;
+        __m512 acc = _mm512_setzero_ps();
+        size_t i = 0;
+        for (; i + 16 <= frameSize; i += 16) {
+            const __m512 v = _mm512_loadu_ps(samples + i);
+            acc = _mm512_add_ps(acc, _mm512_mul_ps(v, v));
+        }
+        float sum = _mm512_reduce_add_ps(acc);
+        for (; i < frameSize; i++) {
+            sum += samples[i] * samples[i];
+        }
+        output[frame] = std::sqrt(sum / static_cast<float>(frameSize));
+    }
+}
+
+} // namespace
+
+void fillAvx512Kernels(KernelTable& table) {
+    table.int16ToFloat = int16ToFloatAvx512;
+    table.int16ToFloatLevel = SimdLevel::Avx512;
+    table.frameEnergy = frameEnergyAvx512;
+    table.frameEnergyLevel = SimdLevel::Avx512;
+}
+
+} // namespace AudioDsp
@@ -0,0 +1,61 @@
+// ARM64 基线即包含 NEON，无需额外编译参数
+#include "kernels.h"
+
+#include <arm_neon.h>
+#include <cmath>
+
+namespace AudioDsp {
+namespace {
+
+void int16ToFloatNeon(const int16_t* input, size_t frames, int channels, float* output) {
+    size_t i = 0;
+    if (channels == 1) {
+        const float32x4_t scale = vdupq_n_f32(1.0f / 32768.0f);
+        for (; i + 8 <= frames; i += 8) {
+            const int16x8_t pcm = vld1q_s16(input + i);
+            const int32x4_t low = vmovl_s16(vget_low_s16(pcm));
+            const int32x4_t high = vmovl_s16(vget_high_s16(pcm));
+            vst1q_f32(output + i, vmulq_f32(vcvtq_f32_s32(low), scale));
+            vst1q_f32(output + i + 4, vmulq_f32(vcvtq_f32_s32(high), scale));
+        }
+    } else if (channels == 2) {
+        // 解交错后整数相加（精确）再乘以 2^-16，与参考实现逐位一致
+        const float32x4_t scale = vdupq_n_f32(1.0f / 65536.0f);
+        for (; i + 8 <= frames; i += 8) {
+            const int16x8x2_t pcm = vld2q_s16(input + 2 * i);
+            const int32x4_t low = vaddl_s16(vget_low_s16(pcm.val[0]), vget_low_s16(pcm.val[1]));
+            const int32x4_t high = vaddl_s16(vget_high_s16(pcm.val[0]), vget_high_s16(pcm.val[1]));
+            vst1q_f32(output + i, vmulq_f32(vcvtq_f32_s32(low), scale));
+            vst1q_f32(output + i + 4, vmulq_f32(vcvtq_f32_s32(high), scale));
+        }
+    }
+    Scalar::int16ToFloat(input + i * channels, frames - i, channels, output + i);
+}
+
+void frameEnergyNeon(const float* input, size_t frameCount, size_t frameSize, float* output) {
+    for (size_t frame = 0; frame < frameCount; frame++) {
+        const float* samples = input + frame * frameSize;
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        size_t i = 0;
+        for (; i + 4 <= frameSize; i += 4) {
+            const float32x4_t v = vld1q_f32(samples + i);
+            acc = vaddq_f32(acc, vmulq_f32(v, v));
+        }
+        float sum = vaddvq_f32(acc);
+        for (; i < frameSize; i++) {
+            sum += samples[i] * samples[i];
+        }
+        output[frame] = std::sqrt(sum / static_cast<float>(frameSize));
+    }
+}
+
+} // namespace
+
+void fillNeonKernels(KernelTable& table) {
+    table.int16ToFloat = int16ToFloatNeon;
+    table.int16ToFloatLevel = SimdLevel::Neon;
+    table.frameEnergy = frameEnergyNeon;
+    table.frameEnergyLevel = SimdLevel::Neon;
+}
+
+} // namespace AudioDsp
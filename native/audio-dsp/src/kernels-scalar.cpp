@@ -0,0 +1,70 @@
+#include "kernels.h"
+
+#include <cmath>
+
+namespace AudioDsp {
+namespace Scalar {
+
+// 2^-15：int16 乘以该值在 float 中是精确的，SIMD 版本因此可以与参考实现逐位一致
+static const float kInt16Scale = 1.0f / 32768.0f;
+
+void int16ToFloat(const int16_t* input, size_t frames, int channels, float* output) {
+    if (channels == 1) {
+        for (size_t i = 0; i < frames; i++) {
+            output[i] = static_cast<float>(input[i]) * kInt16Scale;
+        }
+        return;
+    }
+    if (channels == 2) {
+        // 两个 int16 之和在 float 中同样精确，等价于整数相加后缩放
+        for (size_t i = 0; i < frames; i++) {
+            const float left = static_cast<float>(input[2 * i]) * kInt16Scale;
+            const float right = static_cast<float>(input[2 * i + 1]) * kInt16Scale;
+            output[i] = (left + right) * 0.5f;
+        }
+        return;
+    }
+    for (size_t i = 0; i < frames; i++) {
+        float sum = 0.0f;
+        for (int ch = 0; ch < channels; ch++) {
+            sum += static_cast<float>(input[i * channels + ch]) * kInt16Scale;
+        }
+        output[i] = sum / static_cast<float>(channels);
+    }
+}
+
+void resampleLinear(const float* input, size_t inputLength, double step, float* output, size_t begin, size_t end) {
+    if (inputLength == 0) return;
+    const size_t last = inputLength - 1;
+    for (size_t i = begin; i < end; i++) {
+        const double position = static_cast<double>(i) * step;
+        const size_t index = static_cast<size_t>(position);
+        const size_t next = index + 1 < last ? index + 1 : last;
+        const float fraction = static_cast<float>(position - static_cast<double>(index));
+        output[i] = input[index] * (1.0f - fraction) + input[next] * fraction;
+    }
+}
+
+void frameEnergy(const float* input, size_t frameCount, size_t frameSize, float* output) {
+    for (size_t frame = 0; frame < frameCount; frame++) {
+        const float* samples = input + frame * frameSize;
+        float sum = 0.0f;
+        for (size_t i = 0; i < frameSize; i++) {
+            sum += samples[i] * samples[i];
+        }
+        output[frame] = std::sqrt(sum / static_cast<float>(frameSize));
+    }
+}
+
+} // namespace Scalar
+
+void fillScalarKernels(KernelTable& table) {
+    table.int16ToFloat = Scalar::int16ToFloat;
+    table.int16ToFloatLevel = SimdLevel::Scalar;
+    table.resampleLinear = Scalar::resampleLinear;
+    table.resampleLinearLevel = SimdLevel::Scalar;
+    table.frameEnergy = Scalar::frameEnergy;
+    table.frameEnergyLevel = SimdLevel::Scalar;
+}
+
+} // namespace AudioDsp
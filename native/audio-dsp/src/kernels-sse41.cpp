@@ -0,0 +1,62 @@
+// 编译参数: -msse4.1（见 binding.gyp 中的 audio_dsp_sse41）
+#include "kernels.h"
+
+#include <cmath>
+#include <smmintrin.h>
+
+namespace AudioDsp {
+namespace {
+
+void int16ToFloatSse41(const int16_t* input, size_t frames, int channels, float* output) {
+    size_t i = 0;
+    if (channels == 1) {
+        const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+        for (; i + 8 <= frames; i += 8) {
+            const __m128i pcm = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+            const __m128i low = _mm_cvtepi16_epi32(pcm);
+            const __m128i high = _mm_cvtepi16_epi32(_mm_srli_si128(pcm, 8));
+            _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+            _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+        }
+    } else if (channels == 2) {
+        // 相邻左右声道整数相加（精确）后乘以 2^-16，与参考实现逐位一致
+        const __m128i ones = _mm_set1_epi16(1);
+        const __m128 scale = _mm_set1_ps(1.0f / 65536.0f);
+        for (; i + 4 <= frames; i += 4) {
+            const __m128i pcm = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + 2 * i));
+            const __m128i sums = _mm_madd_epi16(pcm, ones);
+            _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(sums), scale));
+        }
+    }
+    Scalar::int16ToFloat(input + i * channels, frames - i, channels, output + i);
+}
+
+void frameEnergySse41(const float* input, size_t frameCount, size_t frameSize, float* output) {
+    for (size_t frame = 0; frame < frameCount; frame++) {
+        const float* samples = input + frame * frameSize;
+        __m128 acc = _mm_setzero_ps();
+        size_t i = 0;
+        for (; i + 4 <= frameSize; i += 4) {
+            const __m128 v = _mm_loadu_ps(samples + i);
+            acc = _mm_add_ps(acc, _mm_mul_ps(v, v));
+        }
+        acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+        acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+        float sum = _mm_cvtss_f32(acc);
+        for (; i < frameSize; i++) {
+            sum += samples[i] * samples[i];
+        }
+        output[frame] = std::sqrt(sum / static_cast<float>(frameSize));
+    }
+}
+
+} // namespace
+
+void fillSse41Kernels(KernelTable& table) {
+    table.int16ToFloat = int16ToFloatSse41;
+    table.int16ToFloatLevel = SimdLevel::Sse41;
+    table.frameEnergy = frameEnergySse41;
+    table.frameEnergyLevel = SimdLevel::Sse41;
+}
+
+} // namespace AudioDsp
@@ -0,0 +1,79 @@
+#ifndef AUDIO_DSP_KERNELS_H
+#define AUDIO_DSP_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define AUDIO_DSP_X86 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define AUDIO_DSP_ARM64 1
+#endif
+
+namespace AudioDsp {
+
+/**
+ * 内核实现所用的指令集级别
+ * x86 依次为 SSE4.1 / AVX2 / AVX-512，ARM64 为 NEON；Scalar 为参考实现
+ */
+enum class SimdLevel : int {
+    Scalar = 0,
+    Sse41,
+    Avx2,
+    Avx512,
+    Neon,
+    Count,
+};
+
+/**
+ * 16-bit 交错 PCM 转单声道 float（[-1, 1)），多声道取平均
+ * input 含 frames * channels 个样本，output 含 frames 个样本
+ */
+using Int16ToFloatFn = void (*)(const int16_t* input, size_t frames, int channels, float* output);
+
+/**
+ * 线性插值重采样，只计算 output[begin, end)
+ * output[i] = input[k] * (1 - t) + input[k + 1] * t，其中 k + t = i * step
+ * 按区间计算便于调用方切分给多个线程
+ */
+using ResampleLinearFn = void (*)(const float* input, size_t inputLength, double step, float* output, size_t begin, size_t end);
+
+/**
+ * 按帧计算均方根能量，output 含 frameCount 个值
+ */
+using FrameEnergyFn = void (*)(const float* input, size_t frameCount, size_t frameSize, float* output);
+
+/**
+ * 函数指针表：高一级的表从低一级复制后只覆盖已实现的内核，
+ * 未实现的内核沿用低一级版本，各内核实际使用的级别单独记录
+ */
+struct KernelTable {
+    SimdLevel level;
+    Int16ToFloatFn int16ToFloat;
+    SimdLevel int16ToFloatLevel;
+    ResampleLinearFn resampleLinear;
+    SimdLevel resampleLinearLevel;
+    FrameEnergyFn frameEnergy;
+    SimdLevel frameEnergyLevel;
+};
+
+void fillScalarKernels(KernelTable& table);
+#if defined(AUDIO_DSP_X86)
+void fillSse41Kernels(KernelTable& table);
+void fillAvx2Kernels(KernelTable& table);
+void fillAvx512Kernels(KernelTable& table);
+#endif
+#if defined(AUDIO_DSP_ARM64)
+void fillNeonKernels(KernelTable& table);
+#endif
+
+// 参考实现：SIMD 版本用它处理尾部样本，也用于校验
+namespace Scalar {
+void int16ToFloat(const int16_t* input, size_t frames, int channels, float* output);
+void resampleLinear(const float* input, size_t inputLength, double step, float* output, size_t begin, size_t end);
+void frameEnergy(const float* input, size_t frameCount, size_t frameSize, float* output);
+} // namespace Scalar
+
+} // namespace AudioDsp
+
+#endif // AUDIO_DSP_KERNELS_H
@@ -0,0 +1,21 @@
+#include "parallel-kernels.h"
+
+namespace AudioDsp {
+
+void int16ToFloatParallel(const KernelTable& table, const int16_t* input, size_t frames, int channels, float* output,
+                          size_t blockSize) {
+    const Int16ToFloatFn kernel = table.int16ToFloat;
+    parallelFor(frames, blockSize, [=](size_t begin, size_t end) {
+        kernel(input + begin * static_cast<size_t>(channels), end - begin, channels, output + begin);
+    });
+}
+
+void resampleLinearParallel(const KernelTable& table, const float* input, size_t inputLength, double step, float* output,
+                            size_t outputLength, size_t blockSize) {
+    const ResampleLinearFn kernel = table.resampleLinear;
+    parallelFor(outputLength, blockSize, [=](size_t begin, size_t end) {
+        kernel(input, inputLength, step, output, begin, end);
+    });
+}
+
+} // namespace AudioDsp
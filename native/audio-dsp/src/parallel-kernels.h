@@ -0,0 +1,25 @@
+#ifndef AUDIO_DSP_PARALLEL_KERNELS_H
+#define AUDIO_DSP_PARALLEL_KERNELS_H
+
+#include "kernels.h"
+#include "thread-pool.h"
+
+namespace AudioDsp {
+
+/**
+ * 分块并行的格式转换：按帧切块，每块独立调用内核并原地写入输出，结果与串行一致
+ */
+void int16ToFloatParallel(const KernelTable& table, const int16_t* input, size_t frames, int channels, float* output,
+                          size_t blockSize = kParallelBlockSize);
+
+/**
+ * 分块并行的线性重采样：按输出区间切块
+ * 每个输出只依赖 input[k] 与 input[k + 1]（滤波长度 2），各块直接读取共享输入，
+ * 块边界处自然包含 1 个样本的重叠，结果与串行逐位一致
+ */
+void resampleLinearParallel(const KernelTable& table, const float* input, size_t inputLength, double step, float* output,
+                            size_t outputLength, size_t blockSize = kParallelBlockSize);
+
+} // namespace AudioDsp
+
+#endif // AUDIO_DSP_PARALLEL_KERNELS_H
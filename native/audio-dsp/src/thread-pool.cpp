@@ -0,0 +1,148 @@
+#include "thread-pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace AudioDsp {
+namespace {
+
+const size_t kMaxThreads = 16;
+
+size_t resolveThreadCount() {
+    const char* override = std::getenv("SPEECHTIDE_DSP_THREADS");
+    if (override != nullptr) {
+        const long value = std::strtol(override, nullptr, 10);
+        if (value >= 1) return std::min(static_cast<size_t>(value), kMaxThreads);
+    }
+    const unsigned hardware = std::thread::hardware_concurrency();
+    return std::max<size_t>(1, std::min<size_t>(hardware == 0 ? 1 : hardware, kMaxThreads));
+}
+
+/**
+ * 常驻线程池：首次并行时创建，之后复用
+ * 同一时刻只执行一个任务，并发的 parallelFor 调用排队
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threadCount) : threadCount_(threadCount) {
+        // 调用线程也参与执行，只需额外创建 threadCount - 1 个线程
+        for (size_t i = 1; i < threadCount; i++) {
+            // 进程退出时不等待空闲线程，避免卸载时阻塞
+            std::thread(&ThreadPool::workerLoop, this).detach();
+        }
+    }
+
+    size_t threadCount() const { return threadCount_; }
+
+    void run(size_t total, size_t blockSize, const std::function<void(size_t, size_t)>& fn) {
+        std::lock_guard<std::mutex> runLock(runMutex_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = &fn;
+            total_ = total;
+            blockSize_ = blockSize;
+            blockCount_ = (total + blockSize - 1) / blockSize;
+            nextBlock_.store(0, std::memory_order_relaxed);
+            pendingBlocks_ = blockCount_;
+            generation_++;
+        }
+        wake_.notify_all();
+
+        drain();
+
+        // 还要等所有领取过本任务的线程退出，避免迟到的线程误用下一个任务的计数器
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return pendingBlocks_ == 0 && activeThreads_ == 0; });
+        task_ = nullptr;
+    }
+
+private:
+    void workerLoop() {
+        size_t seenGeneration = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&] { return generation_ != seenGeneration; });
+                seenGeneration = generation_;
+            }
+            drain();
+        }
+    }
+
+    /**
+     * 领取并执行块，直到没有剩余
+     */
+    void drain() {
+        const std::function<void(size_t, size_t)>* task;
+        size_t total;
+        size_t blockSize;
+        size_t blockCount;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (task_ == nullptr) return;
+            activeThreads_++;
+            task = task_;
+            total = total_;
+            blockSize = blockSize_;
+            blockCount = blockCount_;
+        }
+
+        size_t completed = 0;
+        for (;;) {
+            const size_t block = nextBlock_.fetch_add(1, std::memory_order_relaxed);
+            if (block >= blockCount) break;
+            const size_t begin = block * blockSize;
+            (*task)(begin, std::min(begin + blockSize, total));
+            completed++;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        pendingBlocks_ -= completed;
+        activeThreads_--;
+        if (pendingBlocks_ == 0 && activeThreads_ == 0) done_.notify_all();
+    }
+
+    const size_t threadCount_;
+    std::mutex runMutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const std::function<void(size_t, size_t)>* task_ = nullptr;
+    size_t total_ = 0;
+    size_t blockSize_ = 0;
+    size_t blockCount_ = 0;
+    std::atomic<size_t> nextBlock_{0};
+    size_t pendingBlocks_ = 0;
+    size_t activeThreads_ = 0;
+    size_t generation_ = 0;
+};
+
+ThreadPool& pool() {
+    // 有意不析构：常驻线程随进程结束
+    static ThreadPool* instance = new ThreadPool(resolveThreadCount());
+    return *instance;
+}
+
+} // namespace
+
+size_t parallelThreadCount() {
+    static const size_t count = resolveThreadCount();
+    return count;
+}
+
+void parallelFor(size_t total, size_t blockSize, const std::function<void(size_t begin, size_t end)>& fn) {
+    if (total == 0) return;
+    if (blockSize == 0) blockSize = kParallelBlockSize;
+    if (parallelThreadCount() <= 1 || total < 2 * blockSize) {
+        fn(0, total);
+        return;
+    }
+    pool().run(total, blockSize, fn);
+}
+
+} // namespace AudioDsp
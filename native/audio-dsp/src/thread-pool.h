@@ -0,0 +1,27 @@
+#ifndef AUDIO_DSP_THREAD_POOL_H
+#define AUDIO_DSP_THREAD_POOL_H
+
+#include <cstddef>
+#include <functional>
+
+namespace AudioDsp {
+
+// 默认块大小（样本数），总量不足两块时直接在调用线程串行执行
+const size_t kParallelBlockSize = 64 * 1024;
+
+/**
+ * 把 [0, total) 切成 blockSize 大小的块并行执行 fn(begin, end)
+ * 调用线程也参与执行，各线程从共享计数器领取下一块（先完成的线程自动多领），
+ * 全部块完成后返回。fn 只能写入自己负责的区间
+ */
+void parallelFor(size_t total, size_t blockSize, const std::function<void(size_t begin, size_t end)>& fn);
+
+/**
+ * 参与并行的线程数（含调用线程）
+ * 默认取 CPU 逻辑核数，环境变量 SPEECHTIDE_DSP_THREADS 可覆盖，1 表示始终串行
+ */
+size_t parallelThreadCount();
+
+} // namespace AudioDsp
+
+#endif // AUDIO_DSP_THREAD_POOL_H
@@ -0,0 +1,190 @@
+#include "verify.h"
+
+#include "dispatch.h"
+#include "parallel-kernels.h"
+
+#include <cmath>
+#include <cstdint>
+
+namespace AudioDsp {
+namespace {
+
+const double kResampleTolerance = 1e-6;
+const double kEnergyRelativeTolerance = 1e-4;
+
+/**
+ * 线性同余生成器，保证每次校验使用相同数据
+ */
+class Lcg {
+public:
+    explicit Lcg(uint32_t seed) : state_(seed) {}
+
+    uint32_t next() {
+        state_ = state_ * 1664525u + 1013904223u;
+        return state_;
+    }
+
+    int16_t nextInt16() { return static_cast<int16_t>(next() >> 16); }
+
+    float nextFloat() { return static_cast<float>(next() >> 8) / 8388608.0f - 1.0f; }
+
+private:
+    uint32_t state_;
+};
+
+struct Comparison {
+    double maxAbsError = 0.0;
+    double maxRelError = 0.0;
+    bool exact = true;
+};
+
+void compare(const std::vector<float>& actual, const std::vector<float>& expected, Comparison& result) {
+    for (size_t i = 0; i < expected.size(); i++) {
+        if (actual[i] != expected[i]) result.exact = false;
+        const double diff = std::fabs(static_cast<double>(actual[i]) - static_cast<double>(expected[i]));
+        if (diff > result.maxAbsError) result.maxAbsError = diff;
+        const double magnitude = std::fabs(static_cast<double>(expected[i]));
+        if (magnitude > 0.0 && diff / magnitude > result.maxRelError) result.maxRelError = diff / magnitude;
+    }
+}
+
+// 长度刻意取非向量宽度整数倍，覆盖尾部处理
+const size_t kFrameCounts[] = {0, 1, 7, 15, 33, 1021, 4099};
+const int kChannelCounts[] = {1, 2, 3};
+
+Comparison checkInt16ToFloat(const KernelTable& table) {
+    Comparison result;
+    Lcg rng(0x5eed0001u);
+    for (int channels : kChannelCounts) {
+        for (size_t frames : kFrameCounts) {
+            std::vector<int16_t> input(frames * channels);
+            for (size_t i = 0; i < input.size(); i++) {
+                // 穿插极值
+                const uint32_t pick = i % 17;
+                input[i] = pick == 0 ? INT16_MIN : pick == 1 ? INT16_MAX : rng.nextInt16();
+            }
+            std::vector<float> expected(frames);
+            std::vector<float> actual(frames);
+            Scalar::int16ToFloat(input.data(), frames, channels, expected.data());
+            table.int16ToFloat(input.data(), frames, channels, actual.data());
+            compare(actual, expected, result);
+        }
+    }
+    return result;
+}
+
+Comparison checkResampleLinear(const KernelTable& table) {
+    Comparison result;
+    Lcg rng(0x5eed0002u);
+    const double steps[] = {44100.0 / 16000.0, 48000.0 / 16000.0, 8000.0 / 16000.0, 22050.0 / 16000.0, 1.0};
+    for (double step : steps) {
+        for (size_t length : kFrameCounts) {
+            if (length == 0) continue;
+            std::vector<float> input(length);
+            for (float& sample : input) sample = rng.nextFloat();
+            const size_t outputLength = static_cast<size_t>(std::floor(static_cast<double>(length) / step));
+            std::vector<float> expected(outputLength);
+            std::vector<float> actual(outputLength);
+            Scalar::resampleLinear(input.data(), length, step, expected.data(), 0, outputLength);
+            table.resampleLinear(input.data(), length, step, actual.data(), 0, outputLength);
+            compare(actual, expected, result);
+            // 非零起点的区间，对应多线程切分后的一段
+            if (outputLength > 8) {
+                const size_t begin = outputLength / 3;
+                std::vector<float> partial(outputLength, 0.0f);
+                table.resampleLinear(input.data(), length, step, partial.data(), begin, outputLength);
+                std::vector<float> expectedTail(expected.begin() + begin, expected.end());
+                std::vector<float> actualTail(partial.begin() + begin, partial.end());
+                compare(actualTail, expectedTail, result);
+            }
+        }
+    }
+    return result;
+}
+
+Comparison checkFrameEnergy(const KernelTable& table) {
+    Comparison result;
+    Lcg rng(0x5eed0003u);
+    const size_t frameSizes[] = {1, 3, 160, 400, 511};
+    for (size_t frameSize : frameSizes) {
+        const size_t frameCount = 13;
+        std::vector<float> input(frameCount * frameSize);
+        for (float& sample : input) sample = rng.nextFloat();
+        std::vector<float> expected(frameCount);
+        std::vector<float> actual(frameCount);
+        Scalar::frameEnergy(input.data(), frameCount, frameSize, expected.data());
+        table.frameEnergy(input.data(), frameCount, frameSize, actual.data());
+        compare(actual, expected, result);
+    }
+    return result;
+}
+
+/**
+ * 分块并行与串行结果比对：用小块强制切分，要求逐位一致
+ */
+Comparison checkInt16ToFloatParallel(const KernelTable& table) {
+    Comparison result;
+    Lcg rng(0x5eed0004u);
+    const size_t frames = 50021;
+    const int channels = 2;
+    std::vector<int16_t> input(frames * channels);
+    for (int16_t& sample : input) sample = rng.nextInt16();
+    std::vector<float> expected(frames);
+    std::vector<float> actual(frames);
+    table.int16ToFloat(input.data(), frames, channels, expected.data());
+    int16ToFloatParallel(table, input.data(), frames, channels, actual.data(), 4099);
+    compare(actual, expected, result);
+    return result;
+}
+
+Comparison checkResampleLinearParallel(const KernelTable& table) {
+    Comparison result;
+    Lcg rng(0x5eed0005u);
+    const size_t length = 100003;
+    std::vector<float> input(length);
+    for (float& sample : input) sample = rng.nextFloat();
+    const double steps[] = {44100.0 / 16000.0, 8000.0 / 16000.0};
+    for (double step : steps) {
+        const size_t outputLength = static_cast<size_t>(std::floor(static_cast<double>(length) / step));
+        std::vector<float> expected(outputLength);
+        std::vector<float> actual(outputLength);
+        table.resampleLinear(input.data(), length, step, expected.data(), 0, outputLength);
+        resampleLinearParallel(table, input.data(), length, step, actual.data(), outputLength, 4093);
+        compare(actual, expected, result);
+    }
+    return result;
+}
+
+} // namespace
+
+std::vector<KernelCheck> verifyKernels() {
+    std::vector<KernelCheck> checks;
+    for (int i = 1; i < static_cast<int>(SimdLevel::Count); i++) {
+        const SimdLevel level = static_cast<SimdLevel>(i);
+        const KernelTable* table = kernelsFor(level);
+        if (table == nullptr) continue;
+
+        // 沿用低一级实现的内核已在对应级别校验过
+        if (table->int16ToFloatLevel == level) {
+            const Comparison c = checkInt16ToFloat(*table);
+            checks.push_back({level, "int16ToFloat", c.maxAbsError, c.exact, c.exact});
+        }
+        if (table->resampleLinearLevel == level) {
+            const Comparison c = checkResampleLinear(*table);
+            checks.push_back({level, "resampleLinear", c.maxAbsError, c.exact, c.maxAbsError <= kResampleTolerance});
+        }
+        if (table->frameEnergyLevel == level) {
+            const Comparison c = checkFrameEnergy(*table);
+            checks.push_back({level, "frameEnergy", c.maxAbsError, c.exact, c.maxRelError <= kEnergyRelativeTolerance});
+        }
+    }
+
+    const KernelTable& active = kernels();
+    const Comparison convert = checkInt16ToFloatParallel(active);
+    checks.push_back({active.level, "int16ToFloat/parallel", convert.maxAbsError, convert.exact, convert.exact});
+    const Comparison resample = checkResampleLinearParallel(active);
+    checks.push_back({active.level, "resampleLinear/parallel", resample.maxAbsError, resample.exact, resample.exact});
+    return checks;
+}
+
+} // namespace AudioDsp
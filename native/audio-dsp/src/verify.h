@@ -0,0 +1,28 @@
+#ifndef AUDIO_DSP_VERIFY_H
+#define AUDIO_DSP_VERIFY_H
+
+#include "kernels.h"
+
+#include <vector>
+
+namespace AudioDsp {
+
+struct KernelCheck {
+    SimdLevel level;
+    const char* kernel;
+    double maxAbsError;
+    // 与参考实现逐位一致
+    bool exact;
+    bool passed;
+};
+
+/**
+ * 用确定性数据对比本机各可用级别的内核与参考实现
+ * 格式转换要求逐位一致；重采样允许 1e-6 绝对误差；能量因累加顺序不同允许 1e-4 相对误差
+ * 另对当前级别比对分块并行与串行结果，要求逐位一致
+ */
+std::vector<KernelCheck> verifyKernels();
+
+} // namespace AudioDsp
+
+#endif // AUDIO_DSP_VERIFY_H
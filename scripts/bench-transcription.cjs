@@ -0,0 +1,373 @@
+#!/usr/bin/env node
+/**
+ * 离线转写基准测试（无需启动 Electron）
+ *
+ * 对目录中的 WAV 文件运行完整识别流程：解析 → 重采样 → VAD 分段 → 特征提取 → 解码，
+ * 输出各阶段耗时、实时率（RTF）、单文件延迟分位数与峰值内存（JSON）。
+ * 解析与 VAD 与识别 worker 使用同一份实现（electron/transcriber/*.cjs）。
+ *
+ * 用法:
+ *   node scripts/bench-transcription.cjs --corpus <目录> [--model-dir <目录>] [--model model.onnx]
+ *       [--threads 2] [--runs 1] [--no-vad] [--no-decode] [--out result.json]
+ *   node scripts/bench-transcription.cjs --compare base.json head.json [--threshold 5] [--fail-on-regression]
+ *
+ * 合成语料可用 scripts/generate-bench-corpus.cjs 生成。
+ */
+
+const fs = require('fs')
+const os = require('os')
+const path = require('path')
+const crypto = require('crypto')
+const { readWaveFile, resampleLinear } = require('../electron/transcriber/wave-reader.cjs')
+const { VadSegmenter, joinSegmentTexts } = require('../electron/transcriber/vad-segmenter.cjs')
+
+const TARGET_SAMPLE_RATE = 16000
+const STAGES = ['parse', 'resample', 'vad', 'features', 'decode']
+const MODEL_VARIANTS = ['model.onnx', 'model.int8.onnx']
+
+function parseArgs(argv) {
+  const args = { threads: 2, runs: 1, vad: true, decode: true, threshold: 5, failOnRegression: false, language: 'zh' }
+  for (let i = 0; i < argv.length; i++) {
+    const key = argv[i]
+    const value = argv[i + 1]
+    switch (key) {
+      case '--corpus': args.corpus = value; i++; break
+      case '--model-dir': args.modelDir = value; i++; break
+      case '--model': args.model = value; i++; break
+      case '--tokens': args.tokens = value; i++; break
+      case '--threads': args.threads = Number(value); i++; break
+      case '--runs': args.runs = Math.max(1, Number(value)); i++; break
+      case '--language': args.language = value; i++; break
+      case '--out': args.out = value; i++; break
+      case '--threshold': args.threshold = Number(value); i++; break
+      case '--compare': args.compare = [value, argv[i + 2]]; i += 2; break
+      case '--no-vad': args.vad = false; break
+      case '--no-decode': args.decode = false; break
+      case '--fail-on-regression': args.failOnRegression = true; break
+      case '--help':
+      case '-h':
+        console.log(fs.readFileSync(__filename, 'utf-8').split('\n').slice(2, 14).join('\n'))
+        process.exit(0)
+        break
+      default:
+        break
+    }
+  }
+  return args
+}
+
+// ============ 模型定位（与应用默认路径一致） ============
+
+function defaultSupportDir() {
+  if (process.platform === 'darwin') return path.join(os.homedir(), 'Library', 'Application Support', 'SpeechTide')
+  if (process.platform === 'win32') return path.join(os.homedir(), 'AppData', 'Roaming', 'SpeechTide')
+  return path.join(os.homedir(), '.config', 'SpeechTide')
+}
+
+/**
+ * 优先使用应用已补齐元数据的模型副本（models/patched/manifest.json）
+ */
+function resolveModel(args) {
+  const supportDir = defaultSupportDir()
+  const modelDir = path.resolve(args.modelDir || path.join(supportDir, 'models', 'sensevoice-small'))
+  const variants = args.model ? [args.model] : MODEL_VARIANTS
+  const sourcePath = variants.map((variant) => path.resolve(modelDir, variant)).find((candidate) => fs.existsSync(candidate))
+  if (!sourcePath) {
+    throw new Error(`未找到模型文件（${variants.join(', ')}），请用 --model-dir 指定模型目录`)
+  }
+
+  let modelPath = sourcePath
+  try {
+    const manifest = JSON.parse(fs.readFileSync(path.join(supportDir, 'models', 'patched', 'manifest.json'), 'utf-8'))
+    const patched = manifest[sourcePath]?.patchedPath
+    if (patched && fs.existsSync(patched)) modelPath = patched
+  } catch {
+    // 没有补丁清单时直接使用源模型
+  }
+
+  const tokensPath = resolveTokens(args.tokens, modelDir, supportDir)
+  return { modelPath, sourcePath, tokensPath }
+}
+
+function resolveTokens(explicit, modelDir, supportDir) {
+  const candidates = [explicit, path.join(modelDir, 'tokens.txt'), path.join(supportDir, 'cache', 'sensevoice-tokens.txt')]
+  const existing = candidates.find((candidate) => candidate && fs.existsSync(candidate))
+  if (existing) return path.resolve(existing)
+
+  const jsonPath = path.join(modelDir, 'tokens.json')
+  if (!fs.existsSync(jsonPath)) {
+    throw new Error('未找到 tokens.txt / tokens.json，请用 --tokens 指定')
+  }
+  const tokens = JSON.parse(fs.readFileSync(jsonPath, 'utf-8'))
+  const converted = path.join(os.tmpdir(), 'speechtide-bench-tokens.txt')
+  fs.writeFileSync(converted, tokens.map((token, index) => `${token} ${index}`).join('\n'), 'utf-8')
+  return converted
+}
+
+function createRecognizer(model, args) {
+  const sherpa = require('sherpa-onnx-node')
+  const senseVoice = { model: model.modelPath, useInverseTextNormalization: 1 }
+  if (args.language && args.language !== 'auto') senseVoice.language = args.language
+  return new sherpa.OfflineRecognizer({
+    featConfig: { sampleRate: TARGET_SAMPLE_RATE, featureDim: 80 },
+    modelConfig: { senseVoice, tokens: model.tokensPath, numThreads: args.threads, provider: 'cpu', debug: 0 },
+  })
+}
+
+// ============ 流水线 ============
+
+function elapsedMs(startedAt) {
+  return Number(process.hrtime.bigint() - startedAt) / 1e6
+}
+
+/**
+ * 与 worker 的后台转写一致：整段送入 VAD，尾段含语音时补上
+ */
+function splitSegments(samples, useVad) {
+  if (!useVad) return [{ start: 0, end: samples.length }]
+  const segmenter = new VadSegmenter(TARGET_SAMPLE_RATE)
+  const segments = segmenter.push(samples)
+  if (segmenter.openSegmentHasSpeech && segmenter.openSegmentStart < samples.length) {
+    segments.push({ start: segmenter.openSegmentStart, end: samples.length })
+  }
+  return segments
+}
+
+function runFile(filePath, recognizer, args) {
+  const stages = Object.fromEntries(STAGES.map((stage) => [stage, 0]))
+
+  let startedAt = process.hrtime.bigint()
+  const wave = readWaveFile(filePath)
+  stages.parse = elapsedMs(startedAt)
+
+  startedAt = process.hrtime.bigint()
+  const samples = resampleLinear(wave.samples, wave.sampleRate, TARGET_SAMPLE_RATE)
+  stages.resample = elapsedMs(startedAt)
+
+  startedAt = process.hrtime.bigint()
+  const segments = splitSegments(samples, args.vad)
+  stages.vad = elapsedMs(startedAt)
+
+  const texts = []
+  if (recognizer) {
+    for (const segment of segments) {
+      const stream = recognizer.createStream()
+      try {
+        // 离线 stream 在 acceptWaveform 时计算 fbank 特征
+        startedAt = process.hrtime.bigint()
+        stream.acceptWaveform({ sampleRate: TARGET_SAMPLE_RATE, samples: samples.subarray(segment.start, segment.end) })
+        stages.features += elapsedMs(startedAt)
+
+        startedAt = process.hrtime.bigint()
+        recognizer.decode(stream)
+        stages.decode += elapsedMs(startedAt)
+        texts.push(recognizer.getResult(stream).text ?? '')
+      } finally {
+        if (typeof stream.free === 'function') stream.free()
+      }
+    }
+  }
+
+  const audioMs = (samples.length / TARGET_SAMPLE_RATE) * 1000
+  const totalMs = STAGES.reduce((sum, stage) => sum + stages[stage], 0)
+  return {
+    file: path.basename(filePath),
+    sampleRate: wave.sampleRate,
+    audioMs: round(audioMs),
+    segments: segments.length,
+    stages: Object.fromEntries(STAGES.map((stage) => [stage, round(stages[stage])])),
+    totalMs: round(totalMs),
+    rtf: audioMs > 0 ? round(totalMs / audioMs, 4) : null,
+    text: joinSegmentTexts(texts),
+  }
+}
+
+// ============ 统计 ============
+
+function round(value, digits = 2) {
+  const factor = 10 ** digits
+  return Math.round(value * factor) / factor
+}
+
+/** 最近秩法分位数 */
+function percentile(sorted, p) {
+  if (sorted.length === 0) return null
+  const rank = Math.ceil((p / 100) * sorted.length)
+  return sorted[Math.min(sorted.length - 1, Math.max(0, rank - 1))]
+}
+
+function summarizeLatency(values) {
+  const sorted = [...values].sort((a, b) => a - b)
+  const mean = sorted.reduce((sum, value) => sum + value, 0) / Math.max(1, sorted.length)
+  return {
+    p50: percentile(sorted, 50),
+    p95: percentile(sorted, 95),
+    p99: percentile(sorted, 99),
+    mean: round(mean),
+    max: sorted[sorted.length - 1] ?? null,
+  }
+}
+
+function summarize(results, loadMs) {
+  const audioMs = results.reduce((sum, result) => sum + result.audioMs, 0)
+  const totalMs = results.reduce((sum, result) => sum + result.totalMs, 0)
+  const stages = {}
+  for (const stage of STAGES) {
+    const values = results.map((result) => result.stages[stage])
+    const stageTotal = values.reduce((sum, value) => sum + value, 0)
+    stages[stage] = {
+      totalMs: round(stageTotal),
+      share: totalMs > 0 ? round(stageTotal / totalMs, 4) : 0,
+      ...summarizeLatency(values),
+    }
+  }
+  return {
+    files: results.length,
+    audioSec: round(audioMs / 1000),
+    processingSec: round(totalMs / 1000),
+    rtf: audioMs > 0 ? round(totalMs / audioMs, 4) : null,
+    latencyMs: summarizeLatency(results.map((result) => result.totalMs)),
+    stages,
+    loadMs: loadMs === null ? null : round(loadMs),
+    // libuv 已将各平台的 maxRSS 统一为 KB
+    peakRssMB: round(process.resourceUsage().maxRSS / 1024, 1),
+  }
+}
+
+/**
+ * 语料指纹：文件名与大小，比较模式下用于提示两次运行的语料不同
+ */
+function corpusFingerprint(files) {
+  const hash = crypto.createHash('sha256')
+  for (const file of files) {
+    hash.update(`${path.basename(file)}:${fs.statSync(file).size}\n`)
+  }
+  return hash.digest('hex').slice(0, 16)
+}
+
+// ============ 比较模式 ============
+
+/** 越小越好的指标 */
+const COMPARE_METRICS = [
+  ['rtf', (summary) => summary.rtf],
+  ['latency.p50', (summary) => summary.latencyMs.p50],
+  ['latency.p95', (summary) => summary.latencyMs.p95],
+  ['latency.p99', (summary) => summary.latencyMs.p99],
+  // 阶段耗时取单文件均值，两次运行的 --runs 不同也可比较
+  ...STAGES.map((stage) => [`${stage}.mean`, (summary) => summary.stages[stage]?.mean]),
+  ['loadMs', (summary) => summary.loadMs],
+  ['peakRssMB', (summary) => summary.peakRssMB],
+]
+
+function compare(basePath, headPath, args) {
+  const base = JSON.parse(fs.readFileSync(basePath, 'utf-8'))
+  const head = JSON.parse(fs.readFileSync(headPath, 'utf-8'))
+  if (base.meta.corpus !== head.meta.corpus) {
+    console.warn('⚠ 两次运行的语料不同，比较结果仅供参考')
+  }
+
+  const rows = COMPARE_METRICS.map(([name, pick]) => {
+    const before = pick(base.summary)
+    const after = pick(head.summary)
+    const deltaPct = typeof before === 'number' && typeof after === 'number' && before !== 0
+      ? round(((after - before) / before) * 100, 1)
+      : null
+    const verdict = deltaPct === null ? '' : deltaPct > args.threshold ? 'regression' : deltaPct < -args.threshold ? 'improvement' : ''
+    return { metric: name, base: before ?? null, head: after ?? null, deltaPct, verdict }
+  })
+
+  console.log(`\n${'指标'.padEnd(16)}${'base'.padStart(12)}${'head'.padStart(12)}${'变化'.padStart(10)}`)
+  for (const row of rows) {
+    const delta = row.deltaPct === null ? '-' : `${row.deltaPct > 0 ? '+' : ''}${row.deltaPct}%`
+    const mark = row.verdict === 'regression' ? '  ▲ 退化' : row.verdict === 'improvement' ? '  ▼ 改善' : ''
+    console.log(`${row.metric.padEnd(16)}${String(row.base ?? '-').padStart(12)}${String(row.head ?? '-').padStart(12)}${delta.padStart(10)}${mark}`)
+  }
+
+  const report = { base: basePath, head: headPath, thresholdPct: args.threshold, rows }
+  if (args.out) fs.writeFileSync(args.out, JSON.stringify(report, null, 2))
+  const regressions = rows.filter((row) => row.verdict === 'regression')
+  if (args.failOnRegression && regressions.length > 0) {
+    console.error(`\n${regressions.length} 项指标退化超过 ${args.threshold}%`)
+    process.exit(1)
+  }
+}
+
+// ============ 入口 ============
+
+function run(args) {
+  if (!args.corpus) {
+    throw new Error('请用 --corpus 指定 WAV 目录，或用 --compare 比较两次结果')
+  }
+  const files = fs.readdirSync(args.corpus)
+    .filter((name) => name.toLowerCase().endsWith('.wav'))
+    .sort()
+    .map((name) => path.join(args.corpus, name))
+  if (files.length === 0) {
+    throw new Error(`目录中没有 WAV 文件: ${args.corpus}`)
+  }
+
+  let recognizer = null
+  let model = null
+  let loadMs = null
+  if (args.decode) {
+    model = resolveModel(args)
+    const startedAt = process.hrtime.bigint()
+    recognizer = createRecognizer(model, args)
+    loadMs = elapsedMs(startedAt)
+    console.error(`[bench] 模型已加载 (${Math.round(loadMs)}ms): ${path.basename(model.modelPath)}, 线程数 ${args.threads}`)
+    // 预热：首次解码包含一次性分配开销，不计入结果
+    runFile(files[0], recognizer, args)
+  }
+
+  const results = []
+  for (let runIndex = 0; runIndex < args.runs; runIndex++) {
+    for (const file of files) {
+      const result = runFile(file, recognizer, args)
+      results.push({ run: runIndex + 1, ...result })
+      console.error(`[bench] ${result.file}: ${result.totalMs}ms, RTF ${result.rtf}, ${result.segments} 段`)
+    }
+  }
+
+  const report = {
+    meta: {
+      createdAt: new Date().toISOString(),
+      node: process.version,
+      platform: process.platform,
+      arch: process.arch,
+      cpu: os.cpus()[0]?.model ?? 'unknown',
+      cores: os.cpus().length,
+      corpus: corpusFingerprint(files),
+      model: model ? path.basename(model.sourcePath) : null,
+      threads: args.decode ? args.threads : null,
+      runs: args.runs,
+      vad: args.vad,
+      decode: args.decode,
+    },
+    summary: summarize(results, loadMs),
+    files: results,
+  }
+
+  const json = JSON.stringify(report, null, 2)
+  if (args.out) {
+    fs.writeFileSync(args.out, json)
+    console.error(`[bench] 结果已写入 ${args.out}`)
+  } else {
+    console.log(json)
+  }
+}
+
+function main() {
+  const args = parseArgs(process.argv.slice(2))
+  try {
+    if (args.compare) {
+      compare(args.compare[0], args.compare[1], args)
+    } else {
+      run(args)
+    }
+  } catch (error) {
+    console.error(`[bench] ${error instanceof Error ? error.message : String(error)}`)
+    process.exit(1)
+  }
+}
+
+main()
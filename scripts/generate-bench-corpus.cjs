@@ -0,0 +1,142 @@
+#!/usr/bin/env node
+/**
+ * 生成离线基准测试用的合成语料
+ *
+ * 用谐波叠加 + 音节包络模拟浊音，短语之间插入静音，使 VAD 能切出多个分段；
+ * 采样率与声道数混合（16k/44.1k/48k、单/双声道），覆盖重采样与混音路径。
+ * 合成音频没有可识别的语义，只用于测量耗时，不能用于评估准确率。
+ *
+ * 用法:
+ *   node scripts/generate-bench-corpus.cjs --out bench-corpus [--count 12] [--min-sec 2] [--max-sec 60] [--seed 1]
+ */
+
+const fs = require('fs')
+const path = require('path')
+
+const SAMPLE_RATES = [16000, 16000, 44100, 48000]
+const CHANNELS = [1, 1, 2]
+
+function parseArgs(argv) {
+  const args = { out: 'bench-corpus', count: 12, minSec: 2, maxSec: 60, seed: 1 }
+  for (let i = 0; i < argv.length; i++) {
+    const key = argv[i]
+    const value = argv[i + 1]
+    if (key === '--out') args.out = value
+    else if (key === '--count') args.count = Number(value)
+    else if (key === '--min-sec') args.minSec = Number(value)
+    else if (key === '--max-sec') args.maxSec = Number(value)
+    else if (key === '--seed') args.seed = Number(value)
+    else if (key === '--help' || key === '-h') {
+      console.log('用法: node scripts/generate-bench-corpus.cjs --out <目录> [--count 12] [--min-sec 2] [--max-sec 60] [--seed 1]')
+      process.exit(0)
+    } else continue
+    i++
+  }
+  return args
+}
+
+/**
+ * 可复现的伪随机数（mulberry32）
+ */
+function createRandom(seed) {
+  let state = seed >>> 0
+  return () => {
+    state = (state + 0x6d2b79f5) >>> 0
+    let t = state
+    t = Math.imul(t ^ (t >>> 15), t | 1)
+    t ^= t + Math.imul(t ^ (t >>> 7), t | 61)
+    return ((t ^ (t >>> 14)) >>> 0) / 4294967296
+  }
+}
+
+/**
+ * 合成一段类语音信号（单声道）
+ */
+function synthesize(random, sampleRate, durationSec) {
+  const total = Math.round(sampleRate * durationSec)
+  const samples = new Float32Array(total)
+  const between = (min, max) => min + random() * (max - min)
+
+  let cursor = Math.round(sampleRate * between(0.2, 0.5))
+  while (cursor < total) {
+    // 一个短语：若干音节，音节之间短停顿
+    const syllables = Math.round(between(4, 14))
+    const f0Base = between(100, 240)
+    for (let s = 0; s < syllables && cursor < total; s++) {
+      const length = Math.round(sampleRate * between(0.15, 0.3))
+      const f0 = f0Base * between(0.85, 1.2)
+      const amplitude = between(0.15, 0.45)
+      let phase = 0
+      for (let i = 0; i < length && cursor + i < total; i++) {
+        const envelope = Math.sin((Math.PI * i) / length) ** 2
+        // 轻微颤音，避免纯音
+        phase += (2 * Math.PI * f0 * (1 + 0.01 * Math.sin((2 * Math.PI * 5 * i) / sampleRate))) / sampleRate
+        let value = 0
+        for (let harmonic = 1; harmonic <= 5; harmonic++) {
+          value += Math.sin(phase * harmonic) / harmonic
+        }
+        samples[cursor + i] += amplitude * envelope * value * 0.5
+      }
+      cursor += length + Math.round(sampleRate * between(0.03, 0.12))
+    }
+    // 短语之间的停顿长于 VAD 静音阈值
+    cursor += Math.round(sampleRate * between(0.7, 1.5))
+  }
+
+  // 低电平底噪
+  for (let i = 0; i < total; i++) {
+    samples[i] += (random() - 0.5) * 0.004
+  }
+  return samples
+}
+
+function encodeWav(samples, sampleRate, channels) {
+  const dataSize = samples.length * channels * 2
+  const buffer = Buffer.alloc(44 + dataSize)
+  buffer.write('RIFF', 0, 'ascii')
+  buffer.writeUInt32LE(36 + dataSize, 4)
+  buffer.write('WAVE', 8, 'ascii')
+  buffer.write('fmt ', 12, 'ascii')
+  buffer.writeUInt32LE(16, 16)
+  buffer.writeUInt16LE(1, 20)
+  buffer.writeUInt16LE(channels, 22)
+  buffer.writeUInt32LE(sampleRate, 24)
+  buffer.writeUInt32LE(sampleRate * channels * 2, 28)
+  buffer.writeUInt16LE(channels * 2, 32)
+  buffer.writeUInt16LE(16, 34)
+  buffer.write('data', 36, 'ascii')
+  buffer.writeUInt32LE(dataSize, 40)
+
+  let offset = 44
+  for (let i = 0; i < samples.length; i++) {
+    const value = Math.round(Math.max(-1, Math.min(1, samples[i])) * 0x7fff)
+    for (let ch = 0; ch < channels; ch++) {
+      buffer.writeInt16LE(value, offset)
+      offset += 2
+    }
+  }
+  return buffer
+}
+
+function main() {
+  const args = parseArgs(process.argv.slice(2))
+  const random = createRandom(args.seed)
+  fs.mkdirSync(args.out, { recursive: true })
+
+  const files = []
+  for (let index = 0; index < args.count; index++) {
+    // 时长在区间内按对数分布，短句居多，也包含长音频
+    const durationSec = Math.round(args.minSec * (args.maxSec / args.minSec) ** random() * 10) / 10
+    const sampleRate = SAMPLE_RATES[index % SAMPLE_RATES.length]
+    const channels = CHANNELS[index % CHANNELS.length]
+    const name = `synthetic-${String(index + 1).padStart(3, '0')}-${sampleRate}hz-${channels}ch.wav`
+    fs.writeFileSync(path.join(args.out, name), encodeWav(synthesize(random, sampleRate, durationSec), sampleRate, channels))
+    files.push({ name, durationSec, sampleRate, channels })
+  }
+
+  fs.writeFileSync(path.join(args.out, 'manifest.json'), JSON.stringify({ seed: args.seed, files }, null, 2))
+  const totalSec = files.reduce((sum, file) => sum + file.durationSec, 0)
+  console.log(`已生成 ${files.length} 个文件，共 ${totalSec.toFixed(1)} 秒 → ${path.resolve(args.out)}`)
+}
+
+main()
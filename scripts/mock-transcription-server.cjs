@@ -0,0 +1,138 @@
+#!/usr/bin/env node
+/**
+ * 本地在线转写替身服务
+ *
+ * 模拟 OpenAI 兼容的 /audio/transcriptions 接口，记录每次请求实际收到的字节数、
+ * 传输方式（Content-Length / chunked）与文件部分的格式和大小，用于对比不同上传格式的流量。
+ * 返回的文本只包含统计信息，不做识别。
+ * --reject-chunked 模拟不接受分块请求体的服务端（返回 411），用于验证边录边传回退整段上传。
+ *
+ * 用法:
+ *   node scripts/mock-transcription-server.cjs [--port 8787] [--save <目录>] [--reject-chunked]
+ * 然后在设置中选择「自定义」服务，Base URL 填 http://127.0.0.1:8787/v1
+ */
+
+const fs = require('fs')
+const http = require('http')
+const path = require('path')
+
+function parseArgs(argv) {
+  const args = { port: 8787, save: null, rejectChunked: false }
+  for (let i = 0; i < argv.length; i++) {
+    const key = argv[i]
+    const value = argv[i + 1]
+    if (key === '--port') args.port = Number(value)
+    else if (key === '--save') args.save = value
+    else if (key === '--reject-chunked') {
+      args.rejectChunked = true
+      continue
+    } else if (key === '--help' || key === '-h') {
+      console.log('用法: node scripts/mock-transcription-server.cjs [--port 8787] [--save <目录>] [--reject-chunked]')
+      process.exit(0)
+    } else continue
+    i++
+  }
+  return args
+}
+
+/**
+ * 拆分 multipart 请求体，返回各部分的头与内容
+ */
+function parseMultipart(body, boundary) {
+  const delimiter = Buffer.from(`--${boundary}`)
+  const parts = []
+  let start = body.indexOf(delimiter)
+  while (start >= 0) {
+    const headerStart = start + delimiter.length + 2
+    const next = body.indexOf(delimiter, headerStart)
+    if (next < 0) break
+    const headerEnd = body.indexOf('\r\n\r\n', headerStart)
+    if (headerEnd < 0 || headerEnd > next) break
+    const headers = body.subarray(headerStart, headerEnd).toString('utf8')
+    // 内容末尾的 \r\n 属于分隔符
+    const content = body.subarray(headerEnd + 4, next - 2)
+    const name = /name="([^"]*)"/.exec(headers)?.[1] ?? ''
+    const fileName = /filename="([^"]*)"/.exec(headers)?.[1] ?? null
+    const contentType = /Content-Type:\s*([^\r\n]+)/i.exec(headers)?.[1] ?? null
+    parts.push({ name, fileName, contentType, content })
+    start = next
+  }
+  return parts
+}
+
+function formatBytes(bytes) {
+  if (bytes < 1024) return `${bytes} B`
+  if (bytes < 1024 * 1024) return `${(bytes / 1024).toFixed(1)} KB`
+  return `${(bytes / 1024 / 1024).toFixed(2)} MB`
+}
+
+function main() {
+  const args = parseArgs(process.argv.slice(2))
+  if (args.save) fs.mkdirSync(args.save, { recursive: true })
+  let requestCount = 0
+
+  const server = http.createServer((req, res) => {
+    if (req.method !== 'POST' || !req.url.endsWith('/audio/transcriptions')) {
+      res.writeHead(404, { 'Content-Type': 'application/json' })
+      res.end(JSON.stringify({ error: { message: `未知接口: ${req.method} ${req.url}` } }))
+      return
+    }
+
+    if (args.rejectChunked && !req.headers['content-length']) {
+      console.log('[MockServer] 拒绝分块请求（411）')
+      res.writeHead(411, { 'Content-Type': 'application/json', Connection: 'close' })
+      res.end(JSON.stringify({ error: { message: 'Length Required' } }))
+      req.resume()
+      return
+    }
+
+    const startedAt = Date.now()
+    const chunks = []
+    let received = 0
+    req.on('data', (chunk) => {
+      chunks.push(chunk)
+      received += chunk.length
+    })
+    req.on('end', () => {
+      requestCount++
+      const transfer = req.headers['content-length'] ? `Content-Length ${req.headers['content-length']}` : 'chunked'
+      const boundary = /boundary=([^;]+)/.exec(req.headers['content-type'] || '')?.[1]
+      const parts = boundary ? parseMultipart(Buffer.concat(chunks), boundary) : []
+      const file = parts.find((part) => part.fileName !== null)
+      const fields = Object.fromEntries(parts.filter((part) => part.fileName === null).map((part) => [part.name, part.content.toString('utf8')]))
+
+      console.log(
+        `[MockServer] #${requestCount} 收到 ${formatBytes(received)}（${transfer}），耗时 ${Date.now() - startedAt}ms`
+      )
+      if (file) {
+        console.log(`[MockServer]   文件 ${file.fileName}，${file.contentType}，${formatBytes(file.content.length)}`)
+        if (args.save) {
+          const target = path.join(args.save, `${requestCount}-${path.basename(file.fileName)}`)
+          fs.writeFileSync(target, file.content)
+          console.log(`[MockServer]   已保存到 ${target}`)
+        }
+      } else {
+        console.log('[MockServer]   未找到文件部分')
+      }
+      console.log(`[MockServer]   字段 ${JSON.stringify(fields)}`)
+
+      const text = file
+        ? `收到 ${file.contentType} ${file.content.length} 字节（请求共 ${received} 字节）`
+        : `请求共 ${received} 字节，未包含文件`
+      if (fields.response_format === 'text') {
+        res.writeHead(200, { 'Content-Type': 'text/plain; charset=utf-8' })
+        res.end(text)
+      } else {
+        res.writeHead(200, { 'Content-Type': 'application/json' })
+        res.end(JSON.stringify({ text, bytesReceived: received, fileBytes: file?.content.length ?? 0 }))
+      }
+    })
+  })
+
+  server.listen(args.port, '127.0.0.1', () => {
+    console.log(`[MockServer] 监听 http://127.0.0.1:${args.port}/v1/audio/transcriptions`)
+    if (args.rejectChunked) console.log('[MockServer] 已开启 --reject-chunked，分块请求将返回 411')
+  })
+}
+
+main()
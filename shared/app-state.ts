@@ -126,6 +126,13 @@ export const TRANSCRIPTION_PROVIDERS: ProviderMeta[] = [
   },
 ]
 
+/**
+ * 在线转录上传的音频格式
+ * - flac: 无损压缩（需要 native/audio-dsp 原生模块，不可用时回退到 wav）
+ * - wav: 16-bit PCM
+ */
+export type UploadAudioFormat = 'flac' | 'wav'
+
 /**
  * 在线转录配置
  */
@@ -138,6 +145,12 @@ export interface OnlineTranscriptionConfig {
   responseFormat?: 'text' | 'json'
   temperature?: number
   timeoutMs?: number
+  /** 上传前的编码格式，默认 flac */
+  uploadFormat?: UploadAudioFormat
+  /** 上传前裁掉首尾静音，默认开启 */
+  trimSilence?: boolean
+  /** 录音期间边编码边以分块请求上传，服务端不支持时自动回退整段上传，默认开启 */
+  streamingUpload?: boolean
 }
 
 export interface AppleDictationConfig {
@@ -149,6 +162,157 @@ export interface TranscriptionSettings {
   mode: TranscriptionMode
   online: OnlineTranscriptionConfig
   apple?: AppleDictationConfig
+  /** 离线模式边说边识别：录音期间按静音分段提前解码，默认开启 */
+  streamingDecode?: boolean
+  /** 边说边识别结束时，将最后一个分段与尾段合并重解码以保证边界处准确率，默认关闭 */
+  streamingRedecodeBoundary?: boolean
+  /** 长音频文件转写每次读取的窗口（秒），越大吞吐越高、内存占用越多，默认 60 */
+  longFileWindowSec?: number
+}
+
+/** 历史记录保留策略，各项为 0 表示不限制 */
+export interface RetentionSettings {
+  /** 录音保留天数，超过后删除音频、保留转写 */
+  audioDays: number
+  /** 会话记录（含转写）保留天数 */
+  transcriptDays: number
+  /** 录音总大小上限（MB），超出时从最早的会话开始删除音频 */
+  maxAudioMB: number
+}
+
+/** 模型卸载原因 */
+export type ModelUnloadReason = 'memory-pressure' | 'rss-cap' | 'config-changed'
+
+/** 离线模型驻留统计 */
+export interface ModelResidencyStats {
+  /** 模型是否已加载 */
+  loaded: boolean
+  /** 模型加载次数（含预热） */
+  loadCount: number
+  /** 其中由预热触发的次数 */
+  prewarmCount: number
+  /** 使用时模型已就绪的次数 */
+  warmHits: number
+  /** 使用时需要等待模型加载的次数 */
+  coldStarts: number
+  /** 冷启动等待时长（毫秒） */
+  lastColdStartMs: number | null
+  avgColdStartMs: number | null
+  maxColdStartMs: number | null
+  /** 最近一次 worker 内部加载耗时（毫秒） */
+  lastLoadMs: number | null
+  /** 最近一次采样的 worker 常驻内存（字节） */
+  workerRssBytes: number | null
+  /** 各原因的卸载次数 */
+  unloads: Record<ModelUnloadReason, number>
+}
+
+/** 识别任务优先级：实时听写 / 后台文件转写 */
+export type TranscriptionPriority = 'live' | 'background'
+
+/** 单个优先级的排队时延统计 */
+export interface QueueDelayStats {
+  count: number
+  avgMs: number | null
+  p95Ms: number | null
+  maxMs: number | null
+  /** 当前排队中的任务数 */
+  pending: number
+}
+
+/** 识别 worker 的调度队列统计 */
+export interface WorkerQueueStats {
+  live: QueueDelayStats
+  background: QueueDelayStats
+  /** 实时任务插队到进行中的后台任务之前的次数 */
+  preemptions: number
+}
+
+/** 带时间戳的转写分段（毫秒） */
+export interface TranscriptSegment {
+  start: number
+  end: number
+  text: string
+}
+
+/** 转写结果缓存统计 */
+export interface ResultCacheStats {
+  entries: number
+  /** 已占用 / 上限（字节） */
+  bytes: number
+  maxBytes: number
+  hits: number
+  misses: number
+  /** 命中率（0-1），尚无查询时为 null */
+  hitRate: number | null
+  /** 因超出容量被淘汰的条目数 */
+  evictions: number
+}
+
+/** 自动调优中单个候选配置的测量结果 */
+export interface AutotuneCandidateResult {
+  /** 模型文件名，如 model.onnx / model.int8.onnx */
+  variant: string
+  numThreads: number
+  /** 创建识别器耗时（毫秒） */
+  loadMs?: number
+  /** 测试音频解码耗时中位数（毫秒） */
+  decodeMs?: number
+  /** 实时率：解码耗时 / 音频时长 */
+  rtf?: number
+  text?: string
+  /** 与 fp32 模型输出的字符相似度（0-1），用于排除精度明显下降的量化模型 */
+  agreement?: number
+  error?: string
+}
+
+/** 持久化的自动调优结果 */
+export interface AutotuneProfile {
+  createdAt: number
+  /** 机器与模型签名，任一变化时结果失效 */
+  signature: string
+  audioMs: number
+  best: {
+    variant: string
+    numThreads: number
+    rtf: number
+    loadMs: number
+  }
+  results: AutotuneCandidateResult[]
+}
+
+export interface AutotuneStatus {
+  running: boolean
+  /** 运行中的进度 */
+  completed?: number
+  total?: number
+  /** 当前生效的调优结果，未调优或已失效时为 null */
+  profile: AutotuneProfile | null
+  error?: string
+}
+
+/** 一次历史记录清理的结果 */
+export interface RetentionRunResult {
+  finishedAt: number
+  durationMs: number
+  /** 删除的会话记录数 */
+  deletedRecords: number
+  /** 删除了音频（保留转写）的会话数 */
+  removedAudio: number
+  /** 回收的磁盘空间（字节），含打包段压缩 */
+  reclaimedBytes: number
+}
+
+export interface RetentionStatus {
+  running: boolean
+  /** 运行中的阶段：扫描、按批删除、压缩打包段 */
+  phase?: 'scanning' | 'deleting' | 'compacting'
+  completed?: number
+  total?: number
+  /** 本次运行已回收的字节数 */
+  reclaimedBytes?: number
+  lastRun: RetentionRunResult | null
+  error?: string
 }
 
 export interface AppleDictationStatus {
@@ -196,6 +360,32 @@ export interface TranscribeFileResponse {
   error?: string
 }
 
+/** Batch queue item status */
+export type BatchItemStatus = 'pending' | 'running' | 'done' | 'error'
+
+/** 批量转写队列中的单个文件 */
+export interface BatchQueueItem {
+  id: string
+  filePath: string
+  fileName: string
+  status: BatchItemStatus
+  text?: string
+  /** 音频时长（毫秒） */
+  durationMs?: number
+  error?: string
+  addedAt: number
+  finishedAt?: number
+}
+
+/** 批量转写队列快照 */
+export interface BatchQueueSnapshot {
+  items: BatchQueueItem[]
+  completed: number
+  total: number
+  /** 实时听写进行中，暂停派发新的批次 */
+  paused: boolean
+}
+
 /** Export transcription request */
 export interface ExportTranscriptionRequest {
   text: string
@@ -11,6 +11,57 @@ export interface ConversationRecord {
   test?: boolean
 }
 
+/** 历史记录全文检索结果 */
+export interface HistorySearchResult {
+  records: ConversationRecord[]
+  /** 匹配总数（records 只含当前页） */
+  total: number
+  /** 索引查询耗时（不含读取记录） */
+  elapsedMs?: number
+  error?: string
+}
+
+export interface UsageAnalyticsOptions {
+  /** 统计的时间范围（毫秒时间戳，含 from 不含 to），缺省为全部 */
+  from?: number
+  to?: number
+  /** 按天分组使用的时区偏移，同 Date#getTimezoneOffset()，缺省为主进程本地时区 */
+  timezoneOffsetMinutes?: number
+}
+
+/** 按模型分组的使用统计 */
+export interface ModelUsageStats {
+  modelId: string
+  count: number
+  /** 录音总时长（毫秒） */
+  spokenMs: number
+  /** 录音结束到出结果的平均耗时（毫秒），不含失败记录 */
+  avgLatencyMs: number | null
+  /** 每分钟字数（中日韩按字、其他按词计），不含失败记录 */
+  wordsPerMinute: number | null
+  /** 失败记录占比（0-1） */
+  errorRate: number
+}
+
+/** 历史记录使用统计（不含测试记录） */
+export interface UsageAnalytics {
+  count: number
+  errorCount: number
+  errorRate: number
+  spokenMs: number
+  words: number
+  wordsPerMinute: number | null
+  avgLatencyMs: number | null
+  /** 每天的听写次数与录音时长，按日期升序，只含有记录的日期 */
+  daily: Array<{ day: string; count: number; spokenMs: number }>
+  /** 按次数降序 */
+  models: ModelUsageStats[]
+  /** 扫描的行数与耗时 */
+  rows: number
+  elapsedMs: number
+  error?: string
+}
+
 export interface ConversationStoreOptions {
   baseDir: string
 }
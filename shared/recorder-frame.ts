@@ -0,0 +1,59 @@
+/**
+ * 录音数据帧格式（渲染进程 → 主进程，经 MessagePort 传输）
+ *
+ * 每帧一个 ArrayBuffer：12 字节帧头 + 交错 16-bit PCM
+ *   [0, 4)  序号 seq，从 0 递增，用于发现丢帧与乱序
+ *   [4, 8)  标志位，FRAME_FLAG_END 表示录音结束（结束帧可带最后一段数据）
+ *   [8, 12) 本帧首个样本的帧偏移（每声道样本数），用于按时间补齐丢失的数据
+ * 全部小端序
+ */
+
+export const RECORDER_FRAME_HEADER_BYTES = 12
+
+/** preload 把主进程送来的端口转发到页面时使用的 window 消息类型 */
+export const RECORDER_PORT_MESSAGE = 'native-recorder:port'
+
+export const FRAME_FLAG_END = 1
+
+/** 默认每帧的音频时长 */
+export const DEFAULT_RECORDER_FRAME_MS = 500
+
+export interface RecorderFrameHeader {
+  seq: number
+  flags: number
+  sampleOffset: number
+}
+
+export interface RecorderFrame extends RecorderFrameHeader {
+  /** 帧内 PCM 字节（不含帧头） */
+  pcm: Uint8Array
+}
+
+/**
+ * 分配一帧，返回整帧缓冲与可直接写入样本的 PCM 视图
+ */
+export function createRecorderFrame(header: RecorderFrameHeader, samples: number): { buffer: ArrayBuffer; pcm: Int16Array } {
+  const buffer = new ArrayBuffer(RECORDER_FRAME_HEADER_BYTES + samples * 2)
+  const view = new DataView(buffer)
+  view.setUint32(0, header.seq >>> 0, true)
+  view.setUint32(4, header.flags >>> 0, true)
+  view.setUint32(8, header.sampleOffset >>> 0, true)
+  return { buffer, pcm: new Int16Array(buffer, RECORDER_FRAME_HEADER_BYTES, samples) }
+}
+
+/**
+ * 解析一帧；长度不足帧头或 PCM 字节数为奇数时返回 null
+ */
+export function parseRecorderFrame(data: ArrayBuffer | Uint8Array): RecorderFrame | null {
+  const bytes = data instanceof Uint8Array ? data : new Uint8Array(data)
+  if (bytes.byteLength < RECORDER_FRAME_HEADER_BYTES || (bytes.byteLength - RECORDER_FRAME_HEADER_BYTES) % 2 !== 0) {
+    return null
+  }
+  const view = new DataView(bytes.buffer, bytes.byteOffset, RECORDER_FRAME_HEADER_BYTES)
+  return {
+    seq: view.getUint32(0, true),
+    flags: view.getUint32(4, true),
+    sampleOffset: view.getUint32(8, true),
+    pcm: bytes.subarray(RECORDER_FRAME_HEADER_BYTES),
+  }
+}
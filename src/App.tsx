@@ -601,7 +601,7 @@ function App() {
                   <div>
                     <span className="text-sm text-[hsl(var(--text-primary))]">模型缓存时间</span>
                     <p className="text-xs text-[hsl(var(--text-tertiary))] mt-0.5">
-                      闲置后自动卸载模型以释放内存
+                      内存紧张时，闲置超过该时间后卸载模型；选择「常驻」仅在内存严重不足时卸载
                     </p>
                   </div>
                   <div className="flex flex-wrap gap-1.5 mt-2">
@@ -610,7 +610,7 @@ function App() {
                       { value: 15, label: '15 分钟' },
                       { value: 30, label: '30 分钟' },
                       { value: 60, label: '1 小时' },
-                      { value: 0, label: '永不' },
+                      { value: 0, label: '常驻' },
                     ].map((opt) => (
                       <button
                         key={opt.value}
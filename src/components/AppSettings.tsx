@@ -21,7 +21,7 @@ const CACHE_TTL_OPTIONS = [
   { value: 15, label: '15 分钟' },
   { value: 30, label: '30 分钟' },
   { value: 60, label: '1 小时' },
-  { value: 0, label: '永不' },
+  { value: 0, label: '常驻' },
 ] as const
 
 interface AppSettingsProps {
@@ -0,0 +1,82 @@
+/**
+ * 批量转录队列组件
+ * 显示每个文件的转录状态，支持复制单个结果和一键导出全部
+ */
+
+import type { BatchQueueItem, BatchQueueSnapshot } from '../../../shared/app-state'
+
+interface BatchQueueProps {
+  snapshot: BatchQueueSnapshot
+  onCopy: (item: BatchQueueItem) => void
+  onExportAll: () => void
+  onClear: () => void
+}
+
+const STATUS_LABEL: Record<BatchQueueItem['status'], string> = {
+  pending: '等待中',
+  running: '转录中',
+  done: '完成',
+  error: '失败',
+}
+
+const STATUS_CLASS: Record<BatchQueueItem['status'], string> = {
+  pending: 'text-gray-400',
+  running: 'text-orange-600 animate-pulse',
+  done: 'text-green-600',
+  error: 'text-rose-600',
+}
+
+export const BatchQueue = ({ snapshot, onCopy, onExportAll, onClear }: BatchQueueProps) => {
+  const progress = snapshot.total > 0 ? Math.round((snapshot.completed / snapshot.total) * 100) : 0
+  const hasDone = snapshot.items.some((item) => item.status === 'done')
+
+  return (
+    <div className="bg-white rounded-xl border border-gray-100 shadow-sm p-4 space-y-3">
+      <div className="flex items-center justify-between">
+        <span className="text-xs font-medium text-gray-600">
+          批量转录 · {snapshot.completed}/{snapshot.total}
+          {snapshot.paused && <span className="ml-2 text-amber-600">听写中，已暂停</span>}
+        </span>
+        <div className="flex gap-2">
+          {hasDone && (
+            <button onClick={onExportAll} className="text-xs text-orange-600 hover:underline">
+              全部导出
+            </button>
+          )}
+          <button onClick={onClear} className="text-xs text-gray-400 hover:text-gray-600">
+            清除已完成
+          </button>
+        </div>
+      </div>
+
+      <div className="relative w-full h-1.5 bg-gray-100 rounded-full overflow-hidden">
+        <div
+          className="absolute left-0 top-0 h-full bg-gradient-to-r from-orange-400 to-orange-500 rounded-full transition-all duration-300"
+          style={{ width: `${progress}%` }}
+        />
+      </div>
+
+      <ul className="divide-y divide-gray-50 max-h-64 overflow-y-auto">
+        {snapshot.items.map((item) => (
+          <li key={item.id} className="py-2">
+            <div className="flex items-center gap-2">
+              <span className="flex-1 min-w-0 text-xs text-gray-700 truncate">{item.fileName}</span>
+              <span className={`text-xs ${STATUS_CLASS[item.status]}`}>{STATUS_LABEL[item.status]}</span>
+              {item.status === 'done' && (
+                <button onClick={() => onCopy(item)} className="text-xs text-gray-400 hover:text-gray-600">
+                  复制
+                </button>
+              )}
+            </div>
+            {item.status === 'done' && item.text && (
+              <p className="mt-1 text-xs text-gray-500 line-clamp-2">{item.text}</p>
+            )}
+            {item.status === 'error' && item.error && (
+              <p className="mt-1 text-xs text-rose-500 truncate">{item.error}</p>
+            )}
+          </li>
+        ))}
+      </ul>
+    </div>
+  )
+}
@@ -1,16 +1,18 @@
 /**
  * 文件拖放区域组件
- * 支持拖放和点击选择 .wav 文件
+ * 支持拖放和点击选择 .wav 文件，提供 onFilesSelect 时可一次选择多个文件
  */
 
 import { useState, useCallback, useRef } from 'react'
 
 interface DropZoneProps {
   onFileSelect: (file: File) => void
+  /** 选择了多个文件时回调（批量转录） */
+  onFilesSelect?: (files: File[]) => void
   disabled: boolean
 }
 
-export const DropZone = ({ onFileSelect, disabled }: DropZoneProps) => {
+export const DropZone = ({ onFileSelect, onFilesSelect, disabled }: DropZoneProps) => {
   const [isDragOver, setIsDragOver] = useState(false)
   const [error, setError] = useState<string | null>(null)
   const inputRef = useRef<HTMLInputElement>(null)
@@ -24,6 +26,24 @@ export const DropZone = ({ onFileSelect, disabled }: DropZoneProps) => {
     return true
   }, [])
 
+  const handleFiles = useCallback((fileList: FileList) => {
+    const files = Array.from(fileList)
+    if (files.length === 0) return
+    if (files.length === 1 || !onFilesSelect) {
+      if (validateFile(files[0])) {
+        onFileSelect(files[0])
+      }
+      return
+    }
+    const valid = files.filter((file) => file.name.toLowerCase().endsWith('.wav'))
+    if (valid.length === 0) {
+      setError('仅支持 .wav 格式文件')
+      return
+    }
+    setError(valid.length < files.length ? `已忽略 ${files.length - valid.length} 个非 .wav 文件` : null)
+    onFilesSelect(valid)
+  }, [onFileSelect, onFilesSelect, validateFile])
+
   const handleDragOver = useCallback((e: React.DragEvent) => {
     e.preventDefault()
     e.stopPropagation()
@@ -45,14 +65,8 @@ export const DropZone = ({ onFileSelect, disabled }: DropZoneProps) => {
 
     if (disabled) return
 
-    const files = e.dataTransfer.files
-    if (files.length > 0) {
-      const file = files[0]
-      if (validateFile(file)) {
-        onFileSelect(file)
-      }
-    }
-  }, [disabled, onFileSelect, validateFile])
+    handleFiles(e.dataTransfer.files)
+  }, [disabled, handleFiles])
 
   const handleClick = useCallback(() => {
     if (!disabled && inputRef.current) {
@@ -62,16 +76,13 @@ export const DropZone = ({ onFileSelect, disabled }: DropZoneProps) => {
 
   const handleFileChange = useCallback((e: React.ChangeEvent<HTMLInputElement>) => {
     const files = e.target.files
-    if (files && files.length > 0) {
-      const file = files[0]
-      if (validateFile(file)) {
-        onFileSelect(file)
-      }
+    if (files) {
+      handleFiles(files)
     }
     if (inputRef.current) {
       inputRef.current.value = ''
     }
-  }, [onFileSelect, validateFile])
+  }, [handleFiles])
 
   return (
     <div className="space-y-2">
@@ -96,6 +107,7 @@ export const DropZone = ({ onFileSelect, disabled }: DropZoneProps) => {
           ref={inputRef}
           type="file"
           accept=".wav"
+          multiple={!!onFilesSelect}
           onChange={handleFileChange}
           className="hidden"
           disabled={disabled}
@@ -126,7 +138,7 @@ export const DropZone = ({ onFileSelect, disabled }: DropZoneProps) => {
               {isDragOver ? '松开以选择文件' : '拖放音频文件到这里'}
             </p>
             <p className="text-xs text-gray-400 mt-1">
-              或点击选择文件 · 仅支持 .wav 格式
+              或点击选择文件 · 仅支持 .wav 格式{onFilesSelect ? ' · 可多选' : ''}
             </p>
           </div>
         </div>
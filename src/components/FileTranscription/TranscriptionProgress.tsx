@@ -1,13 +1,28 @@
 /**
  * 转录进度显示组件
+ * 长音频边转录边显示已完成的分段
  */
 
+import type { TranscriptSegment } from '../../../shared/app-state'
+
 interface TranscriptionProgressProps {
   fileName: string
   progress: number
+  segments?: TranscriptSegment[]
+  /** 导出已完成的部分 */
+  onExportPartial?: () => void
+}
+
+const formatOffset = (ms: number): string => {
+  const totalSeconds = Math.floor(ms / 1000)
+  const hours = Math.floor(totalSeconds / 3600)
+  const minutes = Math.floor((totalSeconds % 3600) / 60)
+  const seconds = totalSeconds % 60
+  const mmss = `${String(minutes).padStart(2, '0')}:${String(seconds).padStart(2, '0')}`
+  return hours > 0 ? `${hours}:${mmss}` : mmss
 }
 
-export const TranscriptionProgress = ({ fileName, progress }: TranscriptionProgressProps) => {
+export const TranscriptionProgress = ({ fileName, progress, segments = [], onExportPartial }: TranscriptionProgressProps) => {
   return (
     <div className="bg-white rounded-xl border border-gray-100 shadow-sm p-4 space-y-3">
       <div className="flex items-center gap-3">
@@ -43,6 +58,27 @@ export const TranscriptionProgress = ({ fileName, progress }: TranscriptionProgr
           style={{ width: `${Math.min(progress + 10, 100)}%` }}
         />
       </div>
+
+      {segments.length > 0 && (
+        <div className="space-y-2">
+          <div className="max-h-48 overflow-y-auto rounded-lg bg-gray-50 border border-gray-100 p-3 space-y-1">
+            {segments.map((segment) => (
+              <p key={segment.start} className="text-xs text-gray-700 leading-relaxed break-words">
+                <span className="text-gray-400 tabular-nums mr-2">{formatOffset(segment.start)}</span>
+                {segment.text}
+              </p>
+            ))}
+          </div>
+          {onExportPartial && (
+            <button
+              onClick={onExportPartial}
+              className="w-full px-3 py-2 text-xs font-medium rounded-lg bg-gray-50 border border-gray-200 text-gray-600 hover:border-gray-300 transition-colors"
+            >
+              导出已完成部分（{segments.length} 段）
+            </button>
+          )}
+        </div>
+      )}
     </div>
   )
 }
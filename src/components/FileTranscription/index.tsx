@@ -1,12 +1,14 @@
 /**
  * 文件转录主组件
- * 支持拖放或选择音频文件进行转录
+ * 支持拖放或选择音频文件进行转录，多个文件进入后台批量队列
  */
 
 import { useState, useCallback, useEffect } from 'react'
+import type { BatchQueueItem, BatchQueueSnapshot, TranscriptSegment } from '../../../shared/app-state'
 import { DropZone } from './DropZone'
 import { TranscriptionProgress } from './TranscriptionProgress'
 import { TranscriptionResult } from './TranscriptionResult'
+import { BatchQueue } from './BatchQueue'
 
 type TranscriptionState = 'idle' | 'selected' | 'transcribing' | 'complete' | 'error'
 
@@ -23,6 +25,10 @@ interface FileTranscriptionState {
   outputPath: string
   fileName: string
   progress: number
+  /** 长音频的分段结果，转录过程中逐步追加 */
+  segments: TranscriptSegment[]
+  /** 导出时每行带时间戳 */
+  includeTimestamps: boolean
   error: string | null
 }
 
@@ -41,9 +47,13 @@ export const FileTranscription = () => {
     outputPath: DEFAULT_OUTPUT_PATH,
     fileName: '',
     progress: 0,
+    segments: [],
+    includeTimestamps: true,
     error: null,
   })
 
+  const [batch, setBatch] = useState<BatchQueueSnapshot | null>(null)
+
   useEffect(() => {
     const dispose = window.speech.onTranscribeProgress((progress) => {
       setState(prev => ({ ...prev, progress }))
@@ -51,6 +61,61 @@ export const FileTranscription = () => {
     return dispose
   }, [])
 
+  useEffect(() => {
+    return window.speech.onTranscribeSegments((segments) => {
+      setState(prev => (prev.status === 'transcribing' ? { ...prev, segments: [...prev.segments, ...segments] } : prev))
+    })
+  }, [])
+
+  // 批量队列在主进程持久化，重新打开窗口或重启后恢复显示
+  useEffect(() => {
+    window.speech.getBatchQueue().then(setBatch).catch(() => {})
+    return window.speech.onBatchQueueUpdate(setBatch)
+  }, [])
+
+  const handleFilesSelect = useCallback(async (files: File[]) => {
+    const paths = files
+      .map((file) => (file as File & { path?: string }).path)
+      .filter((filePath): filePath is string => !!filePath)
+    if (paths.length === 0) {
+      setState(prev => ({ ...prev, status: 'error', error: 'Unable to get file path. Please try again.' }))
+      return
+    }
+    const result = await window.speech.transcribeBatch(paths)
+    if (result.success && result.snapshot) {
+      setBatch(result.snapshot)
+    } else if (!result.success) {
+      setState(prev => ({ ...prev, status: 'error', error: result.error || '批量转录失败' }))
+    }
+  }, [])
+
+  const handleBatchCopy = useCallback(async (item: BatchQueueItem) => {
+    try {
+      await navigator.clipboard.writeText(item.text ?? '')
+    } catch (err) {
+      console.error('复制失败:', err)
+    }
+  }, [])
+
+  const handleBatchExportAll = useCallback(async () => {
+    if (!batch) return
+    const done = batch.items.filter((item) => item.status === 'done')
+    let exported = 0
+    for (const item of done) {
+      const result = await window.speech.exportTranscription({
+        text: item.text ?? '',
+        outputPath: state.outputPath,
+        fileName: getDefaultFileName(item.fileName),
+      })
+      if (result.success) exported++
+    }
+    alert(`已导出 ${exported}/${done.length} 个文件到 ${state.outputPath}`)
+  }, [batch, state.outputPath])
+
+  const handleBatchClear = useCallback(async () => {
+    setBatch(await window.speech.clearBatchQueue())
+  }, [])
+
   const handleFileSelect = useCallback((file: File) => {
     const fileWithPath = file as File & { path?: string }
     
@@ -84,6 +149,7 @@ export const FileTranscription = () => {
       ...prev,
       status: 'transcribing',
       progress: 0,
+      segments: [],
       error: null,
     }))
 
@@ -95,6 +161,7 @@ export const FileTranscription = () => {
           ...prev,
           status: 'complete',
           transcriptionResult: result.text ?? '',
+          segments: result.segments ?? prev.segments,
           progress: 100,
         }))
       } else {
@@ -115,10 +182,15 @@ export const FileTranscription = () => {
 
   const handleExport = useCallback(async () => {
     try {
+      // 转录未完成时导出已解码的分段
+      const text = state.status === 'complete'
+        ? state.transcriptionResult
+        : state.segments.map(segment => segment.text).join('\n')
       const result = await window.speech.exportTranscription({
-        text: state.transcriptionResult,
+        text,
         outputPath: state.outputPath,
         fileName: state.fileName,
+        segments: state.includeTimestamps && state.segments.length > 0 ? state.segments : undefined,
       })
       
       if (result.success) {
@@ -129,7 +201,7 @@ export const FileTranscription = () => {
     } catch (err) {
       alert('导出失败: ' + (err instanceof Error ? err.message : '未知错误'))
     }
-  }, [state.outputPath, state.fileName, state.transcriptionResult])
+  }, [state.status, state.outputPath, state.fileName, state.transcriptionResult, state.segments, state.includeTimestamps])
 
   const handleCopy = useCallback(async () => {
     try {
@@ -147,6 +219,8 @@ export const FileTranscription = () => {
       outputPath: DEFAULT_OUTPUT_PATH,
       fileName: '',
       progress: 0,
+      segments: [],
+      includeTimestamps: true,
       error: null,
     })
   }, [])
@@ -176,10 +250,21 @@ export const FileTranscription = () => {
       {state.status === 'idle' && (
         <DropZone
           onFileSelect={handleFileSelect}
+          onFilesSelect={handleFilesSelect}
           disabled={false}
         />
       )}
 
+      {/* 批量转录队列 */}
+      {state.status === 'idle' && batch && batch.total > 0 && (
+        <BatchQueue
+          snapshot={batch}
+          onCopy={handleBatchCopy}
+          onExportAll={handleBatchExportAll}
+          onClear={handleBatchClear}
+        />
+      )}
+
       {/* 状态：已选择文件 - 显示文件信息和开始按钮 */}
       {state.status === 'selected' && state.selectedFile && (
         <div className="space-y-4">
@@ -262,6 +347,8 @@ export const FileTranscription = () => {
         <TranscriptionProgress
           fileName={state.selectedFile.name}
           progress={state.progress}
+          segments={state.segments}
+          onExportPartial={handleExport}
         />
       )}
 
@@ -310,6 +397,17 @@ export const FileTranscription = () => {
                   <span className="text-xs text-gray-400">.txt</span>
                 </div>
               </div>
+
+              {state.segments.length > 0 && (
+                <label className="flex items-center gap-2 text-xs text-gray-500">
+                  <input
+                    type="checkbox"
+                    checked={state.includeTimestamps}
+                    onChange={(e) => setState(prev => ({ ...prev, includeTimestamps: e.target.checked }))}
+                  />
+                  按分段导出并附带时间戳
+                </label>
+              )}
             </div>
           </div>
         </div>
@@ -19,6 +19,11 @@ const TIME_FILTERS: { value: TimeRangeFilter; label: string }[] = [
   { value: 'all', label: '全部' },
 ]
 
+/** 搜索结果条数上限 */
+const SEARCH_LIMIT = 200
+/** 输入停顿多久后发起搜索 */
+const SEARCH_DEBOUNCE_MS = 150
+
 function formatBytes(bytes: number): string {
   if (bytes === 0) return '0 B'
   const k = 1024
@@ -105,13 +110,19 @@ export const HistoryPanel = memo<HistoryPanelProps>(({ onBack }) => {
   const [copiedId, setCopiedId] = useState<string | null>(null)
   const [playingId, setPlayingId] = useState<string | null>(null)
   const [deletingId, setDeletingId] = useState<string | null>(null)
+  const [exportingId, setExportingId] = useState<string | null>(null)
   const [filter, setFilter] = useState<TimeRangeFilter>('today')
   const [isClearing, setIsClearing] = useState(false)
   const [showConfirm, setShowConfirm] = useState(false)
+  const [query, setQuery] = useState('')
+  const [searchResults, setSearchResults] = useState<ConversationRecord[] | null>(null)
+  const [searchTotal, setSearchTotal] = useState(0)
   const copyTimeout = useRef<NodeJS.Timeout | null>(null)
   const playTimeout = useRef<NodeJS.Timeout | null>(null)
+  const searchSeq = useRef(0)
 
-  const filtered = filterByTimeRange(records, filter)
+  const searching = query.trim().length > 0
+  const filtered = filterByTimeRange(searching && searchResults ? searchResults : records, filter)
   const toDelete = getRecordsToDelete(records, filter)
 
   const loadHistory = useCallback(async () => {
@@ -130,6 +141,27 @@ export const HistoryPanel = memo<HistoryPanelProps>(({ onBack }) => {
 
   useEffect(() => { loadHistory() }, [loadHistory])
 
+  useEffect(() => {
+    const trimmed = query.trim()
+    if (!trimmed) {
+      setSearchResults(null)
+      return
+    }
+    // 只采用最后一次输入的结果
+    const seq = ++searchSeq.current
+    const timer = setTimeout(async () => {
+      try {
+        const result = await window.speech.searchHistory({ query: trimmed, limit: SEARCH_LIMIT })
+        if (seq !== searchSeq.current) return
+        setSearchResults(result.records || [])
+        setSearchTotal(result.total || 0)
+      } catch {
+        if (seq === searchSeq.current) setSearchResults([])
+      }
+    }, SEARCH_DEBOUNCE_MS)
+    return () => clearTimeout(timer)
+  }, [query])
+
   useEffect(() => {
     return () => {
       if (copyTimeout.current) clearTimeout(copyTimeout.current)
@@ -162,12 +194,27 @@ export const HistoryPanel = memo<HistoryPanelProps>(({ onBack }) => {
     }
   }
 
+  const handleExport = async (record: ConversationRecord) => {
+    if (exportingId === record.id) return
+    setExportingId(record.id)
+    try {
+      await window.speech.exportHistoryAudio(record.id)
+    } catch {
+      // ignore
+    } finally {
+      setExportingId(null)
+    }
+  }
+
   const handleDelete = async (record: ConversationRecord) => {
     if (deletingId === record.id) return
     setDeletingId(record.id)
     try {
       const result = await window.speech.deleteHistoryItem(record.id)
-      if (result.success) setRecords(prev => prev.filter(r => r.id !== record.id))
+      if (result.success) {
+        setRecords(prev => prev.filter(r => r.id !== record.id))
+        setSearchResults(prev => prev && prev.filter(r => r.id !== record.id))
+      }
     } catch {
       // ignore
     } finally {
@@ -210,6 +257,26 @@ export const HistoryPanel = memo<HistoryPanelProps>(({ onBack }) => {
             <div className="w-12" />
           </div>
 
+          {/* Search */}
+          <div className="relative mb-3">
+            <input
+              type="text"
+              value={query}
+              onChange={e => setQuery(e.target.value)}
+              placeholder="搜索转写内容，引号内为精确短语"
+              className="w-full px-3 py-2 pr-8 text-xs border border-gray-200 rounded-lg bg-gray-50 focus:outline-none focus:border-orange-300 focus:ring-1 focus:ring-orange-100"
+            />
+            {query && (
+              <button
+                type="button"
+                onClick={() => setQuery('')}
+                className="absolute right-2 top-1/2 -translate-y-1/2 text-xs text-gray-400 hover:text-gray-600"
+              >
+                ✕
+              </button>
+            )}
+          </div>
+
           {/* Filter tabs */}
           <div className="flex gap-1 mb-3">
             {TIME_FILTERS.map(f => (
@@ -226,7 +293,9 @@ export const HistoryPanel = memo<HistoryPanelProps>(({ onBack }) => {
           {/* Stats & clear */}
           <div className="flex items-center justify-between">
             <span className="text-xs text-[hsl(var(--text-tertiary))]">
-              {filtered.length} 条 · {formatBytes(calculateSize(filtered))}
+              {searching && searchResults
+                ? `匹配 ${searchTotal} 条 · 当前显示 ${filtered.length} 条`
+                : `${filtered.length} 条 · ${formatBytes(calculateSize(filtered))}`}
             </span>
             <button
               onClick={() => setShowConfirm(true)}
@@ -287,7 +356,7 @@ export const HistoryPanel = memo<HistoryPanelProps>(({ onBack }) => {
           <div className="text-center py-12">
             <div className="text-4xl mb-3">📝</div>
             <p className="text-sm text-[hsl(var(--text-tertiary))]">
-              {filter === 'all' ? '暂无历史记录' : '该时间段无记录'}
+              {searching ? '没有匹配的记录' : filter === 'all' ? '暂无历史记录' : '该时间段无记录'}
             </p>
           </div>
         ) : (
@@ -338,6 +407,16 @@ export const HistoryPanel = memo<HistoryPanelProps>(({ onBack }) => {
                         </svg>
                       )}
                     </button>
+                    <button
+                      onClick={() => handleExport(record)}
+                      disabled={exportingId === record.id}
+                      title="导出录音"
+                      className="p-1.5 rounded-lg text-[hsl(var(--text-tertiary))] hover:text-[hsl(var(--text-primary))] hover:bg-[hsl(var(--muted))] transition-colors"
+                    >
+                      <svg className="w-4 h-4" fill="none" stroke="currentColor" viewBox="0 0 24 24">
+                        <path strokeLinecap="round" strokeLinejoin="round" strokeWidth={1.5} d="M4 16v1a3 3 0 003 3h10a3 3 0 003-3v-1m-4-4l-4 4m0 0l-4-4m4 4V4" />
+                      </svg>
+                    </button>
                     <button
                       onClick={() => handleDelete(record)}
                       disabled={deletingId === record.id}
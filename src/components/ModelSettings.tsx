@@ -19,6 +19,9 @@ const DEFAULT_ONLINE_CONFIG: OnlineTranscriptionConfig = {
   responseFormat: 'json',
   temperature: 0,
   timeoutMs: 120000,
+  uploadFormat: 'flac',
+  trimSilence: true,
+  streamingUpload: true,
 }
 
 const DEFAULT_APPLE_CONFIG: AppleDictationConfig = {
@@ -38,6 +41,15 @@ const LANGUAGE_PRESETS = [
   { value: 'ja', label: '日本語' },
 ] as const
 
+/** 在线转录上传格式 */
+const UPLOAD_FORMAT_OPTIONS = [
+  { value: 'flac', label: 'FLAC' },
+  { value: 'wav', label: 'WAV' },
+] as const
+
+/** 长音频分块窗口（秒） */
+const LONG_FILE_WINDOW_OPTIONS = [30, 60, 120] as const
+
 interface PillButtonProps {
   active: boolean
   onClick: () => void
@@ -210,6 +222,11 @@ export const ModelSettings = ({ config, onConfigChange }: ModelSettingsProps) =>
     await commitChange(next)
   }, [localConfig, commitChange])
 
+  const handleUploadOptionChange = useCallback(async (patch: Pick<OnlineTranscriptionConfig, 'uploadFormat' | 'trimSilence' | 'streamingUpload'>) => {
+    const next = { ...localConfig, online: { ...localConfig.online, ...patch } }
+    await commitChange(next)
+  }, [localConfig, commitChange])
+
   const handleAppleConfigChange = useCallback(async (patch: Partial<AppleDictationConfig>) => {
     const next = {
       ...localConfig,
@@ -300,8 +317,55 @@ export const ModelSettings = ({ config, onConfigChange }: ModelSettingsProps) =>
         </div>
 
         {localConfig.mode === 'offline' && (
-          <div className="px-3 py-2 bg-gray-50 border border-gray-100 rounded-lg">
+          <div className="px-3 py-2 bg-gray-50 border border-gray-100 rounded-lg space-y-2">
             <p className="text-xs text-gray-600">使用本地 SenseVoice 模型，数据不离开设备。</p>
+            <div className="flex items-center justify-between">
+              <span className="text-xs text-gray-600" title="录音期间按停顿分段提前识别，松开按键后只需处理最后一段">边说边识别</span>
+              <button
+                type="button"
+                onClick={() => commitChange({ ...localConfig, streamingDecode: !(localConfig.streamingDecode ?? true) })}
+                disabled={saving}
+                className={`px-2.5 py-1 text-xs rounded-full border transition-all ${
+                  localConfig.streamingDecode ?? true
+                    ? 'bg-orange-50 border-orange-300 text-orange-700 font-medium'
+                    : 'bg-gray-100 border-gray-200 text-gray-600'
+                } ${saving ? 'opacity-50 cursor-not-allowed' : ''}`}
+              >
+                {localConfig.streamingDecode ?? true ? '已开启' : '已关闭'}
+              </button>
+            </div>
+            {(localConfig.streamingDecode ?? true) && (
+              <div className="flex items-center justify-between">
+                <span className="text-xs text-gray-600" title="结束时将最后一段与尾部合并重新识别，略增延迟，减少分段处丢字">边界重识别</span>
+                <button
+                  type="button"
+                  onClick={() => commitChange({ ...localConfig, streamingRedecodeBoundary: !localConfig.streamingRedecodeBoundary })}
+                  disabled={saving}
+                  className={`px-2.5 py-1 text-xs rounded-full border transition-all ${
+                    localConfig.streamingRedecodeBoundary
+                      ? 'bg-orange-50 border-orange-300 text-orange-700 font-medium'
+                      : 'bg-gray-100 border-gray-200 text-gray-600'
+                  } ${saving ? 'opacity-50 cursor-not-allowed' : ''}`}
+                >
+                  {localConfig.streamingRedecodeBoundary ? '已开启' : '已关闭'}
+                </button>
+              </div>
+            )}
+            <div className="flex items-center justify-between">
+              <span className="text-xs text-gray-600" title="超过 5 分钟的音频文件按窗口分块读取并逐段输出，窗口越大越快、内存占用越多">长音频分块</span>
+              <div className="flex gap-1">
+                {LONG_FILE_WINDOW_OPTIONS.map((seconds) => (
+                  <PillButton
+                    key={seconds}
+                    active={(localConfig.longFileWindowSec ?? 60) === seconds}
+                    onClick={() => commitChange({ ...localConfig, longFileWindowSec: seconds })}
+                    disabled={saving}
+                  >
+                    {seconds}s
+                  </PillButton>
+                ))}
+              </div>
+            </div>
           </div>
         )}
 
@@ -540,6 +604,39 @@ export const ModelSettings = ({ config, onConfigChange }: ModelSettingsProps) =>
                                   />
                                 </div>
                               </div>
+
+                              <div>
+                                <span className="text-xs font-medium text-gray-600">上传格式</span>
+                                <div className="flex flex-wrap gap-1.5 mt-1.5">
+                                  {UPLOAD_FORMAT_OPTIONS.map((option) => (
+                                    <PillButton
+                                      key={option.value}
+                                      active={(localConfig.online.uploadFormat ?? 'flac') === option.value}
+                                      onClick={() => handleUploadOptionChange({ uploadFormat: option.value })}
+                                      disabled={saving}
+                                    >
+                                      {option.label}
+                                    </PillButton>
+                                  ))}
+                                  <PillButton
+                                    active={localConfig.online.trimSilence ?? true}
+                                    onClick={() => handleUploadOptionChange({ trimSilence: !(localConfig.online.trimSilence ?? true) })}
+                                    disabled={saving}
+                                    title="上传前裁掉首尾静音"
+                                  >
+                                    裁剪静音
+                                  </PillButton>
+                                  <PillButton
+                                    active={localConfig.online.streamingUpload ?? true}
+                                    onClick={() => handleUploadOptionChange({ streamingUpload: !(localConfig.online.streamingUpload ?? true) })}
+                                    disabled={saving}
+                                    title="录音期间边编码边上传，松开按键后只需等待识别结果"
+                                  >
+                                    边录边传
+                                  </PillButton>
+                                </div>
+                                <p className="text-[11px] text-gray-400 mt-1">FLAC 为无损压缩，体积约为 WAV 的一半；边录边传需要服务端支持分块请求，不支持时自动整段上传</p>
+                              </div>
                             </div>
                           )}
                         </div>
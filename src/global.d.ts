@@ -1,5 +1,5 @@
-import type { SpeechTideState, ShortcutConfig, AppleDictationStatus } from '../shared/app-state'
-import type { ConversationRecord } from '../shared/conversation'
+import type { SpeechTideState, ShortcutConfig, AppleDictationStatus, ModelResidencyStats, BatchQueueSnapshot, WorkerQueueStats, AutotuneStatus, ResultCacheStats, RetentionStatus, TranscriptSegment } from '../shared/app-state'
+import type { ConversationRecord, HistorySearchResult, UsageAnalytics, UsageAnalyticsOptions } from '../shared/conversation'
 import type { AppSettings } from '../electron/config'
 
 interface TestTranscriptionResult {
@@ -34,10 +34,9 @@ interface ModelInfo {
 }
 
 interface NativeRecorderAPI {
-  onStart: (callback: (config: { sampleRate: number; channels: number }) => void) => () => void
+  /** 音频帧端口通过 window 的 message 事件送达（见 shared/recorder-frame.ts） */
+  onStart: (callback: (config: { sampleRate: number; channels: number; frameMs: number }) => void) => () => void
   onStop: (callback: () => void) => () => void
-  sendChunk: (data: ArrayBuffer) => void
-  sendComplete: (data?: ArrayBuffer | null) => void
 }
 
 /** 更新状态 */
@@ -93,13 +92,33 @@ declare global {
       getHistoryStats: (options?: { maxAgeDays?: number }) => Promise<{ count: number; sizeBytes: number; error?: string }>
       clearHistory: (options?: { maxAgeDays?: number }) => Promise<{ success: boolean; deletedCount?: number; error?: string }>
       getHistoryList: (options?: { limit?: number; offset?: number }) => Promise<{ records: ConversationRecord[]; error?: string }>
+      searchHistory: (options: { query: string; limit?: number; offset?: number }) => Promise<HistorySearchResult>
+      getUsageAnalytics: (options?: UsageAnalyticsOptions) => Promise<UsageAnalytics>
       deleteHistoryItem: (sessionId: string) => Promise<{ success: boolean; error?: string }>
       playHistoryAudio: (sessionId: string) => Promise<{ success: boolean; error?: string }>
+      exportHistoryAudio: (sessionId: string) => Promise<{ success: boolean; canceled?: boolean; filePath?: string; error?: string }>
       onPlayAudio: (callback: (audioPath: string) => void) => () => void
+      getPerformanceStats: () => Promise<{
+        residency: ModelResidencyStats
+        operations: Record<string, { count: number; avgDuration: number; minDuration: number; maxDuration: number }>
+        workerQueues: { dictation: WorkerQueueStats | null; files: WorkerQueueStats[] }
+        resultCache: ResultCacheStats
+      }>
+      getAutotuneStatus: () => Promise<AutotuneStatus>
+      runAutotune: () => Promise<AutotuneStatus>
+      onAutotuneUpdate: (callback: (status: AutotuneStatus) => void) => () => void
+      getRetentionStatus: () => Promise<RetentionStatus>
+      runRetention: () => Promise<RetentionStatus>
+      onRetentionUpdate: (callback: (status: RetentionStatus) => void) => () => void
       // 文件转录 API
-      transcribeFile: (filePath: string) => Promise<{ success: boolean; text?: string; durationMs?: number; error?: string }>
+      transcribeFile: (filePath: string) => Promise<{ success: boolean; text?: string; durationMs?: number; segments?: TranscriptSegment[]; error?: string }>
       onTranscribeProgress: (callback: (progress: number) => void) => () => void
-      exportTranscription: (options: { text: string; outputPath: string; fileName: string }) => Promise<{ success: boolean; fullPath?: string; error?: string }>
+      onTranscribeSegments: (callback: (segments: TranscriptSegment[]) => void) => () => void
+      transcribeBatch: (filePaths: string[]) => Promise<{ success: boolean; snapshot?: BatchQueueSnapshot; error?: string }>
+      getBatchQueue: () => Promise<BatchQueueSnapshot>
+      clearBatchQueue: () => Promise<BatchQueueSnapshot>
+      onBatchQueueUpdate: (callback: (snapshot: BatchQueueSnapshot) => void) => () => void
+      exportTranscription: (options: { text: string; outputPath: string; fileName: string; segments?: TranscriptSegment[] }) => Promise<{ success: boolean; fullPath?: string; error?: string }>
       selectDirectory: () => Promise<{ path: string | null; canceled: boolean }>
     }
     onboarding: {
@@ -1,21 +1,39 @@
 /**
  * 原生录音 Hook
  * 
- * 使用 Web Audio API 在渲染进程录音，通过 IPC 传输到主进程
+ * 使用 Web Audio API 在渲染进程录音，按帧攒批后经主进程提供的 MessagePort 传输
  */
 
 import { useEffect, useRef } from 'react'
+import { RECORDER_PORT_MESSAGE } from '../../shared/recorder-frame'
+import { RecorderFrameSender } from '../lib/recorder-frame-sender'
 
 export function useNativeRecorder() {
   const audioContextRef = useRef<AudioContext | null>(null)
   const processorRef = useRef<ScriptProcessorNode | null>(null)
   const streamRef = useRef<MediaStream | null>(null)
+  const senderRef = useRef<RecorderFrameSender | null>(null)
 
   useEffect(() => {
+    // 接收 preload 转发的音频帧端口（紧随开始信号之后到达）
+    const handlePortMessage = (event: MessageEvent) => {
+      if (event.source !== window || event.data?.type !== RECORDER_PORT_MESSAGE || !event.ports[0]) return
+      if (senderRef.current) {
+        senderRef.current.attach(event.ports[0])
+      } else {
+        event.ports[0].close()
+      }
+    }
+    window.addEventListener('message', handlePortMessage)
+
     // 监听开始录音信号
     const unsubStart = window.nativeRecorder.onStart(async (config) => {
       console.log('[NativeRecorder] 开始录音', config)
-      
+
+      // 在任何 await 之前创建，保证端口消息到达时已有接收方
+      const sender = new RecorderFrameSender(config.sampleRate, config.channels, config.frameMs)
+      senderRef.current = sender
+
       try {
         // 获取麦克风权限
         const stream = await navigator.mediaDevices.getUserMedia({
@@ -42,14 +60,12 @@ export function useNativeRecorder() {
         processorRef.current = processor
 
         processor.onaudioprocess = (e) => {
-          const inputData = e.inputBuffer.getChannelData(0)
-          
-          // 将 Float32 转换为 Int16
-          const int16Data = float32ToInt16(inputData)
-          
-          // 发送到主进程（实时发送，不再本地保存）
-          const buffer = int16Data.buffer as ArrayBuffer
-          window.nativeRecorder.sendChunk(buffer)
+          const channelData: Float32Array[] = []
+          for (let ch = 0; ch < e.inputBuffer.numberOfChannels; ch++) {
+            channelData.push(e.inputBuffer.getChannelData(ch))
+          }
+          // 转换为 Int16 写入当前帧，攒满后发送到主进程
+          sender.write(channelData)
         }
 
         // 连接节点
@@ -84,16 +100,19 @@ export function useNativeRecorder() {
         streamRef.current = null
       }
 
-      // 发送完成信号（不传数据，因为数据已经实时发送了）
-      window.nativeRecorder.sendComplete()
+      // 发送最后一帧并带上结束标志；保留引用，端口晚于停止信号到达时仍可补发
+      senderRef.current?.end()
 
       console.log('[NativeRecorder] 录音已停止')
     })
 
     return () => {
+      window.removeEventListener('message', handlePortMessage)
       unsubStart()
       unsubStop()
-      
+      senderRef.current?.end()
+      senderRef.current = null
+
       // 清理
       if (processorRef.current) {
         processorRef.current.disconnect()
@@ -107,16 +126,3 @@ export function useNativeRecorder() {
     }
   }, [])
 }
-
-/**
- * 将 Float32Array 转换为 Int16Array
- */
-function float32ToInt16(float32Array: Float32Array): Int16Array {
-  const int16Array = new Int16Array(float32Array.length)
-  for (let i = 0; i < float32Array.length; i++) {
-    const s = Math.max(-1, Math.min(1, float32Array[i]))
-    int16Array[i] = s < 0 ? s * 0x8000 : s * 0x7fff
-  }
-  return int16Array
-}
-
@@ -0,0 +1,92 @@
+/**
+ * 录音帧发送器
+ *
+ * 把 Web Audio 回调产生的 Float32 样本直接转换写入帧缓冲，攒满 frameMs 后
+ * 连同帧头一起转移（transfer）到主进程端口，避免逐回调发送与额外拷贝。
+ * 端口尚未送达时先缓存已满的帧。
+ */
+
+import {
+  createRecorderFrame,
+  FRAME_FLAG_END,
+  RECORDER_FRAME_HEADER_BYTES,
+} from '../../shared/recorder-frame'
+
+export class RecorderFrameSender {
+  private port: MessagePort | null = null
+  private backlog: ArrayBuffer[] = []
+  private readonly frameSamples: number
+  private seq = 0
+  /** 已写入的每声道样本数 */
+  private sampleOffset = 0
+  private frame: { buffer: ArrayBuffer; pcm: Int16Array } | null = null
+  private filled = 0
+  private ended = false
+
+  constructor(sampleRate: number, private readonly channels: number, frameMs: number) {
+    const framesPerBatch = Math.max(1, Math.round((sampleRate * frameMs) / 1000))
+    this.frameSamples = framesPerBatch * channels
+  }
+
+  attach(port: MessagePort): void {
+    this.port = port
+    for (const buffer of this.backlog) {
+      port.postMessage(buffer, [buffer])
+    }
+    this.backlog = []
+  }
+
+  /**
+   * 写入一次回调的各声道数据（等长），按交错顺序转换为 16-bit
+   */
+  write(channelData: Float32Array[]): void {
+    if (this.ended) return
+    const frames = channelData[0]?.length ?? 0
+    for (let i = 0; i < frames; i++) {
+      for (let ch = 0; ch < this.channels; ch++) {
+        if (!this.frame) {
+          this.frame = createRecorderFrame(
+            { seq: this.seq, flags: 0, sampleOffset: this.sampleOffset + i },
+            this.frameSamples
+          )
+          this.filled = 0
+        }
+        // 声道数多于实际输入时复用第一声道
+        const s = Math.max(-1, Math.min(1, (channelData[ch] ?? channelData[0])[i]))
+        this.frame.pcm[this.filled++] = s < 0 ? s * 0x8000 : s * 0x7fff
+        if (this.filled === this.frameSamples) {
+          this.post(this.frame.buffer)
+          this.frame = null
+        }
+      }
+    }
+    this.sampleOffset += frames
+  }
+
+  /**
+   * 发送剩余样本与结束标志，之后不再接受数据
+   */
+  end(): void {
+    if (this.ended) return
+    this.ended = true
+    if (this.frame) {
+      // 未写满的帧截掉尾部空白，并在帧头上补结束标志
+      const buffer = this.frame.buffer.slice(0, RECORDER_FRAME_HEADER_BYTES + this.filled * 2)
+      new DataView(buffer).setUint32(4, FRAME_FLAG_END, true)
+      this.frame = null
+      this.post(buffer)
+    } else {
+      const { buffer } = createRecorderFrame({ seq: this.seq, flags: FRAME_FLAG_END, sampleOffset: this.sampleOffset }, 0)
+      this.post(buffer)
+    }
+  }
+
+  private post(buffer: ArrayBuffer): void {
+    this.seq++
+    if (this.port) {
+      this.port.postMessage(buffer, [buffer])
+    } else {
+      this.backlog.push(buffer)
+    }
+  }
+}